@@ -31,8 +31,7 @@ NS_ASSUME_NONNULL_BEGIN
 	size_t inputBufferSize;
 
 #if DSD_DECIMATE
-	void **dsd2pcm;
-	size_t dsd2pcmCount;
+	void *dsd2pcm;
 	int dsd2pcmLatency;
 #endif
 	
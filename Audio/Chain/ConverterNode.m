@@ -19,6 +19,8 @@
 #import "lpc.h"
 #import "util.h"
 
+#import "dsd2pcm.h"
+
 #ifdef _DEBUG
 #import "BadSampleCleaner.h"
 #endif
@@ -407,7 +409,7 @@ static float db_to_scale(float db) {
 #if DSD_DECIMATE
 	if(inputFormat.mBitsPerChannel == 1) {
 		// Decimate this for speed
-		floatFormat.mSampleRate *= 1.0 / 8.0;
+		floatFormat.mSampleRate *= 1.0 / dsd2pcm_decimation(inputFormat.mSampleRate);
 	}
 #endif
 
@@ -16,16 +16,10 @@
 @interface HeadphoneFilter : NSObject {
 	NSURL *URL;
 
-	int bufferSize;
-	int paddedBufferSize;
 	int channelCount;
 	uint32_t config;
 
-	float **mirroredImpulseResponses;
-	
-	float **prevInputs;
-
-	float *paddedSignal[2];
+	void *convolver;
 }
 
 + (BOOL)validateImpulseFile:(NSURL *)url;
@@ -16,6 +16,7 @@
 
 #import "rsstate.h"
 
+#import "HrtfConvolver.h"
 #import "HrtfData.h"
 
 #import "Logging.h"
@@ -26,6 +27,9 @@ typedef struct speakerPosition {
 	float distance;
 } speakerPosition;
 
+// Partition length of the FFT convolver, in frames
+static const uint32_t HeadphoneFilterBlockSize = 256;
+
 #define DEGREES(x) ((x)*M_PI / 180.0)
 
 static const speakerPosition speakerPositions[18] = {
@@ -125,7 +129,8 @@ static void transformPosition(float &elevation, float &azimuth, const simd_float
 	HrtfData *data;
 }
 + (impulseSetCache *)sharedController;
-- (void)getImpulse:(NSURL *)url outImpulse:(float **)outImpulse outSampleCount:(int *)outSampleCount channelCount:(int)channelCount channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix;
+- (HrtfConvolver *)newConvolver:(NSURL *)url channelCount:(int)channelCount channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix;
+- (BOOL)loadImpulses:(NSURL *)url intoConvolver:(HrtfConvolver *)convolver channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix;
 @end
 
 @implementation impulseSetCache
@@ -152,10 +157,7 @@ static impulseSetCache *_sharedController = nil;
 	delete data;
 }
 
-- (void)getImpulse:(NSURL *)url outImpulse:(float **)outImpulse outSampleCount:(int *)outSampleCount channelCount:(int)channelCount channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix {
-	double sampleRateOfSource = 0;
-	int sampleCount = 0;
-
+- (BOOL)loadData:(NSURL *)url {
 	if(!data || ![url isEqualTo:URL]) {
 		delete data;
 		data = NULL;
@@ -173,18 +175,40 @@ static impulseSetCache *_sharedController = nil;
 		}
 	}
 
+	return data != NULL;
+}
+
+- (HrtfConvolver *)newConvolver:(NSURL *)url channelCount:(int)channelCount channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix {
+	if(![self loadData:url]) {
+		return NULL;
+	}
+
+	HrtfConvolver *convolver = NULL;
+
 	try {
-		sampleRateOfSource = data->get_sample_rate();
+		uint32_t sampleCount = data->get_response_length() + ((data->get_longest_delay() + 2) >> 2);
 
-		uint32_t sampleCountExact = data->get_response_length();
-		sampleCount = sampleCountExact + ((data->get_longest_delay() + 2) >> 2);
-		sampleCount = (sampleCount + 15) & ~15;
+		convolver = new HrtfConvolver(channelCount, sampleCount, HeadphoneFilterBlockSize);
+	} catch(std::exception &e) {
+		ALog(@"Exception caught: %s", e.what());
+		return NULL;
+	}
 
-		*outImpulse = (float *)calloc(sizeof(float), sampleCount * channelCount * 2);
-		if(!*outImpulse) {
-			throw std::bad_alloc();
-		}
-		float *hrtfData = *outImpulse;
+	if(![self loadImpulses:url intoConvolver:convolver channelConfig:channelConfig withMatrix:matrix]) {
+		delete convolver;
+		return NULL;
+	}
+
+	return convolver;
+}
+
+- (BOOL)loadImpulses:(NSURL *)url intoConvolver:(HrtfConvolver *)convolver channelConfig:(uint32_t)channelConfig withMatrix:(simd_float4x4)matrix {
+	if(![self loadData:url]) {
+		return NO;
+	}
+
+	try {
+		uint32_t channelCount = convolver->get_channel_count();
 
 		for(uint32_t i = 0; i < channelCount; ++i) {
 			uint32_t channelFlag = [AudioChunk extractChannelFlag:i fromConfig:channelConfig];
@@ -202,15 +226,15 @@ static impulseSetCache *_sharedController = nil;
 
 				data->get_direction_data(elevation, azimuth, speaker.distance, hrtfLeft, hrtfRight);
 
-				cblas_scopy(sampleCountExact, &hrtfLeft.impulse_response[0], 1, &hrtfData[((hrtfLeft.delay + 2) >> 2) + sampleCount * i * 2], 1);
-				cblas_scopy(sampleCountExact, &hrtfRight.impulse_response[0], 1, &hrtfData[((hrtfLeft.delay + 2) >> 2) + sampleCount * (i * 2 + 1)], 1);
+				convolver->set_direction_data(i, hrtfLeft, hrtfRight);
 			}
 		}
-
-		*outSampleCount = sampleCount;
 	} catch(std::exception &e) {
 		ALog(@"Exception caught: %s", e.what());
+		return NO;
 	}
+
+	return YES;
 }
 @end
 
@@ -245,40 +269,9 @@ static impulseSetCache *_sharedController = nil;
 		channelCount = channels;
 		self->config = config;
 
-		float *impulseBuffer = NULL;
-		int sampleCount = 0;
-		[[impulseSetCache sharedController] getImpulse:url outImpulse:&impulseBuffer outSampleCount:&sampleCount channelCount:channels channelConfig:config withMatrix:matrix];
-		if(!impulseBuffer) {
-			return nil;
-		}
-
-		mirroredImpulseResponses = (float **)calloc(sizeof(float *), channelCount * 2);
-		if(!mirroredImpulseResponses) {
-			free(impulseBuffer);
-			return nil;
-		}
-
-		for(int i = 0; i < channelCount * 2; ++i) {
-			mirroredImpulseResponses[i] = &impulseBuffer[sampleCount * i];
-			vDSP_vrvrs(mirroredImpulseResponses[i], 1, sampleCount);
-		}
-
-		paddedBufferSize = sampleCount;
-
-		paddedSignal[0] = (float *)calloc(sizeof(float), paddedBufferSize * 2);
-		if(!paddedSignal[0]) {
-			return nil;
-		}
-		paddedSignal[1] = paddedSignal[0] + paddedBufferSize;
-
-		prevInputs = (float **)calloc(channels, sizeof(float *));
-		if(!prevInputs)
-			return nil;
-		prevInputs[0] = (float *)calloc(sizeof(float), sampleCount * channelCount);
-		if(!prevInputs[0])
+		convolver = (void *)[[impulseSetCache sharedController] newConvolver:url channelCount:channels channelConfig:config withMatrix:matrix];
+		if(!convolver) {
 			return nil;
-		for(int i = 1; i < channels; ++i) {
-			prevInputs[i] = prevInputs[i - 1] + sampleCount;
 		}
 	}
 
@@ -286,73 +279,34 @@ static impulseSetCache *_sharedController = nil;
 }
 
 - (void)dealloc {
-	if(paddedSignal[0]) {
-		free(paddedSignal[0]);
-	}
-
-	if(prevInputs) {
-		if(prevInputs[0]) {
-			free(prevInputs[0]);
-		}
-		free(prevInputs);
-	}
-
-	if(mirroredImpulseResponses) {
-		if(mirroredImpulseResponses[0]) {
-			free(mirroredImpulseResponses[0]);
-		}
-		free(mirroredImpulseResponses);
+	if(convolver) {
+		HrtfConvolver *_convolver = (HrtfConvolver *)convolver;
+		delete _convolver;
 	}
 }
 
 - (void)reloadWithMatrix:(simd_float4x4)matrix {
 	@synchronized (self) {
-		if(!mirroredImpulseResponses[0]) {
+		if(!convolver) {
 			return;
 		}
 
-		free(mirroredImpulseResponses[0]);
-
-		float *impulseBuffer = NULL;
-		int sampleCount = 0;
-		[[impulseSetCache sharedController] getImpulse:URL outImpulse:&impulseBuffer outSampleCount:&sampleCount channelCount:channelCount channelConfig:config withMatrix:matrix];
-
-		for(int i = 0; i < channelCount * 2; ++i) {
-			mirroredImpulseResponses[i] = &impulseBuffer[sampleCount * i];
-			vDSP_vrvrs(mirroredImpulseResponses[i], 1, sampleCount);
-		}
+		HrtfConvolver *_convolver = (HrtfConvolver *)convolver;
+		[[impulseSetCache sharedController] loadImpulses:URL intoConvolver:_convolver channelConfig:config withMatrix:matrix];
 	}
 }
 
 - (void)process:(const float *)inBuffer sampleCount:(int)count toBuffer:(float *)outBuffer {
 	@synchronized (self) {
-		int sampleCount = paddedBufferSize;
-		while(count > 0) {
-			float left = 0, right = 0;
-			for(int i = 0; i < channelCount; ++i) {
-				float thisleft, thisright;
-				vDSP_vmul(prevInputs[i], 1, mirroredImpulseResponses[i * 2], 1, paddedSignal[0], 1, sampleCount);
-				vDSP_vmul(prevInputs[i], 1, mirroredImpulseResponses[i * 2 + 1], 1, paddedSignal[1], 1, sampleCount);
-				vDSP_sve(paddedSignal[0], 1, &thisleft, sampleCount);
-				vDSP_sve(paddedSignal[1], 1, &thisright, sampleCount);
-				left += thisleft;
-				right += thisright;
-
-				memmove(prevInputs[i], prevInputs[i] + 1, sizeof(float) * (sampleCount - 1));
-				prevInputs[i][sampleCount - 1] = *inBuffer++;
-			}
-
-			outBuffer[0] = left;
-			outBuffer[1] = right;
-			outBuffer += 2;
-			--count;
-		}
+		HrtfConvolver *_convolver = (HrtfConvolver *)convolver;
+		_convolver->process(inBuffer, count, outBuffer);
 	}
 }
 
 - (void)reset {
-	for(int i = 0; i < channelCount; ++i) {
-		vDSP_vclr(prevInputs[i], 1, paddedBufferSize);
+	@synchronized (self) {
+		HrtfConvolver *_convolver = (HrtfConvolver *)convolver;
+		_convolver->reset();
 	}
 }
 
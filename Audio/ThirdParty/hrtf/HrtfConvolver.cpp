@@ -0,0 +1,306 @@
+#include "HrtfConvolver.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static const double pi = 3.14159265358979323846;
+
+HrtfConvolver::RealFft::RealFft(uint32_t size)
+: m_size(size), m_half_size(size / 2) {
+	if(size < 4 || (size & (size - 1))) {
+		throw std::logic_error("FFT size must be a power of two.");
+	}
+
+	uint32_t bits = 0;
+	while((1u << bits) < m_half_size) {
+		bits++;
+	}
+
+	m_bit_reverse.resize(m_half_size);
+	for(uint32_t i = 0; i < m_half_size; i++) {
+		uint32_t reversed = 0;
+		for(uint32_t j = 0; j < bits; j++) {
+			reversed |= ((i >> j) & 1) << (bits - 1 - j);
+		}
+		m_bit_reverse[i] = reversed;
+	}
+
+	m_twiddle_re.resize(m_half_size / 2 + 1);
+	m_twiddle_im.resize(m_half_size / 2 + 1);
+	for(uint32_t i = 0; i <= m_half_size / 2; i++) {
+		const double angle = -2.0 * pi * i / m_half_size;
+		m_twiddle_re[i] = float(std::cos(angle));
+		m_twiddle_im[i] = float(std::sin(angle));
+	}
+
+	m_split_re.resize(m_half_size + 1);
+	m_split_im.resize(m_half_size + 1);
+	for(uint32_t i = 0; i <= m_half_size; i++) {
+		const double angle = -2.0 * pi * i / m_size;
+		m_split_re[i] = float(std::cos(angle));
+		m_split_im[i] = float(std::sin(angle));
+	}
+
+	m_work_re.resize(m_half_size);
+	m_work_im.resize(m_half_size);
+}
+
+void HrtfConvolver::RealFft::transform(float* re, float* im, bool inverse) {
+	const uint32_t n = m_half_size;
+
+	for(uint32_t i = 0; i < n; i++) {
+		const uint32_t j = m_bit_reverse[i];
+		if(j > i) {
+			std::swap(re[i], re[j]);
+			std::swap(im[i], im[j]);
+		}
+	}
+
+	const float sign = inverse ? -1.0f : 1.0f;
+
+	for(uint32_t length = 2; length <= n; length <<= 1) {
+		const uint32_t half = length >> 1;
+		const uint32_t step = n / length;
+		for(uint32_t i = 0; i < n; i += length) {
+			for(uint32_t j = 0; j < half; j++) {
+				const float wr = m_twiddle_re[j * step];
+				const float wi = m_twiddle_im[j * step] * sign;
+				const uint32_t a = i + j;
+				const uint32_t b = a + half;
+				const float vr = re[b] * wr - im[b] * wi;
+				const float vi = re[b] * wi + im[b] * wr;
+				re[b] = re[a] - vr;
+				im[b] = im[a] - vi;
+				re[a] += vr;
+				im[a] += vi;
+			}
+		}
+	}
+}
+
+void HrtfConvolver::RealFft::forward(const float* input, float* out_re, float* out_im) {
+	const uint32_t n = m_half_size;
+	float* re = &m_work_re[0];
+	float* im = &m_work_im[0];
+
+	// Pack even samples into the real part and odd samples into the imaginary part
+	for(uint32_t i = 0; i < n; i++) {
+		re[i] = input[i * 2];
+		im[i] = input[i * 2 + 1];
+	}
+
+	transform(re, im, false);
+
+	for(uint32_t k = 0; k <= n; k++) {
+		const uint32_t i = k % n;
+		const uint32_t j = (n - k) % n;
+		const float even_re = (re[i] + re[j]) * 0.5f;
+		const float even_im = (im[i] - im[j]) * 0.5f;
+		const float odd_re = (im[i] + im[j]) * 0.5f;
+		const float odd_im = (re[j] - re[i]) * 0.5f;
+		const float wr = m_split_re[k];
+		const float wi = m_split_im[k];
+		out_re[k] = even_re + odd_re * wr - odd_im * wi;
+		out_im[k] = even_im + odd_re * wi + odd_im * wr;
+	}
+}
+
+void HrtfConvolver::RealFft::inverse(const float* in_re, const float* in_im, float* output) {
+	const uint32_t n = m_half_size;
+	float* re = &m_work_re[0];
+	float* im = &m_work_im[0];
+
+	for(uint32_t k = 0; k < n; k++) {
+		const uint32_t j = n - k;
+		const float even_re = in_re[k] + in_re[j];
+		const float even_im = in_im[k] - in_im[j];
+		const float diff_re = in_re[k] - in_re[j];
+		const float diff_im = in_im[k] + in_im[j];
+		const float wr = m_split_re[k];
+		const float wi = -m_split_im[k];
+		const float odd_re = diff_re * wr - diff_im * wi;
+		const float odd_im = diff_re * wi + diff_im * wr;
+		re[k] = even_re - odd_im;
+		im[k] = even_im + odd_re;
+	}
+
+	transform(re, im, true);
+
+	for(uint32_t i = 0; i < n; i++) {
+		output[i * 2] = re[i];
+		output[i * 2 + 1] = im[i];
+	}
+}
+
+static uint32_t next_power_of_two(uint32_t value) {
+	uint32_t result = 16;
+	while(result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+HrtfConvolver::HrtfConvolver(uint32_t channel_count, uint32_t max_response_length, uint32_t block_size)
+: m_channel_count(channel_count),
+  m_block_size(next_power_of_two(block_size)),
+  m_bin_count(m_block_size + 1),
+  m_partition_count(std::max(1u, (max_response_length + m_block_size - 1) / m_block_size)),
+  m_fill(0),
+  m_history_position(0),
+  m_fft(m_block_size * 2) {
+	if(!channel_count) {
+		throw std::logic_error("Invalid channel count.");
+	}
+
+	const size_t response_size = size_t(m_channel_count) * 2 * m_partition_count * m_bin_count;
+	const size_t history_size = size_t(m_channel_count) * m_partition_count * m_bin_count;
+	const size_t spectrum_size = size_t(m_channel_count) * m_bin_count;
+
+	m_response_re.resize(response_size);
+	m_response_im.resize(response_size);
+	m_history_re.resize(history_size);
+	m_history_im.resize(history_size);
+	m_accumulator_re.resize(2 * m_bin_count);
+	m_accumulator_im.resize(2 * m_bin_count);
+	m_input.resize(size_t(m_channel_count) * m_block_size * 2);
+	m_spectrum_re.resize(spectrum_size);
+	m_spectrum_im.resize(spectrum_size);
+	m_mix_re.resize(m_bin_count);
+	m_mix_im.resize(m_bin_count);
+	m_output.resize(m_block_size * 2);
+}
+
+void HrtfConvolver::set_response(uint32_t channel, uint32_t ear, const DirectionData& data) {
+	const uint32_t block_size = m_block_size;
+	const uint32_t length = block_size * m_partition_count;
+	const uint32_t offset = std::min(uint32_t(std::max(0, (data.delay + 2) >> 2)), length);
+	const uint32_t count = std::min(uint32_t(data.impulse_response.size()), length - offset);
+
+	std::vector<float> response(length + block_size);
+	std::copy(data.impulse_response.begin(), data.impulse_response.begin() + count, response.begin() + offset);
+
+	// Inverse transform is unscaled, fold its gain into the response
+	const float scale = 1.0f / float(block_size * 2);
+	for(uint32_t i = 0; i < length; i++) {
+		response[i] *= scale;
+	}
+
+	std::vector<float> window(block_size * 2);
+	for(uint32_t p = 0; p < m_partition_count; p++) {
+		std::copy(response.begin() + p * block_size, response.begin() + (p + 1) * block_size, window.begin());
+		const size_t index = ((size_t(channel) * 2 + ear) * m_partition_count + p) * m_bin_count;
+		m_fft.forward(&window[0], &m_response_re[index], &m_response_im[index]);
+	}
+}
+
+void HrtfConvolver::set_direction_data(uint32_t channel, const DirectionData& data_left, const DirectionData& data_right) {
+	if(channel >= m_channel_count) {
+		throw std::logic_error("Invalid channel index.");
+	}
+
+	set_response(channel, 0, data_left);
+	set_response(channel, 1, data_right);
+
+	accumulate_history();
+}
+
+void HrtfConvolver::accumulate_history() {
+	const uint32_t bins = m_bin_count;
+
+	std::fill(m_accumulator_re.begin(), m_accumulator_re.end(), 0.0f);
+	std::fill(m_accumulator_im.begin(), m_accumulator_im.end(), 0.0f);
+
+	for(uint32_t p = 1; p < m_partition_count; p++) {
+		const uint32_t slot = (m_history_position + m_partition_count - (p - 1)) % m_partition_count;
+		for(uint32_t c = 0; c < m_channel_count; c++) {
+			const float* x_re = &m_history_re[(size_t(c) * m_partition_count + slot) * bins];
+			const float* x_im = &m_history_im[(size_t(c) * m_partition_count + slot) * bins];
+			for(uint32_t ear = 0; ear < 2; ear++) {
+				const size_t index = ((size_t(c) * 2 + ear) * m_partition_count + p) * bins;
+				const float* h_re = &m_response_re[index];
+				const float* h_im = &m_response_im[index];
+				float* y_re = &m_accumulator_re[ear * bins];
+				float* y_im = &m_accumulator_im[ear * bins];
+				for(uint32_t k = 0; k < bins; k++) {
+					y_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+					y_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+				}
+			}
+		}
+	}
+}
+
+void HrtfConvolver::process(const float* input, uint32_t frame_count, float* output) {
+	const uint32_t block_size = m_block_size;
+	const uint32_t bins = m_bin_count;
+	const uint32_t channels = m_channel_count;
+
+	while(frame_count) {
+		const uint32_t count = std::min(frame_count, block_size - m_fill);
+
+		for(uint32_t c = 0; c < channels; c++) {
+			float* dest = &m_input[size_t(c) * block_size * 2 + block_size + m_fill];
+			for(uint32_t i = 0; i < count; i++) {
+				dest[i] = input[i * channels + c];
+			}
+			m_fft.forward(&m_input[size_t(c) * block_size * 2], &m_spectrum_re[size_t(c) * bins], &m_spectrum_im[size_t(c) * bins]);
+		}
+
+		for(uint32_t ear = 0; ear < 2; ear++) {
+			float* y_re = &m_mix_re[0];
+			float* y_im = &m_mix_im[0];
+			std::copy(m_accumulator_re.begin() + ear * bins, m_accumulator_re.begin() + (ear + 1) * bins, y_re);
+			std::copy(m_accumulator_im.begin() + ear * bins, m_accumulator_im.begin() + (ear + 1) * bins, y_im);
+
+			for(uint32_t c = 0; c < channels; c++) {
+				const float* x_re = &m_spectrum_re[size_t(c) * bins];
+				const float* x_im = &m_spectrum_im[size_t(c) * bins];
+				const size_t index = (size_t(c) * 2 + ear) * m_partition_count * bins;
+				const float* h_re = &m_response_re[index];
+				const float* h_im = &m_response_im[index];
+				for(uint32_t k = 0; k < bins; k++) {
+					y_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+					y_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+				}
+			}
+
+			m_fft.inverse(y_re, y_im, &m_output[0]);
+
+			const float* src = &m_output[block_size + m_fill];
+			for(uint32_t i = 0; i < count; i++) {
+				output[i * 2 + ear] = src[i];
+			}
+		}
+
+		input += count * channels;
+		output += count * 2;
+		frame_count -= count;
+		m_fill += count;
+
+		if(m_fill == block_size) {
+			m_history_position = (m_history_position + 1) % m_partition_count;
+			for(uint32_t c = 0; c < channels; c++) {
+				const size_t index = (size_t(c) * m_partition_count + m_history_position) * bins;
+				std::copy(m_spectrum_re.begin() + c * bins, m_spectrum_re.begin() + (c + 1) * bins, m_history_re.begin() + index);
+				std::copy(m_spectrum_im.begin() + c * bins, m_spectrum_im.begin() + (c + 1) * bins, m_history_im.begin() + index);
+
+				float* buffer = &m_input[size_t(c) * block_size * 2];
+				std::copy(buffer + block_size, buffer + block_size * 2, buffer);
+				std::fill(buffer + block_size, buffer + block_size * 2, 0.0f);
+			}
+			m_fill = 0;
+
+			accumulate_history();
+		}
+	}
+}
+
+void HrtfConvolver::reset() {
+	std::fill(m_history_re.begin(), m_history_re.end(), 0.0f);
+	std::fill(m_history_im.begin(), m_history_im.end(), 0.0f);
+	std::fill(m_accumulator_re.begin(), m_accumulator_re.end(), 0.0f);
+	std::fill(m_accumulator_im.begin(), m_accumulator_im.end(), 0.0f);
+	std::fill(m_input.begin(), m_input.end(), 0.0f);
+	m_fill = 0;
+	m_history_position = 0;
+}
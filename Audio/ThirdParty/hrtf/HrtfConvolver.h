@@ -0,0 +1,89 @@
+#pragma once
+
+#include "HrtfTypes.h"
+#include <cstdint>
+#include <vector>
+
+// Uniformly partitioned overlap-save convolver, mixing any number of input
+// channels down to a binaural pair. Each input channel is convolved with the
+// left and right responses produced by IHrtfData::get_direction_data.
+//
+// Input may be fed in blocks of any size. Whole partitions are transformed
+// once and kept in a frequency domain delay line; a partially filled partition
+// is transformed again on every call, so the convolver adds no latency.
+class HrtfConvolver {
+	class RealFft {
+		public:
+		RealFft(uint32_t size);
+
+		// size real samples in, size / 2 + 1 complex bins out
+		void forward(const float* input, float* out_re, float* out_im);
+		// size / 2 + 1 complex bins in, size real samples out, scaled by size
+		void inverse(const float* in_re, const float* in_im, float* output);
+
+		private:
+		void transform(float* re, float* im, bool inverse);
+
+		uint32_t m_size;
+		uint32_t m_half_size;
+		std::vector<uint32_t> m_bit_reverse;
+		std::vector<float> m_twiddle_re;
+		std::vector<float> m_twiddle_im;
+		std::vector<float> m_split_re;
+		std::vector<float> m_split_im;
+		std::vector<float> m_work_re;
+		std::vector<float> m_work_im;
+	};
+
+	public:
+	// max_response_length must cover the response and its onset delay, in samples
+	HrtfConvolver(uint32_t channel_count, uint32_t max_response_length, uint32_t block_size = 256);
+
+	// Delays are in the quarter sample units used by HrtfData
+	void set_direction_data(uint32_t channel, const DirectionData& data_left, const DirectionData& data_right);
+
+	// Interleaved input of channel_count channels, interleaved stereo output
+	void process(const float* input, uint32_t frame_count, float* output);
+
+	void reset();
+
+	uint32_t get_channel_count() const {
+		return m_channel_count;
+	}
+	uint32_t get_block_size() const {
+		return m_block_size;
+	}
+	uint32_t get_partition_count() const {
+		return m_partition_count;
+	}
+
+	private:
+	void set_response(uint32_t channel, uint32_t ear, const DirectionData& data);
+	void accumulate_history();
+
+	uint32_t m_channel_count;
+	uint32_t m_block_size;
+	uint32_t m_bin_count;
+	uint32_t m_partition_count;
+	uint32_t m_fill;
+	uint32_t m_history_position;
+
+	RealFft m_fft;
+
+	// [channel][ear][partition][bin]
+	std::vector<float> m_response_re;
+	std::vector<float> m_response_im;
+	// [channel][partition][bin], ring indexed by m_history_position
+	std::vector<float> m_history_re;
+	std::vector<float> m_history_im;
+	// [ear][bin], contribution of every partition but the current one
+	std::vector<float> m_accumulator_re;
+	std::vector<float> m_accumulator_im;
+	// [channel][2 * block_size], previous and current input block
+	std::vector<float> m_input;
+	std::vector<float> m_spectrum_re;
+	std::vector<float> m_spectrum_im;
+	std::vector<float> m_mix_re;
+	std::vector<float> m_mix_im;
+	std::vector<float> m_output;
+};
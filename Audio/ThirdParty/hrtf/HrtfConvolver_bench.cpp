@@ -0,0 +1,165 @@
+// Time of the HeadphoneFilter convolution, once the old way, a direct dot
+// product of every input channel history against the mirrored impulse per
+// output frame followed by a one sample history shift, and once through
+// HrtfConvolver, checking the outputs match. Not part of the project, build
+// it by hand:
+//
+// c++ -std=c++11 -O2 -o HrtfConvolver_bench HrtfConvolver_bench.cpp HrtfConvolver.cpp
+//
+// ./HrtfConvolver_bench
+//
+// The old path is written with plain loops standing in for the vDSP_vmul,
+// vDSP_sve and memmove calls HeadphoneFilter made. It read the history before
+// appending the current frame, so its output lags by one frame; the
+// comparison accounts for that.
+
+#include "HrtfConvolver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Buffer size HeadphoneFilter is usually handed per call
+static const uint32_t frames_per_call = 512;
+
+class DirectFilter {
+	public:
+	DirectFilter(uint32_t channel_count, const std::vector<DirectionData>& left, const std::vector<DirectionData>& right, uint32_t max_length)
+	: m_channel_count(channel_count) {
+		m_sample_count = (max_length + 15) & ~15;
+		m_mirrored.resize(size_t(m_sample_count) * channel_count * 2);
+		m_history.resize(size_t(m_sample_count) * channel_count);
+		m_product[0].resize(m_sample_count);
+		m_product[1].resize(m_sample_count);
+
+		for(uint32_t i = 0; i < channel_count; i++) {
+			// The old cache placed both ears at the left ear's onset delay
+			const uint32_t offset = (left[i].delay + 2) >> 2;
+			std::copy(left[i].impulse_response.begin(), left[i].impulse_response.end(), &m_mirrored[m_sample_count * i * 2 + offset]);
+			std::copy(right[i].impulse_response.begin(), right[i].impulse_response.end(), &m_mirrored[m_sample_count * (i * 2 + 1) + offset]);
+		}
+		for(uint32_t i = 0; i < channel_count * 2; i++) {
+			std::reverse(&m_mirrored[m_sample_count * i], &m_mirrored[m_sample_count * (i + 1)]);
+		}
+	}
+
+	void process(const float* input, uint32_t count, float* output) {
+		const uint32_t sample_count = m_sample_count;
+		while(count > 0) {
+			float left = 0, right = 0;
+			for(uint32_t i = 0; i < m_channel_count; i++) {
+				float* history = &m_history[sample_count * i];
+				const float* mirrored_left = &m_mirrored[sample_count * i * 2];
+				const float* mirrored_right = mirrored_left + sample_count;
+				for(uint32_t j = 0; j < sample_count; j++) {
+					m_product[0][j] = history[j] * mirrored_left[j];
+					m_product[1][j] = history[j] * mirrored_right[j];
+				}
+				float this_left = 0, this_right = 0;
+				for(uint32_t j = 0; j < sample_count; j++) {
+					this_left += m_product[0][j];
+					this_right += m_product[1][j];
+				}
+				left += this_left;
+				right += this_right;
+
+				memmove(history, history + 1, sizeof(float) * (sample_count - 1));
+				history[sample_count - 1] = *input++;
+			}
+
+			output[0] = left;
+			output[1] = right;
+			output += 2;
+			--count;
+		}
+	}
+
+	private:
+	uint32_t m_channel_count;
+	uint32_t m_sample_count;
+	std::vector<float> m_mirrored;
+	std::vector<float> m_history;
+	std::vector<float> m_product[2];
+};
+
+static uint32_t seed = 1;
+
+static float noise() {
+	seed = seed * 1664525 + 1013904223;
+	return float(int32_t(seed)) / 2147483648.0f;
+}
+
+// Decaying noise, roughly the shape of a measured response
+static void make_response(DirectionData& data, uint32_t length, delay_t delay) {
+	data.impulse_response.resize(length);
+	for(uint32_t i = 0; i < length; i++) {
+		data.impulse_response[i] = noise() * std::exp(-6.0f * float(i) / float(length));
+	}
+	data.delay = delay;
+	data.delay_right = delay;
+}
+
+template <class Filter>
+static double run(Filter& filter, const std::vector<float>& input, uint32_t channel_count, uint32_t frame_count, std::vector<float>& output) {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(uint32_t done = 0; done < frame_count; done += frames_per_call) {
+		const uint32_t count = std::min(frames_per_call, frame_count - done);
+		filter.process(&input[size_t(done) * channel_count], count, &output[size_t(done) * 2]);
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void bench(uint32_t channel_count, uint32_t response_length) {
+	std::vector<DirectionData> left(channel_count), right(channel_count);
+	for(uint32_t i = 0; i < channel_count; i++) {
+		const delay_t delay = delay_t(4 * (i % 5) * 3);
+		make_response(left[i], response_length, delay);
+		make_response(right[i], response_length, delay);
+	}
+
+	const uint32_t sample_rate = 44100;
+	const uint32_t frame_count = sample_rate * 5;
+	std::vector<float> input(size_t(frame_count) * channel_count);
+	for(size_t i = 0; i < input.size(); i++) {
+		input[i] = noise() * 0.5f;
+	}
+
+	const uint32_t max_length = response_length + ((4 * 4 * 3 + 2) >> 2);
+	HrtfConvolver convolver(channel_count, max_length, 256);
+	for(uint32_t i = 0; i < channel_count; i++) {
+		convolver.set_direction_data(i, left[i], right[i]);
+	}
+	DirectFilter direct(channel_count, left, right, max_length);
+
+	std::vector<float> direct_output(size_t(frame_count) * 2), convolver_output(size_t(frame_count) * 2);
+	const double direct_seconds = run(direct, input, channel_count, frame_count, direct_output);
+	const double convolver_seconds = run(convolver, input, channel_count, frame_count, convolver_output);
+
+	float max_error = 0, peak = 0;
+	for(size_t i = 2; i < direct_output.size(); i++) {
+		max_error = std::max(max_error, std::fabs(direct_output[i] - convolver_output[i - 2]));
+		peak = std::max(peak, std::fabs(direct_output[i]));
+	}
+
+	const double audio_seconds = double(frame_count) / sample_rate;
+	printf("%8u %8u %12.1f %12.1f %8.1fx %12.2e\n", channel_count, response_length,
+	       audio_seconds / direct_seconds, audio_seconds / convolver_seconds,
+	       direct_seconds / convolver_seconds, max_error / peak);
+}
+
+int main() {
+	printf("%8s %8s %12s %12s %9s %12s\n", "channels", "length", "direct x RT", "fft x RT", "speedup", "rel error");
+
+	const uint32_t channel_counts[] = { 2, 6, 8 };
+	const uint32_t response_lengths[] = { 128, 512, 2048 };
+	for(uint32_t c = 0; c < 3; c++) {
+		for(uint32_t l = 0; l < 3; l++) {
+			bench(channel_counts[c], response_lengths[l]);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,345 @@
+//
+//  dsd2pcm.cpp
+//  CogAudio Framework
+//
+
+#include "dsd2pcm.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <new>
+#include <vector>
+
+namespace {
+
+/**
+ * This is the 2nd half of an even order symmetric FIR
+ * lowpass filter (to be used on a signal sampled at 44100*64 Hz)
+ * Passband is 0-24 kHz (ripples +/- 0.025 dB)
+ * Stopband starts at 176.4 kHz (rejection: 170 dB)
+ * The overall gain is 2.0
+ * @author Sebastian Gesemann
+ */
+const int Stage1HalfLength = 64;
+const double Stage1Coefficients[Stage1HalfLength] = {
+	0.09712411121659, 0.09613438994044, 0.09417884216316, 0.09130441727307,
+	0.08757947648990, 0.08309142055179, 0.07794369263673, 0.07225228745463,
+	0.06614191680338, 0.05974199351302, 0.05318259916599, 0.04659059631228,
+	0.04008603356890, 0.03377897290478, 0.02776684382775, 0.02213240062966,
+	0.01694232798846, 0.01224650881275, 0.00807793792573, 0.00445323755944,
+	0.00137370697215, -0.00117318019994, -0.00321193033831, -0.00477694265140,
+	-0.00591028841335, -0.00665946056286, -0.00707518873201, -0.00720940203988,
+	-0.00711340642819, -0.00683632603227, -0.00642384017266, -0.00591723006715,
+	-0.00535273320457, -0.00476118922548, -0.00416794965654, -0.00359301524813,
+	-0.00305135909510, -0.00255339111833, -0.00210551956895, -0.00171076760278,
+	-0.00136940723130, -0.00107957856005, -0.00083786862365, -0.00063983084245,
+	-0.00048043272086, -0.00035442550015, -0.00025663481039, -0.00018217573430,
+	-0.00012659899635, -0.00008597726991, -0.00005694188820, -0.00003668060332,
+	-0.00002290670286, -0.00001380895679, -0.00000799057558, -0.00000440385083,
+	-0.00000228567089, -0.00000109760778, -0.00000047286430, -0.00000017129652,
+	-0.00000004282776, 0.00000000119422, 0.00000000949179, 0.00000000747450
+};
+
+// Bytes covered by the first stage filter
+const int Stage1Bytes = Stage1HalfLength * 2 / 8;
+
+// Idle pattern of DSD streams, averages to silence
+const uint8_t DSDSilence = 0x69;
+
+// Halfband stages keep everything below this fraction of the output rate free of aliasing
+const double HalfbandPassband = 0.4;
+// Stopband rejection of the halfband stages, in dB
+const double HalfbandRejection = 120.0;
+
+// The first stage turns each byte into one sample, as the sum of one table lookup per byte in the
+// filter window. Tables are shared by all decoders and built on first use.
+struct Stage1Tables {
+	// [byte position in the window, oldest first][byte]
+	float table[Stage1Bytes][256];
+
+	Stage1Tables() {
+		for(int position = 0; position < Stage1Bytes; ++position) {
+			const int age = Stage1Bytes - 1 - position;
+			for(int byte = 0; byte < 256; ++byte) {
+				double sum = 0.0;
+				for(int bit = 0; bit < 8; ++bit) {
+					// The least significant bit is the newest sample
+					const int tap = age * 8 + 7 - bit;
+					const double coeff = (tap < Stage1HalfLength) ? Stage1Coefficients[Stage1HalfLength - 1 - tap] : Stage1Coefficients[tap - Stage1HalfLength];
+					sum += (byte & (0x80 >> bit)) ? coeff : -coeff;
+				}
+				table[position][byte] = (float)sum;
+			}
+		}
+	}
+};
+
+const Stage1Tables &getStage1Tables() {
+	static const Stage1Tables tables;
+	return tables;
+}
+
+double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for(int k = 1; k < 64; ++k) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if(term < sum * 1e-16) break;
+	}
+	return sum;
+}
+
+// Kaiser windowed halfband lowpass for decimating by two. Only the center and the taps at odd
+// distances from it are non-zero, and the filter is symmetric, so only those are stored.
+struct HalfbandDesign {
+	int length; // 4 * n + 3
+	float center;
+	std::vector<float> taps; // distances 1, 3, 5...
+
+	HalfbandDesign(double inputRate, double passband) {
+		const double transition = 0.5 - 2.0 * passband / inputRate;
+		int minimum = (int)ceil((HalfbandRejection - 7.95) / (14.36 * transition)) + 1;
+		length = 3;
+		while(length < minimum) length += 4;
+
+		const int half = (length - 1) / 2;
+		const double beta = 0.1102 * (HalfbandRejection - 8.7);
+		const double norm = besselI0(beta);
+
+		std::vector<double> coeffs;
+		double sum = 0.5;
+		for(int distance = 1; distance <= half; distance += 2) {
+			const double ratio = (double)distance / half;
+			const double window = besselI0(beta * sqrt(1.0 - ratio * ratio)) / norm;
+			const double coeff = sin(M_PI * distance / 2.0) / (M_PI * distance) * window;
+			coeffs.push_back(coeff);
+			sum += 2.0 * coeff;
+		}
+
+		center = (float)(0.5 / sum);
+		for(size_t i = 0; i < coeffs.size(); ++i) {
+			taps.push_back((float)(coeffs[i] / sum));
+		}
+	}
+};
+
+// Polyphase decimator: outputs are computed for every other input only, and the taps at odd
+// distances only ever see inputs of one parity, so those are kept in their own delay line.
+struct HalfbandState {
+	const HalfbandDesign *design;
+	std::vector<float> pairHistory; // inputs the taps apply to, two copies so the window is always contiguous
+	std::vector<float> centerHistory; // other inputs, delayed until they reach the center
+	int pairPosition;
+	int centerPosition;
+	int phase;
+	float pending; // center tap of the output in progress
+
+	void reset() {
+		const int taps = (int)design->taps.size();
+		pairHistory.assign(taps * 4, 0.0f);
+		centerHistory.assign(taps, 0.0f);
+		pairPosition = 0;
+		centerPosition = 0;
+		phase = 0;
+		pending = 0.0f;
+	}
+
+	// In place, returns the number of samples output
+	size_t process(float *samples, size_t count) {
+		const int tapCount = (int)design->taps.size();
+		const int pairLength = tapCount * 2;
+		const float center = design->center;
+		const float *taps = &design->taps[0];
+		float *pairs = &pairHistory[0];
+		float *centers = &centerHistory[0];
+		size_t outCount = 0;
+
+		for(size_t i = 0; i < count; ++i) {
+			if(!phase) {
+				phase = 1;
+				// The oldest input left in the delay line is the one at the center now
+				centers[centerPosition] = samples[i];
+				if(++centerPosition >= tapCount) centerPosition = 0;
+				pending = center * centers[centerPosition];
+				continue;
+			}
+			phase = 0;
+
+			pairs[pairPosition] = pairs[pairPosition + pairLength] = samples[i];
+			if(++pairPosition >= pairLength) pairPosition = 0;
+
+			// Oldest first, tap j applies to the inputs at both sides of the middle
+			const float *before = pairs + pairPosition + tapCount - 1;
+			const float *after = pairs + pairPosition + tapCount;
+			float sum0 = 0.0f, sum1 = 0.0f;
+			int j = 0;
+			for(; j + 1 < tapCount; j += 2) {
+				sum0 += taps[j] * (before[-j] + after[j]);
+				sum1 += taps[j + 1] * (before[-j - 1] + after[j + 1]);
+			}
+			if(j < tapCount) {
+				sum0 += taps[j] * (before[-j] + after[j]);
+			}
+			samples[outCount++] = pending + (sum0 + sum1);
+		}
+
+		return outCount;
+	}
+};
+
+struct ChannelState {
+	uint8_t history[Stage1Bytes * 2];
+	int position;
+	std::vector<HalfbandState> stages;
+};
+
+struct DSD2PCMState {
+	size_t channels;
+	std::vector<HalfbandDesign> designs;
+	std::vector<ChannelState> channelStates;
+	std::vector<float> scratch;
+	const Stage1Tables *tables;
+};
+
+int halfbandStageCount(double dsdRate) {
+	int count = 0;
+	double rate = dsdRate / 8.0;
+	while(rate > DSD2PCM_MAX_OUTPUT_RATE) {
+		rate *= 0.5;
+		++count;
+	}
+	return count;
+}
+
+void processStage1(const Stage1Tables *tables, ChannelState &state, const uint8_t *input, size_t stride, size_t count, float *output) {
+	uint8_t *history = state.history;
+	int position = state.position;
+
+	for(size_t i = 0; i < count; ++i) {
+		const uint8_t byte = input[i * stride];
+		history[position] = history[position + Stage1Bytes] = byte;
+		if(++position >= Stage1Bytes) position = 0;
+
+		// Independent partial sums, a single chain of additions would be bound by their latency
+		const uint8_t *window = history + position;
+		float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+		for(int j = 0; j < Stage1Bytes; j += 4) {
+			sum0 += tables->table[j][window[j]];
+			sum1 += tables->table[j + 1][window[j + 1]];
+			sum2 += tables->table[j + 2][window[j + 2]];
+			sum3 += tables->table[j + 3][window[j + 3]];
+		}
+		output[i] = (sum0 + sum1) + (sum2 + sum3);
+	}
+
+	state.position = position;
+}
+
+} // namespace
+
+int dsd2pcm_decimation(double dsdRate) {
+	return 8 << halfbandStageCount(dsdRate);
+}
+
+void *dsd2pcm_alloc(double dsdRate, size_t channels) {
+	if(!channels) return NULL;
+
+	DSD2PCMState *state = new(std::nothrow) DSD2PCMState;
+	if(!state) return NULL;
+
+	try {
+		const int stageCount = halfbandStageCount(dsdRate);
+		const double outputRate = dsdRate / (8 << stageCount);
+
+		state->channels = channels;
+		state->tables = &getStage1Tables();
+
+		double rate = dsdRate / 8.0;
+		for(int i = 0; i < stageCount; ++i) {
+			state->designs.push_back(HalfbandDesign(rate, outputRate * HalfbandPassband));
+			rate *= 0.5;
+		}
+
+		state->channelStates.resize(channels);
+		for(size_t i = 0; i < channels; ++i) {
+			state->channelStates[i].stages.resize(stageCount);
+			for(int j = 0; j < stageCount; ++j) {
+				state->channelStates[i].stages[j].design = &state->designs[j];
+			}
+		}
+	} catch(...) {
+		delete state;
+		return NULL;
+	}
+
+	dsd2pcm_reset(state);
+
+	return state;
+}
+
+void dsd2pcm_free(void *_state) {
+	DSD2PCMState *state = (DSD2PCMState *)_state;
+	delete state;
+}
+
+void dsd2pcm_reset(void *_state) {
+	DSD2PCMState *state = (DSD2PCMState *)_state;
+	if(!state) return;
+
+	for(size_t i = 0; i < state->channels; ++i) {
+		ChannelState &channel = state->channelStates[i];
+		memset(channel.history, DSDSilence, sizeof(channel.history));
+		channel.position = 0;
+		for(size_t j = 0; j < channel.stages.size(); ++j) {
+			channel.stages[j].reset();
+		}
+	}
+}
+
+int dsd2pcm_latency(void *_state) {
+	DSD2PCMState *state = (DSD2PCMState *)_state;
+	if(!state) return 0;
+
+	// In first stage samples, then halved by each following stage
+	double latency = Stage1Bytes / 2;
+	for(size_t i = 0; i < state->designs.size(); ++i) {
+		latency = (latency + state->designs[i].taps.size() * 2 - 1) * 0.5;
+	}
+	return (int)(latency + 0.5);
+}
+
+size_t dsd2pcm_process(void *_state, const uint8_t *input, size_t frames, float *output) {
+	DSD2PCMState *state = (DSD2PCMState *)_state;
+	if(!state || !frames) return 0;
+
+	const size_t channels = state->channels;
+	if(state->scratch.size() < frames) {
+		try {
+			state->scratch.resize(frames);
+		} catch(...) {
+			return 0;
+		}
+	}
+	float *scratch = &state->scratch[0];
+
+	size_t outFrames = 0;
+	for(size_t channel = 0; channel < channels; ++channel) {
+		ChannelState &channelState = state->channelStates[channel];
+
+		processStage1(state->tables, channelState, input + channel, channels, frames, scratch);
+
+		size_t count = frames;
+		for(size_t i = 0; i < channelState.stages.size(); ++i) {
+			count = channelState.stages[i].process(scratch, count);
+		}
+
+		// Every channel is fed the same amount, so they all output the same count
+		for(size_t i = 0; i < count; ++i) {
+			output[i * channels + channel] = scratch[i];
+		}
+		outFrames = count;
+	}
+
+	return outFrames;
+}
@@ -0,0 +1,44 @@
+//
+//  dsd2pcm.h
+//  CogAudio Framework
+//
+
+#ifndef dsd2pcm_h
+#define dsd2pcm_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Highest PCM rate the decoder outputs, DSD is decimated by powers of two until it fits
+#define DSD2PCM_MAX_OUTPUT_RATE 192000.0
+
+// DSD to float PCM decoder. Input frames hold one byte per channel, eight 1-bit
+// samples with the most significant bit first, as delivered by the DSD inputs.
+// The first stage decimates each byte to one sample with lookup tables, then
+// halfband polyphase stages halve the rate down to at most DSD2PCM_MAX_OUTPUT_RATE,
+// so DSD64/128/256 all come out at 176.4 kHz. The gain of the first stage is
+// kept at 2.0, like the dsd2float expansion with halveDSDVolume unset.
+
+// Total decimation factor applied to a DSD stream of the given bit rate
+int dsd2pcm_decimation(double dsdRate);
+
+void *dsd2pcm_alloc(double dsdRate, size_t channels);
+void dsd2pcm_free(void *state);
+void dsd2pcm_reset(void *state);
+
+// Group delay, in output frames
+int dsd2pcm_latency(void *state);
+
+// Converts frames of interleaved DSD bytes to interleaved floats, returns the
+// number of output frames, which is at most frames / decimation * 8 rounded up
+size_t dsd2pcm_process(void *state, const uint8_t *input, size_t frames, float *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* dsd2pcm_h */
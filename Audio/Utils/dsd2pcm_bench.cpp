@@ -0,0 +1,185 @@
+// Time of DSD to PCM decoding for DSD64, DSD128 and DSD256, once the old
+// ChunkList way, the byte-indexed first stage run separately for every
+// channel at an eighth of the DSD rate, and once through dsd2pcm down to
+// 176.4 kHz. Not part of the project, build it by hand:
+//
+// c++ -std=c++11 -O2 -o dsd2pcm_bench dsd2pcm_bench.cpp dsd2pcm.cpp
+//
+// ./dsd2pcm_bench
+//
+// The old path is ChunkList's dsd2pcm_process from before the multistage
+// decoder, with the same filter and lookup tables. Both paths hand their
+// output to soxr, which is not timed here; the soxr rate columns show how
+// many frames per second each leaves it to resample. The 1 kHz amplitude
+// columns should agree, as both first stages have a gain of 2.0.
+
+#include "dsd2pcm.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+// Same coefficients as the first stage of dsd2pcm.cpp
+static const int FilterCoeffsCount = 64;
+static const float FilterCoeffs[FilterCoeffsCount] = {
+	0.09712411121659f, 0.09613438994044f, 0.09417884216316f, 0.09130441727307f,
+	0.08757947648990f, 0.08309142055179f, 0.07794369263673f, 0.07225228745463f,
+	0.06614191680338f, 0.05974199351302f, 0.05318259916599f, 0.04659059631228f,
+	0.04008603356890f, 0.03377897290478f, 0.02776684382775f, 0.02213240062966f,
+	0.01694232798846f, 0.01224650881275f, 0.00807793792573f, 0.00445323755944f,
+	0.00137370697215f, -0.00117318019994f, -0.00321193033831f, -0.00477694265140f,
+	-0.00591028841335f, -0.00665946056286f, -0.00707518873201f, -0.00720940203988f,
+	-0.00711340642819f, -0.00683632603227f, -0.00642384017266f, -0.00591723006715f,
+	-0.00535273320457f, -0.00476118922548f, -0.00416794965654f, -0.00359301524813f,
+	-0.00305135909510f, -0.00255339111833f, -0.00210551956895f, -0.00171076760278f,
+	-0.00136940723130f, -0.00107957856005f, -0.00083786862365f, -0.00063983084245f,
+	-0.00048043272086f, -0.00035442550015f, -0.00025663481039f, -0.00018217573430f,
+	-0.00012659899635f, -0.00008597726991f, -0.00005694188820f, -0.00003668060332f,
+	-0.00002290670286f, -0.00001380895679f, -0.00000799057558f, -0.00000440385083f,
+	-0.00000228567089f, -0.00000109760778f, -0.00000047286430f, -0.00000017129652f,
+	-0.00000004282776f, 0.00000000119422f, 0.00000000949179f, 0.00000000747450f
+};
+
+// One channel of the old decoder, a FIFO of the last bytes seen, with the
+// older half stored bit reversed so both halves use the same tables
+class OldStage1 {
+	public:
+	OldStage1() {
+		parts = (FilterCoeffsCount + 7) / 8;
+		table.resize(parts << 8);
+		for(int part = 0; part < parts; ++part) {
+			for(int bite = 0; bite < 0x100; ++bite) {
+				double sum = 0.0;
+				for(int bit = 0; bit < 8 && part * 8 + bit < FilterCoeffsCount; ++bit) {
+					const double coeff = FilterCoeffs[part * 8 + bit];
+					sum += (bite & (0x80 >> bit)) ? coeff : -coeff;
+				}
+				table[(part << 8) + bite] = (float)sum;
+			}
+		}
+		for(int i = 0; i < 0x100; ++i) {
+			int reversed = 0;
+			for(int bit = 0; bit < 8; ++bit) {
+				if(i & (1 << bit)) reversed |= 0x80 >> bit;
+			}
+			reverse_bits[i] = (uint8_t)reversed;
+		}
+		int length = 1;
+		while(length < parts * 2) length <<= 1;
+		mask = length - 1;
+		fifo.resize(length);
+		for(int i = 0; i < parts; ++i) {
+			fifo[i] = 0x55;
+			fifo[i + parts] = 0xAA;
+		}
+		fpos = parts;
+	}
+
+	void process(const uint8_t *src, size_t sinc, float *dest, size_t dinc, size_t len) {
+		while(len > 0) {
+			fifo[fpos] = reverse_bits[fifo[fpos]];
+			fifo[(fpos + parts) & mask] = *src;
+			src += sinc;
+			const int next = (fpos + 1) & mask;
+			float sample = 0;
+			for(int k = 0; k < parts; ++k) {
+				sample += table[(k << 8) + fifo[(fpos - k) & mask]] + table[(k << 8) + fifo[(next + k) & mask]];
+			}
+			fpos = next;
+			*dest = sample;
+			dest += dinc;
+			--len;
+		}
+	}
+
+	private:
+	int parts;
+	int mask;
+	int fpos;
+	std::vector<float> table;
+	std::vector<int> fifo;
+	uint8_t reverse_bits[0x100];
+};
+
+// Second order sigma-delta modulation of a 1 kHz sine, phase shifted per channel
+static std::vector<uint8_t> make_dsd(double rate, size_t frames, size_t channels) {
+	std::vector<uint8_t> out(frames * channels);
+	for(size_t c = 0; c < channels; ++c) {
+		double i1 = 0, i2 = 0, y = 0;
+		for(size_t b = 0; b < frames; ++b) {
+			uint8_t v = 0;
+			for(int k = 0; k < 8; ++k) {
+				const double x = 0.5 * sin(2 * M_PI * 1000.0 * (b * 8 + k) / rate + c);
+				i1 += x - y;
+				i2 += i1 - y;
+				y = (i2 >= 0) ? 1 : -1;
+				v = (uint8_t)((v << 1) | (y > 0));
+			}
+			out[b * channels + c] = v;
+		}
+	}
+	return out;
+}
+
+// Amplitude of the 1 kHz component of the first channel, over the second half of the output
+static double amplitude(const std::vector<float> &pcm, size_t frames, size_t channels, double rate) {
+	double sc = 0, ss = 0;
+	const size_t start = frames / 2;
+	for(size_t i = start; i < frames; ++i) {
+		const double phase = 2 * M_PI * 1000.0 * i / rate;
+		sc += pcm[i * channels] * cos(phase);
+		ss += pcm[i * channels] * sin(phase);
+	}
+	return 2 * sqrt(sc * sc + ss * ss) / (frames - start);
+}
+
+// Frames the DSD inputs deliver per call
+static const size_t frames_per_call = 4096;
+
+static void bench(const char *name, double rate, size_t channels) {
+	const double seconds = 10.0;
+	const size_t frames = (size_t)(rate / 8 * seconds);
+	const std::vector<uint8_t> dsd = make_dsd(rate, frames, channels);
+
+	std::vector<float> old_output(frames * channels);
+	std::vector<OldStage1> old_stages(channels);
+	clock_t start = clock();
+	for(size_t done = 0; done < frames; done += frames_per_call) {
+		const size_t count = (frames - done < frames_per_call) ? frames - done : frames_per_call;
+		for(size_t c = 0; c < channels; ++c) {
+			old_stages[c].process(&dsd[done * channels + c], channels, &old_output[done * channels + c], channels, count);
+		}
+	}
+	const double old_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	const int decimation = dsd2pcm_decimation(rate);
+	std::vector<float> new_output((frames / (decimation / 8) + 1) * channels);
+	void *state = dsd2pcm_alloc(rate, channels);
+	size_t new_frames = 0;
+	start = clock();
+	for(size_t done = 0; done < frames; done += frames_per_call) {
+		const size_t count = (frames - done < frames_per_call) ? frames - done : frames_per_call;
+		new_frames += dsd2pcm_process(state, &dsd[done * channels], count, &new_output[new_frames * channels]);
+	}
+	const double new_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	dsd2pcm_free(state);
+
+	printf("%-7s %9.1f %9.1f %8.2fx %10.0f %10.0f %8.4f %8.4f\n", name,
+	       seconds / old_seconds, seconds / new_seconds, old_seconds / new_seconds,
+	       rate / 8, rate / decimation,
+	       amplitude(old_output, frames, channels, rate / 8),
+	       amplitude(new_output, new_frames, channels, rate / decimation));
+}
+
+int main() {
+	printf("%-7s %9s %9s %9s %10s %10s %8s %8s\n", "format", "old x RT", "new x RT", "speed", "old soxr", "new soxr", "old amp", "new amp");
+
+	bench("DSD64", 2822400.0, 2);
+	bench("DSD128", 5644800.0, 2);
+	bench("DSD256", 11289600.0, 2);
+
+	return 0;
+}
@@ -43,7 +43,7 @@
  */
 
 #include <math.h>
-#include "internal/resampler.h"
+#include <Resampler/resampler.h>
 #include "internal/dumb.h"
 
 /* Compile with -DHEAVYDEBUG if you want to make sure the pick-up function is
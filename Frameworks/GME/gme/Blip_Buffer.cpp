@@ -395,25 +395,24 @@ void Blip_Synth_::volume_unit( double new_unit )
 }
 #endif
 
-long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_samples, int stereo )
+template<class Out>
+static long read_blip_samples( Blip_Buffer& blip_buf, typename Out::sample_t* BLIP_RESTRICT out,
+		long max_samples, int stereo, Out o )
 {
-	long count = samples_avail();
+	long count = blip_buf.samples_avail();
 	if ( count > max_samples )
 		count = max_samples;
 	
 	if ( count )
 	{
-		int const bass = BLIP_READER_BASS( *this );
-		BLIP_READER_BEGIN( reader, *this );
+		int const bass = BLIP_READER_BASS( blip_buf );
+		BLIP_READER_BEGIN( reader, blip_buf );
 		
 		if ( !stereo )
 		{
 			for ( blip_long n = count; n; --n )
 			{
-				blip_long s = BLIP_READER_READ( reader );
-				if ( (blip_sample_t) s != s )
-					s = 0x7FFF - (s >> 24);
-				*out++ = (blip_sample_t) s;
+				*out++ = o.write( o.read( BLIP_READER_READ_RAW( reader ) ) );
 				BLIP_READER_NEXT( reader, bass );
 			}
 		}
@@ -421,21 +420,28 @@ long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_sampl
 		{
 			for ( blip_long n = count; n; --n )
 			{
-				blip_long s = BLIP_READER_READ( reader );
-				if ( (blip_sample_t) s != s )
-					s = 0x7FFF - (s >> 24);
-				*out = (blip_sample_t) s;
+				*out = o.write( o.read( BLIP_READER_READ_RAW( reader ) ) );
 				out += 2;
 				BLIP_READER_NEXT( reader, bass );
 			}
 		}
-		BLIP_READER_END( reader, *this );
+		BLIP_READER_END( reader, blip_buf );
 		
-		remove_samples( count );
+		blip_buf.remove_samples( count );
 	}
 	return count;
 }
 
+long Blip_Buffer::read_samples( blip_sample_t* out, long max_samples, int stereo )
+{
+	return read_blip_samples( *this, out, max_samples, stereo, Blip_Clamped_Out() );
+}
+
+long Blip_Buffer::read_samples( float* out, long max_samples, float gain, int stereo )
+{
+	return read_blip_samples( *this, out, max_samples, stereo, Blip_Float_Out( gain ) );
+}
+
 void Blip_Buffer::mix_samples( blip_sample_t const* in, long count )
 {
 	if ( buffer_size_ == silent_buf_size )
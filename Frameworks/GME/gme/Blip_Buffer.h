@@ -42,7 +42,11 @@ public:
 	// true, increments 'dest' one extra time after writing each sample, to allow
 	// easy interleving of two channels into a stereo output buffer.
 	long read_samples( blip_sample_t* dest, long max_samples, int stereo = 0 );
-	
+
+	// Same as above, but writes unclamped floating-point samples scaled by 'gain',
+	// where full scale of 16-bit output is 32768.0 before scaling
+	long read_samples( float* dest, long max_samples, float gain, int stereo = 0 );
+
 // Additional optional features
 
 	// Current output sample rate
@@ -307,6 +311,38 @@ int const blip_reader_default_bass = 9;
 #define BLIP_READER_END( name, blip_buffer ) \
 	(void) ((blip_buffer).reader_accum_ = name##_reader_accum)
 
+// Sample output for mixers which can generate either 16-bit or floating-point
+// samples. read() converts BLIP_READER_READ_RAW() to a value at 16-bit scale that
+// can be summed with others in a sum_t, and write() converts such a sum to an
+// output sample.
+
+// 16-bit samples, clamped
+class Blip_Clamped_Out {
+public:
+	typedef blip_sample_t sample_t;
+	typedef blip_long sum_t;
+	static sum_t read( blip_long raw )      { return raw >> (blip_sample_bits - 16); }
+	static sample_t write( sum_t s )
+	{
+		if ( (blip_sample_t) s != s )
+			s = 0x7FFF - (s >> 24);
+		return (sample_t) s;
+	}
+};
+
+// Floating-point samples, unclamped and scaled by 'gain' (1.0 / 32768 gives
+// a nominal range of -1.0 to 1.0). Full internal resolution is kept.
+class Blip_Float_Out {
+public:
+	typedef float sample_t;
+	typedef float sum_t;
+	explicit Blip_Float_Out( float g ) : gain( g ) { }
+	static sum_t read( blip_long raw )      { return raw * (1.0f / (1L << (blip_sample_bits - 16))); }
+	sample_t write( sum_t s ) const         { return s * gain; }
+private:
+	float gain;
+};
+
 
 // Compatibility with older version
 const long blip_unscaled = 65535;
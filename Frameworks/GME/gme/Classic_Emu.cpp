@@ -101,6 +101,21 @@ blargg_err_t Classic_Emu::start_track_( int track )
 	return 0;
 }
 
+blargg_err_t Classic_Emu::run_frame()
+{
+	if ( buf_changed_count != buf->channels_changed_count() )
+	{
+		buf_changed_count = buf->channels_changed_count();
+		remute_voices();
+	}
+	int msec = buf->length();
+	blip_time_t clocks_emulated = (blargg_long) msec * clock_rate_ / 1000;
+	RETURN_ERR( run_clocks( clocks_emulated, msec ) );
+	assert( clocks_emulated );
+	buf->end_frame( clocks_emulated );
+	return 0;
+}
+
 blargg_err_t Classic_Emu::play_( long count, sample_t* out )
 {
 	long remain = count;
@@ -108,22 +123,52 @@ blargg_err_t Classic_Emu::play_( long count, sample_t* out )
 	{
 		remain -= buf->read_samples( &out [count - remain], remain );
 		if ( remain )
-		{
-			if ( buf_changed_count != buf->channels_changed_count() )
-			{
-				buf_changed_count = buf->channels_changed_count();
-				remute_voices();
-			}
-			int msec = buf->length();
-			blip_time_t clocks_emulated = (blargg_long) msec * clock_rate_ / 1000;
-			RETURN_ERR( run_clocks( clocks_emulated, msec ) );
-			assert( clocks_emulated );
-			buf->end_frame( clocks_emulated );
-		}
+			RETURN_ERR( run_frame() );
+	}
+	return 0;
+}
+
+blargg_err_t Classic_Emu::play_float_( long count, float* out )
+{
+	long remain = count;
+	while ( remain )
+	{
+		remain -= buf->read_samples( &out [count - remain], remain, float_gain() );
+		if ( remain )
+			RETURN_ERR( run_frame() );
 	}
 	return 0;
 }
 
+blargg_err_t Classic_Emu::fast_forward_( long count )
+{
+	// Voices are muted, so oscillators don't synthesize anything. Frames end at the
+	// same points as in play_(), so CPU and sound chips end up in the same state.
+	long remain = count;
+	while ( remain )
+	{
+		long n = buf->samples_avail();
+		if ( n > remain )
+			n = remain;
+		buf->remove_samples( n );
+		remain -= n;
+		if ( remain )
+			RETURN_ERR( run_frame() );
+	}
+	return 0;
+}
+
+long Classic_Emu::save_state_( byte* )
+{
+	// state is at end of last frame, past any samples not yet read
+	return buf->samples_avail();
+}
+
+void Classic_Emu::load_state_( byte const* )
+{
+	buf->clear();
+}
+
 // Rom_Data
 
 blargg_err_t Rom_Data_::load_rom_data_( Data_Reader& in,
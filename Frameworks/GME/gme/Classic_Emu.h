@@ -33,12 +33,20 @@ protected:
 	void mute_voices_( int ) override;
 	void set_equalizer_( equalizer_t const& ) override;
 	blargg_err_t play_( long, sample_t* ) override;
+	blargg_err_t play_float_( long, float* ) override;
+	blargg_err_t fast_forward_( long ) override;
+	// Derived emulators save/load their own state and call these, which account
+	// for samples still in the output buffer
+	long save_state_( byte* ) override;
+	void load_state_( byte const* ) override;
 private:
 	Multi_Buffer* buf;
 	Multi_Buffer* stereo_buffer; // NULL if using custom buffer
 	long clock_rate_;
 	unsigned buf_changed_count;
 	int const* voice_types;
+	
+	blargg_err_t run_frame();
 };
 
 inline void Classic_Emu::set_buffer( Multi_Buffer* new_buf )
@@ -22,7 +22,8 @@ Dual_Resampler::Dual_Resampler() :
 	sample_buf_size(0),
 	oversamples_per_frame(-1),
 	buf_pos(-1),
-	resampler_size(0)
+	resampler_size(0),
+	extra_is_float(false)
 {
 }
 
@@ -32,6 +33,7 @@ blargg_err_t Dual_Resampler::reset( int pairs )
 {
 	// expand allocations a bit
 	RETURN_ERR( sample_buf.resize( (pairs + (pairs >> 2)) * 2 ) );
+	RETURN_ERR( float_buf.resize( sample_buf.size() ) );
 	resize( pairs );
 	resampler_size = oversamples_per_frame + (oversamples_per_frame >> 2);
 	return resampler.buffer_size( resampler_size );
@@ -53,7 +55,8 @@ void Dual_Resampler::resize( int pairs )
 	}
 }
 
-void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, dsample_t* out )
+template<class Out>
+void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, typename Out::sample_t* out, Out o )
 {
 	long pair_count = sample_buf_size >> 1;
 	blip_time_t blip_time = blip_buf.count_clocks( pair_count );
@@ -74,11 +77,66 @@ void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, dsample_t* out )
 	assert( count == (long) sample_buf_size );
 #endif
 	
-	mix_samples( blip_buf, out );
+	mix_samples( blip_buf, out, o );
 	blip_buf.remove_samples( pair_count );
 }
 
+// Extra samples are mixed in place into sample_buf, or into float_buf at 16-bit
+// scale, so they can be converted if the next call wants the other sample type.
+
+void Dual_Resampler::play_extra_frame( Blip_Buffer& blip_buf, Blip_Clamped_Out o )
+{
+	play_frame_( blip_buf, sample_buf.begin(), o );
+	extra_is_float = false;
+}
+
+void Dual_Resampler::play_extra_frame( Blip_Buffer& blip_buf, Blip_Float_Out )
+{
+	play_frame_( blip_buf, float_buf.begin(), Blip_Float_Out( 1.0f ) );
+	extra_is_float = true;
+}
+
+void Dual_Resampler::copy_extra( dsample_t* out, long count, Blip_Clamped_Out o )
+{
+	if ( !extra_is_float )
+	{
+		memcpy( out, &sample_buf [buf_pos], count * sizeof *out );
+		return;
+	}
+	
+	float const* in = &float_buf [buf_pos];
+	for ( long i = 0; i < count; i++ )
+		out [i] = o.write( (blargg_long) in [i] );
+}
+
+void Dual_Resampler::copy_extra( float* out, long count, Blip_Float_Out o )
+{
+	if ( extra_is_float )
+	{
+		float const* in = &float_buf [buf_pos];
+		for ( long i = 0; i < count; i++ )
+			out [i] = o.write( in [i] );
+	}
+	else
+	{
+		dsample_t const* in = &sample_buf [buf_pos];
+		for ( long i = 0; i < count; i++ )
+			out [i] = o.write( in [i] );
+	}
+}
+
 void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_buf )
+{
+	dual_play_( count, out, blip_buf, Blip_Clamped_Out() );
+}
+
+void Dual_Resampler::dual_play( long count, float* out, Blip_Buffer& blip_buf, float gain )
+{
+	dual_play_( count, out, blip_buf, Blip_Float_Out( gain ) );
+}
+
+template<class Out>
+void Dual_Resampler::dual_play_( long count, typename Out::sample_t* out, Blip_Buffer& blip_buf, Out o )
 {
 	// empty extra buffer
 	long remain = sample_buf_size - buf_pos;
@@ -87,7 +145,7 @@ void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_bu
 		if ( remain > count )
 			remain = count;
 		count -= remain;
-		memcpy( out, &sample_buf [buf_pos], remain * sizeof *out );
+		copy_extra( out, remain, o );
 		out += remain;
 		buf_pos += remain;
 	}
@@ -95,7 +153,7 @@ void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_bu
 	// entire frames
 	while ( count >= (long) sample_buf_size )
 	{
-		play_frame_( blip_buf, out );
+		play_frame_( blip_buf, out, o );
 		out += sample_buf_size;
 		count -= sample_buf_size;
 	}
@@ -103,14 +161,16 @@ void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_bu
 	// extra
 	if ( count )
 	{
-		play_frame_( blip_buf, sample_buf.begin() );
+		play_extra_frame( blip_buf, o );
+		buf_pos = 0;
+		copy_extra( out, count, o );
 		buf_pos = count;
-		memcpy( out, sample_buf.begin(), count * sizeof *out );
 		out += count;
 	}
 }
 
-void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, dsample_t* out )
+template<class Out>
+void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, typename Out::sample_t* out, Out o )
 {
 	Blip_Reader sn;
 	int bass = sn.begin( blip_buf );
@@ -118,22 +178,16 @@ void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, dsample_t* out )
 	
 	for ( int n = sample_buf_size >> 1; n--; )
 	{
-		int s = sn.read();
-		blargg_long l = (blargg_long) in [0] * 2 + s;
-		if ( (int16_t) l != l )
-			l = 0x7FFF - (l >> 24);
-		
+		typename Out::sum_t s = o.read( sn.read_raw() );
+		typename Out::sum_t l = (typename Out::sum_t) in [0] * 2 + s;
+		typename Out::sum_t r = (typename Out::sum_t) in [1] * 2 + s;
 		sn.next( bass );
-		blargg_long r = (blargg_long) in [1] * 2 + s;
-		if ( (int16_t) r != r )
-			r = 0x7FFF - (r >> 24);
 		
 		in += 2;
-		out [0] = l;
-		out [1] = r;
+		out [0] = o.write( l );
+		out [1] = o.write( r );
 		out += 2;
 	}
 	
 	sn.end( blip_buf );
 }
-
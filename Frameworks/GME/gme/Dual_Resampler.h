@@ -21,19 +21,29 @@ public:
 	
 	void dual_play( long count, dsample_t* out, Blip_Buffer& );
 	
+	// Same as above, but writes unclamped floating-point samples scaled by 'gain'
+	void dual_play( long count, float* out, Blip_Buffer&, float gain );
+	
 protected:
 	virtual int play_frame( blip_time_t, int pcm_count, dsample_t* pcm_out ) = 0;
 private:
 	
 	blargg_vector<dsample_t> sample_buf;
+	blargg_vector<float> float_buf; // extra samples of a frame played as float
 	int sample_buf_size;
 	int oversamples_per_frame;
 	int buf_pos;
 	int resampler_size;
+	bool extra_is_float; // whether extra samples are in float_buf
 	
 	Fir_Resampler<12> resampler;
-	void mix_samples( Blip_Buffer&, dsample_t* );
-	void play_frame_( Blip_Buffer&, dsample_t* );
+	template<class Out> void dual_play_( long count, typename Out::sample_t* out, Blip_Buffer&, Out );
+	template<class Out> void mix_samples( Blip_Buffer&, typename Out::sample_t*, Out );
+	template<class Out> void play_frame_( Blip_Buffer&, typename Out::sample_t*, Out );
+	void play_extra_frame( Blip_Buffer&, Blip_Clamped_Out );
+	void play_extra_frame( Blip_Buffer&, Blip_Float_Out );
+	void copy_extra( dsample_t* out, long count, Blip_Clamped_Out );
+	void copy_extra( float* out, long count, Blip_Float_Out );
 };
 
 inline double Dual_Resampler::setup( double oversample, double rolloff, double gain )
@@ -44,6 +54,7 @@ inline double Dual_Resampler::setup( double oversample, double rolloff, double g
 inline void Dual_Resampler::clear()
 {
 	buf_pos = sample_buf_size;
+	extra_is_float = false;
 	resampler.clear();
 }
 
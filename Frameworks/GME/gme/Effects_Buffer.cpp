@@ -290,10 +290,22 @@ void Effects_Buffer::end_frame( blip_time_t clock_count )
 
 long Effects_Buffer::samples_avail() const
 {
-	return bufs [0].samples_avail() * 2;
+	// same units as read_samples()
+	return bufs [0].samples_avail() * max_voices * 2;
 }
 
 long Effects_Buffer::read_samples( blip_sample_t* out, long total_samples )
+{
+	return read_samples_( out, total_samples, Blip_Clamped_Out() );
+}
+
+long Effects_Buffer::read_samples( float* out, long total_samples, float gain )
+{
+	return read_samples_( out, total_samples, Blip_Float_Out( gain ) );
+}
+
+template<class Out>
+long Effects_Buffer::read_samples_( typename Out::sample_t* out, long total_samples, Out o )
 {
 	const int n_channels = max_voices * 2;
 	const int buf_count_per_voice = buf_count/max_voices;
@@ -316,22 +328,22 @@ long Effects_Buffer::read_samples( blip_sample_t* out, long total_samples )
 			
 			if ( stereo_remain )
 			{
-				mix_enhanced( out, count );
+				mix_enhanced( out, count, o );
 			}
 			else
 			{
-				mix_mono_enhanced( out, count );
+				mix_mono_enhanced( out, count, o );
 				active_bufs = 3;
 			}
 		}
 		else if ( stereo_remain )
 		{
-			mix_stereo( out, count );
+			mix_stereo( out, count, o );
 			active_bufs = 3; 
 		}
 		else
 		{
-			mix_mono( out, count );
+			mix_mono( out, count, o );
 			active_bufs = 1; 
 		}
 		
@@ -364,56 +376,76 @@ long Effects_Buffer::read_samples( blip_sample_t* out, long total_samples )
 	return total_samples * n_channels;
 }
 
-void Effects_Buffer::mix_mono( blip_sample_t* out_, blargg_long count )
+void Effects_Buffer::remove_samples( long total_samples )
+{
+	const int n_channels = max_voices * 2;
+	
+	require( total_samples % n_channels == 0 );
+	
+	long remain = min( bufs [0].samples_avail(), total_samples/n_channels );
+	
+	// echo and reverb have to be fed while they are active
+	if ( effect_remain )
+	{
+		long count = min( remain, effect_remain );
+		Multi_Buffer::remove_samples( count * n_channels );
+		remain -= count;
+	}
+	
+	if ( remain )
+	{
+		stereo_remain -= remain;
+		if ( stereo_remain < 0 )
+			stereo_remain = 0;
+		
+		for ( int i = 0; i < buf_count; i++ )
+			bufs [i].remove_samples( remain );
+	}
+}
+
+template<class Out>
+void Effects_Buffer::mix_mono( typename Out::sample_t* out_, blargg_long count, Out o )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+0] );
 	BLIP_READER_BEGIN( c, bufs [i*max_buf_count+0] );
 	
 	// unrolled loop
 	for ( blargg_long n = count >> 1; n; --n )
 	{
-		blargg_long cs0 = BLIP_READER_READ( c );
+		typename Out::sample_t cs0 = o.write( o.read( BLIP_READER_READ_RAW( c ) ) );
 		BLIP_READER_NEXT( c, bass );
 		
-		blargg_long cs1 = BLIP_READER_READ( c );
+		typename Out::sample_t cs1 = o.write( o.read( BLIP_READER_READ_RAW( c ) ) );
 		BLIP_READER_NEXT( c, bass );
 		
-		if ( (int16_t) cs0 != cs0 )
-			cs0 = 0x7FFF - (cs0 >> 24);
-		((uint32_t*) out) [i*2+0] = ((uint16_t) cs0) | (uint16_t(cs0) << 16);
-		
-		if ( (int16_t) cs1 != cs1 )
-			cs1 = 0x7FFF - (cs1 >> 24);
-		((uint32_t*) out) [i*2+1] = ((uint16_t) cs1) | (uint16_t(cs1) << 16);
+		out [i*2+0] = cs0;
+		out [i*2+1] = cs0;
+		out [max_voices*2 + i*2+0] = cs1;
+		out [max_voices*2 + i*2+1] = cs1;
 		out += max_voices*4;
 	}
 	
 	if ( count & 1 )
 	{
-		int s = BLIP_READER_READ( c );
+		typename Out::sample_t s = o.write( o.read( BLIP_READER_READ_RAW( c ) ) );
 		BLIP_READER_NEXT( c, bass );
 		out [i*2+0] = s;
 		out [i*2+1] = s;
-		if ( (int16_t) s != s )
-		{
-			s = 0x7FFF - (s >> 24);
-			out [i*2+0] = s;
-			out [i*2+1] = s;
-		}
 	}
 	
 	BLIP_READER_END( c, bufs [i*max_buf_count+0] );
     }
 }
 
-void Effects_Buffer::mix_stereo( blip_sample_t* out_, blargg_long frames )
+template<class Out>
+void Effects_Buffer::mix_stereo( typename Out::sample_t* out_, blargg_long frames, Out o )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+0] );
 	BLIP_READER_BEGIN( c, bufs [i*max_buf_count+0] );
 	BLIP_READER_BEGIN( l, bufs [i*max_buf_count+1] );
@@ -422,21 +454,15 @@ void Effects_Buffer::mix_stereo( blip_sample_t* out_, blargg_long frames )
 	int count = frames;
 	while ( count-- )
 	{
-		int cs = BLIP_READER_READ( c );
+		typename Out::sum_t cs = o.read( BLIP_READER_READ_RAW( c ) );
 		BLIP_READER_NEXT( c, bass );
-		int left = cs + BLIP_READER_READ( l );
-		int right = cs + BLIP_READER_READ( r );
+		typename Out::sum_t left = cs + o.read( BLIP_READER_READ_RAW( l ) );
+		typename Out::sum_t right = cs + o.read( BLIP_READER_READ_RAW( r ) );
 		BLIP_READER_NEXT( l, bass );
 		BLIP_READER_NEXT( r, bass );
 		
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
-		
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		out [i*2+0] = o.write( left );
+		out [i*2+1] = o.write( right );
 		
 		out += max_voices*2;
 		
@@ -448,11 +474,12 @@ void Effects_Buffer::mix_stereo( blip_sample_t* out_, blargg_long frames )
     }
 }
 
-void Effects_Buffer::mix_mono_enhanced( blip_sample_t* out_, blargg_long frames )
+template<class Out>
+void Effects_Buffer::mix_mono_enhanced( typename Out::sample_t* out_, blargg_long frames, Out o )
 {
 	for(int i=0; i<max_voices; i++)
 	{
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+2] );
 	BLIP_READER_BEGIN( center, bufs [i*max_buf_count+2] );
 	BLIP_READER_BEGIN( sq1, bufs [i*max_buf_count+0] );
@@ -496,14 +523,8 @@ void Effects_Buffer::mix_mono_enhanced( blip_sample_t* out_, blargg_long frames
 		echo_buf [echo_pos] = sum3_s;
 		echo_pos = (echo_pos + 1) & echo_mask;
 		
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
-		
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		out [i*2+0] = o.write( left );
+		out [i*2+1] = o.write( right );
 		out += max_voices*2;
 	}
 	this->reverb_pos[i] = reverb_pos;
@@ -515,11 +536,12 @@ void Effects_Buffer::mix_mono_enhanced( blip_sample_t* out_, blargg_long frames
     }
 }
 
-void Effects_Buffer::mix_enhanced( blip_sample_t* out_, blargg_long frames )
+template<class Out>
+void Effects_Buffer::mix_enhanced( typename Out::sample_t* out_, blargg_long frames, Out o )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+2] );
 	BLIP_READER_BEGIN( center, bufs [i*max_buf_count+2] );
 	BLIP_READER_BEGIN( l1, bufs [i*max_buf_count+3] );
@@ -573,14 +595,8 @@ void Effects_Buffer::mix_enhanced( blip_sample_t* out_, blargg_long frames )
 		echo_buf [echo_pos] = sum3_s;
 		echo_pos = (echo_pos + 1) & echo_mask;
 		
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
-		
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		out [i*2+0] = o.write( left );
+		out [i*2+1] = o.write( right );
 
 		out += max_voices*2;
 	}
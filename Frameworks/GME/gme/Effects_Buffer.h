@@ -51,7 +51,9 @@ public:
 	channel_t channel( int, int );
 	void end_frame( blip_time_t );
 	long read_samples( blip_sample_t*, long );
+	long read_samples( float*, long, float gain );
 	long samples_avail() const;
+	void remove_samples( long );
 private:
 	typedef long fixed_t;
 	int max_voices;
@@ -81,10 +83,11 @@ private:
 		fixed_t reverb_level;
 	} chans;
 	
-	void mix_mono( blip_sample_t*, blargg_long );
-	void mix_stereo( blip_sample_t*, blargg_long );
-	void mix_enhanced( blip_sample_t*, blargg_long );
-	void mix_mono_enhanced( blip_sample_t*, blargg_long );
+	template<class Out> long read_samples_( typename Out::sample_t*, long, Out );
+	template<class Out> void mix_mono( typename Out::sample_t*, blargg_long, Out );
+	template<class Out> void mix_stereo( typename Out::sample_t*, blargg_long, Out );
+	template<class Out> void mix_enhanced( typename Out::sample_t*, blargg_long, Out );
+	template<class Out> void mix_mono_enhanced( typename Out::sample_t*, blargg_long, Out );
 };
 
 #endif
@@ -130,6 +130,32 @@ void Gb_Apu::reset()
 	memcpy( wave.wave, initial_wave, sizeof initial_wave );
 }
 
+void Gb_Apu::save_state( gb_apu_state_t* out ) const
+{
+	out->square1 = square1;
+	out->square2 = square2;
+	out->wave    = wave;
+	out->noise   = noise;
+	memcpy( out->regs, regs, sizeof regs );
+	out->next_frame_time = next_frame_time;
+	out->last_time       = last_time;
+	out->frame_count     = frame_count;
+}
+
+void Gb_Apu::load_state( gb_apu_state_t const& in )
+{
+	// oscillators only refer to this Gb_Apu, so copying them restores everything
+	square1 = in.square1;
+	square2 = in.square2;
+	wave    = in.wave;
+	noise   = in.noise;
+	memcpy( regs, in.regs, sizeof regs );
+	next_frame_time = in.next_frame_time;
+	last_time       = in.last_time;
+	frame_count     = in.frame_count;
+	update_volume();
+}
+
 void Gb_Apu::run_until( blip_time_t end_time )
 {
 	require( end_time >= last_time ); // end_time must not be before previous time
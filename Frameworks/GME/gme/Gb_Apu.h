@@ -6,6 +6,8 @@
 
 #include "Gb_Oscs.h"
 
+struct gb_apu_state_t;
+
 class Gb_Apu {
 public:
 	
@@ -50,6 +52,11 @@ public:
 	
 	void set_tempo( double );
 	
+	// Save/load exact emulation state. State can only be loaded back into the
+	// same Gb_Apu, and only between frames.
+	void save_state( gb_apu_state_t* out ) const;
+	void load_state( gb_apu_state_t const& );
+	
 public:
 	Gb_Apu();
 private:
@@ -77,6 +84,18 @@ private:
 	void write_osc( int index, int reg, int data );
 };
 
+struct gb_apu_state_t
+{
+	Gb_Square square1;
+	Gb_Square square2;
+	Gb_Wave   wave;
+	Gb_Noise  noise;
+	uint8_t regs [Gb_Apu::register_count];
+	blip_time_t next_frame_time;
+	blip_time_t last_time;
+	int frame_count;
+};
+
 inline void Gb_Apu::output( Blip_Buffer* b ) { output( b, b, b ); }
 	
 inline void Gb_Apu::osc_output( int i, Blip_Buffer* b ) { osc_output( i, b, b, b ); }
@@ -159,6 +159,7 @@ void Gbs_Emu::set_bank( int n )
 	{
 		return;
 	}
+	bank = n;
 	cpu::map_code( bank_size, bank_size, rom.at_addr( rom.mask_addr( addr ) ) );
 }
 
@@ -224,6 +225,7 @@ blargg_err_t Gbs_Emu::start_track_( int track )
 	
 	cpu::map_code( ram_addr, 0x10000 - ram_addr, ram );
 	cpu::map_code( 0, bank_size, rom.at_addr( 0 ) );
+	bank = 1;
 	set_bank( rom.size() > bank_size );
 	
 	ram [hi_page + 6] = header_.timer_modulo;
@@ -240,6 +242,34 @@ blargg_err_t Gbs_Emu::start_track_( int track )
 	return 0;
 }
 
+long Gbs_Emu::state_size_() const
+{
+	return sizeof (state_t);
+}
+
+long Gbs_Emu::save_state_( byte* out )
+{
+	state_t& state = *(state_t*) out;
+	state.cpu       = cpu::r;
+	state.next_play = next_play;
+	state.bank      = bank;
+	memcpy( state.ram, ram, sizeof ram );
+	apu.save_state( &state.apu );
+	return Classic_Emu::save_state_( out );
+}
+
+void Gbs_Emu::load_state_( byte const* in )
+{
+	Classic_Emu::load_state_( in );
+	state_t const& state = *(state_t const*) in;
+	cpu::r    = state.cpu;
+	next_play = state.next_play;
+	memcpy( ram, state.ram, sizeof ram );
+	set_bank( state.bank );
+	update_timer();
+	apu.load_state( state.apu );
+}
+
 blargg_err_t Gbs_Emu::run_clocks( blip_time_t& duration, int )
 {
 	cpu_time = 0;
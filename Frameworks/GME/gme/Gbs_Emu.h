@@ -57,10 +57,14 @@ protected:
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	long state_size_() const;
+	long save_state_( byte* );
+	void load_state_( byte const* );
 private:
 	// rom
 	enum { bank_size = 0x4000 };
 	Rom_Data<bank_size> rom;
+	int bank; // currently mapped at bank_size
 	void set_bank( int );
 	
 	// timer
@@ -83,6 +87,15 @@ public: private: friend class Gb_Cpu;
 	
 	int cpu_read( gb_addr_t );
 	void cpu_write( gb_addr_t, int );
+	
+	struct state_t
+	{
+		Gb_Cpu::registers_t cpu;
+		blip_time_t next_play;
+		int bank;
+		byte ram [sizeof Gbs_Emu::ram];
+		gb_apu_state_t apu;
+	};
 };
 
 #endif
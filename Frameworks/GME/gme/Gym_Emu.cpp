@@ -378,3 +378,9 @@ blargg_err_t Gym_Emu::play_( long count, sample_t* out )
 	Dual_Resampler::dual_play( count, out, blip_buf );
 	return 0;
 }
+
+blargg_err_t Gym_Emu::play_float_( long count, float* out )
+{
+	Dual_Resampler::dual_play( count, out, blip_buf, float_gain() );
+	return 0;
+}
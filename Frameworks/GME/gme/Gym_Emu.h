@@ -49,6 +49,7 @@ protected:
 	blargg_err_t set_sample_rate_( long sample_rate );
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long count, sample_t* );
+	blargg_err_t play_float_( long count, float* );
 	void mute_voices_( int );
 	void set_tempo_( double );
 	int play_frame( blip_time_t blip_time, int sample_count, sample_t* buf );
@@ -28,6 +28,45 @@ Multi_Buffer::Multi_Buffer( int spf ) : samples_per_frame_( spf )
 
 blargg_err_t Multi_Buffer::set_channel_count( int ) { return 0; }
 
+void Multi_Buffer::remove_samples( long count )
+{
+	// buffer may have state of its own (echo etc.), so mix samples as usual
+	blip_sample_t scratch [2048];
+	while ( count > 0 )
+	{
+		long n = sizeof scratch / sizeof *scratch;
+		n -= n % samples_per_frame();
+		if ( n > count )
+			n = count;
+		n = read_samples( scratch, n );
+		if ( !n )
+			break;
+		count -= n;
+	}
+}
+
+long Multi_Buffer::read_samples( float* out, long count, float gain )
+{
+	blip_sample_t scratch [2048];
+	long total = 0;
+	while ( count > 0 )
+	{
+		long n = sizeof scratch / sizeof *scratch;
+		n -= n % samples_per_frame();
+		if ( n > count )
+			n = count;
+		n = read_samples( scratch, n );
+		if ( !n )
+			break;
+		for ( long i = 0; i < n; i++ )
+			out [i] = scratch [i] * gain;
+		out   += n;
+		total += n;
+		count -= n;
+	}
+	return total;
+}
+
 // Silent_Buffer
 
 Silent_Buffer::Silent_Buffer() : Multi_Buffer( 1 ) // 0 channels would probably confuse
@@ -55,6 +94,14 @@ blargg_err_t Mono_Buffer::set_sample_rate( long rate, int msec )
 	return Multi_Buffer::set_sample_rate( buf.sample_rate(), buf.length() );
 }
 
+void Mono_Buffer::remove_samples( long count )
+{
+	long avail = buf.samples_avail();
+	if ( count > avail )
+		count = avail;
+	buf.remove_samples( count );
+}
+
 // Stereo_Buffer
 
 Stereo_Buffer::Stereo_Buffer() : Multi_Buffer( 2 )
@@ -104,6 +151,17 @@ void Stereo_Buffer::end_frame( blip_time_t clock_count )
 }
 
 long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
+{
+	return read_samples_( out, count, Blip_Clamped_Out() );
+}
+
+long Stereo_Buffer::read_samples( float* out, long count, float gain )
+{
+	return read_samples_( out, count, Blip_Float_Out( gain ) );
+}
+
+template<class Out>
+long Stereo_Buffer::read_samples_( typename Out::sample_t* out, long count, Out o )
 {
 	require( !(count & 1) ); // count must be even
 	count = (unsigned) count / 2;
@@ -117,21 +175,21 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
 		//debug_printf( "%X\n", bufs_used );
 		if ( bufs_used <= 1 )
 		{
-			mix_mono( out, count );
+			mix_mono( out, count, o );
 			bufs [0].remove_samples( count );
 			bufs [1].remove_silence( count );
 			bufs [2].remove_silence( count );
 		}
 		else if ( bufs_used & 1 )
 		{
-			mix_stereo( out, count );
+			mix_stereo( out, count, o );
 			bufs [0].remove_samples( count );
 			bufs [1].remove_samples( count );
 			bufs [2].remove_samples( count );
 		}
 		else
 		{
-			mix_stereo_no_center( out, count );
+			mix_stereo_no_center( out, count, o );
 			bufs [0].remove_silence( count );
 			bufs [1].remove_samples( count );
 			bufs [2].remove_samples( count );
@@ -148,9 +206,32 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
 	return count * 2;
 }
 
-void Stereo_Buffer::mix_stereo( blip_sample_t* out_, blargg_long count )
+void Stereo_Buffer::remove_samples( long count )
 {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	require( !(count & 1) ); // count must be even
+	count = (unsigned) count / 2;
+	
+	long avail = bufs [0].samples_avail();
+	if ( count > avail )
+		count = avail;
+	if ( count )
+	{
+		for ( int i = 0; i < buf_count; i++ )
+			bufs [i].remove_samples( count );
+		
+		// same bookkeeping as read_samples()
+		if ( !bufs [0].samples_avail() )
+		{
+			was_stereo   = stereo_added;
+			stereo_added = 0;
+		}
+	}
+}
+
+template<class Out>
+void Stereo_Buffer::mix_stereo( typename Out::sample_t* out_, blargg_long count, Out o )
+{
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [1] );
 	BLIP_READER_BEGIN( left, bufs [1] );
 	BLIP_READER_BEGIN( right, bufs [2] );
@@ -158,21 +239,16 @@ void Stereo_Buffer::mix_stereo( blip_sample_t* out_, blargg_long count )
 	
 	for ( ; count; --count )
 	{
-		int c = BLIP_READER_READ( center );
-		blargg_long l = c + BLIP_READER_READ( left );
-		blargg_long r = c + BLIP_READER_READ( right );
-		if ( (int16_t) l != l )
-			l = 0x7FFF - (l >> 24);
+		typename Out::sum_t c = o.read( BLIP_READER_READ_RAW( center ) );
+		typename Out::sum_t l = c + o.read( BLIP_READER_READ_RAW( left ) );
+		typename Out::sum_t r = c + o.read( BLIP_READER_READ_RAW( right ) );
 		
 		BLIP_READER_NEXT( center, bass );
-		if ( (int16_t) r != r )
-			r = 0x7FFF - (r >> 24);
-		
 		BLIP_READER_NEXT( left, bass );
 		BLIP_READER_NEXT( right, bass );
 		
-		out [0] = l;
-		out [1] = r;
+		out [0] = o.write( l );
+		out [1] = o.write( r );
 		out += 2;
 	}
 	
@@ -181,28 +257,24 @@ void Stereo_Buffer::mix_stereo( blip_sample_t* out_, blargg_long count )
 	BLIP_READER_END( left, bufs [1] );
 }
 
-void Stereo_Buffer::mix_stereo_no_center( blip_sample_t* out_, blargg_long count )
+template<class Out>
+void Stereo_Buffer::mix_stereo_no_center( typename Out::sample_t* out_, blargg_long count, Out o )
 {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [1] );
 	BLIP_READER_BEGIN( left, bufs [1] );
 	BLIP_READER_BEGIN( right, bufs [2] );
 	
 	for ( ; count; --count )
 	{
-		blargg_long l = BLIP_READER_READ( left );
-		if ( (int16_t) l != l )
-			l = 0x7FFF - (l >> 24);
-		
-		blargg_long r = BLIP_READER_READ( right );
-		if ( (int16_t) r != r )
-			r = 0x7FFF - (r >> 24);
+		typename Out::sum_t l = o.read( BLIP_READER_READ_RAW( left ) );
+		typename Out::sum_t r = o.read( BLIP_READER_READ_RAW( right ) );
 		
 		BLIP_READER_NEXT( left, bass );
 		BLIP_READER_NEXT( right, bass );
 		
-		out [0] = l;
-		out [1] = r;
+		out [0] = o.write( l );
+		out [1] = o.write( r );
 		out += 2;
 	}
 	
@@ -210,17 +282,16 @@ void Stereo_Buffer::mix_stereo_no_center( blip_sample_t* out_, blargg_long count
 	BLIP_READER_END( left, bufs [1] );
 }
 
-void Stereo_Buffer::mix_mono( blip_sample_t* out_, blargg_long count )
+template<class Out>
+void Stereo_Buffer::mix_mono( typename Out::sample_t* out_, blargg_long count, Out o )
 {
-	blip_sample_t* BLIP_RESTRICT out = out_;
+	typename Out::sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [0] );
 	BLIP_READER_BEGIN( center, bufs [0] );
 	
 	for ( ; count; --count )
 	{
-		blargg_long s = BLIP_READER_READ( center );
-		if ( (int16_t) s != s )
-			s = 0x7FFF - (s >> 24);
+		typename Out::sample_t s = o.write( o.read( BLIP_READER_READ_RAW( center ) ) );
 		
 		BLIP_READER_NEXT( center, bass );
 		out [0] = s;
@@ -51,6 +51,15 @@ public:
 	virtual long read_samples( blip_sample_t*, long ) = 0;
 	virtual long samples_avail() const = 0;
 	
+	// Read samples as unclamped floating-point, scaled by 'gain' where full scale of
+	// 16-bit output is 32768.0 before scaling. Default implementation converts the
+	// clamped 16-bit samples.
+	virtual long read_samples( float*, long, float gain );
+	
+	// Remove at most 'count' samples, in the same units as read_samples(). Buffers
+	// which can do so drop them without mixing; default implementation reads them.
+	virtual void remove_samples( long count );
+	
 public:
 	BLARGG_DISABLE_NOTHROW
 protected:
@@ -83,6 +92,8 @@ public:
 	void clear() { buf.clear(); }
 	long samples_avail() const { return buf.samples_avail(); }
 	long read_samples( blip_sample_t* p, long s ) { return buf.read_samples( p, s ); }
+	long read_samples( float* p, long s, float gain ) { return buf.read_samples( p, s, gain ); }
+	void remove_samples( long );
 	channel_t channel( int, int ) { return chan; }
 	void end_frame( blip_time_t t ) { buf.end_frame( t ); }
 };
@@ -108,6 +119,8 @@ public:
 	
 	long samples_avail() const { return bufs [0].samples_avail() * 2; }
 	long read_samples( blip_sample_t*, long );
+	long read_samples( float*, long, float gain );
+	void remove_samples( long );
 	
 private:
 	enum { buf_count = 3 };
@@ -116,9 +129,10 @@ private:
 	int stereo_added;
 	int was_stereo;
 	
-	void mix_stereo_no_center( blip_sample_t*, blargg_long );
-	void mix_stereo( blip_sample_t*, blargg_long );
-	void mix_mono( blip_sample_t*, blargg_long );
+	template<class Out> long read_samples_( typename Out::sample_t*, long, Out );
+	template<class Out> void mix_stereo_no_center( typename Out::sample_t*, blargg_long, Out );
+	template<class Out> void mix_stereo( typename Out::sample_t*, blargg_long, Out );
+	template<class Out> void mix_mono( typename Out::sample_t*, blargg_long, Out );
 };
 
 // Silent_Buffer generates no samples, useful where no sound is wanted
@@ -134,6 +148,8 @@ public:
 	void end_frame( blip_time_t ) { }
 	long samples_avail() const { return 0; }
 	long read_samples( blip_sample_t*, long ) { return 0; }
+	long read_samples( float*, long, float ) { return 0; }
+	void remove_samples( long ) { }
 };
 
 
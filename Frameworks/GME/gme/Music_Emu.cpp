@@ -42,6 +42,7 @@ void Music_Emu::clear_track_vars()
 	silence_time     = 0;
 	silence_count    = 0;
 	buf_remain       = 0;
+	checkpoint_next  = INT_MAX;
 	warning(); // clear warning
 }
 
@@ -49,6 +50,7 @@ void Music_Emu::unload()
 {
 	voice_count_ = 0;
 	clear_track_vars();
+	clear_checkpoints();
 	Gme_File::unload();
 }
 
@@ -60,6 +62,8 @@ Music_Emu::Music_Emu()
 	mute_mask_   = 0;
 	tempo_       = 1.0;
 	gain_        = 1.0;
+	float_gain_  = 1.0f / 32768;
+	buf_is_float = false;
 	
 	// defaults
 	max_initial_silence = 2;
@@ -69,6 +73,9 @@ Music_Emu::Music_Emu()
 	equalizer_.bass     = 60;
 	
 	emu_autoload_playback_limit_ = true;
+	
+	checkpoint_msec = 0;
+	checkpoint_max  = 0;
 
 	static const char* const names [] = {
 		"Voice 1", "Voice 2", "Voice 3", "Voice 4",
@@ -146,6 +153,13 @@ void Music_Emu::set_tempo( double t )
 	if ( t > max ) t = max;
 	tempo_ = t;
 	set_tempo_( t );
+	clear_checkpoints();
+}
+
+void Music_Emu::set_float_headroom( double headroom )
+{
+	require( headroom > 0 );
+	float_gain_ = float (1.0 / (32768 * headroom));
 }
 
 void Music_Emu::post_load_()
@@ -157,6 +171,8 @@ void Music_Emu::post_load_()
 blargg_err_t Music_Emu::start_track( int track )
 {
 	clear_track_vars();
+	if ( track != checkpoint_track )
+		clear_checkpoints();
 	
 	int remapped = track;
 	RETURN_ERR( remap_track_( &remapped ) );
@@ -181,6 +197,10 @@ blargg_err_t Music_Emu::start_track( int track )
 		silence_time  = 0;
 		silence_count = 0;
 	}
+	
+	if ( checkpoint_msec )
+		start_checkpoints();
+	
 	return track_ended() ? warning() : 0;
 }
 
@@ -226,7 +246,7 @@ long Music_Emu::tell() const
 
 blargg_err_t Music_Emu::seek_samples( long time )
 {
-	if ( time < out_time )
+	if ( !load_checkpoint( time ) && time < out_time )
 		RETURN_ERR( start_track( current_track_ ) );
 	return skip( time - out_time );
 }
@@ -252,10 +272,17 @@ blargg_err_t Music_Emu::skip( long count )
 		count -= n;
 	}
 		
-	if ( count && !emu_track_ended_ )
+	while ( count && !emu_track_ended_ )
 	{
-		emu_time += count;
-		end_track_if_error( skip_( count ) );
+		// stop at each checkpoint along the way
+		if ( emu_time >= checkpoint_next )
+			save_checkpoint();
+		long n = count;
+		if ( n > checkpoint_next - emu_time )
+			n = checkpoint_next - emu_time;
+		count -= n;
+		emu_time += n;
+		end_track_if_error( skip_( n ) );
 	}
 	
 	if ( !(silence_count | buf_remain) ) // caught up to emulator, so update track ended
@@ -275,7 +302,7 @@ blargg_err_t Music_Emu::skip_( long count )
 		
 		while ( count > threshold / 2 && !emu_track_ended_ )
 		{
-			RETURN_ERR( play_( buf_size, buf.begin() ) );
+			RETURN_ERR( fast_forward_( buf_size ) );
 			count -= buf_size;
 		}
 		
@@ -293,6 +320,103 @@ blargg_err_t Music_Emu::skip_( long count )
 	return 0;
 }
 
+// Seek checkpoints
+
+void Music_Emu::set_seek_checkpoints( long interval_msec, int count )
+{
+	require( interval_msec >= 0 && count > 0 );
+	checkpoint_msec = interval_msec;
+	checkpoint_max  = count;
+	clear_checkpoints();
+}
+
+void Music_Emu::clear_checkpoints()
+{
+	checkpoint_count = 0;
+	checkpoint_track = -1;
+	checkpoint_size  = 0;
+	checkpoint_next  = INT_MAX;
+}
+
+void Music_Emu::start_checkpoints()
+{
+	if ( track_ended_ )
+		return;
+	
+	if ( !checkpoint_count )
+	{
+		checkpoint_size = state_size_();
+		if ( !checkpoint_size )
+			return;
+		
+		if ( checkpoint_data.resize( checkpoint_max * checkpoint_size ) ||
+				checkpoint_times.resize( checkpoint_max ) )
+		{
+			clear_checkpoints(); // out of memory; seek as usual
+			return;
+		}
+		checkpoint_interval = max( msec_to_samples( checkpoint_msec ), (blargg_long) buf_size );
+		checkpoint_track    = current_track_;
+	}
+	checkpoint_next = emu_time;
+}
+
+void Music_Emu::save_checkpoint()
+{
+	// after restarting the track, only save past the existing checkpoints
+	if ( checkpoint_count && checkpoint_times [checkpoint_count - 1] >= emu_time )
+	{
+		checkpoint_next = checkpoint_times [checkpoint_count - 1] + checkpoint_interval;
+		return;
+	}
+	
+	if ( checkpoint_count == checkpoint_max )
+	{
+		// keep every other checkpoint so they continue to cover the whole track
+		int n = 0;
+		for ( int i = 0; i < checkpoint_count; i += 2, n++ )
+		{
+			checkpoint_times [n] = checkpoint_times [i];
+			memmove( &checkpoint_data [n * checkpoint_size],
+					&checkpoint_data [i * checkpoint_size], checkpoint_size );
+		}
+		checkpoint_count = n;
+		checkpoint_interval *= 2;
+	}
+	
+	byte* out = &checkpoint_data [checkpoint_count * checkpoint_size];
+	checkpoint_times [checkpoint_count++] = emu_time + save_state_( out );
+	checkpoint_next = emu_time + checkpoint_interval;
+}
+
+bool Music_Emu::load_checkpoint( blargg_long time )
+{
+	// latest checkpoint at or before time
+	int i = checkpoint_count;
+	while ( i && checkpoint_times [i - 1] > time )
+		i--;
+	if ( !i-- )
+		return false;
+	
+	// when seeking forward, only worthwhile if ahead of emulator
+	blargg_long t = checkpoint_times [i];
+	if ( time >= out_time && t <= emu_time )
+		return false;
+	
+	load_state_( &checkpoint_data [i * checkpoint_size] );
+	remute_voices();
+	
+	out_time         = t;
+	emu_time         = t;
+	emu_track_ended_ = false;
+	track_ended_     = false;
+	silence_time     = t;
+	silence_count    = 0;
+	buf_remain       = 0;
+	checkpoint_next  = checkpoint_times [checkpoint_count - 1] + checkpoint_interval;
+	return true;
+}
+
 // Fading
 
 void Music_Emu::set_fade( long start_msec, long length_msec )
@@ -309,7 +433,24 @@ static int int_log( blargg_long x, int step, int unit )
 	return ((unit - fraction) + (fraction >> 1)) >> shift;
 }
 
-void Music_Emu::handle_fade( long out_count, sample_t* out )
+static void apply_fade( Music_Emu::sample_t* io, int count, int gain, int shift )
+{
+	for ( ; count; --count )
+	{
+		*io = Music_Emu::sample_t ((*io * gain) >> shift);
+		++io;
+	}
+}
+
+static void apply_fade( float* io, int count, int gain, int shift )
+{
+	float const scale = gain * (1.0f / (1 << shift));
+	for ( ; count; --count )
+		*io++ *= scale;
+}
+
+template<class T>
+void Music_Emu::handle_fade( long out_count, T* out )
 {
 	if (!fade_step)
 	{
@@ -326,46 +467,67 @@ void Music_Emu::handle_fade( long out_count, sample_t* out )
 		if ( gain < (unit >> fade_shift) )
 			track_ended_ = emu_track_ended_ = true;
 		
-		sample_t* io = &out [i];
-		for ( int count = min( fade_block_size, out_count - i ); count; --count )
-		{
-			*io = sample_t ((*io * gain) >> shift);
-			++io;
-		}
+		apply_fade( &out [i], min( fade_block_size, out_count - i ), gain, shift );
 	}
 }
 
 // Silence detection
 
-void Music_Emu::emu_play( long count, sample_t* out )
+template<class T>
+void Music_Emu::emu_play( long count, T* out )
 {
 	check( current_track_ >= 0 );
+	if ( emu_time >= checkpoint_next && !emu_track_ended_ )
+		save_checkpoint();
 	emu_time += count;
 	if ( current_track_ >= 0 && !emu_track_ended_ )
-		end_track_if_error( play_( count, out ) );
+		end_track_if_error( play_any_( count, out ) );
 	else
 		memset( out, 0, count * sizeof *out );
 }
 
+Music_Emu::sample_t Music_Emu::silence_level( sample_t* ) const { return silence_threshold; }
+float Music_Emu::silence_level( float* ) const { return silence_threshold * float_gain_; }
+
+static inline bool is_silent( Music_Emu::sample_t s, Music_Emu::sample_t threshold )
+{
+	return (unsigned) (s + threshold / 2) <= (unsigned) threshold;
+}
+
+static inline bool is_silent( float s, float threshold )
+{
+	return s >= threshold * -0.5f && s <= threshold * 0.5f;
+}
+
 // number of consecutive silent samples at end
-static long count_silence( Music_Emu::sample_t* begin, long size )
+template<class T>
+static long count_silence( T* begin, long size, T threshold )
 {
-	Music_Emu::sample_t first = *begin;
-	*begin = silence_threshold; // sentinel
-	Music_Emu::sample_t* p = begin + size;
-	while ( (unsigned) (*--p + silence_threshold / 2) <= (unsigned) silence_threshold ) { }
+	T first = *begin;
+	*begin = threshold; // sentinel
+	T* p = begin + size;
+	while ( is_silent( *--p, threshold ) ) { }
 	*begin = first;
 	return size - (p - begin);
 }
 
 // fill internal buffer and check it for silence
 void Music_Emu::fill_buf()
+{
+	if ( buf_is_float )
+		fill_buf_( float_buf.begin() );
+	else
+		fill_buf_( buf.begin() );
+}
+
+template<class T>
+void Music_Emu::fill_buf_( T* out )
 {
 	assert( !buf_remain );
 	if ( !emu_track_ended_ )
 	{
-		emu_play( buf_size, buf.begin() );
-		long silence = count_silence( buf.begin(), buf_size );
+		emu_play( buf_size, out );
+		long silence = count_silence( out, buf_size, silence_level( out ) );
 		if ( silence < buf_size )
 		{
 			silence_time = emu_time - silence;
@@ -376,7 +538,55 @@ void Music_Emu::fill_buf()
 	silence_count += buf_size;
 }
 
+// switch silence buffer to sample type of play() call, converting any samples left
+void Music_Emu::set_buf_float( bool is_float )
+{
+	if ( buf_is_float == is_float )
+		return;
+	buf_is_float = is_float;
+	
+	for ( long i = buf_size - buf_remain; i < buf_size; i++ )
+	{
+		if ( is_float )
+			float_buf [i] = buf [i] * float_gain_;
+		else
+			buf [i] = Blip_Clamped_Out::write( (blargg_long) (float_buf [i] / float_gain_) );
+	}
+}
+
+blargg_err_t Music_Emu::play_float_( long count, float* out )
+{
+	sample_t scratch [1024]; // multiple of out_channels()
+	while ( count )
+	{
+		long n = min( count, (long) (sizeof scratch / sizeof *scratch) );
+		RETURN_ERR( play_( n, scratch ) );
+		for ( long i = 0; i < n; i++ )
+			out [i] = scratch [i] * float_gain_;
+		out   += n;
+		count -= n;
+	}
+	return 0;
+}
+
 blargg_err_t Music_Emu::play( long out_count, sample_t* out )
+{
+	set_buf_float( false );
+	play_samples( out_count, out );
+	return 0;
+}
+
+blargg_err_t Music_Emu::play( long out_count, float* out )
+{
+	if ( !float_buf.size() )
+		RETURN_ERR( float_buf.resize( buf_size ) );
+	set_buf_float( true );
+	play_samples( out_count, out );
+	return 0;
+}
+
+template<class T>
+void Music_Emu::play_samples( long out_count, T* out )
 {
 	if ( track_ended_ )
 	{
@@ -417,7 +627,7 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 		{
 			// empty silence buf
 			long n = min( buf_remain, out_count - pos );
-			memcpy( &out [pos], buf.begin() + (buf_size - buf_remain), n * sizeof *out );
+			memcpy( &out [pos], buf_begin( out ) + (buf_size - buf_remain), n * sizeof *out );
 			buf_remain -= n;
 			pos += n;
 		}
@@ -432,7 +642,7 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 			if ( !ignore_silence_ || out_time > fade_start )
 			{
 				// check end for a new run of silence
-				long silence = count_silence( out + pos, remain );
+				long silence = count_silence( out + pos, remain, silence_level( out ) );
 				if ( silence < remain )
 					silence_time = emu_time - silence;
 				
@@ -445,7 +655,6 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 			handle_fade( out_count, out );
 	}
 	out_time += out_count;
-	return 0;
 }
 
 // Gme_Info_
@@ -27,6 +27,11 @@ public:
 	typedef short sample_t;
 	blargg_err_t play( long count, sample_t* buf );
 	
+	// Same as above, but generates floating-point samples where 1.0 is full scale of
+	// 16-bit output (see set_float_headroom()). Samples aren't clamped, so loud
+	// tracks don't clip.
+	blargg_err_t play( long count, float* buf );
+	
 // Informational
 	
 	// Sample rate sound is generated at
@@ -60,6 +65,14 @@ public:
 	// Skip n samples
 	blargg_err_t skip( long n );
 	
+	// Save a snapshot of the emulator every interval_msec while the track plays,
+	// so that seeking backwards resumes from the nearest snapshot instead of
+	// restarting the track. At most 'count' snapshots are kept; when full, every
+	// other one is dropped and the interval doubles. Only has an effect for
+	// emulators which can save their state. Takes effect at the next start_track().
+	// An interval of 0 disables snapshots (the default).
+	void set_seek_checkpoints( long interval_msec, int count = 64 );
+	
 	// True if a track has reached its end
 	bool track_ended() const;
 	
@@ -98,6 +111,10 @@ public:
 	// Must be called before set_sample_rate().
 	void set_gain( double );
 	
+	// Scale floating-point output down by 'headroom', so tracks louder than full scale
+	// of 16-bit output still fit within -1.0 to 1.0. Default is 1.0.
+	void set_float_headroom( double );
+	
 	// Request use of custom multichannel buffer. Only supported by "classic" emulators;
 	// on others this has no effect. Should be called only once *before* set_sample_rate().
 	virtual void set_buffer( Multi_Buffer* ) { }
@@ -140,6 +157,7 @@ protected:
 	void set_track_ended()                      { emu_track_ended_ = true; }
 	double gain() const                         { return gain_; }
 	double tempo() const                        { return tempo_; }
+	float float_gain() const                    { return float_gain_; } // 16-bit to float scale
 	void remute_voices();
 	blargg_err_t set_multi_channel_( bool is_enabled );
 	
@@ -151,6 +169,24 @@ protected:
 	virtual blargg_err_t start_track_( int ) = 0; // tempo is set before this
 	virtual blargg_err_t play_( long count, sample_t* out ) = 0;
 	virtual blargg_err_t skip_( long count );
+	
+	// Generate count floating-point samples scaled by float_gain(). Emulators which
+	// mix their output themselves override this to avoid clamping; the default
+	// converts the output of play_().
+	virtual blargg_err_t play_float_( long count, float* out );
+	
+	// Generate and discard count samples while skip_() has all voices muted. Emulators
+	// can override this to avoid synthesizing and mixing sound they would throw away,
+	// as long as emulation ends up in exactly the same state as after play_().
+	virtual blargg_err_t fast_forward_( long count ) { return play_( count, buf.begin() ); }
+	
+	// Snapshot support for seek checkpoints. state_size_() is the number of bytes
+	// save_state_() writes, or 0 if the current track can't be saved. save_state_()
+	// returns the number of samples already generated but not yet returned by
+	// play_(); load_state_() discards any such samples.
+	virtual long state_size_() const                { return 0; }
+	virtual long save_state_( byte* /* out */ )     { return 0; }
+	virtual void load_state_( byte const* /* in */ ) { }
 protected:
 	virtual void unload();
 	virtual void pre_load();
@@ -164,6 +200,7 @@ private:
 	int mute_mask_;
 	double tempo_;
 	double gain_;
+	float float_gain_;
 	bool multi_channel_;
 
 	// returns the number of output channels, i.e. usually 2 for stereo, unlesss multi_channel_ == true
@@ -185,7 +222,7 @@ private:
 	// fading
 	blargg_long fade_start;
 	int fade_step;
-	void handle_fade( long count, sample_t* out );
+	template<class T> void handle_fade( long count, T* out );
 	
 	// silence detection
 	int silence_lookahead; // speed to run emulator when looking ahead for silence
@@ -195,8 +232,36 @@ private:
 	long buf_remain;       // number of samples left in silence buffer
 	enum { buf_size = 2048 };
 	blargg_vector<sample_t> buf;
+	blargg_vector<float> float_buf;
+	bool buf_is_float;     // whether samples left in silence buffer are in float_buf
 	void fill_buf();
-	void emu_play( long count, sample_t* out );
+	void set_buf_float( bool );
+	template<class T> void fill_buf_( T* );
+	template<class T> void emu_play( long count, T* out );
+	template<class T> void play_samples( long count, T* out );
+	
+	// sample type specific parts of play()
+	blargg_err_t play_any_( long n, sample_t* out ) { return play_( n, out ); }
+	blargg_err_t play_any_( long n, float* out )    { return play_float_( n, out ); }
+	sample_t* buf_begin( sample_t* )                { return buf.begin(); }
+	float* buf_begin( float* )                      { return float_buf.begin(); }
+	sample_t silence_level( sample_t* ) const;
+	float silence_level( float* ) const;
+	
+	// seek checkpoints
+	long checkpoint_msec;             // interval set by set_seek_checkpoints()
+	int checkpoint_max;
+	int checkpoint_count;
+	int checkpoint_track;             // track checkpoints were saved for, or -1
+	long checkpoint_size;             // bytes per checkpoint, 0 if not saving
+	blargg_long checkpoint_interval;  // samples between checkpoints
+	blargg_long checkpoint_next;      // emu_time when next checkpoint is due
+	blargg_vector<byte> checkpoint_data;
+	blargg_vector<blargg_long> checkpoint_times; // ascending
+	void clear_checkpoints();
+	void start_checkpoints();
+	void save_checkpoint();
+	bool load_checkpoint( blargg_long time );
 	
 	Multi_Buffer* effects_buffer;
 	friend Music_Emu* gme_internal_new_emu_( gme_type_t, int, bool );
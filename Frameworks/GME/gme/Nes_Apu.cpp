@@ -115,6 +115,88 @@ void Nes_Apu::reset( bool pal_mode, int initial_dmc_dac )
 		dmc.last_amp = initial_dmc_dac; // prevent output transition
 }
 
+void Nes_Apu::save_state( apu_state_t* out ) const
+{
+	out->square1 = square1;
+	out->square2 = square2;
+	out->square_phases [0] = square1.phase;
+	out->square_phases [1] = square2.phase;
+	out->square_sweep_delays [0] = square1.sweep_delay;
+	out->square_sweep_delays [1] = square2.sweep_delay;
+	
+	out->triangle = triangle;
+	out->triangle_phase = triangle.phase;
+	out->triangle_linear_counter = triangle.linear_counter;
+	
+	out->noise = noise;
+	out->noise_shift = noise.noise;
+	
+	out->dmc = dmc;
+	out->dmc_address     = dmc.address;
+	out->dmc_period      = dmc.period;
+	out->dmc_buf         = dmc.buf;
+	out->dmc_bits_remain = dmc.bits_remain;
+	out->dmc_bits        = dmc.bits;
+	out->dmc_buf_full    = dmc.buf_full;
+	out->dmc_silence     = dmc.silence;
+	out->dmc_dac         = dmc.dac;
+	out->dmc_next_irq    = dmc.next_irq;
+	out->dmc_irq_enabled = dmc.irq_enabled;
+	out->dmc_irq_flag    = dmc.irq_flag;
+	
+	out->last_time     = last_time;
+	out->last_dmc_time = last_dmc_time;
+	out->next_irq      = next_irq;
+	out->frame_period  = frame_period;
+	out->frame_delay   = frame_delay;
+	out->frame         = frame;
+	out->osc_enables   = osc_enables;
+	out->frame_mode    = frame_mode;
+	out->irq_flag      = irq_flag;
+}
+
+void Nes_Apu::load_state( apu_state_t const& in )
+{
+	// oscillator outputs are restored too, so voices must be remuted afterwards
+	(Nes_Envelope&) square1 = in.square1;
+	(Nes_Envelope&) square2 = in.square2;
+	square1.phase = in.square_phases [0];
+	square2.phase = in.square_phases [1];
+	square1.sweep_delay = in.square_sweep_delays [0];
+	square2.sweep_delay = in.square_sweep_delays [1];
+	
+	(Nes_Osc&) triangle = in.triangle;
+	triangle.phase = in.triangle_phase;
+	triangle.linear_counter = in.triangle_linear_counter;
+	
+	(Nes_Envelope&) noise = in.noise;
+	noise.noise = in.noise_shift;
+	
+	(Nes_Osc&) dmc = in.dmc;
+	dmc.address     = in.dmc_address;
+	dmc.period      = in.dmc_period;
+	dmc.buf         = in.dmc_buf;
+	dmc.bits_remain = in.dmc_bits_remain;
+	dmc.bits        = in.dmc_bits;
+	dmc.buf_full    = in.dmc_buf_full;
+	dmc.silence     = in.dmc_silence;
+	dmc.dac         = in.dmc_dac;
+	dmc.next_irq    = in.dmc_next_irq;
+	dmc.irq_enabled = in.dmc_irq_enabled;
+	dmc.irq_flag    = in.dmc_irq_flag;
+	
+	last_time     = in.last_time;
+	last_dmc_time = in.last_dmc_time;
+	next_irq      = in.next_irq;
+	frame_period  = in.frame_period;
+	frame_delay   = in.frame_delay;
+	frame         = in.frame;
+	osc_enables   = in.osc_enables;
+	frame_mode    = in.frame_mode;
+	irq_flag      = in.irq_flag;
+	irq_changed();
+}
+
 void Nes_Apu::irq_changed()
 {
 	nes_time_t new_irq = dmc.next_irq;
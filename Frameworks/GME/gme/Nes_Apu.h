@@ -53,7 +53,8 @@ public:
 	// Adjust frame period
 	void set_tempo( double );
 	
-	// Save/load exact emulation state
+	// Save/load exact emulation state. State can only be loaded back into the
+	// same Nes_Apu, and only between frames.
 	void save_state( apu_state_t* out ) const;
 	void load_state( apu_state_t const& );
 	
@@ -138,6 +139,44 @@ private:
 	friend class Nes_Core;
 };
 
+struct apu_state_t
+{
+	Nes_Envelope square1;
+	Nes_Envelope square2;
+	int square_phases [2];
+	int square_sweep_delays [2];
+	
+	Nes_Osc triangle;
+	int triangle_phase;
+	int triangle_linear_counter;
+	
+	Nes_Envelope noise;
+	int noise_shift;
+	
+	Nes_Osc dmc;
+	int dmc_address;
+	int dmc_period;
+	int dmc_buf;
+	int dmc_bits_remain;
+	int dmc_bits;
+	bool dmc_buf_full;
+	bool dmc_silence;
+	int dmc_dac;
+	nes_time_t dmc_next_irq;
+	bool dmc_irq_enabled;
+	bool dmc_irq_flag;
+	
+	nes_time_t last_time;
+	nes_time_t last_dmc_time;
+	nes_time_t next_irq;
+	int frame_period;
+	int frame_delay;
+	int frame;
+	int osc_enables;
+	int frame_mode;
+	bool irq_flag;
+};
+
 inline void Nes_Apu::osc_output( int osc, Blip_Buffer* buf )
 {
 	assert( (unsigned) osc < osc_count );
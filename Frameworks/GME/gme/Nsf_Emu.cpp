@@ -614,6 +614,75 @@ blargg_err_t Nsf_Emu::start_track_( int track )
 	return 0;
 }
 
+struct nsf_state_t
+{
+	Nes_Cpu::registers_t cpu;
+	Nes_Cpu::registers_t saved_state;
+	nes_time_t next_play;
+	int play_extra;
+	int play_ready;
+	byte banks [8];
+	byte mmc5_mul [2];
+	byte low_mem [0x800];
+	byte sram [0x2000];
+	apu_state_t apu;
+	#if !NSF_EMU_APU_ONLY
+		vrc6_apu_state_t vrc6;
+		fme7_apu_state_t fme7;
+	#endif
+};
+
+long Nsf_Emu::state_size_() const
+{
+	#if !NSF_EMU_APU_ONLY
+		// remaining expansion chips can't save their state
+		if ( namco || fds || mmc5 || vrc7 )
+			return 0;
+	#endif
+	return sizeof (nsf_state_t);
+}
+
+long Nsf_Emu::save_state_( byte* out )
+{
+	nsf_state_t& state = *(nsf_state_t*) out;
+	state.cpu         = cpu::r;
+	state.saved_state = saved_state;
+	state.next_play   = next_play;
+	state.play_extra  = play_extra;
+	state.play_ready  = play_ready;
+	memcpy( state.banks, current_banks, sizeof state.banks );
+	memcpy( state.mmc5_mul, mmc5_mul, sizeof mmc5_mul );
+	memcpy( state.low_mem, low_mem, sizeof low_mem );
+	memcpy( state.sram, sram, sizeof sram );
+	apu.save_state( &state.apu );
+	#if !NSF_EMU_APU_ONLY
+		if ( vrc6 ) vrc6->save_state( &state.vrc6 );
+		if ( fme7 ) fme7->save_state( &state.fme7 );
+	#endif
+	return Classic_Emu::save_state_( out );
+}
+
+void Nsf_Emu::load_state_( byte const* in )
+{
+	Classic_Emu::load_state_( in );
+	nsf_state_t const& state = *(nsf_state_t const*) in;
+	cpu::r      = state.cpu;
+	saved_state = state.saved_state;
+	next_play   = state.next_play;
+	play_extra  = state.play_extra;
+	play_ready  = state.play_ready;
+	memcpy( mmc5_mul, state.mmc5_mul, sizeof mmc5_mul );
+	memcpy( low_mem, state.low_mem, sizeof low_mem );
+	memcpy( sram, state.sram, sizeof sram );
+	for ( int i = 0; i < bank_count; ++i )
+		cpu_write( bank_select_addr + i, state.banks [i] );
+	apu.load_state( state.apu );
+	#if !NSF_EMU_APU_ONLY
+		if ( vrc6 ) vrc6->load_state( state.vrc6 );
+		if ( fme7 ) fme7->load_state( state.fme7 );
+	#endif
+}
+
 blargg_err_t Nsf_Emu::run_clocks( blip_time_t& duration, int )
 {
 	set_time( 0 );
@@ -61,9 +61,13 @@ protected:
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	long state_size_() const;
+	long save_state_( byte* );
+	void load_state_( byte const* );
 protected:
 	enum { bank_count = 8 };
 	byte initial_banks [bank_count];
+	byte current_banks [bank_count];
 	nes_addr_t init_addr;
 	nes_addr_t play_addr;
 	double clock_rate_;
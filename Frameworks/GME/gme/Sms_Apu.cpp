@@ -231,6 +231,31 @@ void Sms_Apu::reset( unsigned feedback, int noise_width )
 	noise.reset();
 }
 
+void Sms_Apu::save_state( sms_apu_state_t* out ) const
+{
+	for ( int i = 0; i < 3; i++ )
+		out->squares [i] = squares [i];
+	out->noise          = noise;
+	out->noise_period   = noise.period;
+	out->noise_shifter  = noise.shifter;
+	out->noise_feedback = noise.feedback;
+	out->last_time      = last_time;
+	out->latch          = latch;
+}
+
+void Sms_Apu::load_state( sms_apu_state_t const& in )
+{
+	// oscillator outputs are restored too, so voices must be remuted afterwards
+	for ( int i = 0; i < 3; i++ )
+		squares [i] = in.squares [i];
+	(Sms_Osc&) noise = in.noise;
+	noise.period   = in.noise_period;
+	noise.shifter  = in.noise_shifter;
+	noise.feedback = in.noise_feedback;
+	last_time      = in.last_time;
+	latch          = in.latch;
+}
+
 void Sms_Apu::run_until( blip_time_t end_time )
 {
 	require( end_time >= last_time ); // end_time must not be before previous time
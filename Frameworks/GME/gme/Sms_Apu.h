@@ -6,6 +6,8 @@
 
 #include "Sms_Oscs.h"
 
+struct sms_apu_state_t;
+
 class Sms_Apu {
 public:
 	// Set overall volume of all oscillators, where 1.0 is full volume
@@ -41,6 +43,11 @@ public:
 	// Run all oscillators up to specified time, end current frame, then
 	// start a new frame at time 0.
 	void end_frame( blip_time_t );
+	
+	// Save/load exact emulation state. State can only be loaded back into the
+	// same Sms_Apu, and only between frames.
+	void save_state( sms_apu_state_t* out ) const;
+	void load_state( sms_apu_state_t const& );
 
 public:
 	Sms_Apu();
@@ -64,8 +71,13 @@ private:
 
 struct sms_apu_state_t
 {
-	unsigned char regs [8] [2];
-	unsigned char latch;
+	Sms_Square squares [3];
+	Sms_Osc noise;
+	int const* noise_period;
+	unsigned noise_shifter;
+	unsigned noise_feedback;
+	blip_time_t last_time;
+	int latch;
 };
 
 inline void Sms_Apu::output( Blip_Buffer* b ) { output( b, b, b ); }
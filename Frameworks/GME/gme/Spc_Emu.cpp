@@ -603,6 +603,24 @@ blargg_err_t Spc_Emu::play_( long count, sample_t* out )
 	return 0;
 }
 
+long Spc_Emu::state_size_() const
+{
+	return (long) SuperFamicom::SMP::state_size();
+}
+
+long Spc_Emu::save_state_( byte* out )
+{
+	smp.save_state( out );
+	return sample_rate() != native_sample_rate ? resampler.avail() : 0;
+}
+
+void Spc_Emu::load_state_( byte const* in )
+{
+	smp.load_state( in );
+	resampler.clear();
+	filter.clear();
+}
+
 blargg_err_t Rsn_Emu::load_archive( const char* path )
 {
 #ifdef RARDLL
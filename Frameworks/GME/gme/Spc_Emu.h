@@ -79,6 +79,9 @@ protected:
 	void mute_voices_( int );
 	void set_tempo_( double );
 	void enable_accuracy_( bool );
+	long state_size_() const;
+	long save_state_( byte* );
+	void load_state_( byte const* );
 	byte const* file_data;
 	long        file_size;
 private:
@@ -483,6 +483,47 @@ blargg_err_t Vgm_Emu::start_track_( int track )
 	return 0;
 }
 
+struct vgm_state_t
+{
+	int vgm_time;
+	Vgm_Emu::byte const* pos;
+	Vgm_Emu::byte const* pcm_data;
+	Vgm_Emu::byte const* pcm_pos;
+	sms_apu_state_t psg [2];
+};
+
+long Vgm_Emu::state_size_() const
+{
+	// FM chips can't save their state
+	return uses_fm ? 0 : sizeof (vgm_state_t);
+}
+
+long Vgm_Emu::save_state_( byte* out )
+{
+	vgm_state_t& state = *(vgm_state_t*) out;
+	state.vgm_time = vgm_time;
+	state.pos      = pos;
+	state.pcm_data = pcm_data;
+	state.pcm_pos  = pcm_pos;
+	psg[0].save_state( &state.psg [0] );
+	if ( psg_dual )
+		psg[1].save_state( &state.psg [1] );
+	return Classic_Emu::save_state_( out );
+}
+
+void Vgm_Emu::load_state_( byte const* in )
+{
+	Classic_Emu::load_state_( in );
+	vgm_state_t const& state = *(vgm_state_t const*) in;
+	vgm_time = state.vgm_time;
+	pos      = state.pos;
+	pcm_data = state.pcm_data;
+	pcm_pos  = state.pcm_pos;
+	psg[0].load_state( state.psg [0] );
+	if ( psg_dual )
+		psg[1].load_state( state.psg [1] );
+}
+
 blargg_err_t Vgm_Emu::run_clocks( blip_time_t& time_io, int msec )
 {
 	time_io = run_commands( msec * vgm_rate / 1000 );
@@ -500,3 +541,21 @@ blargg_err_t Vgm_Emu::play_( long count, sample_t* out )
 	Dual_Resampler::dual_play( count, out, blip_buf );
 	return 0;
 }
+
+blargg_err_t Vgm_Emu::play_float_( long count, float* out )
+{
+	if ( !uses_fm )
+		return Classic_Emu::play_float_( count, out );
+		
+	Dual_Resampler::dual_play( count, out, blip_buf, float_gain() );
+	return 0;
+}
+
+blargg_err_t Vgm_Emu::fast_forward_( long count )
+{
+	// FM chips have to generate their output to advance
+	if ( uses_fm )
+		return Music_Emu::fast_forward_( count );
+	
+	return Classic_Emu::fast_forward_( count );
+}
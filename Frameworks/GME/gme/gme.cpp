@@ -381,6 +381,7 @@ void      gme_set_user_cleanup(Music_Emu* me, gme_user_cleanup_t func ) { me->se
 
 gme_err_t gme_start_track    ( Music_Emu* me, int index )           { return me->start_track( index ); }
 gme_err_t gme_play           ( Music_Emu* me, int n, short* p )     { return me->play( n, p ); }
+gme_err_t gme_play_float     ( Music_Emu* me, int n, float* p )     { return me->play( n, p ); }
 void      gme_set_fade       ( Music_Emu* me, int start_msec, int fade_msec ) { me->set_fade( start_msec, fade_msec ); }
 int       gme_track_ended    ( Music_Emu const* me )                { return me->track_ended(); }
 int       gme_tell           ( Music_Emu const* me )                { return me->tell(); }
@@ -388,7 +389,9 @@ int       gme_tell_samples   ( Music_Emu const* me )                { return me-
 gme_err_t gme_seek           ( Music_Emu* me, int msec )            { return me->seek( msec ); }
 gme_err_t gme_seek_samples   ( Music_Emu* me, int n )               { return me->seek_samples( n ); }
 int       gme_voice_count    ( Music_Emu const* me )                { return me->voice_count(); }
+void      gme_set_float_headroom( Music_Emu* me, double h )         { me->set_float_headroom( h ); }
 void      gme_ignore_silence ( Music_Emu* me, int disable )         { me->ignore_silence( disable != 0 ); }
+void      gme_set_seek_checkpoints( Music_Emu* me, int msec, int n ){ me->set_seek_checkpoints( msec, n ); }
 void      gme_set_tempo      ( Music_Emu* me, double t )            { me->set_tempo( t ); }
 void      gme_mute_voice     ( Music_Emu* me, int index, int mute ) { me->mute_voice( index, mute != 0 ); }
 void      gme_mute_voices    ( Music_Emu* me, int mask )            { me->mute_voices( mask ); }
@@ -33,6 +33,10 @@ BLARGG_EXPORT gme_err_t gme_start_track( Music_Emu*, int index );
 /* Generate 'count' 16-bit signed samples info 'out'. Output is in stereo. */
 BLARGG_EXPORT gme_err_t gme_play( Music_Emu*, int count, short out [] );
 
+/* Same as gme_play(), but generates unclamped floating-point samples, where 1.0
+is full scale of 16-bit output divided by the headroom set below. */
+BLARGG_EXPORT gme_err_t gme_play_float( Music_Emu*, int count, float out [] );
+
 /* Finish using emulator and free memory */
 BLARGG_EXPORT void gme_delete( Music_Emu* );
 
@@ -138,10 +142,20 @@ struct BLARGG_EXPORT gme_info_t
 GYM, SPC, and Sega Genesis VGM music */
 BLARGG_EXPORT void gme_set_stereo_depth( Music_Emu*, double depth );
 
+/* Scale floating-point output down by headroom, so tracks louder than full scale
+still fit within -1.0 to 1.0. Default is 1.0. */
+BLARGG_EXPORT void gme_set_float_headroom( Music_Emu*, double headroom );
+
 /* Disable automatic end-of-track detection and skipping of silence at beginning
 if ignore is true */
 BLARGG_EXPORT void gme_ignore_silence( Music_Emu*, int ignore );
 
+/* Save emulator snapshots every interval_msec of playback, keeping at most count,
+so that seeking backwards resumes from the nearest snapshot instead of restarting
+the track. Only supported by some emulators; 0 disables. Takes effect at the next
+gme_start_track(). */
+BLARGG_EXPORT void gme_set_seek_checkpoints( Music_Emu*, int interval_msec, int count );
+
 /* Adjust song tempo, where 1.0 = normal, 0.5 = half speed, 2.0 = double speed.
 Track length as returned by track_info() assumes a tempo of 1.0. */
 BLARGG_EXPORT void gme_set_tempo( Music_Emu*, double tempo );
@@ -1,6 +1,8 @@
 #include "../smp/smp.hpp"
 #include "dsp.hpp"
 
+#include <string.h>
+
 namespace SuperFamicom {
 
 void DSP::step(uint64_t clocks) {
@@ -63,6 +65,31 @@ void DSP::disable_surround(bool disable) {
   spc_dsp.disable_surround(disable);
 }
 
+void DSP::save_state(uint8_t*& out) const {
+  memcpy(out, &clock, sizeof clock); out += sizeof clock;
+  memcpy(out, &removed_samples, sizeof removed_samples); out += sizeof removed_samples;
+  memcpy(out, samplebuffer, sizeof samplebuffer); out += sizeof samplebuffer;
+  memcpy(out, &spc_dsp.m, sizeof spc_dsp.m); out += sizeof spc_dsp.m;
+}
+
+void DSP::load_state(const uint8_t*& in) {
+  //keep current settings rather than those in effect when saved
+  int const mute_mask = spc_dsp.m.mute_mask;
+  int const surround_threshold = spc_dsp.m.surround_threshold;
+  int const interpolation_level = spc_dsp.m.interpolation_level;
+  int const enable_echo = spc_dsp.m.enable_echo;
+
+  memcpy(&clock, in, sizeof clock); in += sizeof clock;
+  memcpy(&removed_samples, in, sizeof removed_samples); in += sizeof removed_samples;
+  memcpy(samplebuffer, in, sizeof samplebuffer); in += sizeof samplebuffer;
+  memcpy(&spc_dsp.m, in, sizeof spc_dsp.m); in += sizeof spc_dsp.m;
+
+  spc_dsp.m.mute_mask = mute_mask;
+  spc_dsp.m.surround_threshold = surround_threshold;
+  spc_dsp.m.interpolation_level = interpolation_level;
+  spc_dsp.m.enable_echo = enable_echo;
+}
+
 DSP::DSP(struct SMP & p_smp)
     : smp( p_smp ), clock( 0 ), removed_samples( 0 ) {
   for(unsigned i = 0; i < 8; i++) channel_enabled[i] = true;
@@ -24,6 +24,11 @@ struct DSP {
   void channel_enable(unsigned channel, bool enable);
   void disable_surround(bool disable = true);
 
+  //exact state, only valid for loading back into the same DSP
+  enum : unsigned { state_size = sizeof(int64_t) + sizeof(unsigned long) + sizeof(int16_t) * 8192 + sizeof(SPC_DSP::state_t) };
+  void save_state(uint8_t*& out) const;
+  void load_state(const uint8_t*& in);
+
   DSP(struct SMP&);
 
   SPC_DSP spc_dsp;
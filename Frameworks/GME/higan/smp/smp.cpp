@@ -1,6 +1,7 @@
 #include "smp.hpp"
 
 #include <cstdlib>
+#include <cstring>
 
 #define SMP_CPP
 namespace SuperFamicom {
@@ -137,6 +138,86 @@ void SMP::reset() {
   dsp.reset();
 }
 
+template<typename T> static void save_value(uint8_t *& out, T const& value) {
+  memcpy(out, &value, sizeof value);
+  out += sizeof value;
+}
+
+template<typename T> static void load_value(const uint8_t *& in, T& value) {
+  memcpy(&value, in, sizeof value);
+  in += sizeof value;
+}
+
+template<unsigned frequency> static void save_timer(uint8_t *& out, SMP::Timer<frequency> const& timer) {
+  save_value(out, timer.stage0_ticks);
+  save_value(out, timer.stage1_ticks);
+  save_value(out, timer.stage2_ticks);
+  save_value(out, timer.stage3_ticks);
+  save_value(out, timer.current_line);
+  save_value(out, timer.enable);
+  save_value(out, timer.target);
+}
+
+template<unsigned frequency> static void load_timer(const uint8_t *& in, SMP::Timer<frequency>& timer) {
+  load_value(in, timer.stage0_ticks);
+  load_value(in, timer.stage1_ticks);
+  load_value(in, timer.stage2_ticks);
+  load_value(in, timer.stage3_ticks);
+  load_value(in, timer.current_line);
+  load_value(in, timer.enable);
+  load_value(in, timer.target);
+}
+
+size_t SMP::state_size() {
+  size_t const timer_size = 5 * sizeof(uint8_t) + 2 * sizeof(bool);
+  return sizeof(clock) + sizeof(apuram) + sizeof(regs)
+       + sizeof(dp) + sizeof(sp) + sizeof(rd) + sizeof(wr)
+       + sizeof(bit) + sizeof(ya) + sizeof(opcode)
+       + sizeof(status) + 3 * timer_size
+       + sizeof(sfm_last) + sizeof(sfm_queue)
+       + DSP::state_size;
+}
+
+void SMP::save_state(uint8_t * out) const {
+  save_value(out, clock);
+  save_value(out, apuram);
+  save_value(out, regs);
+  save_value(out, dp);
+  save_value(out, sp);
+  save_value(out, rd);
+  save_value(out, wr);
+  save_value(out, bit);
+  save_value(out, ya);
+  save_value(out, opcode);
+  save_value(out, status);
+  save_timer(out, timer0);
+  save_timer(out, timer1);
+  save_timer(out, timer2);
+  save_value(out, sfm_last);
+  save_value(out, sfm_queue);
+  dsp.save_state(out);
+}
+
+void SMP::load_state(const uint8_t * in) {
+  load_value(in, clock);
+  load_value(in, apuram);
+  load_value(in, regs);
+  load_value(in, dp);
+  load_value(in, sp);
+  load_value(in, rd);
+  load_value(in, wr);
+  load_value(in, bit);
+  load_value(in, ya);
+  load_value(in, opcode);
+  load_value(in, status);
+  load_timer(in, timer0);
+  load_timer(in, timer1);
+  load_timer(in, timer2);
+  load_value(in, sfm_last);
+  load_value(in, sfm_queue);
+  dsp.load_state(in);
+}
+
 SMP::SMP() : dsp( *this ), timer0( *this ), timer1( *this ), timer2( *this ), clock( 0 ) {
   for(auto& byte : iplrom) byte = 0;
   set_sfm_queue(0, 0, 0);
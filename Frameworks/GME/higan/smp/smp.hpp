@@ -32,6 +32,11 @@ struct SMP : Processor::SPC700 {
 
   void render(int16_t * buffer, unsigned count);
   void skip(unsigned count);
+
+  //exact state of SMP and DSP, only valid for loading back into the same SMP
+  static size_t state_size();
+  void save_state(uint8_t * out) const;
+  void load_state(const uint8_t * in);
   
   uint8_t sfm_last[4];
 private:
@@ -518,10 +518,12 @@ static void EMU_CALL dma_transfer(struct IOP_STATE *state, uint32 core, uint32 c
   switch(realchan) {
   case 4: // SPU CORE0
     spu_dma(SPUSTATE, 0, PSXRAM_BYTE_NATIVE, mem_address & 0x1FFFFC, 0x1FFFFC, len, is_writing);
+    if(!is_writing) r3000_invalidate_code(R3000STATE, mem_address, len);
     cycles_delay = DMA_SPU_CYCLES_PER_HALFWORD * (len / 2);
     break;
   case 7: // SPU CORE1
     spu_dma(SPUSTATE, 1, PSXRAM_BYTE_NATIVE, mem_address & 0x1FFFFC, 0x1FFFFC, len, is_writing);
+    if(!is_writing) r3000_invalidate_code(R3000STATE, mem_address, len);
     cycles_delay = DMA_SPU_CYCLES_PER_HALFWORD * (len / 2);
     break;
   case 10: // SIF
@@ -774,6 +776,10 @@ static void EMU_CALL iop_emucall_sw(void *state, uint32 a, uint32 d, uint32 mask
       0x200000,
       type, emufd, ofs, arg1, arg2
     );
+    // Virtual read fills RAM
+    if(type == 5 && arg1 > 0) {
+      r3000_invalidate_code(R3000STATE, ofs & 0x1FFFFF, arg1);
+    }
     //
     // Special case: fatal error if return value is -5
     //
@@ -784,6 +790,7 @@ static void EMU_CALL iop_emucall_sw(void *state, uint32 a, uint32 d, uint32 mask
     break;
   }
   *((sint32*)((PSXRAM_BYTE_NATIVE)+((d+(4*( 0 )))&0x1FFFFC))) = r;
+  r3000_invalidate_code(R3000STATE, d & 0x1FFFFC, 4);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1138,6 +1145,7 @@ uint32 EMU_CALL iop_getword(void *state, uint32 a) { a &= 0x1FFFFFFC;
 void EMU_CALL iop_setword(void *state, uint32 a, uint32 d) { a &= 0x1FFFFFFC;
   if(a < 0x00800000) {
     (*((uint32*)(PSXRAM_BYTE_NATIVE+(a&0x1FFFFC)))) = d;
+    r3000_invalidate_code(R3000STATE, a, 4);
   }
 }
 
@@ -1195,6 +1203,7 @@ void EMU_CALL iop_upload_to_ram(void *state, uint32 address, const void *src, ui
 #else
     memcpy((PSXRAM_BYTE_NATIVE) + address, src, advance);
 #endif
+    r3000_invalidate_code(R3000STATE, address, advance);
     src = (((const char*)src) + advance);
     len -= advance;
     address += advance;
@@ -46,6 +46,69 @@ sint32 EMU_CALL r3000_init(void) {
 #define C0_epc    (14)
 #define C0_prid   (15)
 
+/*
+** Block cache
+**
+** Straight-line runs of code are predecoded into ops with the register
+** fields already extracted and a direct handler pointer, so they can be run
+** without going through the decoder. Anything unusual is left to the
+** interpreter below.
+**
+** RAM is split into code pages, each with a generation number. A block
+** remembers the generation of its page, and any write to a word some block
+** was decoded from (CPU stores here, DMA and uploads through
+** r3000_invalidate_code) bumps it, which makes all blocks of that page stale.
+** Data written next to code leaves them alone. A block that goes stale over
+** and over is being rewritten all the time, so it is left to the
+** interpreter instead of being decoded again every time, for as many
+** instructions as it covered, so the cache is not asked again for each one.
+*/
+#define R3000_BLOCK_ENTRIES (4096)
+#define R3000_BLOCK_OPS     (8192)
+#define R3000_BLOCK_MAX     (64)
+#define R3000_BLOCK_REBUILD_MAX (8)
+
+#define R3000_CODE_PAGE_SHIFT (10)
+#define R3000_CODE_PAGE_SIZE  (1 << R3000_CODE_PAGE_SHIFT)
+#define R3000_CODE_PAGES      (0x200000 >> R3000_CODE_PAGE_SHIFT)
+#define R3000_CODE_WORDS      (0x200000 >> 2)
+
+#define R3000_OP_FLAG_EXIT  (1) /* may reach a callback, which may break */
+#define R3000_OP_FLAG_NOP0  (2) /* sll to r0, which the idle detection looks for */
+
+struct R3000_STATE;
+struct R3000_OP;
+
+typedef void (EMU_CALL * r3000_op_handler_t)(struct R3000_STATE *state, const struct R3000_OP *op);
+
+struct R3000_OP {
+  r3000_op_handler_t handler;
+  uint32 pc;
+  uint32 imm; /* extended immediate, shift amount, or branch target */
+  uint8 s, t, d, flags;
+};
+
+struct R3000_BLOCK {
+  uint32 pc;
+  uint16 count;    /* zero if empty */
+  uint16 branch;   /* last two ops are a branch and its delay slot */
+  uint32 first;    /* index into block_ops */
+  uint32 gen;      /* code_gen[page] when it was decoded */
+  uint16 page;     /* R3000_CODE_PAGES if it is not in RAM */
+  uint16 rebuilds; /* times it went stale at this pc */
+};
+
+/*
+** The first map entry, if it is a pointer, is taken to be RAM and gets a fast
+** path ahead of the map walker. x is out of reach when it is not.
+*/
+struct R3000_RAM {
+  uint32 x;
+  uint32 last; /* y - x */
+  uint32 mask;
+  uint8 *p;
+};
+
 struct R3000_STATE {
   uint32 regs[32];
 
@@ -83,26 +146,58 @@ struct R3000_STATE {
   void *hwstate;
   struct R3000_MEMORY_MAP *map_load;
   struct R3000_MEMORY_MAP *map_store;
+  struct R3000_RAM ram_load;
+  struct R3000_RAM ram_store;
 
   //
   // The following are TEMPORARY.
   // There are no location invariance issues.
   //
+  uint32 minpc;
   uint32 maxpc;
   void *fetchbase;
   uint32 fetchbox;
+  uint8 fetchpointer;
+
+  //
+  // Block cache (holds no pointers into the state)
+  //
+  uint8 block_cache_enabled;
+  uint32 block_op_next;
+  uint32 block_skip; /* instructions left to the interpreter */
+  struct R3000_BLOCK blocks[R3000_BLOCK_ENTRIES];
+  struct R3000_OP block_ops[R3000_BLOCK_OPS];
+  uint32 code_words[R3000_CODE_WORDS / 32]; /* bit set if a block holds the word */
+  uint32 code_gen[R3000_CODE_PAGES + 1]; /* the extra one is never bumped */
 };
 
 uint32 EMU_CALL r3000_get_state_size(void) {
   return sizeof(struct R3000_STATE);
 }
 
+static void EMU_CALL set_ram(struct R3000_RAM *ram, const struct R3000_MEMORY_MAP *map) {
+  if(map && map->type.n == R3000_MAP_TYPE_POINTER) {
+    ram->x    = map->x;
+    ram->last = map->y - map->x;
+    ram->mask = map->type.mask;
+    ram->p    = (uint8*)(map->type.p);
+  } else {
+    ram->x    = 0xFFFFFFFF;
+    ram->last = 0;
+    ram->mask = 0;
+    ram->p    = NULL;
+  }
+}
+
 void EMU_CALL r3000_clear_state(void *state) {
   memset(state, 0, sizeof(struct R3000_STATE));
   STATE->c0_prid = 0x02;
   STATE->pc = 0xBFC00000;
   /* update statistics every 20 million cycles (may overshoot a little) */
   STATE->usage_cycles_max = 20000000;
+  STATE->block_cache_enabled = 1;
+  set_ram(&(STATE->ram_load), NULL);
+  set_ram(&(STATE->ram_store), NULL);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -116,6 +211,8 @@ void EMU_CALL r3000_set_memory_maps(
 ) {
   STATE->map_load  = map_load;
   STATE->map_store = map_store;
+  set_ram(&(STATE->ram_load), map_load);
+  set_ram(&(STATE->ram_store), map_store);
 }
 
 void EMU_CALL r3000_set_advance_callback(
@@ -135,6 +232,19 @@ void EMU_CALL r3000_set_prid(void *state, uint32 prid) {
   STATE->c0_prid = prid;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+/*
+** Enable or disable the block cache (enabled by default)
+*/
+void EMU_CALL r3000_enable_block_cache(void *state, uint8 enable) {
+  STATE->block_cache_enabled = (enable != 0);
+  if(!enable) {
+    memset(STATE->blocks, 0, sizeof(STATE->blocks));
+    STATE->block_op_next = 0;
+    STATE->block_skip = 0;
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 static EMU_INLINE uint32 EMU_CALL getc0(struct R3000_STATE *state, uint32 regnum) {
@@ -213,6 +323,24 @@ static EMU_INLINE struct R3000_MEMORY_TYPE* EMU_CALL mmwalk(struct R3000_MEMORY_
   }
 }
 
+/*
+** RAM fast path, tried before the walker
+*/
+#define RAM_HIT(ram,a) (((((uint32)(a)) & 0x1FFFFFFF) - (ram).x) <= (ram).last)
+
+//
+// Marks a RAM word as written; if a block was decoded from it, every block
+// of its page goes stale
+//
+static EMU_INLINE void EMU_CALL code_touch(struct R3000_STATE *state, uint32 ofs) {
+  uint32 w = (ofs >> 2) & (R3000_CODE_WORDS - 1);
+  if(state->code_words[w >> 5] & (((uint32)1) << (w & 31))) {
+    uint32 page = w >> (R3000_CODE_PAGE_SHIFT - 2);
+    memset(state->code_words + (page << (R3000_CODE_PAGE_SHIFT - 7)), 0, R3000_CODE_PAGE_SIZE / 32);
+    state->code_gen[page]++;
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 static EMU_INLINE void EMU_CALL exception(struct R3000_STATE *state, uint32 cause, uint32 IP) {
@@ -310,9 +438,13 @@ static EMU_INLINE void EMU_CALL renew_fetch_region(struct R3000_STATE *state) {
   struct R3000_MEMORY_TYPE *t = mmwalk(state->map_load, state->pc);
   if(t->n == R3000_MAP_TYPE_POINTER) {
     uint32 astart = (state->pc) & (~(t->mask));
+    state->minpc = astart;
     state->maxpc = astart + ((t->mask) + 1);
     state->fetchbase = ((uint8*)(t->p)) - astart;
+    state->fetchpointer = 1;
   } else {
+    state->fetchpointer = 0;
+    state->minpc = state->pc;
     state->maxpc = state->pc + 4;
     state->fetchbase = ((uint8*)(&(state->fetchbox)))-(state->pc);
     state->fetchbox = ((r3000_load_callback_t)(t->p))(state->hwstate, state->pc, 0xFFFFFFFF);
@@ -320,7 +452,13 @@ static EMU_INLINE void EMU_CALL renew_fetch_region(struct R3000_STATE *state) {
 }
 
 static EMU_INLINE uint32 EMU_CALL lb(struct R3000_STATE *state, uint32 a) {
-  struct R3000_MEMORY_TYPE *t = mmwalk(state->map_load, a);
+  struct R3000_MEMORY_TYPE *t;
+  if(RAM_HIT(state->ram_load, a)) {
+    a &= state->ram_load.mask;
+    a ^= EMU_ENDIAN_XOR(3);
+    return *((uint8*)(state->ram_load.p+a));
+  }
+  t = mmwalk(state->map_load, a);
   a &= t->mask;
   if(t->n == R3000_MAP_TYPE_POINTER) {
     a ^= EMU_ENDIAN_XOR(3);
@@ -335,7 +473,14 @@ static EMU_INLINE uint32 EMU_CALL lb(struct R3000_STATE *state, uint32 a) {
 }
 
 static EMU_INLINE uint32 EMU_CALL lh(struct R3000_STATE *state, uint32 a) {
-  struct R3000_MEMORY_TYPE *t = mmwalk(state->map_load, a);
+  struct R3000_MEMORY_TYPE *t;
+  if(RAM_HIT(state->ram_load, a)) {
+    a &= state->ram_load.mask;
+    a ^= EMU_ENDIAN_XOR(2);
+    a &= (~1);
+    return *((uint16*)(state->ram_load.p+a));
+  }
+  t = mmwalk(state->map_load, a);
   a &= t->mask;
   if(t->n == R3000_MAP_TYPE_POINTER) {
     a ^= EMU_ENDIAN_XOR(2);
@@ -352,6 +497,11 @@ static EMU_INLINE uint32 EMU_CALL lh(struct R3000_STATE *state, uint32 a) {
 
 static EMU_INLINE uint32 EMU_CALL lw(struct R3000_STATE *state, uint32 a) {
   struct R3000_MEMORY_TYPE *t;
+  if(RAM_HIT(state->ram_load, a)) {
+    a &= state->ram_load.mask;
+    a &= (~3);
+    return *((uint32*)(state->ram_load.p+a));
+  }
   /*
   ** HACK HACK HACK TODO fix later
   */
@@ -386,7 +536,15 @@ static EMU_INLINE uint32 EMU_CALL lw_noeffects(struct R3000_STATE *state, uint32
 }
 
 static EMU_INLINE void EMU_CALL sb(struct R3000_STATE *state, uint32 a, uint32 d) {
-  struct R3000_MEMORY_TYPE *t = mmwalk(state->map_store, a);
+  struct R3000_MEMORY_TYPE *t;
+  if(RAM_HIT(state->ram_store, a)) {
+    a &= state->ram_store.mask;
+    code_touch(state, a);
+    a ^= EMU_ENDIAN_XOR(3);
+    *((uint8*)(state->ram_store.p+a)) = d;
+    return;
+  }
+  t = mmwalk(state->map_store, a);
   a &= t->mask;
   if(t->n == R3000_MAP_TYPE_POINTER) {
     a ^= EMU_ENDIAN_XOR(3);
@@ -400,7 +558,16 @@ static EMU_INLINE void EMU_CALL sb(struct R3000_STATE *state, uint32 a, uint32 d
 }
 
 static EMU_INLINE void EMU_CALL sh(struct R3000_STATE *state, uint32 a, uint32 d) {
-  struct R3000_MEMORY_TYPE *t = mmwalk(state->map_store, a);
+  struct R3000_MEMORY_TYPE *t;
+  if(RAM_HIT(state->ram_store, a)) {
+    a &= state->ram_store.mask;
+    code_touch(state, a);
+    a ^= EMU_ENDIAN_XOR(2);
+    a &= (~1);
+    *((uint16*)(state->ram_store.p+a)) = d;
+    return;
+  }
+  t = mmwalk(state->map_store, a);
   a &= t->mask;
   if(t->n == R3000_MAP_TYPE_POINTER) {
     a ^= EMU_ENDIAN_XOR(2);
@@ -430,6 +597,13 @@ static EMU_INLINE void EMU_CALL sw(struct R3000_STATE *state, uint32 a, uint32 d
   }
   if(state->cache_isolate) return;
 
+  if(RAM_HIT(state->ram_store, a)) {
+    a &= state->ram_store.mask;
+    a &= (~3);
+    code_touch(state, a);
+    *((uint32*)(state->ram_store.p+a)) = d;
+    return;
+  }
   t = mmwalk(state->map_store, a);
   a &= t->mask;
   a &= (~3);
@@ -446,6 +620,443 @@ static EMU_INLINE uint32 EMU_CALL fetch(struct R3000_STATE *state) {
   return *((uint32*)(((uint8*)(state->fetchbase))+(state->pc)));
 }
 
+/////////////////////////////////////////////////////////////////////////////
+/*
+** Report RAM written without going through the CPU (DMA, uploads)
+*/
+void EMU_CALL r3000_invalidate_code(void *state, uint32 a, uint32 len) {
+  uint32 words;
+  if(!len) return;
+  if(!RAM_HIT(STATE->ram_store, a)) return;
+  a &= STATE->ram_store.mask;
+  words = ((a & 3) + len + 3) >> 2;
+  if(words > R3000_CODE_WORDS) words = R3000_CODE_WORDS;
+  a &= (~3);
+  while(words--) {
+    code_touch(STATE, a);
+    a += 4;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/*
+** Block cache ops
+**
+** Each of these does exactly what the matching case in r3000_execute does.
+** PC is only kept up to date for the ops that can reach a callback.
+*/
+#define OP(name) static void EMU_CALL op_##name(struct R3000_STATE *state, const struct R3000_OP *op)
+#define OPS   (REGS[op->s])
+#define OPT   (REGS[op->t])
+#define OPD   (REGS[op->d])
+#define OPJ   {STATE->slot=2;STATE->slot_target=op->imm;}
+
+OP(nop)   { }
+OP(sll)   { OPD = ((uint32)(OPT)) << op->imm; }
+OP(srl)   { OPD = ((uint32)(OPT)) >> op->imm; }
+OP(sra)   { OPD = ((sint32)(OPT)) >> op->imm; }
+OP(sllv)  { uint32 sc=OPS; if(sc>=32){OPD=0;}else{OPD=OPT<<sc;} }
+OP(srlv)  { uint32 sc=OPS; if(sc>=32){OPD=0;}else{OPD=OPT>>sc;} }
+OP(srav)  { uint32 sc=OPS; if(sc>=32){sc=31;}            {OPD=(((sint32)(OPT))>>sc);} }
+OP(mfhi)  { OPD = HI; }
+OP(mthi)  { HI = OPS; }
+OP(mflo)  { OPD = LO; }
+OP(mtlo)  { LO = OPS; }
+OP(mult)  { sint64 t = ((sint64)(((sint32)(OPS)))) * ((sint64)(((sint32)(OPT)))); LO = (uint32)(t); HI = (uint32)(t >> 32); }
+OP(multu) { uint64 t = ((uint64)(((uint32)(OPS)))) * ((uint64)(((uint32)(OPT)))); LO = (uint32)(t); HI = (uint32)(t >> 32); }
+OP(div)   { if(OPT) { LO = ((sint32)(OPS)) / ((sint32)(OPT)); HI = ((sint32)(OPS)) % ((sint32)(OPT)); } }
+OP(divu)  { if(OPT) { LO = ((uint32)(OPS)) / ((uint32)(OPT)); HI = ((uint32)(OPS)) % ((uint32)(OPT)); } }
+OP(addu)  { OPD =  (((uint32)(OPS)) + ((uint32)(OPT))); }
+OP(subu)  { OPD =  (((uint32)(OPS)) - ((uint32)(OPT))); }
+OP(and)   { OPD =  (((uint32)(OPS)) & ((uint32)(OPT))); }
+OP(or)    { OPD =  (((uint32)(OPS)) | ((uint32)(OPT))); }
+OP(xor)   { OPD =  (((uint32)(OPS)) ^ ((uint32)(OPT))); }
+OP(nor)   { OPD = ~(((uint32)(OPS)) | ((uint32)(OPT))); }
+OP(slt)   { OPD =  (((sint32)(OPS)) < ((sint32)(OPT))); }
+OP(sltu)  { OPD =  (((uint32)(OPS)) < ((uint32)(OPT))); }
+OP(addiu) { OPT = OPS + op->imm; }
+OP(slti)  { OPT = (((sint32)(OPS)) < ((sint32)(op->imm))); }
+OP(sltiu) { OPT = (((uint32)(OPS)) < op->imm); }
+OP(andi)  { OPT = OPS & op->imm; }
+OP(ori)   { OPT = OPS | op->imm; }
+OP(xori)  { OPT = OPS ^ op->imm; }
+OP(lui)   { OPT = op->imm; }
+OP(mfc0)  { OPT = getc0(STATE, op->d); }
+OP(mtc0)  { PC = op->pc; setc0(STATE, op->d, OPT); r3000_break(state); }
+OP(rfe)   {
+  PC = op->pc;
+  STATE->c0_status =
+    (STATE->c0_status & 0xFFFFFFC0) |
+    ((STATE->c0_status & 0x3C) >> 2) |
+    ((STATE->c0_status & 0x03) << 4);
+  r3000_break(state);
+}
+
+OP(lb)    { uint32 d; PC = op->pc; d = lb(state, OPS + op->imm); if(op->t) { OPT = ((sint32)((sint8)(d)));  } }
+OP(lh)    { uint32 d; PC = op->pc; d = lh(state, OPS + op->imm); if(op->t) { OPT = ((sint32)((sint16)(d))); } }
+OP(lw)    { uint32 d; PC = op->pc; d = lw(state, OPS + op->imm); if(op->t) { OPT = d;                       } }
+OP(lbu)   { uint32 d; PC = op->pc; d = lb(state, OPS + op->imm); if(op->t) { OPT = d & 0x000000FF;          } }
+OP(lhu)   { uint32 d; PC = op->pc; d = lh(state, OPS + op->imm); if(op->t) { OPT = d & 0x0000FFFF;          } }
+OP(sb)    { PC = op->pc; sb(state, OPS + op->imm, OPT & 0x000000FF); }
+OP(sh)    { PC = op->pc; sh(state, OPS + op->imm, OPT & 0x0000FFFF); }
+OP(sw)    { PC = op->pc; sw(state, OPS + op->imm, OPT             ); }
+OP(lwl)   {
+  uint32 a = OPS + op->imm;
+  int bitshift;
+  PC = op->pc;
+  for(bitshift = 24;; bitshift -= 8) {
+    OPT &= ~(0xFF << bitshift);
+    OPT |= (((uint32)(lb(state, a))) & 0xFF) << bitshift;
+    if(!(a&3))break;
+    a--;
+  }
+  REGS[0] = 0;
+}
+OP(lwr)   {
+  uint32 a = OPS + op->imm;
+  int bitshift;
+  PC = op->pc;
+  for(bitshift = 0;; bitshift += 8) {
+    OPT &= ~(0xFF << bitshift);
+    OPT |= (((uint32)(lb(state, a))) & 0xFF) << bitshift;
+    if((a&3) == 3)break;
+    a++;
+  }
+  REGS[0] = 0;
+}
+OP(swl)   {
+  uint32 a = OPS + op->imm;
+  int bitshift;
+  PC = op->pc;
+  for(bitshift = 24;; bitshift -= 8) {
+    sb(state, a, OPT>>bitshift);
+    if(!(a&3))break;
+    a--;
+  }
+}
+OP(swr)   {
+  uint32 a = OPS + op->imm;
+  int bitshift;
+  PC = op->pc;
+  for(bitshift = 0;; bitshift += 8) {
+    sb(state, a, OPT>>bitshift);
+    if((a&3) == 3)break;
+    a++;
+  }
+}
+
+/* branches only ever start out of a delay slot here */
+OP(bltz)   { if(((sint32)(OPS)) <  0) {                       OPJ; } }
+OP(bgez)   { if(((sint32)(OPS)) >= 0) {                       OPJ; } }
+OP(bltzal) { if(((sint32)(OPS)) <  0) { REGS[31]=op->pc+8;    OPJ; } }
+OP(bgezal) { if(((sint32)(OPS)) >= 0) { REGS[31]=op->pc+8;    OPJ; } }
+OP(j)      {                                                  OPJ;   }
+OP(jal)    {                            REGS[31]=op->pc+8;    OPJ;   }
+OP(beq)    { if(OPS == OPT)           {                       OPJ; } }
+OP(bne)    { if(OPS != OPT)           {                       OPJ; } }
+OP(blez)   { if(((sint32)(OPS)) <= 0) {                       OPJ; } }
+OP(bgtz)   { if(((sint32)(OPS)) >  0) {                       OPJ; } }
+OP(jr)     {                            STATE->slot=2; STATE->slot_target=OPS; }
+OP(jalr)   { OPD = op->pc + 8;          STATE->slot=2; STATE->slot_target=OPS; }
+
+enum {
+  OP_NOP, OP_SLL, OP_SRL, OP_SRA, OP_SLLV, OP_SRLV, OP_SRAV,
+  OP_MFHI, OP_MTHI, OP_MFLO, OP_MTLO, OP_MULT, OP_MULTU, OP_DIV, OP_DIVU,
+  OP_ADDU, OP_SUBU, OP_AND, OP_OR, OP_XOR, OP_NOR, OP_SLT, OP_SLTU,
+  OP_ADDIU, OP_SLTI, OP_SLTIU, OP_ANDI, OP_ORI, OP_XORI, OP_LUI,
+  OP_MFC0, OP_MTC0, OP_RFE,
+  OP_LB, OP_LH, OP_LW, OP_LBU, OP_LHU, OP_SB, OP_SH, OP_SW,
+  OP_LWL, OP_LWR, OP_SWL, OP_SWR,
+  OP_BLTZ, OP_BGEZ, OP_BLTZAL, OP_BGEZAL, OP_J, OP_JAL,
+  OP_BEQ, OP_BNE, OP_BLEZ, OP_BGTZ, OP_JR, OP_JALR,
+  OP_BAD
+};
+
+static const r3000_op_handler_t op_handlers[OP_BAD] = {
+  op_nop, op_sll, op_srl, op_sra, op_sllv, op_srlv, op_srav,
+  op_mfhi, op_mthi, op_mflo, op_mtlo, op_mult, op_multu, op_div, op_divu,
+  op_addu, op_subu, op_and, op_or, op_xor, op_nor, op_slt, op_sltu,
+  op_addiu, op_slti, op_sltiu, op_andi, op_ori, op_xori, op_lui,
+  op_mfc0, op_mtc0, op_rfe,
+  op_lb, op_lh, op_lw, op_lbu, op_lhu, op_sb, op_sh, op_sw,
+  op_lwl, op_lwr, op_swl, op_swr,
+  op_bltz, op_bgez, op_bltzal, op_bgezal, op_j, op_jal,
+  op_beq, op_bne, op_blez, op_bgtz, op_jr, op_jalr
+};
+
+#undef OP
+#undef OPS
+#undef OPT
+#undef OPD
+#undef OPJ
+
+//
+// Decodes one instruction into an op
+// Returns OP_BAD for anything the block cache leaves to the interpreter
+//
+static uint32 EMU_CALL decode_op(struct R3000_OP *op, uint32 instruction, uint32 pc) {
+  uint32 h = OP_BAD;
+  op->pc = pc;
+  op->imm = SIGNED16(INS_I);
+  op->s = INS_S;
+  op->t = INS_T;
+  op->d = INS_D;
+  op->flags = 0;
+  if(instruction < 0x04000000) {
+    switch(instruction & 0x3F) {
+    case 0x00: h = OP_SLL; op->imm = INS_H; if(!INS_D) { op->flags = R3000_OP_FLAG_NOP0; } break;
+    case 0x02: h = OP_SRL; op->imm = INS_H; break;
+    case 0x03: h = OP_SRA; op->imm = INS_H; break;
+    case 0x04: h = OP_SLLV; break;
+    case 0x06: h = OP_SRLV; break;
+    case 0x07: h = OP_SRAV; break;
+    case 0x08: h = OP_JR; break;
+    case 0x09: h = OP_JALR; return h; /* writes rd even if it is r0 */
+    case 0x10: h = OP_MFHI; break;
+    case 0x11: h = OP_MTHI; return h;
+    case 0x12: h = OP_MFLO; break;
+    case 0x13: h = OP_MTLO; return h;
+    case 0x18: h = OP_MULT; return h;
+    case 0x19: h = OP_MULTU; return h;
+    case 0x1A: h = OP_DIV; return h;
+    case 0x1B: h = OP_DIVU; return h;
+    case 0x20: case 0x21: h = OP_ADDU; break;
+    case 0x22: case 0x23: h = OP_SUBU; break;
+    case 0x24: h = OP_AND; break;
+    case 0x25: h = OP_OR; break;
+    case 0x26: h = OP_XOR; break;
+    case 0x27: h = OP_NOR; break;
+    case 0x2A: h = OP_SLT; break;
+    case 0x2B: h = OP_SLTU; break;
+    default: return OP_BAD;
+    }
+    if(h != OP_JR && !INS_D) { h = OP_NOP; }
+    return h;
+  }
+  switch(instruction >> 26) {
+  case 0x01:
+    op->imm = pc + 4 + (SIGNED16(INS_I) << 2);
+    switch(INS_T) {
+    case 0x00: return OP_BLTZ;
+    case 0x01: return OP_BGEZ;
+    case 0x10: return OP_BLTZAL;
+    case 0x11: return OP_BGEZAL;
+    }
+    return OP_BAD;
+  case 0x02: op->imm = (pc & 0xF0000000) | ((instruction << 2) & 0x0FFFFFFC); return OP_J;
+  case 0x03: op->imm = (pc & 0xF0000000) | ((instruction << 2) & 0x0FFFFFFC); return OP_JAL;
+  case 0x04: op->imm = pc + 4 + (SIGNED16(INS_I) << 2); return OP_BEQ;
+  case 0x05: op->imm = pc + 4 + (SIGNED16(INS_I) << 2); return OP_BNE;
+  case 0x06: op->imm = pc + 4 + (SIGNED16(INS_I) << 2); return OP_BLEZ;
+  case 0x07: op->imm = pc + 4 + (SIGNED16(INS_I) << 2); return OP_BGTZ;
+  case 0x08: case 0x09: h = OP_ADDIU; break;
+  case 0x0A: h = OP_SLTI; break;
+  case 0x0B: h = OP_SLTIU; break;
+  case 0x0C: h = OP_ANDI; op->imm = UNSIGNED16(INS_I); break;
+  case 0x0D: h = OP_ORI;  op->imm = UNSIGNED16(INS_I); break;
+  case 0x0E: h = OP_XORI; op->imm = UNSIGNED16(INS_I); break;
+  case 0x0F: h = OP_LUI;  op->imm = INS_I << 16; break;
+  case 0x10:
+    switch(INS_S) {
+    case 0x00: h = OP_MFC0; break;
+    case 0x04: op->flags = R3000_OP_FLAG_EXIT; return OP_MTC0;
+    case 0x10: op->flags = R3000_OP_FLAG_EXIT; return OP_RFE;
+    default: return OP_BAD;
+    }
+    break;
+  case 0x20: h = OP_LB;  break;
+  case 0x21: h = OP_LH;  break;
+  case 0x22: h = OP_LWL; break;
+  case 0x23: h = OP_LW;  break;
+  case 0x24: h = OP_LBU; break;
+  case 0x25: h = OP_LHU; break;
+  case 0x26: h = OP_LWR; break;
+  case 0x28: h = OP_SB;  break;
+  case 0x29: h = OP_SH;  break;
+  case 0x2A: h = OP_SWL; break;
+  case 0x2B: h = OP_SW;  break;
+  case 0x2E: h = OP_SWR; break;
+  default: return OP_BAD;
+  }
+  if(h >= OP_LB) {
+    op->flags = R3000_OP_FLAG_EXIT;
+  } else if(!INS_T) {
+    h = OP_NOP;
+  }
+  return h;
+}
+
+#define IS_BRANCH_OP(h) ((h) >= OP_BLTZ && (h) <= OP_JALR)
+
+//
+// Decodes the straight-line code at PC, which must be in a pointer region
+// Returns the block, or NULL if the first instruction has to be interpreted
+//
+static struct R3000_BLOCK* EMU_CALL compile_block(struct R3000_STATE *state) {
+  struct R3000_BLOCK *block = STATE->blocks + ((PC >> 2) & (R3000_BLOCK_ENTRIES - 1));
+  struct R3000_OP *ops;
+  uint32 page = R3000_CODE_PAGES;
+  uint32 word = 0;
+  uint32 pc = PC;
+  uint32 n = 0;
+
+  if(RAM_HIT(STATE->ram_store, PC)) {
+    uint32 ofs = PC & STATE->ram_store.mask;
+    /* the page is only tracked if this is the RAM the stores go to */
+    if((((uint8*)(STATE->fetchbase))+PC) != (STATE->ram_store.p+ofs)) return NULL;
+    page = (ofs >> R3000_CODE_PAGE_SHIFT) & (R3000_CODE_PAGES - 1);
+    word = (ofs >> 2) & (R3000_CODE_WORDS - 1);
+  } else if(mmwalk(STATE->map_store, PC)->n == R3000_MAP_TYPE_POINTER) {
+    /* writable, but not tracked */
+    return NULL;
+  }
+
+  if(block->pc != PC) {
+    block->rebuilds = 0;
+  } else if(block->count) {
+    /* it went stale */
+    if(block->rebuilds < R3000_BLOCK_REBUILD_MAX) block->rebuilds++;
+    if(block->rebuilds >= R3000_BLOCK_REBUILD_MAX) {
+      /* count is kept, it is how far the interpreter takes over */
+      STATE->block_skip = block->count - block->branch - 1;
+      return NULL;
+    }
+  }
+
+  if(STATE->block_op_next > (R3000_BLOCK_OPS - R3000_BLOCK_MAX)) {
+    memset(STATE->blocks, 0, sizeof(STATE->blocks));
+    STATE->block_op_next = 0;
+  }
+  ops = STATE->block_ops + STATE->block_op_next;
+
+  block->count = 0;
+  block->branch = 0;
+  /* blocks stay within one code page */
+  while(n < (R3000_BLOCK_MAX - 1) && pc < STATE->maxpc && (!n || (pc & (R3000_CODE_PAGE_SIZE - 1)))) {
+    uint32 h = decode_op(ops + n, *((uint32*)(((uint8*)(STATE->fetchbase))+pc)), pc);
+    if(h == OP_BAD) break;
+    ops[n].handler = op_handlers[h];
+    if(IS_BRANCH_OP(h)) {
+      /* the delay slot has to be an ordinary op too */
+      uint32 hd = OP_BAD;
+      if((pc + 4) < STATE->maxpc && ((pc + 4) & (R3000_CODE_PAGE_SIZE - 1))) {
+        hd = decode_op(ops + n + 1, *((uint32*)(((uint8*)(STATE->fetchbase))+pc+4)), pc + 4);
+      }
+      if(hd == OP_BAD || IS_BRANCH_OP(hd)) break;
+      ops[n + 1].handler = op_handlers[hd];
+      n += 2;
+      block->branch = 1;
+      break;
+    }
+    n++;
+    pc += 4;
+  }
+  if(!n) return NULL;
+
+  block->pc = PC;
+  block->count = n;
+  block->first = STATE->block_op_next;
+  block->page = page;
+  block->gen = STATE->code_gen[page];
+  if(page < R3000_CODE_PAGES) {
+    uint32 i;
+    for(i = 0; i < n; i++, word++) {
+      STATE->code_words[word >> 5] |= ((uint32)1) << (word & 31);
+    }
+  }
+  STATE->block_op_next += n;
+  return block;
+}
+
+//
+// Runs one block starting at PC, out of a delay slot
+// Returns the number of instructions run, or 0 if the interpreter should
+// take the next one
+//
+// cycles_remaining is only written back before the ops that can reach a
+// callback, since nothing else looks at it
+//
+static uint32 EMU_CALL run_block(struct R3000_STATE *state) {
+  struct R3000_BLOCK *block;
+  const struct R3000_OP *op;
+  const uint32 *gen;
+  sint32 cycles;
+  uint32 n, count;
+
+  if(PC >= STATE->maxpc) renew_fetch_region(state);
+  if(!STATE->fetchpointer) return 0;
+
+  block = STATE->blocks + ((PC >> 2) & (R3000_BLOCK_ENTRIES - 1));
+  if(
+    (!block->count) || (block->pc != PC) ||
+    (block->gen != STATE->code_gen[block->page])
+  ) {
+    block = compile_block(state);
+    if(!block) return 0;
+  }
+  gen = STATE->code_gen + block->page;
+
+  count = block->count;
+  cycles = STATE->cycles_remaining;
+  /* every op in the block has to get its turn before the cycles run out */
+  if(cycles <= (sint32)((count - 1) * DIVIDER)) return 0;
+
+  op = STATE->block_ops + block->first;
+  if(block->branch) count -= 2;
+
+  for(n = 0; n < count; n++, op++) {
+    if(op->flags & R3000_OP_FLAG_EXIT) {
+      STATE->cycles_remaining = cycles;
+      op->handler(state, op);
+      cycles = STATE->cycles_remaining - DIVIDER;
+      /* stop if it ran out of cycles or wrote over its own page */
+      if(cycles <= 0 || *gen != block->gen) {
+        STATE->cycles_remaining = cycles;
+        PC = op->pc + 4;
+        return n + 1;
+      }
+    } else {
+      op->handler(state, op);
+      cycles -= DIVIDER;
+    }
+  }
+
+  if(!block->branch) {
+    STATE->cycles_remaining = cycles;
+    PC = op[-1].pc + 4;
+    return n;
+  }
+
+  /* branch */
+  op->handler(state, op);
+  cycles -= DIVIDER;
+  if(STATE->slot) STATE->slot--;
+  op++; n++;
+
+  /* delay slot */
+  if((op->flags & R3000_OP_FLAG_NOP0) && STATE->slot && STATE->slot_target == (op->pc - 4)) {
+    /* leave the idle loop to the interpreter */
+    STATE->cycles_remaining = cycles;
+    PC = op->pc;
+    return n;
+  }
+  STATE->cycles_remaining = cycles;
+  op->handler(state, op);
+  STATE->cycles_remaining -= DIVIDER;
+  n++;
+
+  if(STATE->slot) {
+    STATE->slot = 0;
+    PC = STATE->slot_target & (~3);
+    if(PC < STATE->minpc) STATE->maxpc = 0;
+  } else {
+    PC = op->pc + 4;
+  }
+  return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 #define caseMINOR(a) case(a):
 #define caseMAJOR(a) case(a):
 
@@ -474,6 +1085,10 @@ sint32 EMU_CALL r3000_execute(void *state, sint32 cycles) {
   STATE->maxpc = 0;
 
   while(STATE->slot || STATE->cycles_remaining > 0) {
+    if((!STATE->slot) && STATE->block_cache_enabled) {
+      if(STATE->block_skip) STATE->block_skip--;
+      else if(run_block(STATE)) continue;
+    }
     instruction = fetch(state);
     if(instruction < 0x04000000) {
       switch(instruction & 0x3F) {
@@ -39,6 +39,18 @@ void EMU_CALL r3000_set_advance_callback(
 
 void EMU_CALL r3000_set_prid(void *state, uint32 prid);
 
+//
+// Runs straight-line code from predecoded blocks (enabled by default)
+// Results are the same either way
+//
+void EMU_CALL r3000_enable_block_cache(void *state, uint8 enable);
+
+//
+// Must be called for anything written to RAM other than by the CPU (DMA,
+// uploads), so blocks decoded from it are thrown out
+//
+void EMU_CALL r3000_invalidate_code(void *state, uint32 a, uint32 len);
+
 #define R3000_REG_GEN (0)
 #define R3000_REG_C0  (32)
 #define R3000_REG_PC  (64)
@@ -10,6 +10,8 @@
 
 #include "spucore.h"
 
+#include <stddef.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 /*
 ** Key-on defer
@@ -386,6 +388,20 @@ struct SPUCORE_REVERB {
   struct SPUCORE_REVERB_RESAMPLER resampler;
 };
 
+/*
+** Decoded ADPCM blocks, indexed by SPU RAM block address
+** An entry is only reused if the block data and the two samples of history
+** it was decoded from still match, so RAM writes from any source (transfer
+** port, DMA, reverb, the other core) need no explicit invalidation
+*/
+#define SPUCORE_BLOCK_CACHE_ENTRIES (1024)
+
+struct SPUCORE_BLOCK_CACHE_ENTRY {
+  uint16 block[8];
+  sint32 history[2];
+  sint32 decoded[28];
+};
+
 struct SPUCORE_STATE {
   uint32 flags;
   sint32 memsize;
@@ -407,6 +423,8 @@ struct SPUCORE_STATE {
   sint32 noiseval;
   uint32 irq_decoder_clock;
   uint32 irq_triggered_cycle;
+  /* must stay last, see spucore_cycles_until_interrupt */
+  struct SPUCORE_BLOCK_CACHE_ENTRY block_cache[SPUCORE_BLOCK_CACHE_ENTRIES];
 };
 
 struct SPUCORE_IRQ_STATE {
@@ -551,9 +569,36 @@ static spucore_predict_callback_t spucore_predict[8] = {
   spucore_predict_4, spucore_predict_1, spucore_predict_2, spucore_predict_3
 };
 
+/*
+** A cleared entry holds an all-zero block, which decodes to zeros with any
+** history, so a zeroed cache is valid as-is
+*/
+static void EMU_CALL decode_block_cached(
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
+  uint32 block_addr,
+  uint16 *block,
+  sint32 *dest
+) {
+  struct SPUCORE_BLOCK_CACHE_ENTRY *entry = cache + ((block_addr >> 4) & (SPUCORE_BLOCK_CACHE_ENTRIES-1));
+  uint32 filter = (block[0]>>4)&7;
+  if(!memcmp(entry->block, block, sizeof(entry->block))) {
+    /* filter 0 does not use the history */
+    if(!filter || (entry->history[0] == dest[-2] && entry->history[1] == dest[-1])) {
+      memcpy(dest, entry->decoded, sizeof(entry->decoded));
+      return;
+    }
+  }
+  (spucore_predict[filter])(block + 1, dest, block[0] & 0xF);
+  memcpy(entry->block, block, sizeof(entry->block));
+  entry->history[0] = dest[-2];
+  entry->history[1] = dest[-1];
+  memcpy(entry->decoded, dest, sizeof(entry->decoded));
+}
+
 static void EMU_CALL decode_sample_block(
   uint16 *ram,
   uint32 memmax,
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
   struct SPUCORE_SAMPLE *sample,
   int skip
 ) {
@@ -580,11 +625,7 @@ static void EMU_CALL decode_sample_block(
       sample->array[1] = sample->array[29];
       sample->array[2] = sample->array[30];
       sample->array[3] = sample->array[31];
-      (spucore_predict[(ram[0]>>4)&7])(
-        ram + 1,
-        sample->array + 4,
-        ram[0] & 0xF
-      );
+      decode_block_cached(cache, sample->block_addr, ram, sample->array + 4);
     }
     /* set loop start address if necessary */
     if(ram[0]&0x0400) {
@@ -618,6 +659,7 @@ static void EMU_CALL decode_sample_block(
 static uint32 EMU_CALL resampler(
   uint16 *ram,
   uint32 memmax,
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
   struct SPUCORE_SAMPLE *sample,
   sint32 *dest,
   uint32 n,
@@ -636,7 +678,7 @@ static uint32 EMU_CALL resampler(
       if(irq_state && irq_state->offset - sample->block_addr < 16 && irq_triggered_cycle == 0xFFFFFFFF) {
         irq_triggered_cycle = s;
       }
-      decode_sample_block(ram, memmax, sample, 1);
+      decode_sample_block(ram, memmax, cache, sample, 1);
       s += phase_inc * 28;
       ph -= 0x1C000;
     }
@@ -652,7 +694,7 @@ static uint32 EMU_CALL resampler(
         if(irq_state && irq_state->offset - sample->block_addr < 16 && irq_triggered_cycle == 0xFFFFFFFF) {
           irq_triggered_cycle = t;
         }
-        decode_sample_block(ram, memmax, sample, 0);
+        decode_sample_block(ram, memmax, cache, sample, 0);
         ph -= 0x1C000;
       }
       source_signal = sample->array + (ph >> 12);
@@ -687,6 +729,7 @@ static uint32 EMU_CALL resampler(
 static uint32 EMU_CALL resampler_modulated(
   uint16 *ram,
   uint32 memmax,
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
   struct SPUCORE_SAMPLE *sample,
   sint32 *dest,
   uint32 n,
@@ -710,7 +753,7 @@ static uint32 EMU_CALL resampler_modulated(
         if(irq_state && irq_state->offset - sample->block_addr < 16 && irq_triggered_cycle == 0xFFFFFFFF) {
           irq_triggered_cycle = t;
         }
-        decode_sample_block(ram, memmax, sample, 1);
+        decode_sample_block(ram, memmax, cache, sample, 1);
         ph -= 0x1C000;
       }
       t += pimod;
@@ -725,7 +768,7 @@ static uint32 EMU_CALL resampler_modulated(
         if(irq_state && irq_state->offset - sample->block_addr < 16 && irq_triggered_cycle == 0xFFFFFFFF) {
           irq_triggered_cycle = t;
         }
-        decode_sample_block(ram, memmax, sample, 0);
+        decode_sample_block(ram, memmax, cache, sample, 0);
         ph -= 0x1C000;
       }
       source_signal = sample->array + (ph >> 12);
@@ -1087,6 +1130,7 @@ static int EMU_CALL enveloper(
 static int EMU_CALL render_channel_raw(
   uint16 *ram,
   uint32 memmax,
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
   struct SPUCORE_CHAN *c,
   sint32 *buf,
   sint32 *fmbuf,
@@ -1098,8 +1142,8 @@ static int EMU_CALL render_channel_raw(
   /* If the envelope is dead, don't bother anyway */
   if((c->env.state) == ENVELOPE_STATE_OFF) return 0;
   /* Do resampling */
-  if (fmbuf) r = resampler_modulated(ram, memmax, &(c->sample), buf, r, c->voice_pitch, fmbuf, irq_state);
-  else r = resampler(ram, memmax, &(c->sample), buf, r, c->voice_pitch, irq_state);
+  if (fmbuf) r = resampler_modulated(ram, memmax, cache, &(c->sample), buf, r, c->voice_pitch, fmbuf, irq_state);
+  else r = resampler(ram, memmax, cache, &(c->sample), buf, r, c->voice_pitch, irq_state);
   if(nbuf) {
     r = samples;
     if(buf) memcpy(buf, nbuf, 4 * r);
@@ -1122,6 +1166,7 @@ static int EMU_CALL render_channel_raw(
 static int EMU_CALL render_channel_mono(
   uint16 *ram,
   uint32 memmax,
+  struct SPUCORE_BLOCK_CACHE_ENTRY *cache,
   struct SPUCORE_CHAN *c,
   sint32 *buf,
   sint32 *fmbuf,
@@ -1142,7 +1187,7 @@ static int EMU_CALL render_channel_mono(
   n = c->samples_until_pending_keyon;
 
   if(!n) {
-    return render_channel_raw(ram, memmax, c, buf, fmbuf, nbuf, samples, irq_state);
+    return render_channel_raw(ram, memmax, cache, c, buf, fmbuf, nbuf, samples, irq_state);
   }
 
   //
@@ -1159,7 +1204,7 @@ static int EMU_CALL render_channel_mono(
   /*
   ** r = how many samples we actually will process
   */
-  r = render_channel_raw(ram, memmax, c, buf, fmbuf, nbuf, n, irq_state);
+  r = render_channel_raw(ram, memmax, cache, c, buf, fmbuf, nbuf, n, irq_state);
 
   defer_remaining = c->samples_until_pending_keyon;
   if(buf) {
@@ -1203,7 +1248,7 @@ static int EMU_CALL render_channel_mono(
       s = &spare_state;
       spare_state.offset = irq_state->offset;
     }
-    r2 = render_channel_raw(ram, memmax, c, buf, fmbuf, nbuf, samples, s);
+    r2 = render_channel_raw(ram, memmax, cache, c, buf, fmbuf, nbuf, samples, s);
 	if(irq_state && irq_state->triggered_cycle == 0xFFFFFFFF && spare_state.triggered_cycle != 0xFFFFFFFF) irq_state->triggered_cycle = spare_state.triggered_cycle + r * 768;
   }
 
@@ -1753,7 +1798,7 @@ static void EMU_CALL render(struct SPUCORE_STATE *state, uint16 *ram, sint16 *bu
     sint32 *noise = (chanbit & masknoise) ? ibufn : NULL;
     if(!(main_l | main_r | verb_l | verb_r)) b = NULL;
     r = render_channel_mono(
-      ram, state->memsize, state->chan + ch, b, fm, noise, samples, irq_state_ptr
+      ram, state->memsize, state->block_cache, state->chan + ch, b, fm, noise, samples, irq_state_ptr
     );
     if(!b) {
       memset(ibuffm, 0, 4 * samples);
@@ -2124,7 +2169,8 @@ uint32 EMU_CALL spucore_cycles_until_interrupt(void *state, uint16 *ram, uint32
 
   backup = malloc(spucore_get_state_size());
   if (!backup) return 0xFFFFFFFF;
-  memcpy(backup, state, spucore_get_state_size());
+  /* nothing is decoded while fast-forwarding, so leave the block cache behind */
+  memcpy(backup, state, offsetof(struct SPUCORE_STATE, block_cache));
   state = backup;
   SPUCORESTATE->irq_triggered_cycle = 0xFFFFFFFF;
   r = 0;
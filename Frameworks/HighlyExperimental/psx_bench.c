@@ -0,0 +1,387 @@
+// Renders PlayStation sound through the PSX core twice, once with every
+// instruction interpreted and once through the R3000 block cache, then
+// reports the time of each pass and whether the two outputs and the final
+// RAM match. Not part of the project, build it by hand from this directory
+// (psx.h includes <HighlyExperimental/emuconfig.h>, which the framework build
+// exports):
+//
+// mkdir -p /tmp/he && ln -sf $PWD/HighlyExperimental/Core /tmp/he/HighlyExperimental
+// cc -O2 -DEMU_COMPILE -DEMU_LITTLE_ENDIAN -DHAVE_STDINT_H -I/tmp/he
+//    -IHighlyExperimental/Core -I../psflib -I../../Plugins/HighlyComplete/HighlyComplete
+//    -o psx_bench psx_bench.c HighlyExperimental/Core/{psx,iop,ioptimer,r3000,spu,spucore,bios,vfs}.c
+//    ../psflib/psflib/psflib.c -lz
+//
+// ./psx_bench [-t seconds] [file.psf|file.minipsf ...]
+//
+// Without files, it renders two synthetic drivers that fill SPU RAM with a
+// looping sample, key it on and then walk a table, multiply and bend the
+// pitch forever; one keeps its table in a page of its own, the other right
+// behind its code, where every store throws out the blocks of that page.
+//
+// To time the block cache from before it tracked code pages, build a second
+// binary against the earlier sources; both must render identical output:
+//
+// mkdir -p /tmp/he_old
+// for f in r3000.c r3000.h iop.c; do git show c546a96:Frameworks/HighlyExperimental/HighlyExperimental/Core/$f > /tmp/he_old/$f; done
+// cc -O2 -DEMU_COMPILE -DEMU_LITTLE_ENDIAN -DHAVE_STDINT_H -I/tmp/he
+//    -IHighlyExperimental/Core -I../psflib -I../../Plugins/HighlyComplete/HighlyComplete
+//    -o psx_bench_old psx_bench.c HighlyExperimental/Core/{psx,ioptimer,spu,spucore,bios,vfs}.c
+//    /tmp/he_old/{r3000,iop}.c ../psflib/psflib/psflib.c -lz
+
+#include "HighlyExperimental/Core/psx.h"
+#include "HighlyExperimental/Core/iop.h"
+#include "HighlyExperimental/Core/r3000.h"
+#include "HighlyExperimental/Core/bios.h"
+
+#include <psflib/psflib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "hebios.h"
+
+static const uint32_t sample_rate = 44100;
+static const uint32_t samples_per_call = 1024;
+
+static void *stdio_fopen(const char *path) {
+	return fopen(path, "rb");
+}
+
+static size_t stdio_fread(void *buffer, size_t size, size_t count, void *handle) {
+	return fread(buffer, size, count, (FILE *)handle);
+}
+
+static int stdio_fseek(void *handle, int64_t offset, int whence) {
+	return fseek((FILE *)handle, (long)offset, whence);
+}
+
+static int stdio_fclose(void *handle) {
+	return fclose((FILE *)handle);
+}
+
+static long stdio_ftell(void *handle) {
+	return ftell((FILE *)handle);
+}
+
+static psf_file_callbacks stdio_callbacks = {
+	"\\/:",
+	stdio_fopen,
+	stdio_fread,
+	stdio_fseek,
+	stdio_fclose,
+	stdio_ftell
+};
+
+static uint32_t get_le32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void set_le32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+// Same upload as psf1_loader in HighlyComplete's HCDecoder.mm
+struct psf1_load_state {
+	void *emu;
+	int first;
+	uint32_t refresh;
+};
+
+static int psf1_loader(void *context, const uint8_t *exe, size_t exe_size,
+                       const uint8_t *reserved, size_t reserved_size) {
+	struct psf1_load_state *state = (struct psf1_load_state *)context;
+
+	if(exe_size < 0x800) return -1;
+
+	uint32_t addr = get_le32(exe + 0x18);
+	uint32_t size = (uint32_t)(exe_size - 0x800);
+
+	addr &= 0x1fffff;
+	if((addr < 0x10000) || (size > 0x1f0000) || (addr + size > 0x200000)) return -1;
+
+	void *iop = psx_get_iop_state(state->emu);
+	iop_upload_to_ram(iop, addr, exe + 0x800, size);
+
+	if(!state->refresh) {
+		if(!strncasecmp((const char *)exe + 113, "Japan", 5))
+			state->refresh = 60;
+		else if(!strncasecmp((const char *)exe + 113, "Europe", 6))
+			state->refresh = 50;
+		else if(!strncasecmp((const char *)exe + 113, "North America", 13))
+			state->refresh = 60;
+	}
+
+	if(state->first) {
+		void *r3000 = iop_get_r3000_state(iop);
+		r3000_setreg(r3000, R3000_REG_PC, get_le32(exe + 0x10));
+		r3000_setreg(r3000, R3000_REG_GEN + 29, get_le32(exe + 0x30));
+		state->first = 0;
+	}
+
+	return 0;
+}
+
+// Instruction encoding for the synthetic drivers
+enum { ZERO = 0, T0 = 8, T1, T2, T3, T4, T5, T6, S0 = 16, S1, S2, RA = 31 };
+
+#define OP_R(s, t, d, h, f) (((s) << 21) | ((t) << 16) | ((d) << 11) | ((h) << 6) | (f))
+#define OP_I(op, s, t, i) (((uint32_t)(op) << 26) | ((s) << 21) | ((t) << 16) | ((i) & 0xFFFF))
+#define OP_J(op, a) (((uint32_t)(op) << 26) | (((a) >> 2) & 0x3FFFFFF))
+
+#define LUI(t, i) OP_I(0x0F, 0, t, i)
+#define ORI(t, s, i) OP_I(0x0D, s, t, i)
+#define ANDI(t, s, i) OP_I(0x0C, s, t, i)
+#define ADDIU(t, s, i) OP_I(0x09, s, t, i)
+#define LW(t, i, s) OP_I(0x23, s, t, i)
+#define SW(t, i, s) OP_I(0x2B, s, t, i)
+#define SH(t, i, s) OP_I(0x29, s, t, i)
+#define BNE(s, t, i) OP_I(0x05, s, t, i)
+#define ADDU(d, s, t) OP_R(s, t, d, 0, 0x21)
+#define SRL(d, t, h) OP_R(0, t, d, h, 0x02)
+#define MULT(s, t) OP_R(s, t, 0, 0, 0x18)
+#define MULTU(s, t) OP_R(s, t, 0, 0, 0x19)
+#define MFLO(d) OP_R(0, 0, d, 0, 0x12)
+#define JR(s) OP_R(s, 0, 0, 0, 0x08)
+#define J(a) OP_J(0x02, a)
+#define JAL(a) OP_J(0x03, a)
+#define NOP 0
+
+static const uint32_t text_start = 0x80010000;
+
+// PS-X EXE for the synthetic runs, with its table at data
+static uint8_t *make_synthetic_program(uint32_t data, size_t *size) {
+	uint32_t code[96];
+	uint32_t n = 0;
+	uint32_t fill, put, main_loop, loop, sub;
+
+	// SPU on, volumes up, voice 0 playing from 0x1000 in SPU RAM
+	code[n++] = LUI(S0, 0x1F80);
+	code[n++] = ORI(S0, S0, 0x1C00);
+	code[n++] = ORI(T0, ZERO, 0xC000);
+	code[n++] = SH(T0, 0x1AA, S0);
+	code[n++] = ORI(T0, ZERO, 0x3FFF);
+	code[n++] = SH(T0, 0x180, S0);
+	code[n++] = SH(T0, 0x182, S0);
+	code[n++] = SH(T0, 0x000, S0);
+	code[n++] = SH(T0, 0x002, S0);
+	code[n++] = ORI(T0, ZERO, 0x1000);
+	code[n++] = SH(T0, 0x004, S0);
+	code[n++] = ORI(T0, ZERO, 0x1000 >> 3);
+	code[n++] = SH(T0, 0x006, S0);
+	code[n++] = SH(T0, 0x00E, S0);
+	code[n++] = SH(T0, 0x1A6, S0);
+	code[n++] = ORI(T0, ZERO, 0x000F);
+	code[n++] = SH(T0, 0x008, S0);
+	code[n++] = SH(ZERO, 0x00A, S0);
+
+	// 256 ADPCM blocks of noise through the transfer FIFO, the last one looping
+	code[n++] = LUI(T1, 0x1234);
+	code[n++] = ORI(T2, ZERO, 2048);
+	code[n++] = LUI(T5, 0x41C6);
+	code[n++] = ORI(T5, T5, 0x4E6D);
+	fill = n;
+	code[n++] = MULTU(T1, T5);
+	code[n++] = MFLO(T1);
+	code[n++] = ADDIU(T1, T1, 12345);
+	code[n++] = SRL(T3, T1, 16);
+	code[n++] = ANDI(T4, T2, 7);
+	put = n + 5;
+	code[n] = BNE(T4, ZERO, put - n - 1); n++;
+	code[n++] = ORI(T4, ZERO, 8);
+	code[n] = BNE(T2, T4, put - n - 1); n++;
+	code[n++] = ORI(T3, ZERO, 0x0004);
+	code[n++] = ORI(T3, ZERO, 0x0304);
+	code[n++] = SH(T3, 0x1A8, S0);
+	code[n++] = ADDIU(T2, T2, -1);
+	code[n] = BNE(T2, ZERO, fill - n - 1); n++;
+	code[n++] = NOP;
+	code[n++] = ORI(T0, ZERO, 1);
+	code[n++] = SH(T0, 0x188, S0);
+
+	// Table walk, then a subroutine bending the pitch and counting ticks
+	code[n++] = LUI(S2, data >> 16);
+	code[n++] = ORI(S2, S2, data & 0xFFFF);
+	main_loop = n;
+	code[n++] = ADDU(S1, S2, ZERO);
+	code[n++] = ORI(T2, ZERO, 64);
+	loop = n;
+	code[n++] = LW(T3, 0, S1);
+	code[n++] = ADDIU(S1, S1, 4);
+	code[n++] = MULT(T3, T6);
+	code[n++] = MFLO(T5);
+	code[n++] = ADDU(T6, T6, T5);
+	code[n++] = ADDIU(T6, T6, 1);
+	code[n++] = SW(T6, -4, S1);
+	code[n++] = ADDIU(T2, T2, -1);
+	code[n] = BNE(T2, ZERO, loop - n - 1); n++;
+	code[n++] = NOP;
+	sub = n + 4;
+	code[n++] = JAL(text_start + sub * 4);
+	code[n++] = NOP;
+	code[n++] = J(text_start + main_loop * 4);
+	code[n++] = NOP;
+	code[n++] = SRL(T0, T6, 20);
+	code[n++] = ANDI(T0, T0, 0x1FFF);
+	code[n++] = ADDIU(T0, T0, 0x400);
+	code[n++] = SH(T0, 0x004, S0);
+	code[n++] = LW(T1, 0x100, S2);
+	code[n++] = ADDIU(T1, T1, 1);
+	code[n++] = JR(RA);
+	code[n++] = SW(T1, 0x100, S2);
+
+	const uint32_t text_size = 0x10000;
+	uint8_t *exe = (uint8_t *)calloc(0x800 + text_size, 1);
+	memcpy(exe, "PS-X EXE", 8);
+	set_le32(exe + 0x10, text_start);
+	set_le32(exe + 0x18, text_start);
+	set_le32(exe + 0x1C, text_size);
+	set_le32(exe + 0x30, 0x801FFF00);
+	strcpy((char *)exe + 113, "North America");
+	for(uint32_t i = 0; i < n; i++) {
+		set_le32(exe + 0x800 + i * 4, code[i]);
+	}
+	for(uint32_t i = 0; i < 64; i++) {
+		set_le32(exe + 0x800 + (data - text_start) + i * 4, i * 0x9E3779B9);
+	}
+	*size = 0x800 + text_size;
+	return exe;
+}
+
+static int load_psf(void *state, const char *path) {
+	struct psf1_load_state load;
+	load.emu = state;
+	load.first = 1;
+	load.refresh = 0;
+	if(psf_load(path, &stdio_callbacks, 1, psf1_loader, &load, 0, 0, 0) <= 0) return -1;
+	if(load.refresh) psx_set_refresh(state, load.refresh);
+	return 0;
+}
+
+// Renders sample_count stereo samples into out and sums the RAM into *ram_hash,
+// returns the CPU time in seconds or a negative value on error
+static double render(const char *path, const uint8_t *exe, size_t exe_size, int cache, int16_t *out, uint32_t sample_count, uint32_t *ram_hash) {
+	void *state = malloc(psx_get_state_size(1));
+	psx_clear_state(state, 1);
+
+	void *iop = psx_get_iop_state(state);
+	r3000_enable_block_cache(iop_get_r3000_state(iop), (uint8)cache);
+
+	if(path ? load_psf(state, path) : psx_upload_psxexe(state, (void *)exe, (uint32)exe_size)) {
+		free(state);
+		return -1;
+	}
+
+	double seconds = 0;
+	const clock_t begin = clock();
+	uint32_t done = 0;
+	while(done < sample_count) {
+		uint32 howmany = sample_count - done;
+		if(howmany > samples_per_call) howmany = samples_per_call;
+		if(psx_execute(state, 0x7fffffff, out + done * 2, &howmany, 0) < 0) {
+			seconds = -1;
+			break;
+		}
+		done += howmany;
+	}
+	if(seconds == 0) {
+		seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+	}
+
+	uint32_t hash = 0;
+	for(uint32_t a = 0; a < 0x200000; a += 4) {
+		hash = (hash ^ iop_getword(iop, a)) * 0x01000193;
+	}
+	*ram_hash = hash;
+
+	free(state);
+	return seconds;
+}
+
+static int bench(const char *name, const char *path, const uint8_t *exe, size_t exe_size, uint32_t seconds) {
+	const uint32_t sample_count = sample_rate * seconds;
+	int16_t *interpreted = (int16_t *)calloc(sample_count, 4);
+	int16_t *cached = (int16_t *)calloc(sample_count, 4);
+	uint32_t interpreted_ram, cached_ram;
+
+	const double interpreter_seconds = render(path, exe, exe_size, 0, interpreted, sample_count, &interpreted_ram);
+	const double cache_seconds = render(path, exe, exe_size, 1, cached, sample_count, &cached_ram);
+
+	int result = 0;
+	if(interpreter_seconds < 0 || cache_seconds < 0) {
+		printf("%-32s execution error\n", name);
+		result = 1;
+	} else {
+		uint32_t mismatches = 0, first = 0;
+		int16_t peak = 0;
+		for(uint32_t i = 0; i < sample_count * 2; i++) {
+			if(interpreted[i] != cached[i]) {
+				if(!mismatches) first = i / 2;
+				mismatches++;
+			}
+			if(abs(interpreted[i]) > peak) peak = (int16_t)abs(interpreted[i]);
+		}
+		printf("%-32s %10.1f %9.1f %8.2fx %6d ", name, seconds / interpreter_seconds, seconds / cache_seconds, interpreter_seconds / cache_seconds, peak);
+		if(mismatches) {
+			printf("%u samples differ, first at %u\n", mismatches, first);
+			result = 1;
+		} else if(interpreted_ram != cached_ram) {
+			printf("RAM differs\n");
+			result = 1;
+		} else {
+			printf("identical\n");
+		}
+	}
+
+	free(interpreted);
+	free(cached);
+	return result;
+}
+
+int main(int argc, char **argv) {
+	uint32_t seconds = 60;
+	int first_file = 1;
+	if(argc > 2 && !strcmp(argv[1], "-t")) {
+		seconds = (uint32_t)atoi(argv[2]);
+		first_file = 3;
+	}
+
+	bios_set_image(hebios, HEBIOS_SIZE);
+	if(psx_init()) {
+		fprintf(stderr, "psx_init failed\n");
+		return 1;
+	}
+
+	printf("%-32s %10s %9s %9s %6s %s\n", "track", "interp xRT", "cache xRT", "speedup", "peak", "output");
+
+	int result = 0;
+	if(first_file >= argc) {
+		size_t size;
+		uint8_t *exe = make_synthetic_program(0x80018000, &size);
+		result |= bench("(synthetic driver)", NULL, exe, size, seconds);
+		free(exe);
+		exe = make_synthetic_program(0x80010200, &size);
+		result |= bench("(synthetic, table beside code)", NULL, exe, size, seconds);
+		free(exe);
+		return result;
+	}
+
+	for(int i = first_file; i < argc; i++) {
+		if(psf_load(argv[i], &stdio_callbacks, 0, 0, 0, 0, 0, 0) != 1) {
+			printf("%-32s not a PSF file\n", argv[i]);
+			result = 1;
+			continue;
+		}
+
+		const char *name = strrchr(argv[i], '/');
+		result |= bench(name ? name + 1 : argv[i], argv[i], NULL, 0, seconds);
+	}
+
+	return result;
+}
@@ -305,3 +305,17 @@ void EMU_CALL sega_enable_dsp_dynarec(void *state, uint8 enable) {
 }
 
 /////////////////////////////////////////////////////////////////////////////
+//
+// Allocate or release executable memory for the DSP dynarec
+//
+void EMU_CALL sega_prepare_dynacode(void *state) {
+  void *yamstate = getyamstate(SEGASTATE);
+  if(yamstate) yam_prepare_dynacode(yamstate);
+}
+
+void EMU_CALL sega_unprepare_dynacode(void *state) {
+  void *yamstate = getyamstate(SEGASTATE);
+  if(yamstate) yam_unprepare_dynacode(yamstate);
+}
+
+/////////////////////////////////////////////////////////////////////////////
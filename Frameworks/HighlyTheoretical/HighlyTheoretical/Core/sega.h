@@ -95,6 +95,14 @@ void EMU_CALL sega_enable_dry(void *state, uint8 enable);
 void EMU_CALL sega_enable_dsp(void *state, uint8 enable);
 void EMU_CALL sega_enable_dsp_dynarec(void *state, uint8 enable);
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Allocate or release executable memory for the DSP dynarec
+// Call unprepare before freeing or clearing a state that was prepared
+//
+void EMU_CALL sega_prepare_dynacode(void *state);
+void EMU_CALL sega_unprepare_dynacode(void *state);
+
 /////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cplusplus
@@ -20,6 +20,7 @@
 #endif
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <math.h>
 
 #ifndef _WIN32
@@ -31,13 +32,21 @@
 #endif
 #endif
 
-/* No dynarec for x86_64 yet */
 #if defined(_WIN32) || defined(__i386__)
 #define ENABLE_DYNAREC
 #endif
 #if defined(_WIN64) || defined(__amd64__)
 #undef ENABLE_DYNAREC
 #endif
+/* x86_64 dynarec only speaks the System V calling convention */
+#if (defined(__amd64__) || defined(__x86_64__)) && !defined(_WIN32)
+#define ENABLE_DYNAREC
+#define DYNAREC_X86_64
+#endif
+
+#ifdef DYNAREC_X86_64
+#include <sys/mman.h>
+#endif
 
 // no 'conversion from _blah_ possible loss of data' warnings
 #pragma warning (disable: 4244)
@@ -359,7 +368,11 @@ static uint64 mpro_aica_read(struct MPRO *mpro) {
   return value;
 }
 
+#ifdef DYNAREC_X86_64
+#define DYNACODE_MAX_SIZE (0x10000)
+#else
 #define DYNACODE_MAX_SIZE (0x6000)
+#endif
 #define DYNACODE_SLOP_SIZE (0x80)
 
 struct YAM_STATE {
@@ -449,7 +462,9 @@ struct YAM_STATE {
   //
   // Buffer for dynarec code
   //
-#ifdef ENABLE_DYNAREC
+#ifdef DYNAREC_X86_64
+  uint8 *dynacode; // mapped by yam_prepare_dynacode
+#elif defined(ENABLE_DYNAREC)
   uint8 dynacode[DYNACODE_MAX_SIZE];
 #endif
 };
@@ -2533,7 +2548,9 @@ static void __fastcall dsp_sample_interpret(struct YAM_STATE *state) {
 #define C32(N) { *((uint32*)outp) = ((uint32)(N)); outp += 4; }
 #define C32CALL(N) { *((uint32*)outp) = ((uint32)(N)) - (((uint32)(outp))+4); outp += 4; }
 
-#define STRUCTOFS(thetype,thefield) ((uint32)(&(((struct thetype*)0)->thefield)))
+#define C64(N) { *((uint64*)outp) = ((uint64)(N)); outp += 8; }
+
+#define STRUCTOFS(thetype,thefield) ((uint32)offsetof(struct thetype,thefield))
 #define STATEOFS(thefield) STRUCTOFS(YAM_STATE,thefield)
 
 #ifdef ENABLE_DYNAREC
@@ -2561,7 +2578,327 @@ static int instruction_uses_shifted(struct MPRO *mpro) {
 // Also uses the current ringbuffer pointer and size, and ram pointer/mask/memwordxor
 // So if any of those change, the compiled dynacode must be invalidated
 //
-#ifdef ENABLE_DYNAREC
+#ifdef DYNAREC_X86_64
+//
+// x86_64 version: follows dsp_sample_interpret step for step, including
+// skipped steps and memory/input operations on every line
+//
+// Register usage (all callee-saved, so they survive the float conversion calls):
+//   rbx = state, ebp = mdec_ct, r12 = ram_ptr
+//   r13d = ACC, r14d = SHIFTED, r15d = INPUTS of the current step
+//
+static void dynacompile(struct YAM_STATE *state) {
+  // Pre-compute ringbuffer size mask
+  uint32 rbmask = (1 << ((state->rbl)+13)) - 1;
+
+  uint8 *outp = state->dynacode;
+  int i;
+  char ins_uses_acc[129];
+  char ins_uses_shifted[129];
+
+  outp += DYNACODE_SLOP_SIZE;
+  //
+  // Figure out which instructions need what things
+  // Skipped instructions replace ACC without looking at it
+  //
+  memset(ins_uses_acc, 0, sizeof(ins_uses_acc));
+  memset(ins_uses_shifted, 0, sizeof(ins_uses_shifted));
+  ins_uses_acc[128] = 1;
+  ins_uses_shifted[128] = 1;
+  for(i = 0; i < 128; i++) {
+    struct MPRO *mpro = state->mpro + i;
+    if(mpro->__kisxzbon & 0x80) { continue; }
+    ins_uses_shifted[i] = instruction_uses_shifted(mpro);
+    ins_uses_acc[i] =
+      (ins_uses_shifted[i]) ||
+      ((mpro->__kisxzbon & 0x0C) == 0x04);
+  }
+
+  //
+  // Prefix
+  //
+  C(0x53)                                                          // push rbx
+  C(0x55)                                                          // push rbp
+  C(0x41) C(0x54)                                                  // push r12
+  C(0x41) C(0x55)                                                  // push r13
+  C(0x41) C(0x56)                                                  // push r14
+  C(0x41) C(0x57)                                                  // push r15
+  C(0x48) C(0x83) C(0xEC) C(0x08)                                  // sub rsp,8 (align calls, [rsp] is scratch)
+  C(0x48) C(0x89) C(0xFB)                                          // mov rbx,rdi
+  C(0x8B) C(0xAB) C32(STATEOFS(mdec_ct))                           // mov ebp,[rbx+<OFS32:mdec_ct>]
+  C(0x4C) C(0x8B) C(0xA3) C32(STATEOFS(ram_ptr))                   // mov r12,[rbx+<OFS32:ram_ptr>]
+  C(0x44) C(0x8B) C(0xAB) C32(STATEOFS(xzbchoice[XZBCHOICE_ACC]))  // mov r13d,[rbx+<OFS32:acc>]
+  // 37 bytes
+  //
+  // Each instruction
+  //
+  for(i = 0; i < 128; i++) {
+    struct MPRO *mpro = state->mpro + i;
+    int need_acc = ins_uses_acc[i + 1];
+    int need_inputs;
+    //
+    // Skipped instruction: ACC = TEMP[MDEC_CT] * FRC_REG + TEMP[MDEC_CT]
+    //
+    if(mpro->__kisxzbon & 0x80) {
+      if(need_acc) {
+        C(0x89) C(0xE9)                                         // mov ecx,ebp
+        C(0x83) C(0xE1) C(0x7F)                                 // and ecx,7Fh
+        C(0x8B) C(0x84) C(0x8B) C32(STATEOFS(temp))             // mov eax,[rbx+rcx*4+<OFS32:temp>]
+        C(0x89) C(0xC6)                                         // mov esi,eax
+        C(0xF7) C(0xAB) C32(STATEOFS(yychoice[YYCHOICE_FRC_REG])) // imul dword ptr [rbx+<OFS32:yychoice0>]
+        C(0x0F) C(0xAC) C(0xD0) C(0x0C)                         // shrd eax,edx,12
+        C(0x01) C(0xF0)                                         // add eax,esi
+        C(0x41) C(0x89) C(0xC5)                                 // mov r13d,eax
+      }
+      // 29 bytes max
+      continue;
+    }
+    //
+    // Input read, before the input write can replace it
+    //
+    need_inputs =
+      (need_acc && (mpro->__kisxzbon & 0x10)) ||
+      (mpro->m_wrAFyyYh & 2) ||
+      ((mpro->m_wrAFyyYh & 0x20) && !(mpro->__kisxzbon & 0x40));
+    if(need_inputs) {
+      C(0x44) C(0x8B) C(0xBB) C32(STATEOFS(inputs[mpro->i_00rrrrrr])) // mov r15d,[rbx+<OFS32:INPUTS+4*IRA>]
+    }
+    // 7 bytes max
+    //
+    // If IWT is on, perform input write
+    //
+    if((mpro->i_0T0wwwww & 0x40) == 0) {
+      C(0x8B) C(0x83) C32(STATEOFS(mem_in_data[i&3]))         // mov eax,[rbx+<OFS32:memindata>]
+      C(0x89) C(0x83) C32(STATEOFS(inputs[mpro->i_0T0wwwww])) // mov [rbx+<OFS32:INPUTS+4*IWA>],eax
+    }
+    // 12 bytes max
+    //
+    // If we will be needing SHIFTED this instruction, r14d will become SHIFTED
+    //
+    if(ins_uses_shifted[i]) {
+      C(0x44) C(0x89) C(0xE8)           // mov eax,r13d
+      if(mpro->m_wrAFyyYh & 1) {
+        C(0x01) C(0xC0)                 // add eax,eax
+      }
+      if(mpro->__kisxzbon & 0x20) {
+        C(0xBA) C32(0x007FFFFF)         // mov edx,7FFFFFh
+        C(0x39) C(0xD0)                 // cmp eax,edx
+        C(0x0F) C(0x4F) C(0xC2)         // cmovg eax,edx
+        C(0xBA) C32(0xFF800000)         // mov edx,0FF800000h
+        C(0x39) C(0xD0)                 // cmp eax,edx
+        C(0x0F) C(0x4C) C(0xC2)         // cmovl eax,edx
+      }
+      C(0x41) C(0x89) C(0xC6)           // mov r14d,eax
+    }
+    // 28 bytes max
+    //
+    // If we need the accumulator next instruction, compute it (to EAX)
+    //
+    if(need_acc) {
+      int need_tra =
+        ((mpro->__kisxzbon & 0x10) == 0x00) ||
+        ((mpro->__kisxzbon & 0x0C) == 0x00);
+      if(need_tra) {
+        C(0x8D) C(0x4D) C(mpro->t_0rrrrrrr) // lea ecx,[rbp+<BYTE:TRA>]
+        C(0x83) C(0xE1) C(0x7F)             // and ecx,7Fh
+      }
+      //
+      // Load EAX with the Y value
+      //
+      switch(mpro->m_wrAFyyYh & 0x0C) {
+      case 0x00: // FRC_REG
+        C(0x8B) C(0x83) C32(STATEOFS(yychoice[YYCHOICE_FRC_REG])) // mov eax,[rbx+yychoice0]
+        break;
+      case 0x04: // COEF
+        { sint32 coef = state->coef[mpro->c_0rrrrrrr];
+          C(0xB8) C32(coef)                                       // mov eax,<SINT32:COEF>
+        }
+        break;
+      case 0x08: // Y_REG_H
+        C(0x8B) C(0x83) C32(STATEOFS(yychoice[YYCHOICE_Y_REG_H])) // mov eax,[rbx+yychoice2]
+        break;
+      case 0x0C: // Y_REG_L
+        C(0x8B) C(0x83) C32(STATEOFS(yychoice[YYCHOICE_Y_REG_L])) // mov eax,[rbx+yychoice3]
+        break;
+      }
+    }
+    // 12 bytes max
+    //
+    // If YRL is on, latch Y register (after Y was selected)
+    //
+    if(mpro->m_wrAFyyYh & 2) {
+      C(0x44) C(0x89) C(0xFA)                                   // mov edx,r15d
+      C(0xC1) C(0xFA) C(0x0B)                                   // sar edx,11
+      C(0x89) C(0x93) C32(STATEOFS(yychoice[YYCHOICE_Y_REG_H])) // mov [rbx+<OFS32:yychoice2>],edx
+      C(0x44) C(0x89) C(0xFA)                                   // mov edx,r15d
+      C(0xC1) C(0xFA) C(0x04)                                   // sar edx,4
+      C(0x81) C(0xE2) C32(0x00000FFF)                           // and edx,0FFFh
+      C(0x89) C(0x93) C32(STATEOFS(yychoice[YYCHOICE_Y_REG_L])) // mov [rbx+<OFS32:yychoice3>],edx
+    }
+    // 30 bytes max
+    if(need_acc) {
+      //
+      // Multiply by the X value
+      //
+      if((mpro->__kisxzbon & 0x10) == 0) {
+        C(0xF7) C(0xAC) C(0x8B) C32(STATEOFS(temp)) // imul dword ptr [rbx+rcx*4+<OFS32:temp>]
+      } else {
+        C(0x41) C(0xF7) C(0xEF)                     // imul r15d
+      }
+      C(0x0F) C(0xAC) C(0xD0) C(0x0C)               // shrd eax,edx,12
+      //
+      // Add B if necessary
+      //
+      if((mpro->__kisxzbon & 0x08) == 0) {
+        if(mpro->negb == 0) {
+          if((mpro->__kisxzbon & 0x04) == 0) {
+            C(0x03) C(0x84) C(0x8B) C32(STATEOFS(temp)) // add eax,[rbx+rcx*4+<OFS32:temp>]
+          } else {
+            C(0x44) C(0x01) C(0xE8)                     // add eax,r13d
+          }
+        } else {
+          if((mpro->__kisxzbon & 0x04) == 0) {
+            C(0x2B) C(0x84) C(0x8B) C32(STATEOFS(temp)) // sub eax,[rbx+rcx*4+<OFS32:temp>]
+          } else {
+            C(0x44) C(0x29) C(0xE8)                     // sub eax,r13d
+          }
+        }
+      }
+      C(0x41) C(0x89) C(0xC5)                           // mov r13d,eax
+    }
+    // 21 bytes max
+    //
+    // If TWT is on, perform the temp write of SHIFTED
+    //
+    if((mpro->t_Twwwwwww & 0x80) == 0) {
+      C(0x8D) C(0x4D) C(mpro->t_Twwwwwww)                  // lea ecx,[rbp+<BYTE:TWA>]
+      C(0x83) C(0xE1) C(0x7F)                              // and ecx,7Fh
+      C(0x44) C(0x89) C(0xB4) C(0x8B) C32(STATEOFS(temp))  // mov [rbx+rcx*4+<OFS32:temp>],r14d
+    }
+    // 14 bytes max
+    //
+    // If FRCL is set, latch it
+    //
+    if(mpro->m_wrAFyyYh & 0x10) {
+      C(0x44) C(0x89) C(0xF0)   // mov eax,r14d
+      if(mpro->__kisxzbon & 0x40) { // interpolate mode
+        C(0x25) C32(0x00000FFF) // and eax,0FFFh
+      } else { // non-interpolate mode
+        C(0xC1) C(0xF8) C(0x0B) // sar eax,11
+      }
+      C(0x89) C(0x83) C32(STATEOFS(yychoice[YYCHOICE_FRC_REG])) // mov [rbx+<OFS32:yychoice0>],eax
+    }
+    // 14 bytes max
+    //
+    // Memory operations: compute the byte offset in EAX
+    //
+    if(mpro->m_wrAFyyYh & 0xC0) {
+      uint32 madrsnx = state->madrs[mpro->m_00aaaaaa];
+      uint32 mwt_float = (mpro->m_wrAFyyYh & 0x80) && !(mpro->__kisxzbon & 0x02);
+      if(mpro->__kisxzbon & 1) { madrsnx++; }
+      if(mpro->tablemask == 0) {
+        C(0x8D) C(0x85) C32(madrsnx)                      // lea eax,[rbp+<DWORD:MADRS+NXADR>]
+      } else {
+        C(0xB8) C32(madrsnx)                              // mov eax,<DWORD:MADRS+NXADR>
+      }
+      if(mpro->adrmask != 0) {
+        C(0x03) C(0x83) C32(STATEOFS(adrs_reg))           // add eax,[rbx+<OFS32:adrs_reg>]
+      }
+      C(0x25) C32((rbmask | (sint32)(mpro->tablemask)) & 0xFFFF) // and eax,<DWORD:rblmask>
+      C(0x01) C(0xC0)                                     // add eax,eax
+      C(0x05) C32(state->rbp)                             // add eax,<DWORD:rbp>
+      C(0x25) C32(state->ram_mask)                        // and eax,<DWORD:RAMMASK>
+      if(state->mem_word_address_xor != 0) {
+        C(0x35) C32(state->mem_word_address_xor)          // xor eax,<DWORD:memwxor>
+      }
+      // 34 bytes max
+      //
+      // If MRD is set, read from [r12+rax]
+      //
+      if(mpro->m_wrAFyyYh & 0x40) {
+        if((mpro->__kisxzbon & 0x02) == 0) { // NOFL=0
+          if(mwt_float) {
+            C(0x89) C(0x04) C(0x24)                       // mov [rsp],eax
+          }
+          C(0x41) C(0x0F) C(0xBF) C(0x3C) C(0x04)         // movsx edi,word ptr [r12+rax]
+          C(0x48) C(0xB8) C64((size_t)float16_to_int24)   // mov rax,<QWORD:float16_to_int24>
+          C(0xFF) C(0xD0)                                 // call rax
+          C(0x89) C(0x83) C32(STATEOFS(mem_in_data[(i+2)&3])) // mov [rbx+<OFS32:meminptr>],eax
+          if(mwt_float) {
+            C(0x8B) C(0x04) C(0x24)                       // mov eax,[rsp]
+          }
+        } else { // NOFL=1
+          C(0x41) C(0x0F) C(0xBF) C(0x0C) C(0x04)         // movsx ecx,word ptr [r12+rax]
+          C(0xC1) C(0xE1) C(0x08)                         // shl ecx,8
+          C(0x89) C(0x8B) C32(STATEOFS(mem_in_data[(i+2)&3])) // mov [rbx+<OFS32:meminptr>],ecx
+        }
+      }
+      // 29 bytes max
+      //
+      // If MWT is set, write SHIFTED to [r12+rax]
+      //
+      if(mpro->m_wrAFyyYh & 0x80) {
+        if(mwt_float) { // NOFL=0
+          C(0x89) C(0x04) C(0x24)                         // mov [rsp],eax
+          C(0x44) C(0x89) C(0xF7)                         // mov edi,r14d
+          C(0x48) C(0xB8) C64((size_t)int24_to_float16)   // mov rax,<QWORD:int24_to_float16>
+          C(0xFF) C(0xD0)                                 // call rax
+          C(0x8B) C(0x0C) C(0x24)                         // mov ecx,[rsp]
+          C(0x66) C(0x41) C(0x89) C(0x04) C(0x0C)         // mov [r12+rcx],ax
+        } else { // NOFL=1
+          C(0x44) C(0x89) C(0xF2)                         // mov edx,r14d
+          C(0xC1) C(0xFA) C(0x08)                         // sar edx,8
+          C(0x66) C(0x41) C(0x89) C(0x14) C(0x04)         // mov [r12+rax],dx
+        }
+      }
+      // 26 bytes max
+    }
+    // 89 bytes max
+    //
+    // If ADRL is set, latch address reg
+    //
+    if(mpro->m_wrAFyyYh & 0x20) {
+      if(mpro->__kisxzbon & 0x40) { // interpolate mode
+        C(0x44) C(0x89) C(0xF0)   // mov eax,r14d
+        C(0xC1) C(0xF8) C(0x0C)   // sar eax,12
+      } else {
+        C(0x44) C(0x89) C(0xF8)   // mov eax,r15d
+        C(0xC1) C(0xF8) C(0x10)   // sar eax,16
+      }
+      C(0x25) C32(0x00000FFF)                 // and eax,0FFFh
+      C(0x89) C(0x83) C32(STATEOFS(adrs_reg)) // mov [rbx+<OFS32:adrs_reg>],eax
+    }
+    // 17 bytes max
+    //
+    // If EWT is on, perform write of EFREG
+    //
+    if((mpro->e_000Twwww & 0x10) == 0) {
+      C(0x44) C(0x89) C(0xF0)                                        // mov eax,r14d
+      C(0xC1) C(0xF8) C(0x08)                                        // sar eax,8
+      C(0x66) C(0x89) C(0x83) C32(STATEOFS(efreg[mpro->e_000Twwww])) // mov [rbx+<OFS32:EFREG+2*EWA>],ax
+    }
+    // 13 bytes max
+  }
+  // 257 bytes max per instruction
+  //
+  // Suffix
+  //
+  C(0x44) C(0x89) C(0xAB) C32(STATEOFS(xzbchoice[XZBCHOICE_ACC])) // mov [rbx+<OFS32:acc>],r13d
+  C(0x48) C(0x83) C(0xC4) C(0x08)                                 // add rsp,8
+  C(0x41) C(0x5F)                                                 // pop r15
+  C(0x41) C(0x5E)                                                 // pop r14
+  C(0x41) C(0x5D)                                                 // pop r13
+  C(0x41) C(0x5C)                                                 // pop r12
+  C(0x5D)                                                         // pop rbp
+  C(0x5B)                                                         // pop rbx
+  C(0xC3)                                                         // retn
+  // 24 bytes
+  //
+  // Set valid flag
+  //
+  state->dsp_dyna_valid = 1;
+}
+#elif defined(ENABLE_DYNAREC)
 static void dynacompile(struct YAM_STATE *state) {
   // Pre-compute ringbuffer size mask
   uint32 rbmask = (1 << ((state->rbl)+13)) - 1;
@@ -2875,7 +3212,11 @@ static void render_effects(
   sint32 eflin_r[16];
 
 #ifdef ENABLE_DYNAREC
+#ifdef DYNAREC_X86_64
+  if(state->dsp_dyna_enabled && state->dynacode) {
+#else
   if(state->dsp_dyna_enabled) {
+#endif
     if(!(state->dsp_dyna_valid)) {
       dynacompile(state);
     }
@@ -3075,6 +3416,17 @@ void EMU_CALL yam_prepare_dynacode(void *state) {
 #ifdef _WIN32
   DWORD i;
   VirtualProtect( &YAMSTATE->dynacode, sizeof(YAMSTATE->dynacode), PAGE_EXECUTE_READWRITE, &i );
+#elif defined(DYNAREC_X86_64)
+  void *code;
+  int flags = MAP_PRIVATE | MAP_ANON;
+#ifdef MAP_JIT
+  flags |= MAP_JIT;
+#endif
+  if(YAMSTATE->dynacode) { return; }
+  code = mmap(NULL, DYNACODE_MAX_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, flags, -1, 0);
+  if(code == MAP_FAILED) { return; }
+  YAMSTATE->dynacode = code;
+  YAMSTATE->dsp_dyna_valid = 0;
 #elif defined(HAVE_MPROTECT)
   unsigned long startaddr = &YAMSTATE->dynacode;
   unsigned long length    = sizeof(YAMSTATE->dynacode);
@@ -3090,6 +3442,11 @@ void EMU_CALL yam_unprepare_dynacode(void *state) {
 #ifdef _WIN32
   DWORD i;
   VirtualProtect( &YAMSTATE->dynacode, sizeof(YAMSTATE->dynacode), PAGE_READWRITE, &i );
+#elif defined(DYNAREC_X86_64)
+  if(!YAMSTATE->dynacode) { return; }
+  munmap(YAMSTATE->dynacode, DYNACODE_MAX_SIZE);
+  YAMSTATE->dynacode = NULL;
+  YAMSTATE->dsp_dyna_valid = 0;
 #elif defined(HAVE_MPROTECT)
   unsigned long startaddr = &YAMSTATE->dynacode;
   unsigned long length    = sizeof(YAMSTATE->dynacode);
@@ -0,0 +1,298 @@
+// Renders Saturn or Dreamcast sound through the Sega core twice, once with
+// the effects DSP interpreted and once through the dynarec, then reports the
+// time of each pass and whether the two outputs match. Not part of the
+// project, build it by hand from this directory (sega.h includes
+// <HighlyTheoretical/emuconfig.h>, which the framework build exports):
+//
+// mkdir -p /tmp/ht && ln -sf $PWD/HighlyTheoretical/Core /tmp/ht/HighlyTheoretical
+// cc -O2 -DEMU_COMPILE -DEMU_LITTLE_ENDIAN -DHAVE_STDINT_H -DUSE_M68K -I/tmp/ht
+//    -IHighlyTheoretical/Core -I../psflib -o sega_dsp_bench sega_dsp_bench.c
+//    HighlyTheoretical/Core/{sega,satsound,dcsound,yam,arm}.c
+//    HighlyTheoretical/Core/m68k/{m68kcpu,m68kops}.c ../psflib/psflib/psflib.c -lz
+//
+// ./sega_dsp_bench [-t seconds] [file.ssf|file.minissf|file.dsf|file.minidsf ...]
+//
+// Without files, it renders a Dreamcast state whose ARM idles in a loop while
+// a random effects program runs over a ring buffer filled with noise, so only
+// the DSP and the mixer do any work. The dynarec only exists for x86_64 and
+// i386 builds; elsewhere both passes run the interpreter.
+
+#include "HighlyTheoretical/Core/sega.h"
+#include "HighlyTheoretical/Core/dcsound.h"
+#include "HighlyTheoretical/Core/yam.h"
+
+#include <psflib/psflib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const uint32_t sample_rate = 44100;
+static const uint32_t samples_per_call = 1024;
+
+static void *stdio_fopen(const char *path) {
+	return fopen(path, "rb");
+}
+
+static size_t stdio_fread(void *buffer, size_t size, size_t count, void *handle) {
+	return fread(buffer, size, count, (FILE *)handle);
+}
+
+static int stdio_fseek(void *handle, int64_t offset, int whence) {
+	return fseek((FILE *)handle, (long)offset, whence);
+}
+
+static int stdio_fclose(void *handle) {
+	return fclose((FILE *)handle);
+}
+
+static long stdio_ftell(void *handle) {
+	return ftell((FILE *)handle);
+}
+
+static psf_file_callbacks stdio_callbacks = {
+	"\\/:",
+	stdio_fopen,
+	stdio_fread,
+	stdio_fseek,
+	stdio_fclose,
+	stdio_ftell
+};
+
+static uint32_t get_le32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void set_le32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+// Same merge as sdsf_loader in HighlyComplete's HCDecoder.mm
+struct sdsf_loader_state {
+	uint8_t *data;
+	size_t data_size;
+};
+
+static int sdsf_loader(void *context, const uint8_t *exe, size_t exe_size,
+                       const uint8_t *reserved, size_t reserved_size) {
+	if(exe_size < 4) return -1;
+
+	struct sdsf_loader_state *state = (struct sdsf_loader_state *)context;
+
+	uint8_t *dst = state->data;
+
+	if(state->data_size < 4) {
+		state->data = dst = (uint8_t *)malloc(exe_size);
+		state->data_size = exe_size;
+		memcpy(dst, exe, exe_size);
+		return 0;
+	}
+
+	uint32_t dst_start = get_le32(dst);
+	uint32_t src_start = get_le32(exe);
+	dst_start &= 0x7fffff;
+	src_start &= 0x7fffff;
+	size_t dst_len = state->data_size - 4;
+	size_t src_len = exe_size - 4;
+	if(dst_len > 0x800000) dst_len = 0x800000;
+	if(src_len > 0x800000) src_len = 0x800000;
+
+	if(src_start < dst_start) {
+		uint32_t diff = dst_start - src_start;
+		state->data_size = dst_len + 4 + diff;
+		state->data = dst = (uint8_t *)realloc(dst, state->data_size);
+		memmove(dst + 4 + diff, dst + 4, dst_len);
+		memset(dst + 4, 0, diff);
+		dst_len += diff;
+		dst_start = src_start;
+		set_le32(dst, dst_start);
+	}
+	if((src_start + src_len) > (dst_start + dst_len)) {
+		size_t diff = (src_start + src_len) - (dst_start + dst_len);
+		state->data_size = dst_len + 4 + diff;
+		state->data = dst = (uint8_t *)realloc(dst, state->data_size);
+		memset(dst + 4 + dst_len, 0, diff);
+	}
+
+	memcpy(dst + 4 + (src_start - dst_start), exe + 4, src_len);
+
+	return 0;
+}
+
+static uint32_t seed = 1;
+
+static uint32_t noise(void) {
+	seed = seed * 1664525 + 1013904223;
+	return seed;
+}
+
+// Program image for the synthetic run: "b ." in every exception vector, noise above them
+static uint8_t *make_synthetic_program(size_t *size) {
+	const size_t ram_size = 0x200000;
+	uint8_t *data = (uint8_t *)malloc(ram_size + 4);
+	set_le32(data, 0);
+	for(size_t i = 0; i < 8; i++) {
+		set_le32(data + 4 + i * 4, 0xEAFFFFFE);
+	}
+	for(size_t i = 4 + 8 * 4; i < ram_size + 4; i++) {
+		data[i] = (uint8_t)(noise() >> 24);
+	}
+	*size = ram_size + 4;
+	return data;
+}
+
+// Random effects program, mixed to the output through EFSDL
+static void program_synthetic_dsp(void *state) {
+	void *yam = dcsound_get_yam_state(sega_get_dcsound_state(state));
+	uint32_t i;
+	seed = 2;
+	// Ring buffer at 1MB, away from the idle loop
+	yam_aica_store_reg(yam, 0x2804, 0x0200, 0xFFFF, NULL);
+	yam_aica_store_reg(yam, 0x2800, 0x000F, 0xFFFF, NULL);
+	for(i = 0; i < 16; i++) {
+		yam_aica_store_reg(yam, 0x2000 + i * 4, 0x0F00 | ((i & 1) ? 0x1F : 0x0F), 0xFFFF, NULL);
+	}
+	for(i = 0; i < 128; i++) {
+		yam_aica_store_reg(yam, 0x3000 + i * 4, noise() >> 16, 0xFFFF, NULL);
+	}
+	for(i = 0; i < 64; i++) {
+		yam_aica_store_reg(yam, 0x3200 + i * 4, noise() >> 16, 0xFFFF, NULL);
+	}
+	for(i = 0; i < 128 * 4; i++) {
+		yam_aica_store_reg(yam, 0x3400 + i * 4, noise() >> 16, 0xFFFF, NULL);
+	}
+}
+
+// Renders sample_count stereo samples into out, returns the CPU time in seconds or a negative value on error
+static double render(const uint8_t *program, size_t program_size, uint8_t version, int synthetic, int dynarec, int16_t *out, uint32_t sample_count) {
+	void *state = malloc(sega_get_state_size(version));
+	sega_clear_state(state, version);
+
+	sega_enable_dry(state, 1);
+	sega_enable_dsp(state, 1);
+	if(dynarec) {
+		sega_enable_dsp_dynarec(state, 1);
+		sega_prepare_dynacode(state);
+	} else {
+		sega_enable_dsp_dynarec(state, 0);
+	}
+
+	uint32_t start = get_le32(program);
+	size_t length = program_size;
+	const size_t max_length = (version == 2) ? 0x800000 : 0x80000;
+	if((start + (length - 4)) > max_length) {
+		length = max_length - start + 4;
+	}
+	sega_upload_program(state, (void *)program, (uint32_t)length);
+
+	if(synthetic) {
+		program_synthetic_dsp(state);
+	}
+
+	double seconds = 0;
+	const clock_t begin = clock();
+	uint32_t done = 0;
+	while(done < sample_count) {
+		uint32_t howmany = sample_count - done;
+		if(howmany > samples_per_call) howmany = samples_per_call;
+		if(sega_execute(state, 0x7fffffff, out + done * 2, &howmany) < 0) {
+			seconds = -1;
+			break;
+		}
+		done += howmany;
+	}
+	if(seconds == 0) {
+		seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+	}
+
+	if(dynarec) {
+		sega_unprepare_dynacode(state);
+	}
+	free(state);
+	return seconds;
+}
+
+static int bench(const char *name, const uint8_t *program, size_t program_size, uint8_t version, int synthetic, uint32_t seconds) {
+	const uint32_t sample_count = sample_rate * seconds;
+	int16_t *interpreted = (int16_t *)calloc(sample_count, 4);
+	int16_t *recompiled = (int16_t *)calloc(sample_count, 4);
+
+	const double interpreter_seconds = render(program, program_size, version, synthetic, 0, interpreted, sample_count);
+	const double dynarec_seconds = render(program, program_size, version, synthetic, 1, recompiled, sample_count);
+
+	int result = 0;
+	if(interpreter_seconds < 0 || dynarec_seconds < 0) {
+		printf("%-32s execution error\n", name);
+		result = 1;
+	} else {
+		uint32_t mismatches = 0, first = 0;
+		int16_t peak = 0;
+		for(uint32_t i = 0; i < sample_count * 2; i++) {
+			if(interpreted[i] != recompiled[i]) {
+				if(!mismatches) first = i / 2;
+				mismatches++;
+			}
+			if(abs(interpreted[i]) > peak) peak = (int16_t)abs(interpreted[i]);
+		}
+		printf("%-32s %10.1f %11.1f %8.2fx %6d ", name, seconds / interpreter_seconds, seconds / dynarec_seconds, interpreter_seconds / dynarec_seconds, peak);
+		if(mismatches) {
+			printf("%u samples differ, first at %u\n", mismatches, first);
+			result = 1;
+		} else {
+			printf("identical\n");
+		}
+	}
+
+	free(interpreted);
+	free(recompiled);
+	return result;
+}
+
+int main(int argc, char **argv) {
+	uint32_t seconds = 60;
+	int first_file = 1;
+	if(argc > 2 && !strcmp(argv[1], "-t")) {
+		seconds = (uint32_t)atoi(argv[2]);
+		first_file = 3;
+	}
+
+	if(sega_init()) {
+		fprintf(stderr, "sega_init failed\n");
+		return 1;
+	}
+
+	printf("%-32s %10s %11s %9s %6s %s\n", "track", "interp xRT", "dynarec xRT", "speedup", "peak", "output");
+
+	int result = 0;
+	if(first_file >= argc) {
+		size_t size;
+		uint8_t *program = make_synthetic_program(&size);
+		result |= bench("(synthetic AICA program)", program, size, 2, 1, seconds);
+		free(program);
+		return result;
+	}
+
+	for(int i = first_file; i < argc; i++) {
+		struct sdsf_loader_state state;
+		memset(&state, 0, sizeof(state));
+
+		const int type = psf_load(argv[i], &stdio_callbacks, 0, 0, 0, 0, 0, 0);
+		if((type != 0x11 && type != 0x12) || psf_load(argv[i], &stdio_callbacks, (uint8_t)type, sdsf_loader, &state, 0, 0, 0) <= 0) {
+			printf("%-32s not an SSF or DSF file\n", argv[i]);
+			free(state.data);
+			result = 1;
+			continue;
+		}
+
+		const char *name = strrchr(argv[i], '/');
+		result |= bench(name ? name + 1 : argv[i], state.data, state.data_size, (uint8_t)(type - 0x10), 0, seconds);
+		free(state.data);
+	}
+
+	return result;
+}
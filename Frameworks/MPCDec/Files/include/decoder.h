@@ -55,6 +55,14 @@ enum {
     MPC_DECODER_MEMSIZE = 16384,  // overall buffer size
 };
 
+/// instruction sets for the synthesis filter, see mpc_decoder_set_synth_simd
+enum {
+    MPC_SYNTH_SIMD_NONE = 0,
+    MPC_SYNTH_SIMD_SSE2,
+    MPC_SYNTH_SIMD_AVX,
+    MPC_SYNTH_SIMD_NEON,
+};
+
 struct mpc_decoder_t {
     /// @name internal state variables
     //@{
@@ -68,6 +76,7 @@ struct mpc_decoder_t {
 	mpc_uint64_t decoded_samples;    ///< Number of samples decoded from file begining
 	mpc_uint32_t samples_to_skip;    ///< Number samples to skip (used for seeking)
 	mpc_int32_t last_max_band;       ///< number of bands used in the last frame
+	mpc_int32_t synth_simd;          ///< Instruction set of the synthesis filter (MPC_SYNTH_SIMD_*)
 
     // randomizer state variables
     mpc_uint32_t  __r1;
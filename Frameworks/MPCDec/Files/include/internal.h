@@ -99,6 +99,7 @@ static mpc_inline mpc_status mpc_check_key(char * key)
 mpc_uint32_t mpc_random_int(mpc_decoder *d); // in synth_filter.c
 void mpc_decoder_init_quant(mpc_decoder *d, double scale_factor);
 void mpc_decoder_synthese_filter_float(mpc_decoder *d, MPC_SAMPLE_FORMAT* OutData, mpc_int_t channels);
+mpc_int_t mpc_decoder_set_synth_simd(mpc_decoder *d, mpc_int_t simd); // in synth_filter.c, returns the set in use
 
 #define MPC_IS_FAILURE(X) ((int)(X) < (int)MPC_STATUS_OK)
 #define MPC_AUTO_FAIL(X) { mpc_status s = (X); if (MPC_IS_FAILURE(s)) return s; }
@@ -97,6 +97,7 @@ void mpc_decoder_setup(mpc_decoder *d)
 	d->__r2 = 1;
 
 	mpc_decoder_init_quant(d, 1.0f);
+	mpc_decoder_set_synth_simd(d, MPC_SYNTH_SIMD_NEON); // the best the cpu can do
 }
 
 void mpc_decoder_set_streaminfo(mpc_decoder *d, mpc_streaminfo *si)
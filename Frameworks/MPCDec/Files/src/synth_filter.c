@@ -37,8 +37,32 @@
 #include <string.h>
 #include <mpcdec/mpcdec.h>
 #include "decoder.h"
+#include "internal.h"
 #include "mpcdec_math.h"
 
+// vectorised synthesis, float builds only
+#ifndef MPC_FIXED_POINT
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_X64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MPC_SYNTH_SSE2
+#if defined(_MSC_VER) || defined(__clang__) || defined(__GNUC__)
+#include <immintrin.h>
+#define MPC_SYNTH_AVX
+#endif
+#endif
+#ifdef __APPLE__
+#include <TargetConditionals.h>
+#if TARGET_CPU_ARM || TARGET_CPU_ARM64
+#define MPC_SYNTH_NEON
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MPC_SYNTH_NEON
+#endif
+#ifdef MPC_SYNTH_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 /* C O N S T A N T S */
 #define MPC_FIXED_POINT_SYNTH_FIX 2
 
@@ -354,9 +378,303 @@ mpc_synthese_filter_float_internal(MPC_SAMPLE_FORMAT* p_out, MPC_SAMPLE_FORMAT*
     }
 }
 
+#ifdef MPC_SYNTH_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#define xgetbv(a) _xgetbv(a)
+#elif defined(__clang__) || defined(__GNUC__)
+static mpc_inline void __cpuidex(int *data, int selector, int subselector)
+{
+#if defined(__PIC__) && defined(__i386__)
+    __asm("xchgl %%ebx, %%esi; cpuid; xchgl %%ebx, %%esi"
+          : "=a"(data[0]), "=S"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#elif defined(__PIC__) && defined(__amd64__)
+    __asm("xchg{q} {%%}rbx, %q1; cpuid; xchg{q} {%%}rbx, %q1"
+          : "=a"(data[0]), "=&r"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#else
+    __asm("cpuid"
+          : "=a"(data[0]), "=b"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#endif
+}
+#define __cpuid(a, b) __cpuidex((a), (b), 0)
+
+static mpc_inline unsigned long long xgetbv(unsigned int index)
+{
+    unsigned int eax, edx;
+    // xgetbv, spelled out for assemblers which do not know it
+    __asm(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((unsigned long long)edx << 32) | eax;
+}
+#else
+#define __cpuid(a, b) memset((a), 0, sizeof(int) * 4)
+#define xgetbv(a) 0
+#endif
+
+static int
+mpc_cpu_has_sse2(void)
+{
+    int buffer[4];
+    __cpuid(buffer, 1);
+    return (buffer[3] & (1 << 26)) != 0;
+}
+
+#ifdef MPC_SYNTH_AVX
+static int
+mpc_cpu_has_avx(void)
+{
+    int buffer[4];
+    __cpuid(buffer, 1);
+    // AVX, and the OS saving the YMM registers on context switches
+    if ((buffer[2] & (1 << 27)) == 0 || (buffer[2] & (1 << 28)) == 0)
+        return 0;
+    return (xgetbv(0) & 6) == 6;
+}
+#endif
+#endif
+
+#if defined(MPC_SYNTH_SSE2) || defined(MPC_SYNTH_NEON)
+#define MPC_SYNTH_SIMD
+
+#undef _
+#define _(value)  MAKE_MPC_SAMPLE((double)value/(double)(0x10000))
+
+/// Di_opt transposed: Di_opt_T[j][k] = Di_opt[k][j], so that the windowing
+/// can load the coefficients of consecutive outputs k in one go
+static const MPC_SAMPLE_FORMAT  Di_opt_T [16] [32] = {
+    { _(  0), _( -1), _( -1), _( -1), _( -1), _( -1), _( -1), _( -2), _( -2), _( -2), _( -2), _( -3), _( -3), _( -4), _( -4), _( -5),
+      _( -5), _( -6), _( -7), _( -7), _( -8), _( -9), _(-10), _(-11), _(-13), _(-14), _(-16), _(-17), _(-19), _(-21), _(-24), _(-26) },
+    { _( -29), _( -31), _( -35), _( -38), _( -41), _( -45), _( -49), _( -53), _( -58), _( -63), _( -68), _( -73), _( -79), _( -85), _( -91), _( -97),
+      _(-104), _(-111), _(-117), _(-125), _(-132), _(-139), _(-147), _(-154), _(-161), _(-169), _(-176), _(-183), _(-190), _(-196), _(-202), _(-208) },
+    { _( 213), _( 218), _( 222), _( 225), _( 227), _( 228), _( 228), _( 227), _( 224), _( 221), _( 215), _( 208), _( 200), _( 189), _( 177), _( 163),
+      _( 146), _( 127), _( 106), _(  83), _(  57), _(  29), _(  -2), _( -36), _( -72), _(-111), _(-153), _(-197), _(-244), _(-294), _(-347), _(-401) },
+    { _( -459), _( -519), _( -581), _( -645), _( -711), _( -779), _( -848), _( -919), _( -991), _(-1064), _(-1137), _(-1210), _(-1283), _(-1356), _(-1428), _(-1498),
+      _(-1567), _(-1634), _(-1698), _(-1759), _(-1817), _(-1870), _(-1919), _(-1962), _(-2001), _(-2032), _(-2057), _(-2075), _(-2085), _(-2087), _(-2080), _(-2063) },
+    { _( 2037), _( 2000), _( 1952), _( 1893), _( 1822), _( 1739), _( 1644), _( 1535), _( 1414), _( 1280), _( 1131), _(  970), _(  794), _(  605), _(  402), _(  185),
+      _(  -45), _( -288), _( -545), _( -814), _(-1095), _(-1388), _(-1692), _(-2006), _(-2330), _(-2663), _(-3004), _(-3351), _(-3705), _(-4063), _(-4425), _(-4788) },
+    { _(-5153), _(-5517), _(-5879), _(-6237), _(-6589), _(-6935), _(-7271), _(-7597), _(-7910), _(-8209), _(-8491), _(-8755), _(-8998), _(-9219), _(-9416), _(-9585),
+      _(-9727), _(-9838), _(-9916), _(-9959), _(-9966), _(-9935), _(-9863), _(-9750), _(-9592), _(-9389), _(-9139), _(-8840), _(-8492), _(-8092), _(-7640), _(-7134) },
+    { _(  6574), _(  5959), _(  5288), _(  4561), _(  3776), _(  2935), _(  2037), _(  1082), _(    70), _(  -998), _( -2122), _( -3300), _( -4533), _( -5818), _( -7154), _( -8540),
+      _( -9975), _(-11455), _(-12980), _(-14548), _(-16155), _(-17799), _(-19478), _(-21189), _(-22929), _(-24694), _(-26482), _(-28289), _(-30112), _(-31947), _(-33791), _(-35640) },
+    { _(-37489), _(-39336), _(-41176), _(-43006), _(-44821), _(-46617), _(-48390), _(-50137), _(-51853), _(-53534), _(-55178), _(-56778), _(-58333), _(-59838), _(-61289), _(-62684),
+      _(-64019), _(-65290), _(-66494), _(-67629), _(-68692), _(-69679), _(-70590), _(-71420), _(-72169), _(-72835), _(-73415), _(-73908), _(-74313), _(-74630), _(-74856), _(-74992) },
+    { _(75038), _(74992), _(74856), _(74630), _(74313), _(73908), _(73415), _(72835), _(72169), _(71420), _(70590), _(69679), _(68692), _(67629), _(66494), _(65290),
+      _(64019), _(62684), _(61289), _(59838), _(58333), _(56778), _(55178), _(53534), _(51853), _(50137), _(48390), _(46617), _(44821), _(43006), _(41176), _(39336) },
+    { _(37489), _(35640), _(33791), _(31947), _(30112), _(28289), _(26482), _(24694), _(22929), _(21189), _(19478), _(17799), _(16155), _(14548), _(12980), _(11455),
+      _( 9975), _( 8540), _( 7154), _( 5818), _( 4533), _( 3300), _( 2122), _(  998), _(  -70), _(-1082), _(-2037), _(-2935), _(-3776), _(-4561), _(-5288), _(-5959) },
+    { _(6574), _(7134), _(7640), _(8092), _(8492), _(8840), _(9139), _(9389), _(9592), _(9750), _(9863), _(9935), _(9966), _(9959), _(9916), _(9838),
+      _(9727), _(9585), _(9416), _(9219), _(8998), _(8755), _(8491), _(8209), _(7910), _(7597), _(7271), _(6935), _(6589), _(6237), _(5879), _(5517) },
+    { _( 5153), _( 4788), _( 4425), _( 4063), _( 3705), _( 3351), _( 3004), _( 2663), _( 2330), _( 2006), _( 1692), _( 1388), _( 1095), _(  814), _(  545), _(  288),
+      _(   45), _( -185), _( -402), _( -605), _( -794), _( -970), _(-1131), _(-1280), _(-1414), _(-1535), _(-1644), _(-1739), _(-1822), _(-1893), _(-1952), _(-2000) },
+    { _(2037), _(2063), _(2080), _(2087), _(2085), _(2075), _(2057), _(2032), _(2001), _(1962), _(1919), _(1870), _(1817), _(1759), _(1698), _(1634),
+      _(1567), _(1498), _(1428), _(1356), _(1283), _(1210), _(1137), _(1064), _( 991), _( 919), _( 848), _( 779), _( 711), _( 645), _( 581), _( 519) },
+    { _( 459), _( 401), _( 347), _( 294), _( 244), _( 197), _( 153), _( 111), _(  72), _(  36), _(   2), _( -29), _( -57), _( -83), _(-106), _(-127),
+      _(-146), _(-163), _(-177), _(-189), _(-200), _(-208), _(-215), _(-221), _(-224), _(-227), _(-228), _(-228), _(-227), _(-225), _(-222), _(-218) },
+    { _(213), _(208), _(202), _(196), _(190), _(183), _(176), _(169), _(161), _(154), _(147), _(139), _(132), _(125), _(117), _(111),
+      _(104), _( 97), _( 91), _( 85), _( 79), _( 73), _( 68), _( 63), _( 58), _( 53), _( 49), _( 45), _( 41), _( 38), _( 35), _( 31) },
+    { _(29), _(26), _(24), _(21), _(19), _(17), _(16), _(14), _(13), _(11), _(10), _( 9), _( 8), _( 7), _( 7), _( 6),
+      _( 5), _( 5), _( 4), _( 4), _( 3), _( 3), _( 2), _( 2), _( 2), _( 2), _( 1), _( 1), _( 1), _( 1), _( 1), _( 1) }
+};
+
+#undef  _
+
+/// The vectorised synthesis is built from synth_filter_simd.inc once for each
+/// instruction set, out of these primitives. SYNTH_WIDTH floats make a
+/// SYNTH_VEC, SYNTH_TRANSPOSE transposes SYNTH_WIDTH of them in place, and
+/// SYNTH_STORE_STEREO interleaves two of them into the output.
+#define SYNTH_PASTE(a, b) a##_##b
+#define SYNTH_EVALUATE(a, b) SYNTH_PASTE(a, b)
+#define SYNTH_FN(name) SYNTH_EVALUATE(name, SYNTH_SIMD)
+#define SYNTH_SCALE(X,Y) SYNTH_MUL(X, SYNTH_SET1(Y))
+
+#ifdef MPC_SYNTH_SSE2
+static mpc_inline void
+synth_transpose_sse2(__m128* r)
+{
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+}
+
+static mpc_inline void
+synth_store_stereo_sse2(MPC_SAMPLE_FORMAT* p, __m128 l, __m128 r)
+{
+    _mm_storeu_ps(p,     _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(l, r));
+}
+
+#define SYNTH_SIMD            sse2
+#define SYNTH_TARGET
+#define SYNTH_WIDTH           4
+#define SYNTH_VEC             __m128
+#define SYNTH_LOAD            _mm_loadu_ps
+#define SYNTH_STORE           _mm_storeu_ps
+#define SYNTH_SET1            _mm_set1_ps
+#define SYNTH_ZERO            _mm_setzero_ps
+#define SYNTH_ADD             _mm_add_ps
+#define SYNTH_SUB             _mm_sub_ps
+#define SYNTH_MUL             _mm_mul_ps
+#define SYNTH_NEG(X)          _mm_xor_ps(X, _mm_set1_ps(-0.0f))
+#define SYNTH_TRANSPOSE       synth_transpose_sse2
+#define SYNTH_STORE_STEREO    synth_store_stereo_sse2
+#include "synth_filter_simd.inc"
+#endif
+
+#ifdef MPC_SYNTH_AVX
+#ifdef _MSC_VER
+#define MPC_SYNTH_AVX_TARGET
+#else
+#define MPC_SYNTH_AVX_TARGET __attribute__((target("avx")))
+#endif
+
+MPC_SYNTH_AVX_TARGET
+static mpc_inline void
+synth_transpose_avx(__m256* r)
+{
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44), s1 = _mm256_shuffle_ps(t0, t2, 0xee);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44), s3 = _mm256_shuffle_ps(t1, t3, 0xee);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44), s5 = _mm256_shuffle_ps(t4, t6, 0xee);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44), s7 = _mm256_shuffle_ps(t5, t7, 0xee);
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+MPC_SYNTH_AVX_TARGET
+static mpc_inline void
+synth_store_stereo_avx(MPC_SAMPLE_FORMAT* p, __m256 l, __m256 r)
+{
+    __m256 lo = _mm256_unpacklo_ps(l, r), hi = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(p,     _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+#define SYNTH_SIMD            avx
+#define SYNTH_TARGET          MPC_SYNTH_AVX_TARGET
+#define SYNTH_WIDTH           8
+#define SYNTH_VEC             __m256
+#define SYNTH_LOAD            _mm256_loadu_ps
+#define SYNTH_STORE           _mm256_storeu_ps
+#define SYNTH_SET1            _mm256_set1_ps
+#define SYNTH_ZERO            _mm256_setzero_ps
+#define SYNTH_ADD             _mm256_add_ps
+#define SYNTH_SUB             _mm256_sub_ps
+#define SYNTH_MUL             _mm256_mul_ps
+#define SYNTH_NEG(X)          _mm256_xor_ps(X, _mm256_set1_ps(-0.0f))
+#define SYNTH_TRANSPOSE       synth_transpose_avx
+#define SYNTH_STORE_STEREO    synth_store_stereo_avx
+#include "synth_filter_simd.inc"
+#endif
+
+#ifdef MPC_SYNTH_NEON
+static mpc_inline void
+synth_transpose_neon(float32x4_t* r)
+{
+    float32x4x2_t t0 = vtrnq_f32(r[0], r[1]), t1 = vtrnq_f32(r[2], r[3]);
+    r[0] = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0]));
+    r[1] = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1]));
+    r[2] = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0]));
+    r[3] = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1]));
+}
+
+static mpc_inline void
+synth_store_stereo_neon(MPC_SAMPLE_FORMAT* p, float32x4_t l, float32x4_t r)
+{
+    float32x4x2_t lr;
+    lr.val[0] = l;
+    lr.val[1] = r;
+    vst2q_f32(p, lr);
+}
+
+// vmulq/vaddq rather than vmlaq/vfmaq, to round like the other sets
+#define SYNTH_SIMD            neon
+#define SYNTH_TARGET
+#define SYNTH_WIDTH           4
+#define SYNTH_VEC             float32x4_t
+#define SYNTH_LOAD            vld1q_f32
+#define SYNTH_STORE           vst1q_f32
+#define SYNTH_SET1            vdupq_n_f32
+#define SYNTH_ZERO()          vdupq_n_f32(0.0f)
+#define SYNTH_ADD             vaddq_f32
+#define SYNTH_SUB             vsubq_f32
+#define SYNTH_MUL             vmulq_f32
+#define SYNTH_NEG             vnegq_f32
+#define SYNTH_TRANSPOSE       synth_transpose_neon
+#define SYNTH_STORE_STEREO    synth_store_stereo_neon
+#include "synth_filter_simd.inc"
+#endif
+#endif
+
+mpc_int_t
+mpc_decoder_set_synth_simd(mpc_decoder* p_dec, mpc_int_t simd)
+{
+    mpc_int_t simd_max = MPC_SYNTH_SIMD_NONE;
+
+#ifdef MPC_SYNTH_NEON
+    simd_max = MPC_SYNTH_SIMD_NEON;
+#endif
+#ifdef MPC_SYNTH_SSE2
+    if (mpc_cpu_has_sse2()) {
+        simd_max = MPC_SYNTH_SIMD_SSE2;
+#ifdef MPC_SYNTH_AVX
+        if (mpc_cpu_has_avx())
+            simd_max = MPC_SYNTH_SIMD_AVX;
+#endif
+    }
+#endif
+
+    if (simd > simd_max)
+        simd = simd_max;
+    // NEON sorts after the x86 sets, which ARM builds do not have
+#ifndef MPC_SYNTH_AVX
+    if (simd == MPC_SYNTH_SIMD_AVX)
+        simd = MPC_SYNTH_SIMD_SSE2;
+#endif
+#ifndef MPC_SYNTH_SSE2
+    if (simd == MPC_SYNTH_SIMD_SSE2)
+        simd = MPC_SYNTH_SIMD_NONE;
+#endif
+    if (simd < MPC_SYNTH_SIMD_NONE)
+        simd = MPC_SYNTH_SIMD_NONE;
+
+    return p_dec->synth_simd = simd;
+}
+
 void
 mpc_decoder_synthese_filter_float(mpc_decoder* p_dec, MPC_SAMPLE_FORMAT* p_out, mpc_int_t channels)
 {
+#ifdef MPC_SYNTH_SIMD
+    // the vectorised versions interleave at most two channels
+    if (channels <= 2) {
+        switch (p_dec->synth_simd) {
+#ifdef MPC_SYNTH_SSE2
+        case MPC_SYNTH_SIMD_SSE2:
+            mpc_decoder_synthese_filter_sse2(p_dec, p_out, channels);
+            return;
+#endif
+#ifdef MPC_SYNTH_AVX
+        case MPC_SYNTH_SIMD_AVX:
+            mpc_decoder_synthese_filter_avx(p_dec, p_out, channels);
+            return;
+#endif
+#ifdef MPC_SYNTH_NEON
+        case MPC_SYNTH_SIMD_NEON:
+            mpc_decoder_synthese_filter_neon(p_dec, p_out, channels);
+            return;
+#endif
+        }
+    }
+#endif
+
     /********* left channel ********/
     memmove(&p_dec->V_L[MPC_V_MEM], p_dec->V_L, 960 * sizeof *p_dec->V_L);
 	mpc_synthese_filter_float_internal(p_out, &p_dec->V_L[MPC_V_MEM], p_dec->Y_L[0], channels);
@@ -0,0 +1,196 @@
+// Decode time of Musepack SV7 and SV8 files with the synthesis filter built
+// for each instruction set the current CPU can run, checking the output
+// against the plain C filter. Not part of the project, build it by hand:
+//
+// cc -O2 -IFiles/include -o synth_filter_bench synth_filter_bench.c Files/src/*.c -lm
+//
+// ./synth_filter_bench [file.mpc ...]
+//
+// Without files it times the synthesis filter alone, on ten minutes of
+// random stereo subband samples.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mpcdec/mpcdec.h>
+#include "decoder.h"
+#include "internal.h"
+
+static const char *const simd_names[] = {"c", "sse2", "avx", "neon"};
+
+enum { SIMD_COUNT = MPC_SYNTH_SIMD_NEON + 1 };
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, int simd, double seconds, double audio,
+                   const MPC_SAMPLE_FORMAT *out, const MPC_SAMPLE_FORMAT *ref,
+                   size_t count) {
+    double max_diff = 0;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        double diff = fabs(out[i] - ref[i]);
+        if (diff > max_diff)
+            max_diff = diff;
+    }
+    printf("%-24s %-6s %10.1f %12.1f %12g %s\n", name, simd_names[simd],
+           seconds * 1000.0, audio / seconds, max_diff,
+           out == ref ? "reference"
+                      : memcmp(out, ref, count * sizeof(*out)) ? "differs" : "same");
+}
+
+/* Decodes the whole file with the given set, returns the number of samples
+   (counting each channel) or -1 when the set is not available */
+static long decode_file(const char *filename, int simd, MPC_SAMPLE_FORMAT **out,
+                        double *seconds, mpc_streaminfo *si) {
+    MPC_SAMPLE_FORMAT buffer[MPC_DECODER_BUFFER_LENGTH];
+    size_t size = 0, alloc = 0;
+    mpc_reader reader;
+    mpc_demux *demux;
+    mpc_frame_info frame;
+    double start;
+
+    if (mpc_reader_init_stdio(&reader, filename) != MPC_STATUS_OK)
+        return -2;
+    demux = mpc_demux_init(&reader);
+    if (!demux) {
+        mpc_reader_exit_stdio(&reader);
+        return -2;
+    }
+    mpc_demux_get_info(demux, si);
+
+    if (mpc_decoder_set_synth_simd(demux->d, simd) != simd) {
+        mpc_demux_exit(demux);
+        mpc_reader_exit_stdio(&reader);
+        return -1;
+    }
+
+    *out = NULL;
+    frame.buffer = buffer;
+    start = now();
+    for (;;) {
+        size_t count;
+        if (mpc_demux_decode(demux, &frame) != MPC_STATUS_OK || frame.bits == -1)
+            break;
+        count = frame.samples * si->channels;
+        if (size + count > alloc) {
+            alloc = (size + count) * 2;
+            *out = realloc(*out, alloc * sizeof(**out));
+        }
+        memcpy(*out + size, buffer, count * sizeof(*buffer));
+        size += count;
+    }
+    *seconds = now() - start;
+
+    mpc_demux_exit(demux);
+    mpc_reader_exit_stdio(&reader);
+    return (long)size;
+}
+
+static int bench_file(const char *filename) {
+    MPC_SAMPLE_FORMAT *ref = NULL, *out;
+    long ref_count = 0, count;
+    mpc_streaminfo si;
+    double seconds;
+    char name[32];
+    int simd;
+
+    for (simd = 0; simd < SIMD_COUNT; simd++) {
+        count = decode_file(filename, simd, &out, &seconds, &si);
+        if (count == -2) {
+            fprintf(stderr, "Cannot decode %s\n", filename);
+            return 1;
+        }
+        if (count < 0)
+            continue;
+        if (!simd) {
+            ref = out;
+            ref_count = count;
+        }
+        snprintf(name, sizeof(name), "%.20s SV%u", strrchr(filename, '/') ? strrchr(filename, '/') + 1 : filename,
+                 si.stream_version);
+        report(name, simd, seconds, (double)count / si.channels / si.sample_freq, out, ref,
+               count == ref_count ? (size_t)count : 0);
+        if (count != ref_count)
+            printf("%-24s %-6s length %ld instead of %ld\n", "", simd_names[simd], count, ref_count);
+        if (out != ref)
+            free(out);
+    }
+    free(ref);
+    return 0;
+}
+
+static void bench_synthetic(void) {
+    enum { FRAMES = 44100 * 600 / MPC_FRAME_LENGTH };
+    mpc_decoder *decoders[SIMD_COUNT];
+    MPC_SAMPLE_FORMAT *outs[SIMD_COUNT];
+    double seconds[SIMD_COUNT] = {0};
+    mpc_uint32_t seed = 1;
+    int simd, frame, i;
+
+    for (simd = 0; simd < SIMD_COUNT; simd++) {
+        decoders[simd] = calloc(1, sizeof(mpc_decoder));
+        outs[simd] = malloc(MPC_FRAME_LENGTH * 2 * sizeof(MPC_SAMPLE_FORMAT));
+        if (mpc_decoder_set_synth_simd(decoders[simd], simd) != simd) {
+            free(decoders[simd]);
+            decoders[simd] = NULL;
+        }
+    }
+
+    // every set decodes the same frames, compare them as they come
+    for (frame = 0; frame < FRAMES; frame++) {
+        MPC_SAMPLE_FORMAT Y[2][36][32];
+        for (i = 0; i < 2 * 36 * 32; i++) {
+            seed = seed * 1664525 + 1013904223;
+            (&Y[0][0][0])[i] = ((mpc_int32_t)seed >> 8) * (1.0f / (1 << 23)) * (1 + (i & 31)) / 32;
+        }
+        for (simd = 0; simd < SIMD_COUNT; simd++) {
+            mpc_decoder *d = decoders[simd];
+            double start;
+            if (!d)
+                continue;
+            memcpy(d->Y_L, Y[0], sizeof(d->Y_L));
+            memcpy(d->Y_R, Y[1], sizeof(d->Y_R));
+            start = now();
+            mpc_decoder_synthese_filter_float(d, outs[simd], 2);
+            seconds[simd] += now() - start;
+            if (simd && decoders[0] && memcmp(outs[simd], outs[0], MPC_FRAME_LENGTH * 2 * sizeof(MPC_SAMPLE_FORMAT))) {
+                double max_diff = 0;
+                for (i = 0; i < MPC_FRAME_LENGTH * 2; i++)
+                    if (fabs(outs[simd][i] - outs[0][i]) > max_diff)
+                        max_diff = fabs(outs[simd][i] - outs[0][i]);
+                printf("%-6s differs in frame %d by up to %g\n", simd_names[simd], frame, max_diff);
+                free(decoders[simd]);
+                decoders[simd] = NULL;
+            }
+        }
+    }
+
+    for (simd = 0; simd < SIMD_COUNT; simd++) {
+        if (decoders[simd])
+            printf("%-24s %-6s %10.1f %12.1f %12s %s\n", "synthesis only", simd_names[simd],
+                   seconds[simd] * 1000.0, FRAMES * (double)MPC_FRAME_LENGTH / 44100 / seconds[simd], "-",
+                   simd ? "same" : "reference");
+        free(decoders[simd]);
+        free(outs[simd]);
+    }
+}
+
+int main(int argc, char **argv) {
+    int i, result = 0;
+
+    printf("%-24s %-6s %10s %12s %12s %s\n", "stream", "simd", "ms", "x realtime", "max diff", "output");
+
+    if (argc < 2)
+        bench_synthetic();
+    for (i = 1; i < argc; i++)
+        result |= bench_file(argv[i]);
+
+    return result;
+}
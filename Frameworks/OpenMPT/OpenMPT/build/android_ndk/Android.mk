@@ -157,6 +157,7 @@ LOCAL_SRC_FILES += \
 	soundlib/MIDIMacros.cpp \
 	soundlib/MixerLoops.cpp \
 	soundlib/MixerSettings.cpp \
+	soundlib/MixerThreadPool.cpp \
 	soundlib/MixFuncTable.cpp \
 	soundlib/ModChannel.cpp \
 	soundlib/modcommand.cpp \
@@ -173,6 +174,7 @@ LOCAL_SRC_FILES += \
 	soundlib/pattern.cpp \
 	soundlib/RowVisitor.cpp \
 	soundlib/S3MTools.cpp \
+	soundlib/SampleDecodeQueue.cpp \
 	soundlib/SampleFormats.cpp \
 	soundlib/SampleFormatBRR.cpp \
 	soundlib/SampleFormatFLAC.cpp \
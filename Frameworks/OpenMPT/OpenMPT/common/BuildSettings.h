@@ -168,7 +168,7 @@
 #else
 //#define MPT_ENABLE_CHARSET_LOCALE
 #endif
-// Do not use architecture-specifid intrinsics in library builds. There is just about no codepath which would use it anyway.
+// Architecture-specific intrinsics are opt-in for library builds. They are used by the mixer interpolation kernels and the reverb.
 //#define MPT_ENABLE_ARCH_INTRINSICS
 #if defined(MPT_BUILD_HACK_ARCHIVE_SUPPORT)
 //#define NO_ARCHIVE_SUPPORT
@@ -231,6 +231,7 @@
 
 #define MPT_ENABLE_ARCH_INTRINSICS_SSE
 #define MPT_ENABLE_ARCH_INTRINSICS_SSE2
+#define MPT_ENABLE_ARCH_INTRINSICS_AVX2
 
 #elif MPT_COMPILER_MSVC && defined(_M_X64)
 
@@ -238,6 +239,22 @@
 
 #define MPT_ENABLE_ARCH_INTRINSICS_SSE
 #define MPT_ENABLE_ARCH_INTRINSICS_SSE2
+#define MPT_ENABLE_ARCH_INTRINSICS_AVX2
+
+#elif (MPT_COMPILER_GCC || MPT_COMPILER_CLANG) && (MPT_ARCH_X86 || MPT_ARCH_AMD64)
+
+#if defined(__SSE__)
+#define MPT_ENABLE_ARCH_INTRINSICS_SSE
+#endif
+#if defined(__SSE2__)
+#define MPT_ENABLE_ARCH_INTRINSICS_SSE2
+// Code using AVX2 is compiled with a target attribute and only used after checking CPUID, see IntMixerSIMD.h
+#define MPT_ENABLE_ARCH_INTRINSICS_AVX2
+#endif
+
+#elif (MPT_COMPILER_GCC || MPT_COMPILER_CLANG) && (MPT_ARCH_AARCH64 || (MPT_ARCH_ARM && defined(__ARM_NEON)))
+
+#define MPT_ENABLE_ARCH_INTRINSICS_NEON
 
 #endif // arch
 #endif // MPT_ENABLE_ARCH_INTRINSICS
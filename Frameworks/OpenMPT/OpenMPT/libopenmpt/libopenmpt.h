@@ -1417,7 +1417,12 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *          - load.skip_patterns (boolean): Set to "1" to avoid loading patterns into memory
  *          - load.skip_plugins (boolean): Set to "1" to avoid loading plugins
  *          - load.skip_subsongs_init (boolean): Set to "1" to avoid pre-initializing sub-songs. Skipping results in faster module loading but slower seeking.
+ *          - load.sample_decoding (text): Set how compressed sample data (IT 2.14 / 2.15 samples and MO3 samples using delta or Ogg Vorbis compression) is decoded. This ctl only has an effect when passed as an initial ctl when loading the module.
+ *                         - "serial": Decode all samples on the loading thread while loading the module. This is the default.
+ *                         - "parallel": Decode all samples on several threads while loading the module.
+ *                         - "deferred": Decode samples on a background thread after the module has been loaded. Samples that are played before they have been decoded are decoded by the thread calling openmpt_module_read. Memory for the decoded samples is reserved while loading the module.
  *          - seek.sync_samples (boolean): Set to "0" to not sync sample playback when using openmpt_module_set_position_seconds or openmpt_module_set_position_order_row.
+ *          - seek.checkpoint_interval (integer): Set to a number of rows n to keep a snapshot of the playback state every n rows while seeking with openmpt_module_set_position_seconds or openmpt_module_set_position_order_row. Later seeks resume from the closest snapshot instead of simulating the song from its start again, at the cost of memory. "0" (the default) disables snapshots.
  *          - subsong (integer): The current subsong. Setting it has identical semantics as openmpt_module_select_subsong(), getting it returns the currently selected subsong.
  *          - play.at_end (text): Chooses the behaviour when the end of song is reached. The song end is considered to be reached after the number of reptitions set by openmpt_module_set_repeat_count was played, so if the song is set to repeat infinitely, its end is never considered to be reached.
  *                         - "fadeout": Fades the module out for a short while. Subsequent reads after the fadeout will return 0 rendered frames.
@@ -1432,6 +1437,7 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *                    - "a1200": Amiga A1200 filter.
  *                    - "unfiltered": BLEP synthesis without model-specific filters. The LED filter is ignored by this setting. This filter mode is considered to be experimental and might change in the future.
  *          - render.opl.volume_factor (floatingpoint): Set volume factor applied to synthesized OPL sounds, relative to the default OPL volume.
+ *          - render.mixer.threads (integer): Set the number of threads that sample channels are mixed on. "1" (the default) mixes all channels on the thread calling openmpt_module_read. Values greater than "1" distribute the channels of modules with many active channels over additional worker threads. The output is identical to mixing on a single thread. Values are clamped to the range [1, 16]. This setting is ignored on platforms without thread support.
  *          - dither (integer): Set the dither algorithm that is used for the 16 bit versions of openmpt_module_read. Supported values are:
  *                    - 0: No dithering.
  *                    - 1: Default mode. Chosen by OpenMPT code, might change.
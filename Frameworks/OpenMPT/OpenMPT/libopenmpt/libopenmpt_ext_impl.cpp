@@ -147,6 +147,7 @@ namespace openmpt {
 		}
 		m_sndFile->m_nTempoFactor = mpt::saturate_round<uint32_t>( 65536.0 / factor );
 		m_sndFile->RecalculateSamplesPerTick();
+		m_sndFile->ClearSeekCheckpoints();
 	}
 
 	double module_ext_impl::get_tempo_factor( ) const {
@@ -199,6 +200,7 @@ namespace openmpt {
 		}
 		m_sndFile->ChnSettings[channel].dwFlags.set( OpenMPT::CHN_MUTE | OpenMPT::CHN_SYNCMUTE , mute );
 		m_sndFile->m_PlayState.Chn[channel].dwFlags.set( OpenMPT::CHN_MUTE | OpenMPT::CHN_SYNCMUTE , mute );
+		m_sndFile->ClearSeekCheckpoints();
 
 		// Also update NNA channels
 		for ( OpenMPT::CHANNELINDEX i = m_sndFile->GetNumChannels(); i < OpenMPT::MAX_CHANNELS; i++)
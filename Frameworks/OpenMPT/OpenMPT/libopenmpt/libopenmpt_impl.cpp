@@ -482,6 +482,11 @@ void module_impl::load( const OpenMPT::FileCursor & file, const std::map< std::s
 		if ( m_ctl_load_skip_plugins ) {
 			load_flags &= ~(OpenMPT::CSoundFile::loadPluginData | OpenMPT::CSoundFile::loadPluginInstance);
 		}
+		if ( m_ctl_load_sample_decoding == sample_decoding_mode::parallel ) {
+			load_flags |= OpenMPT::CSoundFile::loadSamplesParallel;
+		} else if ( m_ctl_load_sample_decoding == sample_decoding_mode::deferred ) {
+			load_flags |= OpenMPT::CSoundFile::loadSamplesDeferred;
+		}
 		if ( !m_sndFile->Create( file, static_cast<OpenMPT::CSoundFile::ModLoadingFlags>( load_flags ) ) ) {
 			throw openmpt::exception("error loading file");
 		}
@@ -1640,7 +1645,9 @@ std::pair<const module_impl::ctl_info *, const module_impl::ctl_info *> module_i
 		{ "load.skip_patterns", ctl_type::boolean },
 		{ "load.skip_plugins", ctl_type::boolean },
 		{ "load.skip_subsongs_init", ctl_type::boolean },
+		{ "load.sample_decoding", ctl_type::text },
 		{ "seek.sync_samples", ctl_type::boolean },
+		{ "seek.checkpoint_interval", ctl_type::integer },
 		{ "subsong", ctl_type::integer },
 		{ "play.tempo_factor", ctl_type::floatingpoint },
 		{ "play.pitch_factor", ctl_type::floatingpoint },
@@ -1648,6 +1655,7 @@ std::pair<const module_impl::ctl_info *, const module_impl::ctl_info *> module_i
 		{ "render.resampler.emulate_amiga", ctl_type::boolean },
 		{ "render.resampler.emulate_amiga_type", ctl_type::text },
 		{ "render.opl.volume_factor", ctl_type::floatingpoint },
+		{ "render.mixer.threads", ctl_type::integer },
 		{ "dither", ctl_type::integer }
 	};
 	return std::make_pair(std::begin(ctl_infos), std::end(ctl_infos));
@@ -1779,6 +1787,10 @@ std::int64_t module_impl::ctl_get_integer( std::string_view ctl, bool throw_if_u
 	}
 	if ( ctl == "" ) {
 		throw openmpt::exception("empty ctl");
+	} else if ( ctl == "seek.checkpoint_interval" ) {
+		return m_sndFile->GetSeekCheckpointInterval();
+	} else if ( ctl == "render.mixer.threads" ) {
+		return m_sndFile->GetMixerThreads();
 	} else if ( ctl == "subsong" ) {
 		return get_selected_subsong();
 	} else if ( ctl == "dither" ) {
@@ -1860,6 +1872,17 @@ std::string module_impl::ctl_get_text( std::string_view ctl, bool throw_if_unkno
 	}
 	if ( ctl == "" ) {
 		throw openmpt::exception("empty ctl");
+	} else if ( ctl == "load.sample_decoding" ) {
+		switch ( m_ctl_load_sample_decoding ) {
+			case sample_decoding_mode::serial:
+				return "serial";
+			case sample_decoding_mode::parallel:
+				return "parallel";
+			case sample_decoding_mode::deferred:
+				return "deferred";
+			default:
+				return std::string();
+		}
 	} else if ( ctl == "play.at_end" ) {
 		switch ( m_ctl_play_at_end )
 		{
@@ -2007,6 +2030,10 @@ void module_impl::ctl_set_integer( std::string_view ctl, std::int64_t value, boo
 
 	if ( ctl == "" ) {
 		throw openmpt::exception("empty ctl: := " + mpt::format_value_default<std::string>( value ) );
+	} else if ( ctl == "seek.checkpoint_interval" ) {
+		m_sndFile->SetSeekCheckpointInterval( mpt::saturate_cast<OpenMPT::ROWINDEX>( std::max( value, std::int64_t( 0 ) ) ) );
+	} else if ( ctl == "render.mixer.threads" ) {
+		m_sndFile->SetMixerThreads( mpt::saturate_cast<std::uint32_t>( std::max( value, std::int64_t( 1 ) ) ) );
 	} else if ( ctl == "subsong" ) {
 		select_subsong( mpt::saturate_cast<std::int32_t>( value ) );
 	} else if ( ctl == "dither" ) {
@@ -2056,6 +2083,7 @@ void module_impl::ctl_set_floatingpoint( std::string_view ctl, double value, boo
 		}
 		m_sndFile->m_nTempoFactor = mpt::saturate_round<uint32_t>( 65536.0 / factor );
 		m_sndFile->RecalculateSamplesPerTick();
+		m_sndFile->ClearSeekCheckpoints();
 	} else if ( ctl == "play.pitch_factor" ) {
 		if ( !is_loaded() ) {
 			return;
@@ -2099,6 +2127,16 @@ void module_impl::ctl_set_text( std::string_view ctl, std::string_view value, bo
 
 	if ( ctl == "" ) {
 		throw openmpt::exception("empty ctl: := " + std::string( value ) );
+	} else if ( ctl == "load.sample_decoding" ) {
+		if ( value == "serial" ) {
+			m_ctl_load_sample_decoding = sample_decoding_mode::serial;
+		} else if ( value == "parallel" ) {
+			m_ctl_load_sample_decoding = sample_decoding_mode::parallel;
+		} else if ( value == "deferred" ) {
+			m_ctl_load_sample_decoding = sample_decoding_mode::deferred;
+		} else {
+			throw openmpt::exception( "invalid sample decoding mode" );
+		}
 	} else if ( ctl == "play.at_end" ) {
 		if ( value == "fadeout" ) {
 			m_ctl_play_at_end = song_end_action::fadeout_song;
@@ -118,6 +118,12 @@ protected:
 		stop_song,
 	};
 
+	enum class sample_decoding_mode {
+		serial,
+		parallel,
+		deferred,
+	};
+
 	static constexpr std::int32_t all_subsongs = -1;
 
 	enum class ctl_type {
@@ -147,6 +153,7 @@ protected:
 	bool m_ctl_load_skip_patterns;
 	bool m_ctl_load_skip_plugins;
 	bool m_ctl_load_skip_subsongs_init;
+	sample_decoding_mode m_ctl_load_sample_decoding = sample_decoding_mode::serial;
 	bool m_ctl_seek_sync_samples;
 	std::vector<std::string> m_loaderMessages;
 public:
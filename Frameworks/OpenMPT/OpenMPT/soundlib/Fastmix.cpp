@@ -20,6 +20,7 @@
 #include "Sndfile.h"
 #include "MixerLoops.h"
 #include "MixFuncTable.h"
+#include "MixerThreadPool.h"
 #include "plugins/PlugInterface.h"
 #include <cfloat>  // For FLT_EPSILON
 #include <algorithm>
@@ -305,8 +306,6 @@ struct MixLoopState
 // Render count * number of channels samples
 void CSoundFile::CreateStereoMix(int count)
 {
-	mixsample_t *pOfsL, *pOfsR;
-
 	if(!count)
 		return;
 
@@ -316,221 +315,395 @@ void CSoundFile::CreateStereoMix(int count)
 		StereoFill(MixRearBuffer, count, m_surroundROfsVol, m_surroundLOfsVol);
 
 	CHANNELINDEX nchmixed = 0;
-
-	for(uint32 nChn = 0; nChn < m_nMixChannels; nChn++)
+	if(CanMixInParallel())
+	{
+		nchmixed = CreateStereoMixParallel(count);
+	} else
 	{
-		ModChannel &chn = m_PlayState.Chn[m_PlayState.ChnMix[nChn]];
+		for(CHANNELINDEX nChn = 0; nChn < m_nMixChannels; nChn++)
+		{
+			ModChannel &chn = m_PlayState.Chn[m_PlayState.ChnMix[nChn]];
 
-		if(!chn.pCurrentSample && !chn.nLOfs && !chn.nROfs)
-			continue;
+			if(!chn.pCurrentSample && !chn.nLOfs && !chn.nROfs)
+				continue;
 
-		pOfsR = &m_dryROfsVol;
-		pOfsL = &m_dryLOfsVol;
+			const MixerChannelTarget target = GetChannelMixTarget(nChn, count);
+			nchmixed += MixChannel(chn, target, count, nchmixed >= m_MixerSettings.m_nMaxMixChannels);
+		}
+	}
+	m_nMixStat = std::max(m_nMixStat, nchmixed);
+}
 
-		uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
-		if(chn.dwFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
-		if(chn.dwFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
-#ifndef NO_FILTER
-		if(chn.dwFlags[CHN_FILTER]) functionNdx |= MixFuncTable::ndxFilter;
-#endif
 
-		mixsample_t *pbuffer = MixSoundBuffer;
+// Find the buffer that a channel should be mixed into, and prepare it for mixing if it hasn't been used during this tick yet.
+MixerChannelTarget CSoundFile::GetChannelMixTarget(CHANNELINDEX mixIndex, int count)
+{
+	const ModChannel &chn = m_PlayState.Chn[m_PlayState.ChnMix[mixIndex]];
+
+	MixerChannelTarget target;
+	target.mixIndex = mixIndex;
+	target.buffer = MixSoundBuffer;
+	target.ofsR = &m_dryROfsVol;
+	target.ofsL = &m_dryLOfsVol;
+
 #ifndef NO_REVERB
-		if(((m_MixerSettings.DSPMask & SNDDSP_REVERB) && !chn.dwFlags[CHN_NOREVERB]) || chn.dwFlags[CHN_REVERB])
-		{
-			m_Reverb.TouchReverbSendBuffer(ReverbSendBuffer, m_RvbROfsVol, m_RvbLOfsVol, count);
-			pbuffer = ReverbSendBuffer;
-			pOfsR = &m_RvbROfsVol;
-			pOfsL = &m_RvbLOfsVol;
-		}
+	if(((m_MixerSettings.DSPMask & SNDDSP_REVERB) && !chn.dwFlags[CHN_NOREVERB]) || chn.dwFlags[CHN_REVERB])
+	{
+		m_Reverb.TouchReverbSendBuffer(ReverbSendBuffer, m_RvbROfsVol, m_RvbLOfsVol, count);
+		target.buffer = ReverbSendBuffer;
+		target.ofsR = &m_RvbROfsVol;
+		target.ofsL = &m_RvbLOfsVol;
+	}
 #endif
-		if(chn.dwFlags[CHN_SURROUND] && m_MixerSettings.gnChannels > 2)
-		{
-			pbuffer = MixRearBuffer;
-			pOfsR = &m_surroundROfsVol;
-			pOfsL = &m_surroundLOfsVol;
-		}
+	if(chn.dwFlags[CHN_SURROUND] && m_MixerSettings.gnChannels > 2)
+	{
+		target.buffer = MixRearBuffer;
+		target.ofsR = &m_surroundROfsVol;
+		target.ofsL = &m_surroundLOfsVol;
+	}
 
-		//Look for plugins associated with this implicit tracker channel.
+	//Look for plugins associated with this implicit tracker channel.
 #ifndef NO_PLUGINS
-		PLUGINDEX nMixPlugin = GetBestPlugin(m_PlayState, m_PlayState.ChnMix[nChn], PrioritiseInstrument, RespectMutes);
+	PLUGINDEX nMixPlugin = GetBestPlugin(m_PlayState, m_PlayState.ChnMix[mixIndex], PrioritiseInstrument, RespectMutes);
 
-		if ((nMixPlugin > 0) && (nMixPlugin <= MAX_MIXPLUGINS) && m_MixPlugins[nMixPlugin - 1].pMixPlugin != nullptr)
+	if ((nMixPlugin > 0) && (nMixPlugin <= MAX_MIXPLUGINS) && m_MixPlugins[nMixPlugin - 1].pMixPlugin != nullptr)
+	{
+		target.plugin = nMixPlugin;
+		// Render into plugin buffer instead of global buffer
+		SNDMIXPLUGINSTATE &mixState = m_MixPlugins[nMixPlugin - 1].pMixPlugin->m_MixState;
+		if (mixState.pMixBuffer)
 		{
-			// Render into plugin buffer instead of global buffer
-			SNDMIXPLUGINSTATE &mixState = m_MixPlugins[nMixPlugin - 1].pMixPlugin->m_MixState;
-			if (mixState.pMixBuffer)
-			{
-				pbuffer = mixState.pMixBuffer;
-				pOfsR = &mixState.nVolDecayR;
-				pOfsL = &mixState.nVolDecayL;
-				if (!(mixState.dwFlags & SNDMIXPLUGINSTATE::psfMixReady))
-				{
-					StereoFill(pbuffer, count, *pOfsR, *pOfsL);
-					mixState.dwFlags |= SNDMIXPLUGINSTATE::psfMixReady;
-				}
+			target.buffer = mixState.pMixBuffer;
+			target.ofsR = &mixState.nVolDecayR;
+			target.ofsL = &mixState.nVolDecayL;
+			if (!(mixState.dwFlags & SNDMIXPLUGINSTATE::psfMixReady))
+			{
+				StereoFill(target.buffer, count, *target.ofsR, *target.ofsL);
+				mixState.dwFlags |= SNDMIXPLUGINSTATE::psfMixReady;
 			}
 		}
+	}
+#else
+	MPT_UNUSED(count);
 #endif // NO_PLUGINS
 
-		if(chn.isPaused)
+	return target;
+}
+
+
+// Mix a single channel into its target buffer. Returns 1 if the channel was audible.
+// If tooManyChannels is set, the channel is advanced without being mixed.
+CHANNELINDEX CSoundFile::MixChannel(ModChannel &chn, const MixerChannelTarget &target, int count, bool tooManyChannels)
+{
+	const MixFuncInterface *mixFunctions = MixFuncTable::GetFunctions();
+	mixsample_t *pbuffer = target.buffer;
+	mixsample_t *pOfsR = target.ofsR, *pOfsL = target.ofsL;
+
+	uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
+	if(chn.dwFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
+	if(chn.dwFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
+#ifndef NO_FILTER
+	if(chn.dwFlags[CHN_FILTER]) functionNdx |= MixFuncTable::ndxFilter;
+#endif
+
+	if(chn.isPaused)
+	{
+		EndChannelOfs(chn, pbuffer, count);
+		*pOfsR += chn.nROfs;
+		*pOfsL += chn.nLOfs;
+		chn.nROfs = chn.nLOfs = 0;
+		return 0;
+	}
+
+	MixLoopState mixLoopState(*this, chn);
+
+	////////////////////////////////////////////////////
+	CHANNELINDEX naddmix = 0;
+	int nsamples = count;
+	// Keep mixing this sample until the buffer is filled.
+	do
+	{
+		uint32 nrampsamples = nsamples;
+		int32 nSmpCount;
+		if(chn.nRampLength > 0)
 		{
-			EndChannelOfs(chn, pbuffer, count);
+			if (nrampsamples > chn.nRampLength) nrampsamples = chn.nRampLength;
+		}
+
+		if((nSmpCount = mixLoopState.GetSampleCount(chn, nrampsamples)) <= 0)
+		{
+			// Stopping the channel
+			chn.pCurrentSample = nullptr;
+			chn.nLength = 0;
+			chn.position.Set(0);
+			chn.nRampLength = 0;
+			EndChannelOfs(chn, pbuffer, nsamples);
 			*pOfsR += chn.nROfs;
 			*pOfsL += chn.nLOfs;
 			chn.nROfs = chn.nLOfs = 0;
-			continue;
+			chn.dwFlags.reset(CHN_PINGPONGFLAG);
+			break;
 		}
 
-		MixLoopState mixLoopState(*this, chn);
-
-		////////////////////////////////////////////////////
-		CHANNELINDEX naddmix = 0;
-		int nsamples = count;
-		// Keep mixing this sample until the buffer is filled.
-		do
+		// Should we mix this channel ?
+		if(tooManyChannels											// Too many channels
+			|| (!chn.nRampLength && !(chn.leftVol | chn.rightVol)))	// Channel is completely silent
 		{
-			uint32 nrampsamples = nsamples;
-			int32 nSmpCount;
-			if(chn.nRampLength > 0)
-			{
-				if (nrampsamples > chn.nRampLength) nrampsamples = chn.nRampLength;
-			}
-
-			if((nSmpCount = mixLoopState.GetSampleCount(chn, nrampsamples)) <= 0)
-			{
-				// Stopping the channel
-				chn.pCurrentSample = nullptr;
-				chn.nLength = 0;
-				chn.position.Set(0);
-				chn.nRampLength = 0;
-				EndChannelOfs(chn, pbuffer, nsamples);
-				*pOfsR += chn.nROfs;
-				*pOfsL += chn.nLOfs;
-				chn.nROfs = chn.nLOfs = 0;
-				chn.dwFlags.reset(CHN_PINGPONGFLAG);
-				break;
-			}
-
-			// Should we mix this channel ?
-			if((nchmixed >= m_MixerSettings.m_nMaxMixChannels)				// Too many channels
-				|| (!chn.nRampLength && !(chn.leftVol | chn.rightVol)))		// Channel is completely silent
+			chn.position += chn.increment * nSmpCount;
+			chn.nROfs = chn.nLOfs = 0;
+			pbuffer += nSmpCount * 2;
+			naddmix = 0;
+		}
+#ifdef MODPLUG_TRACKER
+		else if(m_SamplePlayLengths != nullptr)
+		{
+			// Detecting the longest play time for each sample for optimization
+			SmpLength pos = chn.position.GetUInt();
+			chn.position += chn.increment * nSmpCount;
+			if(!chn.increment.IsNegative())
 			{
-				chn.position += chn.increment * nSmpCount;
-				chn.nROfs = chn.nLOfs = 0;
-				pbuffer += nSmpCount * 2;
-				naddmix = 0;
+				pos = chn.position.GetUInt();
 			}
-#ifdef MODPLUG_TRACKER
-			else if(m_SamplePlayLengths != nullptr)
+			size_t smp = std::distance(static_cast<const ModSample*>(static_cast<std::decay<decltype(Samples)>::type>(Samples)), chn.pModSample);
+			if(smp < m_SamplePlayLengths->size())
 			{
-				// Detecting the longest play time for each sample for optimization
-				SmpLength pos = chn.position.GetUInt();
-				chn.position += chn.increment * nSmpCount;
-				if(!chn.increment.IsNegative())
-				{
-					pos = chn.position.GetUInt();
-				}
-				size_t smp = std::distance(static_cast<const ModSample*>(static_cast<std::decay<decltype(Samples)>::type>(Samples)), chn.pModSample);
-				if(smp < m_SamplePlayLengths->size())
-				{
-					(*m_SamplePlayLengths)[smp] = std::max((*m_SamplePlayLengths)[smp], pos);
-				}
+				(*m_SamplePlayLengths)[smp] = std::max((*m_SamplePlayLengths)[smp], pos);
 			}
+		}
 #endif
-			else
-			{
-				// Do mixing
-				mixsample_t *pbufmax = pbuffer + (nSmpCount * 2);
-				chn.nROfs = -*(pbufmax - 2);
-				chn.nLOfs = -*(pbufmax - 1);
+		else
+		{
+			// Do mixing
+			mixsample_t *pbufmax = pbuffer + (nSmpCount * 2);
+			chn.nROfs = -*(pbufmax - 2);
+			chn.nLOfs = -*(pbufmax - 1);
 
 #ifdef MPT_BUILD_DEBUG
-				SamplePosition targetpos = chn.position + chn.increment * nSmpCount;
+			SamplePosition targetpos = chn.position + chn.increment * nSmpCount;
 #endif
-				MixFuncTable::Functions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+			mixFunctions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
 #ifdef MPT_BUILD_DEBUG
-				MPT_ASSERT(chn.position.GetUInt() == targetpos.GetUInt());
+			MPT_ASSERT(chn.position.GetUInt() == targetpos.GetUInt());
 #endif
 
-				chn.nROfs += *(pbufmax - 2);
-				chn.nLOfs += *(pbufmax - 1);
-				pbuffer = pbufmax;
-				naddmix = 1;
-			}
+			chn.nROfs += *(pbufmax - 2);
+			chn.nLOfs += *(pbufmax - 1);
+			pbuffer = pbufmax;
+			naddmix = 1;
+		}
 
-			nsamples -= nSmpCount;
-			if (chn.nRampLength)
+		nsamples -= nSmpCount;
+		if (chn.nRampLength)
+		{
+			if (chn.nRampLength <= static_cast<uint32>(nSmpCount))
 			{
-				if (chn.nRampLength <= static_cast<uint32>(nSmpCount))
-				{
-					// Ramping is done
-					chn.nRampLength = 0;
-					chn.leftVol = chn.newLeftVol;
-					chn.rightVol = chn.newRightVol;
-					chn.rightRamp = chn.leftRamp = 0;
-					if(chn.dwFlags[CHN_NOTEFADE] && !chn.nFadeOutVol)
-					{
-						chn.nLength = 0;
-						chn.pCurrentSample = nullptr;
-					}
-				} else
+				// Ramping is done
+				chn.nRampLength = 0;
+				chn.leftVol = chn.newLeftVol;
+				chn.rightVol = chn.newRightVol;
+				chn.rightRamp = chn.leftRamp = 0;
+				if(chn.dwFlags[CHN_NOTEFADE] && !chn.nFadeOutVol)
 				{
-					chn.nRampLength -= nSmpCount;
+					chn.nLength = 0;
+					chn.pCurrentSample = nullptr;
 				}
+			} else
+			{
+				chn.nRampLength -= nSmpCount;
 			}
+		}
 
-			const bool pastLoopEnd = chn.position.GetUInt() >= chn.nLoopEnd && chn.dwFlags[CHN_LOOP];
-			const bool pastSampleEnd = chn.position.GetUInt() >= chn.nLength && !chn.dwFlags[CHN_LOOP] && chn.nLength && !chn.nMasterChn;
-			const bool doSampleSwap = m_playBehaviour[kMODSampleSwap] && chn.nNewIns && chn.nNewIns <= GetNumSamples() && chn.pModSample != &Samples[chn.nNewIns];
-			if((pastLoopEnd || pastSampleEnd) && doSampleSwap)
-			{
-				// ProTracker compatibility: Instrument changes without a note do not happen instantly, but rather when the sample loop has finished playing.
-				// Test case: PTInstrSwap.mod, PTSwapNoLoop.mod
+		const bool pastLoopEnd = chn.position.GetUInt() >= chn.nLoopEnd && chn.dwFlags[CHN_LOOP];
+		const bool pastSampleEnd = chn.position.GetUInt() >= chn.nLength && !chn.dwFlags[CHN_LOOP] && chn.nLength && !chn.nMasterChn;
+		const bool doSampleSwap = m_playBehaviour[kMODSampleSwap] && chn.nNewIns && chn.nNewIns <= GetNumSamples() && chn.pModSample != &Samples[chn.nNewIns];
+		if((pastLoopEnd || pastSampleEnd) && doSampleSwap)
+		{
+			// ProTracker compatibility: Instrument changes without a note do not happen instantly, but rather when the sample loop has finished playing.
+			// Test case: PTInstrSwap.mod, PTSwapNoLoop.mod
 #ifdef MODPLUG_TRACKER
-				if(m_SamplePlayLengths != nullptr)
+			if(m_SamplePlayLengths != nullptr)
+			{
+				// Even if the sample was playing at zero volume, we need to retain its full length for correct sample swap timing
+				size_t smp = std::distance(static_cast<const ModSample *>(static_cast<std::decay<decltype(Samples)>::type>(Samples)), chn.pModSample);
+				if(smp < m_SamplePlayLengths->size())
 				{
-					// Even if the sample was playing at zero volume, we need to retain its full length for correct sample swap timing
-					size_t smp = std::distance(static_cast<const ModSample *>(static_cast<std::decay<decltype(Samples)>::type>(Samples)), chn.pModSample);
-					if(smp < m_SamplePlayLengths->size())
-					{
-						(*m_SamplePlayLengths)[smp] = std::max((*m_SamplePlayLengths)[smp], std::min(chn.nLength, chn.position.GetUInt()));
-					}
+					(*m_SamplePlayLengths)[smp] = std::max((*m_SamplePlayLengths)[smp], std::min(chn.nLength, chn.position.GetUInt()));
 				}
+			}
 #endif
-				const ModSample &smp = Samples[chn.nNewIns];
-				chn.pModSample = &smp;
-				chn.pCurrentSample = smp.samplev();
-				chn.dwFlags = (chn.dwFlags & CHN_CHANNELFLAGS) | smp.uFlags;
-				chn.nLength = smp.uFlags[CHN_LOOP] ? smp.nLoopEnd : 0; // non-looping sample continue in oneshot mode (i.e. they will most probably just play silence)
-				chn.nLoopStart = smp.nLoopStart;
-				chn.nLoopEnd = smp.nLoopEnd;
-				chn.position.SetInt(chn.nLoopStart);
-				mixLoopState.UpdateLookaheadPointers(chn);
-				if(!chn.pCurrentSample)
-				{
-					break;
-				}
-			} else if(pastLoopEnd && !doSampleSwap && m_playBehaviour[kMODOneShotLoops] && chn.nLoopStart == 0)
+			const ModSample &smp = Samples[chn.nNewIns];
+			chn.pModSample = &smp;
+			chn.pCurrentSample = smp.samplev();
+			chn.dwFlags = (chn.dwFlags & CHN_CHANNELFLAGS) | smp.uFlags;
+			chn.nLength = smp.uFlags[CHN_LOOP] ? smp.nLoopEnd : 0; // non-looping sample continue in oneshot mode (i.e. they will most probably just play silence)
+			chn.nLoopStart = smp.nLoopStart;
+			chn.nLoopEnd = smp.nLoopEnd;
+			chn.position.SetInt(chn.nLoopStart);
+			mixLoopState.UpdateLookaheadPointers(chn);
+			if(!chn.pCurrentSample)
 			{
-				// ProTracker "oneshot" loops (if loop start is 0, play the whole sample once and then repeat until loop end)
-				chn.position.SetInt(0);
-				chn.nLoopEnd = chn.nLength = chn.pModSample->nLoopEnd;
+				break;
 			}
-		} while(nsamples > 0);
+		} else if(pastLoopEnd && !doSampleSwap && m_playBehaviour[kMODOneShotLoops] && chn.nLoopStart == 0)
+		{
+			// ProTracker "oneshot" loops (if loop start is 0, play the whole sample once and then repeat until loop end)
+			chn.position.SetInt(0);
+			chn.nLoopEnd = chn.nLength = chn.pModSample->nLoopEnd;
+		}
+	} while(nsamples > 0);
+
+	// Restore sample pointer in case it got changed through loop wrap-around
+	chn.pCurrentSample = mixLoopState.samplePointer;
 
-		// Restore sample pointer in case it got changed through loop wrap-around
-		chn.pCurrentSample = mixLoopState.samplePointer;
-		nchmixed += naddmix;
-	
 #ifndef NO_PLUGINS
-		if(naddmix && nMixPlugin > 0 && nMixPlugin <= MAX_MIXPLUGINS && m_MixPlugins[nMixPlugin - 1].pMixPlugin)
+	if(naddmix && target.plugin)
+	{
+		m_MixPlugins[target.plugin - 1].pMixPlugin->ResetSilence();
+	}
+#endif // NO_PLUGINS
+
+	return naddmix;
+}
+
+
+// The parallel mixer is only used if it produces the same output as the serial mixer:
+// Floating-point sums depend on the order of the channels, and so does the channel limit.
+bool CSoundFile::CanMixInParallel() const
+{
+#if defined(MPT_INTMIXER) && defined(MPT_ENABLE_MIXER_THREADS)
+	if(!m_mixerThreads || m_mixerThreads->GetNumThreads() < 2)
+		return false;
+	if(m_nMixChannels < 2 * MixerThreadPool::MinChannelsPerThread || m_nMixChannels > m_MixerSettings.m_nMaxMixChannels)
+		return false;
+#ifdef MODPLUG_TRACKER
+	if(m_SamplePlayLengths != nullptr)
+		return false;
+#endif // MODPLUG_TRACKER
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+static void AddPartialMix(mixsample_t * MPT_RESTRICT mix, const mixsample_t * MPT_RESTRICT partial, int count)
+{
+	for(int i = 0; i < count * 2; i++)
+	{
+		mix[i] += partial[i];
+	}
+}
+
+
+// Distribute the channels over the mixer threads. The calling thread mixes straight into the mix buffers,
+// the other threads mix into their partial buffers, which are then added to the mix buffers in thread order.
+CHANNELINDEX CSoundFile::CreateStereoMixParallel(int count)
+{
+	MixerThreadPool &pool = *m_mixerThreads;
+	const uint32 numThreads = std::min(pool.GetNumThreads(), static_cast<uint32>(m_nMixChannels / MixerThreadPool::MinChannelsPerThread));
+	for(uint32 thread = 0; thread < pool.GetNumThreads(); thread++)
+	{
+		MixerThreadState &state = pool.GetState(thread);
+		state.numChannels = 0;
+		state.numMixed = 0;
+		state.dryOfsR = state.dryOfsL = 0;
+		state.rearOfsR = state.rearOfsL = 0;
+		state.reverbOfsR = state.reverbOfsL = 0;
+		state.usesRear = state.usesReverb = false;
+	}
+
+	// Buffers are prepared in channel order, exactly as in the serial mixer.
+	// Channels that are routed to plugins always stay on the calling thread, as plugin state is not thread-safe.
+	uint32 nextThread = 0;
+	for(CHANNELINDEX nChn = 0; nChn < m_nMixChannels; nChn++)
+	{
+		const ModChannel &chn = m_PlayState.Chn[m_PlayState.ChnMix[nChn]];
+
+		if(!chn.pCurrentSample && !chn.nLOfs && !chn.nROfs)
+			continue;
+
+		MixerChannelTarget target = GetChannelMixTarget(nChn, count);
+		uint32 thread = 0;
+		if(!target.plugin)
 		{
-			m_MixPlugins[nMixPlugin - 1].pMixPlugin->ResetSilence();
+			thread = nextThread;
+			if(++nextThread >= numThreads)
+				nextThread = 0;
 		}
-#endif // NO_PLUGINS
+		MixerThreadState &state = pool.GetState(thread);
+		if(thread != 0)
+		{
+			if(target.buffer == MixRearBuffer)
+			{
+				target.buffer = state.rearBuffer.data();
+				target.ofsR = &state.rearOfsR;
+				target.ofsL = &state.rearOfsL;
+				state.usesRear = true;
+#ifndef NO_REVERB
+			} else if(target.buffer == ReverbSendBuffer)
+			{
+				target.buffer = state.reverbBuffer.data();
+				target.ofsR = &state.reverbOfsR;
+				target.ofsL = &state.reverbOfsL;
+				state.usesReverb = true;
+#endif // NO_REVERB
+			} else
+			{
+				MPT_ASSERT(target.buffer == MixSoundBuffer);
+				target.buffer = state.dryBuffer.data();
+				target.ofsR = &state.dryOfsR;
+				target.ofsL = &state.dryOfsL;
+			}
+		}
+		state.channels[state.numChannels++] = target;
 	}
-	m_nMixStat = std::max(m_nMixStat, nchmixed);
+
+	pool.Run([&](uint32 thread)
+	{
+		MixerThreadState &state = pool.GetState(thread);
+		if(!state.numChannels)
+			return;
+		if(thread != 0)
+		{
+			std::fill(state.dryBuffer.begin(), state.dryBuffer.begin() + count * 2, 0);
+			if(state.usesRear)
+				std::fill(state.rearBuffer.begin(), state.rearBuffer.begin() + count * 2, 0);
+			if(state.usesReverb)
+				std::fill(state.reverbBuffer.begin(), state.reverbBuffer.begin() + count * 2, 0);
+		}
+		for(CHANNELINDEX i = 0; i < state.numChannels; i++)
+		{
+			const MixerChannelTarget &target = state.channels[i];
+			state.numMixed += MixChannel(m_PlayState.Chn[m_PlayState.ChnMix[target.mixIndex]], target, count, false);
+		}
+	});
+
+	CHANNELINDEX nchmixed = pool.GetState(0).numMixed;
+	for(uint32 thread = 1; thread < numThreads; thread++)
+	{
+		const MixerThreadState &state = pool.GetState(thread);
+		if(!state.numChannels)
+			continue;
+		nchmixed += state.numMixed;
+		AddPartialMix(MixSoundBuffer, state.dryBuffer.data(), count);
+		m_dryROfsVol += state.dryOfsR;
+		m_dryLOfsVol += state.dryOfsL;
+		if(state.usesRear)
+		{
+			AddPartialMix(MixRearBuffer, state.rearBuffer.data(), count);
+			m_surroundROfsVol += state.rearOfsR;
+			m_surroundLOfsVol += state.rearOfsL;
+		}
+#ifndef NO_REVERB
+		if(state.usesReverb)
+		{
+			AddPartialMix(ReverbSendBuffer, state.reverbBuffer.data(), count);
+			m_RvbROfsVol += state.reverbOfsR;
+			m_RvbLOfsVol += state.reverbOfsL;
+		}
+#endif // NO_REVERB
+	}
+	return nchmixed;
 }
 
 
@@ -347,6 +347,28 @@ ITDecompression::ITDecompression(FileReader &file, ModSample &sample, bool it215
 }
 
 
+// Walk the block headers of a compressed sample to find out how much data it occupies, without decompressing it.
+// For well-formed sample data, this is exactly the amount of data that is consumed by the decompressor.
+FileReader::pos_type ITDecompression::GetCompressedSize(FileReader file, const ModSample &sample)
+{
+	const FileReader::pos_type startPos = file.GetPosition();
+	const SmpLength blockLength = static_cast<SmpLength>(ITCompression::blockSize / sample.GetElementarySampleSize());
+	for(uint8 chn = 0; chn < sample.GetNumChannels(); chn++)
+	{
+		SmpLength writtenSamples = 0;
+		while(writtenSamples < sample.nLength && file.CanRead(sizeof(uint16)))
+		{
+			uint16 compressedSize = file.ReadUint16LE();
+			if(!compressedSize)
+				continue;
+			file.Skip(compressedSize);
+			writtenSamples += std::min(sample.nLength - writtenSamples, blockLength);
+		}
+	}
+	return file.GetPosition() - startPos;
+}
+
+
 template<typename Properties>
 void ITDecompression::Uncompress(typename Properties::sample_t *target)
 {
@@ -78,6 +78,9 @@ class ITDecompression
 public:
 	ITDecompression(FileReader &file, ModSample &sample, bool it215);
 
+	// Walk the block headers of a compressed sample to find out how much data it occupies, without decompressing it.
+	static FileReader::pos_type GetCompressedSize(FileReader file, const ModSample &sample);
+
 protected:
 	BitReader bitFile;
 	ModSample &mptSample;  // Sample that is being processed
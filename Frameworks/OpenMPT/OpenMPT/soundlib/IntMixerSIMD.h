@@ -0,0 +1,320 @@
+/*
+ * IntMixerSIMD.h
+ * --------------
+ * Purpose: SIMD versions of the fixed point FIR, polyphase and cubic interpolation templates
+ * Notes  : The kernels only compute the dot products of the filter taps and sampling points.
+ *          Integer addition is associative, so these sums are the same no matter in which order
+ *          they are computed, and the final scaling is done with the same scalar expressions as in
+ *          IntMixer.h. The output is thus bit-identical to the scalar templates.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "openmpt/all/BuildSettings.hpp"
+
+#include "IntMixer.h"
+
+#include <cstring>
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+#include <immintrin.h>
+#endif
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2) && (MPT_COMPILER_GCC || MPT_COMPILER_CLANG) && !defined(__AVX2__)
+// GCC and Clang only inline intrinsics into functions targeting their instruction set.
+// The AVX2 kernels, interpolation templates and sample loops carry this attribute, and GetFunctions() only hands them out after checking CPUID.
+#define MPT_INTMIXER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MPT_INTMIXER_TARGET_AVX2
+#endif
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_NEON)
+#include <arm_neon.h>
+#endif
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+// The kernels expect sampling points to be converted to 16-bit values
+template<class Traits>
+inline constexpr bool IsSIMDMixerTraits = std::is_same<typename Traits::output_t, int32>::value
+	&& Traits::Convert(typename Traits::input_t(1)) == (1 << (16 - sizeof(typename Traits::input_t) * 8))
+	&& Traits::numChannelsIn <= 2;
+
+
+//////////////////////////////////////////////////////////////////////////
+// Kernels
+// Each kernel set provides:
+// FilterTaps8: Sums of lut[0..3] and lut[4..7] applied to the sampling points inBuffer[-3..4], per channel
+// FilterTaps4: Sum of lut[0..3] applied to the sampling points inBuffer[-1..2], per channel
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2)
+
+struct SSE2Kernels
+{
+	// Load sampling points as 16-bit values
+	static MPT_FORCEINLINE __m128i Load8(const int16 *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+	static MPT_FORCEINLINE __m128i Load8(const int8 *p) { return _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))); }
+	static MPT_FORCEINLINE __m128i Load4(const int16 *p) { return _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)); }
+	static MPT_FORCEINLINE __m128i Load4(const int8 *p)
+	{
+		int32 v;
+		std::memcpy(&v, p, sizeof(v));
+		return _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_cvtsi32_si128(v));
+	}
+
+	// Sum of all four lanes of left and right products
+	static MPT_FORCEINLINE void HorizontalAddStereo(__m128i left, __m128i right, int32 (&sum)[2])
+	{
+		__m128i t = _mm_add_epi32(_mm_unpacklo_epi32(left, right), _mm_unpackhi_epi32(left, right));
+		t = _mm_add_epi32(t, _mm_unpackhi_epi64(t, t));
+		sum[0] = _mm_cvtsi128_si32(t);
+		sum[1] = _mm_cvtsi128_si32(_mm_srli_si128(t, 4));
+	}
+
+	// Multiply interleaved stereo sampling points with four taps each
+	static MPT_FORCEINLINE void MultiplyAddStereo(__m128i samples, __m128i taps, int32 (&sum)[2])
+	{
+		// (tap, 0) pairs pick the left channel from each frame, (0, tap) pairs the right channel
+		const __m128i leftTaps = _mm_unpacklo_epi16(taps, _mm_setzero_si128());
+		const __m128i rightTaps = _mm_slli_epi32(leftTaps, 16);
+		HorizontalAddStereo(_mm_madd_epi16(samples, leftTaps), _mm_madd_epi16(samples, rightTaps), sum);
+	}
+
+	template<class Traits>
+	static MPT_FORCEINLINE void FilterTaps8(const typename Traits::input_t * const MPT_RESTRICT inBuffer, const int16 * const lut, int32 (&sum03)[2], int32 (&sum47)[2])
+	{
+		static_assert(IsSIMDMixerTraits<Traits>);
+		const __m128i taps = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lut));
+		if constexpr(Traits::numChannelsIn == 1)
+		{
+			const __m128i products = _mm_madd_epi16(Load8(inBuffer - 3), taps);
+			const __m128i sums = _mm_add_epi32(products, _mm_shuffle_epi32(products, _MM_SHUFFLE(2, 3, 0, 1)));
+			sum03[0] = _mm_cvtsi128_si32(sums);
+			sum47[0] = _mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+		} else
+		{
+			MultiplyAddStereo(Load8(inBuffer - 6), taps, sum03);
+			MultiplyAddStereo(Load8(inBuffer + 2), _mm_unpackhi_epi64(taps, taps), sum47);
+		}
+	}
+
+	template<class Traits>
+	static MPT_FORCEINLINE void FilterTaps4(const typename Traits::input_t * const MPT_RESTRICT inBuffer, const int16 * const lut, int32 (&sum)[2])
+	{
+		static_assert(IsSIMDMixerTraits<Traits>);
+		const __m128i taps = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(lut));
+		if constexpr(Traits::numChannelsIn == 1)
+		{
+			const __m128i products = _mm_madd_epi16(Load4(inBuffer - 1), taps);
+			sum[0] = _mm_cvtsi128_si32(_mm_add_epi32(products, _mm_srli_si128(products, 4)));
+		} else
+		{
+			MultiplyAddStereo(Load8(inBuffer - 2), taps, sum);
+		}
+	}
+};
+
+#endif // MPT_ENABLE_ARCH_INTRINSICS_SSE2
+
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+
+// Stereo 8-tap filters fit in a single 256-bit register, everything else is as fast with 128-bit registers
+struct AVX2Kernels : public SSE2Kernels
+{
+	static MPT_INTMIXER_TARGET_AVX2 MPT_FORCEINLINE __m256i Load16(const int16 *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+	static MPT_INTMIXER_TARGET_AVX2 MPT_FORCEINLINE __m256i Load16(const int8 *p) { return _mm256_slli_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))), 8); }
+
+	template<class Traits>
+	static MPT_INTMIXER_TARGET_AVX2 MPT_FORCEINLINE void FilterTaps8(const typename Traits::input_t * const MPT_RESTRICT inBuffer, const int16 * const lut, int32 (&sum03)[2], int32 (&sum47)[2])
+	{
+		if constexpr(Traits::numChannelsIn == 1)
+		{
+			SSE2Kernels::FilterTaps8<Traits>(inBuffer, lut, sum03, sum47);
+		} else
+		{
+			static_assert(IsSIMDMixerTraits<Traits>);
+			const __m256i samples = Load16(inBuffer - 6);
+			const __m256i leftTaps = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lut)));
+			const __m256i rightTaps = _mm256_slli_epi32(leftTaps, 16);
+			// Low lane: taps 0-3, high lane: taps 4-7
+			__m256i sums = _mm256_hadd_epi32(_mm256_madd_epi16(samples, leftTaps), _mm256_madd_epi16(samples, rightTaps));
+			sums = _mm256_hadd_epi32(sums, sums);
+			const __m128i low = _mm256_castsi256_si128(sums), high = _mm256_extracti128_si256(sums, 1);
+			sum03[0] = _mm_cvtsi128_si32(low);
+			sum03[1] = _mm_cvtsi128_si32(_mm_srli_si128(low, 4));
+			sum47[0] = _mm_cvtsi128_si32(high);
+			sum47[1] = _mm_cvtsi128_si32(_mm_srli_si128(high, 4));
+		}
+	}
+};
+
+#endif // MPT_ENABLE_ARCH_INTRINSICS_AVX2
+
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_NEON)
+
+struct NEONKernels
+{
+	// Load sampling points as 16-bit values
+	static MPT_FORCEINLINE int16x8_t Load8(const int16 *p) { return vld1q_s16(p); }
+	static MPT_FORCEINLINE int16x8_t Load8(const int8 *p) { return vshll_n_s8(vld1_s8(p), 8); }
+	static MPT_FORCEINLINE int16x8x2_t Load8Stereo(const int16 *p) { return vld2q_s16(p); }
+	static MPT_FORCEINLINE int16x8x2_t Load8Stereo(const int8 *p)
+	{
+		const int8x8x2_t v = vld2_s8(p);
+		return {{vshll_n_s8(v.val[0], 8), vshll_n_s8(v.val[1], 8)}};
+	}
+	static MPT_FORCEINLINE int16x4_t Load4(const int16 *p) { return vld1_s16(p); }
+	static MPT_FORCEINLINE int16x4_t Load4(const int8 *p)
+	{
+		int32 v;
+		std::memcpy(&v, p, sizeof(v));
+		return vget_low_s16(vshll_n_s8(vreinterpret_s8_s32(vdup_n_s32(v)), 8));
+	}
+	static MPT_FORCEINLINE int16x4x2_t Load4Stereo(const int16 *p) { return vld2_s16(p); }
+	static MPT_FORCEINLINE int16x4x2_t Load4Stereo(const int8 *p)
+	{
+		const int8x8_t v = vld1_s8(p);
+		const int8x8x2_t deinterleaved = vuzp_s8(v, v);
+		return {{vget_low_s16(vshll_n_s8(deinterleaved.val[0], 8)), vget_low_s16(vshll_n_s8(deinterleaved.val[1], 8))}};
+	}
+
+	static MPT_FORCEINLINE int32 HorizontalAdd(int32x4_t v)
+	{
+#if MPT_ARCH_AARCH64
+		return vaddvq_s32(v);
+#else
+		const int32x2_t s = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+		return vget_lane_s32(vpadd_s32(s, s), 0);
+#endif
+	}
+
+	template<class Traits>
+	static MPT_FORCEINLINE void FilterTaps8(const typename Traits::input_t * const MPT_RESTRICT inBuffer, const int16 * const lut, int32 (&sum03)[2], int32 (&sum47)[2])
+	{
+		static_assert(IsSIMDMixerTraits<Traits>);
+		const int16x8_t taps = vld1q_s16(lut);
+		const int16x4_t taps03 = vget_low_s16(taps), taps47 = vget_high_s16(taps);
+		if constexpr(Traits::numChannelsIn == 1)
+		{
+			const int16x8_t samples = Load8(inBuffer - 3);
+			sum03[0] = HorizontalAdd(vmull_s16(vget_low_s16(samples), taps03));
+			sum47[0] = HorizontalAdd(vmull_s16(vget_high_s16(samples), taps47));
+		} else
+		{
+			const int16x8x2_t samples = Load8Stereo(inBuffer - 6);
+			for(int i = 0; i < 2; i++)
+			{
+				sum03[i] = HorizontalAdd(vmull_s16(vget_low_s16(samples.val[i]), taps03));
+				sum47[i] = HorizontalAdd(vmull_s16(vget_high_s16(samples.val[i]), taps47));
+			}
+		}
+	}
+
+	template<class Traits>
+	static MPT_FORCEINLINE void FilterTaps4(const typename Traits::input_t * const MPT_RESTRICT inBuffer, const int16 * const lut, int32 (&sum)[2])
+	{
+		static_assert(IsSIMDMixerTraits<Traits>);
+		const int16x4_t taps = vld1_s16(lut);
+		if constexpr(Traits::numChannelsIn == 1)
+		{
+			sum[0] = HorizontalAdd(vmull_s16(Load4(inBuffer - 1), taps));
+		} else
+		{
+			const int16x4x2_t samples = Load4Stereo(inBuffer - 2);
+			sum[0] = HorizontalAdd(vmull_s16(samples.val[0], taps));
+			sum[1] = HorizontalAdd(vmull_s16(samples.val[1], taps));
+		}
+	}
+};
+
+#endif // MPT_ENABLE_ARCH_INTRINSICS_NEON
+
+
+//////////////////////////////////////////////////////////////////////////
+// Interpolation templates, see IntMixer.h for the scalar versions
+
+
+// Defines the interpolation templates for a kernel set as FastSincInterpolation<isa> etc.
+// The attributes are applied to the functions the kernels are inlined into.
+#define MPT_DEFINE_SIMD_INTERPOLATION(isa, Kernels, attributes) \
+template<class Traits> \
+struct FastSincInterpolation ## isa : public FastSincInterpolation<Traits> \
+{ \
+	using FastSincInterpolation<Traits>::FastSincInterpolation; \
+ \
+	attributes MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo) \
+	{ \
+		const int16 *lut = CResampler::FastSincTable + ((posLo >> 22) & 0x3FC); \
+		int32 sum[2]; \
+		Kernels::template FilterTaps4<Traits>(inBuffer, lut, sum); \
+		for(int i = 0; i < Traits::numChannelsIn; i++) \
+		{ \
+			outSample[i] = sum[i] / 16384; \
+		} \
+	} \
+}; \
+ \
+ \
+template<class Traits> \
+struct PolyphaseInterpolation ## isa : public PolyphaseInterpolation<Traits> \
+{ \
+	using PolyphaseInterpolation<Traits>::PolyphaseInterpolation; \
+ \
+	attributes MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo) \
+	{ \
+		static_assert(std::is_same<SINC_TYPE, int16>::value); \
+		const SINC_TYPE *lut = this->sinc + ((posLo >> (32 - SINC_PHASES_BITS)) & SINC_MASK) * SINC_WIDTH; \
+		int32 sum03[2], sum47[2]; \
+		Kernels::template FilterTaps8<Traits>(inBuffer, lut, sum03, sum47); \
+		for(int i = 0; i < Traits::numChannelsIn; i++) \
+		{ \
+			/* Wrapping addition, like the single sum in the scalar version */ \
+			outSample[i] = static_cast<int32>(static_cast<uint32>(sum03[i]) + static_cast<uint32>(sum47[i])) / (1 << SINC_QUANTSHIFT); \
+		} \
+	} \
+}; \
+ \
+ \
+template<class Traits> \
+struct FIRFilterInterpolation ## isa : public FIRFilterInterpolation<Traits> \
+{ \
+	using FIRFilterInterpolation<Traits>::FIRFilterInterpolation; \
+ \
+	attributes MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo) \
+	{ \
+		const int16 * const lut = this->WFIRlut + ((((posLo >> 16) + WFIR_FRACHALVE) >> WFIR_FRACSHIFT) & WFIR_FRACMASK); \
+		int32 vol1[2], vol2[2]; \
+		Kernels::template FilterTaps8<Traits>(inBuffer, lut, vol1, vol2); \
+		for(int i = 0; i < Traits::numChannelsIn; i++) \
+		{ \
+			outSample[i] = ((vol1[i] / 2) + (vol2[i] / 2)) / (1 << (WFIR_16BITSHIFT - 1)); \
+		} \
+	} \
+};
+
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2)
+MPT_DEFINE_SIMD_INTERPOLATION(SSE2, SSE2Kernels, )
+#endif // MPT_ENABLE_ARCH_INTRINSICS_SSE2
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+MPT_DEFINE_SIMD_INTERPOLATION(AVX2, AVX2Kernels, MPT_INTMIXER_TARGET_AVX2)
+// SampleLoop with the AVX2 kernels inlined
+MPT_DEFINE_SAMPLELOOP(SampleLoopAVX2, MPT_INTMIXER_TARGET_AVX2)
+#endif // MPT_ENABLE_ARCH_INTRINSICS_AVX2
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_NEON)
+MPT_DEFINE_SIMD_INTERPOLATION(NEON, NEONKernels, )
+#endif // MPT_ENABLE_ARCH_INTRINSICS_NEON
+
+#undef MPT_DEFINE_SIMD_INTERPOLATION
+
+
+OPENMPT_NAMESPACE_END
@@ -28,6 +28,7 @@
 #include <sstream>
 #include "../common/version.h"
 #include "ITTools.h"
+#include "ITCompression.h"
 #include "mpt/io/base.hpp"
 #include "mpt/io/io.hpp"
 #include "mpt/io/io_stdstream.hpp"
@@ -341,6 +342,33 @@ static void CopyPatternName(CPattern &pattern, FileReader &file)
 }
 
 
+// Let IT 2.14 / 2.15 compressed sample data be decoded on another thread or when the sample is first played.
+static void QueueCompressedSample(CSoundFile &sndFile, SAMPLEINDEX smp, const SampleIO sampleIO, FileReader &file, CSoundFile::ModLoadingFlags loadFlags)
+{
+	ModSample &sample = sndFile.GetSample(smp);
+	sample.uFlags.set(CHN_16BIT, sampleIO.GetBitDepth() >= 16);
+	sample.uFlags.set(CHN_STEREO, sampleIO.GetChannelFormat() != SampleIO::mono);
+	// The decoder only gets to see the compressed blocks of this sample, so it must not be longer than what they can represent (see SampleIO::ReadSample).
+	std::vector<std::byte> data = file.ReadRawDataAsByteVector(ITDecompression::GetCompressedSize(file, sample));
+	size_t maxLength = data.size();
+	const uint8 maxSamplesPerByte = 8 / sample.GetNumChannels();
+	if(Util::MaxValueOfType(maxLength) / maxSamplesPerByte >= maxLength)
+		maxLength *= maxSamplesPerByte;
+	else
+		maxLength = Util::MaxValueOfType(maxLength);
+	LimitMax(sample.nLength, mpt::saturate_cast<SmpLength>(maxLength));
+	if(!sample.nLength)
+		return;
+
+	sndFile.DecodeSampleData(smp, [sampleIO, data = std::move(data)](ModSample &mptSample, const ILog &)
+	{
+		FileReader sampleData(mpt::as_span(data));
+		sampleIO.ReadSample(mptSample, sampleData);
+		return true;
+	}, loadFlags);
+}
+
+
 // Get version of Schism Tracker that was used to create an IT/S3M file.
 mpt::ustring CSoundFile::GetSchismTrackerVersion(uint16 cwtv, uint32 reserved)
 {
@@ -813,7 +841,11 @@ bool CSoundFile::ReadIT(FileReader &file, ModLoadingFlags loadFlags)
 			} else if(!sample.uFlags[SMP_KEEPONDISK])
 			{
 				SampleIO sampleIO = sampleHeader.GetSampleFormat(fileHeader.cwtv);
-				if(loadFlags & loadSampleData)
+				if((loadFlags & loadSampleData) && (loadFlags & (loadSamplesParallel | loadSamplesDeferred))
+				   && (sampleIO.GetEncoding() == SampleIO::IT214 || sampleIO.GetEncoding() == SampleIO::IT215))
+				{
+					QueueCompressedSample(*this, i + 1, sampleIO, file, loadFlags);
+				} else if(loadFlags & loadSampleData)
 				{
 					sampleIO.ReadSample(sample, file);
 				} else
@@ -855,6 +887,7 @@ bool CSoundFile::ReadIT(FileReader &file, ModLoadingFlags loadFlags)
 		}
 	}
 	m_nSamples = std::max(SAMPLEINDEX(1), GetNumSamples());
+	FinishSampleDecoding(loadFlags);
 
 	if(possibleXMconversion && fileHeader.cwtv == 0x0204 && fileHeader.cmwt == 0x0200 && fileHeader.special == 0 && fileHeader.reserved == 0
 		&& (fileHeader.flags & ~ITFileHeader::linearSlides) == (ITFileHeader::useStereoPlayback | ITFileHeader::instrumentMode | ITFileHeader::itOldEffects)
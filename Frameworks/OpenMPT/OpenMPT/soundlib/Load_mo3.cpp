@@ -652,6 +652,29 @@ static void UnpackMO3DeltaPredictionSample(FileReader &file, typename Properties
 #undef DECODE_CTRL_BITS
 
 
+// Unpack delta-compressed sample data with or without prediction.
+static bool UnpackMO3CompressedSample(ModSample &sample, FileReader sampleData, uint32 compression)
+{
+	if(!sample.AllocateSample())
+		return false;
+	const uint8 numChannels = sample.GetNumChannels();
+	if(compression == MO3Sample::smpDeltaCompression)
+	{
+		if(sample.uFlags[CHN_16BIT])
+			UnpackMO3DeltaSample<MO3Delta16BitParams>(sampleData, sample.sample16(), sample.nLength, numChannels);
+		else
+			UnpackMO3DeltaSample<MO3Delta8BitParams>(sampleData, sample.sample8(), sample.nLength, numChannels);
+	} else
+	{
+		if(sample.uFlags[CHN_16BIT])
+			UnpackMO3DeltaPredictionSample<MO3Delta16BitParams>(sampleData, sample.sample16(), sample.nLength, numChannels);
+		else
+			UnpackMO3DeltaPredictionSample<MO3Delta8BitParams>(sampleData, sample.sample8(), sample.nLength, numChannels);
+	}
+	return true;
+}
+
+
 #if defined(MPT_WITH_VORBIS) && defined(MPT_WITH_VORBISFILE)
 
 static size_t VorbisfileFilereaderRead(void *ptr, size_t size, size_t nmemb, void *datasource)
@@ -1313,6 +1336,7 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 		} else if(smpHeader.compressedSize < 0 && (smp + smpHeader.compressedSize) > 0)
 		{
 			// Duplicate sample
+			DecodePendingSample(static_cast<SAMPLEINDEX>(smp + smpHeader.compressedSize));
 			sample.CopyWaveform(Samples[smp + smpHeader.compressedSize]);
 		} else if(smpHeader.compressedSize > 0)
 		{
@@ -1337,23 +1361,18 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				LimitMax(sample.nLength, mpt::saturate_cast<SmpLength>(maxLength));
 			}
 
-			if(compression == MO3Sample::smpDeltaCompression)
+			if(compression == MO3Sample::smpDeltaCompression || compression == MO3Sample::smpDeltaPrediction)
 			{
-				if(sample.AllocateSample())
+				if(loadFlags & (loadSamplesParallel | loadSamplesDeferred))
 				{
-					if(smpHeader.flags & MO3Sample::smp16Bit)
-						UnpackMO3DeltaSample<MO3Delta16BitParams>(sampleData, sample.sample16(), sample.nLength, numChannels);
-					else
-						UnpackMO3DeltaSample<MO3Delta8BitParams>(sampleData, sample.sample8(), sample.nLength, numChannels);
-				}
-			} else if(compression == MO3Sample::smpDeltaPrediction)
-			{
-				if(sample.AllocateSample())
+					// The decoder may run after the file has been closed, so it needs its own copy of the compressed data.
+					DecodeSampleData(smp, [compression, data = sampleData.GetRawDataAsByteVector()](ModSample &mptSample, const ILog &)
+					{
+						return UnpackMO3CompressedSample(mptSample, FileReader(mpt::as_span(data)), compression);
+					}, loadFlags);
+				} else
 				{
-					if(smpHeader.flags & MO3Sample::smp16Bit)
-						UnpackMO3DeltaPredictionSample<MO3Delta16BitParams>(sampleData, sample.sample16(), sample.nLength, numChannels);
-					else
-						UnpackMO3DeltaPredictionSample<MO3Delta8BitParams>(sampleData, sample.sample8(), sample.nLength, numChannels);
+					UnpackMO3CompressedSample(sample, sampleData, compression);
 				}
 			} else if(compression == MO3Sample::smpCompressionOgg || compression == MO3Sample::smpSharedOgg)
 			{
@@ -1408,19 +1427,10 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 	// Now we can load Ogg samples with shared headers.
 	if(loadFlags & loadSampleData)
 	{
-		for(SAMPLEINDEX smp = 1; smp <= m_nSamples; smp++)
+		// Decoding may be deferred to a decode thread, in which case sampleChunk and headerSource are backed by copies of the compressed data.
+		const auto decodeOggSample = [](ModSample &sample, SAMPLEINDEX smp, MO3SampleChunk sampleChunk, FileReader headerSource, bool sharedHeader, const ILog &log)
 		{
-			MO3SampleChunk &sampleChunk = sampleChunks[smp - 1];
-			// Is this an Ogg sample?
-			if(!sampleChunk.chunk.IsValid())
-				continue;
-
-			SAMPLEINDEX sharedOggHeader = (smp + sampleChunk.sharedHeader > 0) ? static_cast<SAMPLEINDEX>(smp + sampleChunk.sharedHeader) : smp;
-			// Which chunk are we going to read the header from?
-			// Note: Every Ogg stream has a unique serial number.
-			// stb_vorbis (currently) ignores this serial number so we can just stitch
-			// together our sample without adjusting the shared header's serial number.
-			const bool sharedHeader = sharedOggHeader != smp && sharedOggHeader > 0 && sharedOggHeader <= m_nSamples && sampleChunk.headerSize > 0;
+			bool success = true;
 
 #if defined(MPT_WITH_VORBIS) && defined(MPT_WITH_VORBISFILE)
 
@@ -1447,8 +1457,8 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				std::ostringstream mergedStream(std::ios::binary);
 				mergedStream.imbue(std::locale::classic());
 
-				sampleChunks[sharedOggHeader - 1].chunk.Rewind();
-				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk.ReadChunk(sampleChunk.headerSize);
+				headerSource.Rewind();
+				FileReader sharedChunk = headerSource.ReadChunk(sampleChunk.headerSize);
 				sharedChunk.Rewind();
 
 				std::vector<uint32> streamSerials;
@@ -1496,8 +1506,8 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				std::ostringstream mergedStream(std::ios::binary);
 				mergedStream.imbue(std::locale::classic());
 
-				sampleChunks[sharedOggHeader - 1].chunk.Rewind();
-				FileReader sharedChunk = sampleChunks[sharedOggHeader - 1].chunk.ReadChunk(sampleChunk.headerSize);
+				headerSource.Rewind();
+				FileReader sharedChunk = headerSource.ReadChunk(sampleChunk.headerSize);
 				sharedChunk.Rewind();
 
 				std::vector<uint32> dataStreamSerials;
@@ -1553,13 +1563,13 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 
 				if(headStreamSerials.size() > 1)
 				{
-					AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Ogg Vorbis data with shared header and multiple logical bitstreams in header chunk found. This may be handled incorrectly.")(smp));
+					log.AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Ogg Vorbis data with shared header and multiple logical bitstreams in header chunk found. This may be handled incorrectly.")(smp));
 				} else if(dataStreamSerials.size() > 1)
 				{
-					AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Ogg Vorbis sample with shared header and multiple logical bitstreams found. This may be handled incorrectly.")(smp));
+					log.AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Ogg Vorbis sample with shared header and multiple logical bitstreams found. This may be handled incorrectly.")(smp));
 				} else if((dataStreamSerials.size() == 1) && (headStreamSerials.size() == 1) && (dataStreamSerials[0] != headStreamSerials[0]))
 				{
-					AddToLog(LogInformation, MPT_UFORMAT("Sample {}: Ogg Vorbis data with shared header and different logical bitstream serials found.")(smp));
+					log.AddToLog(LogInformation, MPT_UFORMAT("Sample {}: Ogg Vorbis data with shared header and different logical bitstream serials found.")(smp));
 				}
 
 				std::string mergedStreamData = mergedStream.str();
@@ -1580,7 +1590,7 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 #else  // !(MPT_WITH_VORBIS && MPT_WITH_VORBISFILE)
 
 			FileReader &sampleData = sampleChunk.chunk;
-			FileReader &headerChunk = sharedHeader ? sampleChunks[sharedOggHeader - 1].chunk : sampleData;
+			FileReader &headerChunk = sharedHeader ? headerSource : sampleData;
 #if defined(MPT_WITH_STBVORBIS)
 			std::size_t initialRead = sharedHeader ? sampleChunk.headerSize : headerChunk.GetLength();
 #endif  // MPT_WITH_STBVORBIS
@@ -1589,7 +1599,7 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 
 			headerChunk.Rewind();
 			if(sharedHeader && !headerChunk.CanRead(sampleChunk.headerSize))
-				continue;
+				return true;
 
 #if defined(MPT_WITH_VORBIS) && defined(MPT_WITH_VORBISFILE)
 
@@ -1607,7 +1617,6 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 					vorbis_info *vi = ov_info(&vf, -1);
 					if(vi && vi->rate > 0 && vi->channels > 0)
 					{
-						ModSample &sample = Samples[smp];
 						sample.AllocateSample();
 						SmpLength offset = 0;
 						int channels = vi->channels;
@@ -1643,21 +1652,24 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 						}
 					} else
 					{
-						unsupportedSamples = true;
+						success = false;
 					}
 				} else
 				{
-					AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Unsupported Ogg Vorbis chained stream found.")(smp));
-					unsupportedSamples = true;
+					log.AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Unsupported Ogg Vorbis chained stream found.")(smp));
+					success = false;
 				}
 				ov_clear(&vf);
 			} else
 			{
-				unsupportedSamples = true;
+				success = false;
 			}
 
 #elif defined(MPT_WITH_STBVORBIS)
 
+			MPT_UNREFERENCED_PARAMETER(smp);
+			MPT_UNREFERENCED_PARAMETER(log);
+
 			// NOTE/TODO: stb_vorbis does not handle inferred negative PCM sample
 			// position at stream start. (See
 			// <https://www.xiph.org/vorbis/doc/Vorbis_I_spec.html#x1-132000A.2>).
@@ -1687,7 +1699,6 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 			if(vorb)
 			{
 				// Header has been read, proceed to reading the sample data
-				ModSample &sample = Samples[smp];
 				sample.AllocateSample();
 				SmpLength offset = 0;
 				while((error == VORBIS__no_error || (error == VORBIS_need_more_data && dataLeft > 0))
@@ -1716,15 +1727,53 @@ bool CSoundFile::ReadMO3(FileReader &file, ModLoadingFlags loadFlags)
 				stb_vorbis_close(vorb);
 			} else
 			{
-				unsupportedSamples = true;
+				success = false;
 			}
 
 #else  // !VORBIS
 
-			unsupportedSamples = true;
+			MPT_UNREFERENCED_PARAMETER(sample);
+			MPT_UNREFERENCED_PARAMETER(smp);
+			MPT_UNREFERENCED_PARAMETER(log);
+
+			success = false;
 
 #endif  // VORBIS
+
+			return success;
+		};
+
+		for(SAMPLEINDEX smp = 1; smp <= m_nSamples; smp++)
+		{
+			MO3SampleChunk &sampleChunk = sampleChunks[smp - 1];
+			// Is this an Ogg sample?
+			if(!sampleChunk.chunk.IsValid())
+				continue;
+
+			SAMPLEINDEX sharedOggHeader = (smp + sampleChunk.sharedHeader > 0) ? static_cast<SAMPLEINDEX>(smp + sampleChunk.sharedHeader) : smp;
+			// Which chunk are we going to read the header from?
+			// Note: Every Ogg stream has a unique serial number.
+			// stb_vorbis (currently) ignores this serial number so we can just stitch
+			// together our sample without adjusting the shared header's serial number.
+			const bool sharedHeader = sharedOggHeader != smp && sharedOggHeader > 0 && sharedOggHeader <= m_nSamples && sampleChunk.headerSize > 0;
+
+			FileReader headerSource = sharedHeader ? sampleChunks[sharedOggHeader - 1].chunk : FileReader();
+			if(loadFlags & (loadSamplesParallel | loadSamplesDeferred))
+			{
+				// The decoder may run after the file has been closed, so it needs its own copy of the compressed data.
+				std::vector<std::byte> sampleData = sampleChunk.chunk.GetRawDataAsByteVector();
+				std::vector<std::byte> headerData = sharedHeader ? headerSource.GetRawDataAsByteVector(sampleChunk.headerSize) : std::vector<std::byte>();
+				DecodeSampleData(smp, [decodeOggSample, smp, sampleData = std::move(sampleData), headerData = std::move(headerData), headerSize = sampleChunk.headerSize, sharedHeader](ModSample &sample, const ILog &log)
+				{
+					return decodeOggSample(sample, smp, MO3SampleChunk(FileReader(mpt::as_span(sampleData)), headerSize), FileReader(mpt::as_span(headerData)), sharedHeader, log);
+				}, loadFlags);
+			} else if(!DecodeSampleData(smp, [&](ModSample &sample, const ILog &log) { return decodeOggSample(sample, smp, sampleChunk, headerSource, sharedHeader, log); }, loadFlags))
+			{
+				unsupportedSamples = true;
+			}
 		}
+		if(!FinishSampleDecoding(loadFlags))
+			unsupportedSamples = true;
 	}
 
 	if(m_nType == MOD_TYPE_XM)
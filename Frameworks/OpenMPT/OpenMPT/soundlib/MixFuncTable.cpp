@@ -20,6 +20,10 @@
 
 #ifdef MPT_INTMIXER
 #include "IntMixer.h"
+#include "IntMixerSIMD.h"
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2) || defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+#include "../common/mptCPU.h"
+#endif
 #else
 #include "FloatMixer.h"
 #endif // MPT_INTMIXER
@@ -40,38 +44,110 @@ using I8S = Int8SToFloatS;
 using I16S = Int16SToFloatS;
 #endif // MPT_INTMIXER
 
-// Build mix function table for given resampling, filter and ramping settings: One function each for 8-Bit / 16-Bit Mono / Stereo
-#define BuildMixFuncTableRamp(resampling, filter, ramp) \
-	SampleLoop<I8M, resampling<I8M>, filter<I8M>, MixMono ## ramp<I8M> >, \
-	SampleLoop<I16M, resampling<I16M>, filter<I16M>, MixMono ## ramp<I16M> >, \
-	SampleLoop<I8S, resampling<I8S>, filter<I8S>, MixStereo ## ramp<I8S> >, \
-	SampleLoop<I16S, resampling<I16S>, filter<I16S>, MixStereo ## ramp<I16S> >
+// Build mix function table for given sample loop, resampling, filter and ramping settings: One function each for 8-Bit / 16-Bit Mono / Stereo
+#define BuildMixFuncTableRamp(loop, resampling, filter, ramp) \
+	loop<I8M, resampling<I8M>, filter<I8M>, MixMono ## ramp<I8M> >, \
+	loop<I16M, resampling<I16M>, filter<I16M>, MixMono ## ramp<I16M> >, \
+	loop<I8S, resampling<I8S>, filter<I8S>, MixStereo ## ramp<I8S> >, \
+	loop<I16S, resampling<I16S>, filter<I16S>, MixStereo ## ramp<I16S> >
 
-// Build mix function table for given resampling, filter settings: With and without ramping
-#define BuildMixFuncTableFilter(resampling, filter) \
-	BuildMixFuncTableRamp(resampling, filter, NoRamp), \
-	BuildMixFuncTableRamp(resampling, filter, Ramp)
+// Build mix function table for given sample loop, resampling, filter settings: With and without ramping
+#define BuildMixFuncTableFilter(loop, resampling, filter) \
+	BuildMixFuncTableRamp(loop, resampling, filter, NoRamp), \
+	BuildMixFuncTableRamp(loop, resampling, filter, Ramp)
 
-// Build mix function table for given resampling settings: With and without filter
-#define BuildMixFuncTable(resampling) \
-	BuildMixFuncTableFilter(resampling, NoFilter), \
-	BuildMixFuncTableFilter(resampling, ResonantFilter)
+// Build mix function table for given sample loop and resampling settings: With and without filter
+#define BuildMixFuncTable(loop, resampling) \
+	BuildMixFuncTableFilter(loop, resampling, NoFilter), \
+	BuildMixFuncTableFilter(loop, resampling, ResonantFilter)
 
 const MixFuncInterface Functions[6 * 16] =
 {
-	BuildMixFuncTable(NoInterpolation),        // No SRC
-	BuildMixFuncTable(LinearInterpolation),    // Linear SRC
-	BuildMixFuncTable(FastSincInterpolation),  // Fast Sinc (Cubic Spline) SRC
-	BuildMixFuncTable(PolyphaseInterpolation), // Kaiser SRC
-	BuildMixFuncTable(FIRFilterInterpolation), // FIR SRC
-	BuildMixFuncTable(AmigaBlepInterpolation), // Amiga emulation
+	BuildMixFuncTable(SampleLoop, NoInterpolation),        // No SRC
+	BuildMixFuncTable(SampleLoop, LinearInterpolation),    // Linear SRC
+	BuildMixFuncTable(SampleLoop, FastSincInterpolation),  // Fast Sinc (Cubic Spline) SRC
+	BuildMixFuncTable(SampleLoop, PolyphaseInterpolation), // Kaiser SRC
+	BuildMixFuncTable(SampleLoop, FIRFilterInterpolation), // FIR SRC
+	BuildMixFuncTable(SampleLoop, AmigaBlepInterpolation), // Amiga emulation
 };
 
+#ifdef MPT_INTMIXER
+
+// Same as above, using the SIMD interpolation kernels for the given instruction set
+#define BuildMixFuncTableSIMD(loop, isa) \
+	{ \
+		BuildMixFuncTable(loop, NoInterpolation), \
+		BuildMixFuncTable(loop, LinearInterpolation), \
+		BuildMixFuncTable(loop, FastSincInterpolation ## isa), \
+		BuildMixFuncTable(loop, PolyphaseInterpolation ## isa), \
+		BuildMixFuncTable(loop, FIRFilterInterpolation ## isa), \
+		BuildMixFuncTable(loop, AmigaBlepInterpolation), \
+	}
+
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2)
+static const MixFuncInterface FunctionsSSE2[6 * 16] = BuildMixFuncTableSIMD(SampleLoop, SSE2);
+#endif
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+static const MixFuncInterface FunctionsAVX2[6 * 16] = BuildMixFuncTableSIMD(SampleLoopAVX2, AVX2);
+#endif
+#if defined(MPT_ENABLE_ARCH_INTRINSICS_NEON)
+static const MixFuncInterface FunctionsNEON[6 * 16] = BuildMixFuncTableSIMD(SampleLoop, NEON);
+#endif
+
+#undef BuildMixFuncTableSIMD
+
+#endif // MPT_INTMIXER
+
 #undef BuildMixFuncTableRamp
 #undef BuildMixFuncTableFilter
 #undef BuildMixFuncTable
 
 
+const MixFuncInterface *GetFunctions(Kernels kernels)
+{
+	switch(kernels)
+	{
+	case Kernels::Scalar:
+		return Functions;
+#if defined(MPT_INTMIXER) && defined(MPT_ENABLE_ARCH_INTRINSICS_SSE2)
+	case Kernels::SSE2:
+		if(CPU::HasFeatureSet(CPU::feature::sse2) && CPU::HasModesEnabled(CPU::mode::xmm128sse))
+			return FunctionsSSE2;
+		break;
+#endif
+#if defined(MPT_INTMIXER) && defined(MPT_ENABLE_ARCH_INTRINSICS_AVX2)
+	case Kernels::AVX2:
+		if(CPU::HasFeatureSet(CPU::feature::sse2 | CPU::feature::avx2) && CPU::HasModesEnabled(CPU::mode::xmm128sse | CPU::mode::ymm256avx))
+			return FunctionsAVX2;
+		break;
+#endif
+#if defined(MPT_INTMIXER) && defined(MPT_ENABLE_ARCH_INTRINSICS_NEON)
+	case Kernels::NEON:
+		// Part of the baseline instruction set of all targets it is enabled for
+		return FunctionsNEON;
+#endif
+	default:
+		break;
+	}
+	return nullptr;
+}
+
+
+const MixFuncInterface *GetFunctions()
+{
+	static const MixFuncInterface *const functions = []()
+	{
+		for(const auto kernels : {Kernels::AVX2, Kernels::SSE2, Kernels::NEON})
+		{
+			if(const MixFuncInterface *table = GetFunctions(kernels))
+				return table;
+		}
+		return Functions;
+	}();
+	return functions;
+}
+
+
 ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode)
 {
 	switch(resamplingMode)
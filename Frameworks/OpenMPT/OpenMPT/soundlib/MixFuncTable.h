@@ -44,8 +44,23 @@ namespace MixFuncTable
 		ndxAmigaBlep       = 0x50,
 	};
 
+	// Interpolation kernel implementations
+	enum class Kernels
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		NEON,
+	};
+
 	extern const MixFuncInterface Functions[6 * 16];
 
+	// Returns the function table using the given interpolation kernels, or nullptr if they are not supported by this build or CPU.
+	// All tables produce bit-identical output.
+	const MixFuncInterface *GetFunctions(Kernels kernels);
+	// Returns the function table using the fastest interpolation kernels available
+	const MixFuncInterface *GetFunctions();
+
 	ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode);
 }
 
@@ -78,35 +78,40 @@ struct NoInterpolation
 // InterpolationFunc: Functor for reading the sample data and doing the SRC
 // FilterFunc: Functor for applying the resonant filter
 // MixFunc: Functor for mixing the computed sample data into the output buffer
-template<class Traits, class InterpolationFunc, class FilterFunc, class MixFunc>
-static void SampleLoop(ModChannel &chn, const CResampler &resampler, typename Traits::output_t * MPT_RESTRICT outBuffer, unsigned int numSamples)
-{
-	ModChannel &c = chn;
-	const typename Traits::input_t * MPT_RESTRICT inSample = static_cast<const typename Traits::input_t *>(c.pCurrentSample);
-
-	InterpolationFunc interpolate{c, resampler, numSamples};
-	FilterFunc filter{c};
-	MixFunc mix{c};
-
-	unsigned int samples = numSamples;
-	SamplePosition smpPos = c.position;            // Fixed-point sample position
-	const SamplePosition increment = c.increment;  // Fixed-point sample increment
-
-	while(samples--)
-	{
-		typename Traits::outbuf_t outSample;
-		interpolate(outSample, inSample + smpPos.GetInt() * Traits::numChannelsIn, smpPos.GetFract());
-		filter(outSample, c);
-		mix(outSample, c, outBuffer);
-		outBuffer += Traits::numChannelsOut;
-
-		smpPos += increment;
-	}
-
-	c.position = smpPos;
+// The loop is defined through a macro so that it can be instantiated with additional function attributes,
+// such as the target instruction set of the SIMD interpolation kernels in IntMixerSIMD.h.
+#define MPT_DEFINE_SAMPLELOOP(name, attributes) \
+template<class Traits, class InterpolationFunc, class FilterFunc, class MixFunc> \
+attributes static void name(ModChannel &chn, const CResampler &resampler, typename Traits::output_t * MPT_RESTRICT outBuffer, unsigned int numSamples) \
+{ \
+	ModChannel &c = chn; \
+	const typename Traits::input_t * MPT_RESTRICT inSample = static_cast<const typename Traits::input_t *>(c.pCurrentSample); \
+ \
+	InterpolationFunc interpolate{c, resampler, numSamples}; \
+	FilterFunc filter{c}; \
+	MixFunc mix{c}; \
+ \
+	unsigned int samples = numSamples; \
+	SamplePosition smpPos = c.position;            /* Fixed-point sample position */ \
+	const SamplePosition increment = c.increment;  /* Fixed-point sample increment */ \
+ \
+	while(samples--) \
+	{ \
+		typename Traits::outbuf_t outSample; \
+		interpolate(outSample, inSample + smpPos.GetInt() * Traits::numChannelsIn, smpPos.GetFract()); \
+		filter(outSample, c); \
+		mix(outSample, c, outBuffer); \
+		outBuffer += Traits::numChannelsOut; \
+ \
+		smpPos += increment; \
+	} \
+ \
+	c.position = smpPos; \
 }
 
-// Type of the SampleLoop function above
+MPT_DEFINE_SAMPLELOOP(SampleLoop, )
+
+// Type of the SampleLoop functions above
 using MixFuncInterface = void (*)(ModChannel &, const CResampler &, mixsample_t *, unsigned int);
 
 OPENMPT_NAMESPACE_END
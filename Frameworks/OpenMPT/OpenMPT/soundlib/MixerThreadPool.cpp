@@ -0,0 +1,124 @@
+/*
+ * MixerThreadPool.cpp
+ * -------------------
+ * Purpose: Worker threads for mixing subsets of the active channels in parallel.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+#include "MixerThreadPool.h"
+
+#include <algorithm>
+#include <system_error>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+MixerThreadPool::MixerThreadPool(uint32 numThreads)
+{
+#ifndef MPT_ENABLE_MIXER_THREADS
+	numThreads = 1;
+#endif
+	numThreads = std::clamp(numThreads, uint32(1), MaxThreads);
+	m_state.reserve(numThreads);
+	for(uint32 thread = 0; thread < numThreads; thread++)
+	{
+		m_state.push_back(std::make_unique<MixerThreadState>());
+	}
+#ifdef MPT_ENABLE_MIXER_THREADS
+	m_threads.reserve(numThreads - 1);
+	try
+	{
+		for(uint32 thread = 1; thread < numThreads; thread++)
+		{
+			m_threads.emplace_back(&MixerThreadPool::WorkerThread, this, thread);
+		}
+	} catch(const std::system_error &)
+	{
+		// Could not create all threads, make do with the ones we have.
+		m_state.resize(m_threads.size() + 1);
+	}
+#endif // MPT_ENABLE_MIXER_THREADS
+}
+
+
+MixerThreadPool::~MixerThreadPool()
+{
+#ifdef MPT_ENABLE_MIXER_THREADS
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_startCondition.notify_all();
+	for(auto &thread : m_threads)
+	{
+		thread.join();
+	}
+#endif // MPT_ENABLE_MIXER_THREADS
+}
+
+
+void MixerThreadPool::RunJob(Job job, void *context)
+{
+#ifdef MPT_ENABLE_MIXER_THREADS
+	if(m_threads.empty())
+	{
+		job(context, 0);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = job;
+		m_context = context;
+		m_pending = static_cast<uint32>(m_threads.size());
+		m_generation++;
+	}
+	m_startCondition.notify_all();
+	job(context, 0);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this] { return m_pending == 0; });
+#else
+	job(context, 0);
+#endif // MPT_ENABLE_MIXER_THREADS
+}
+
+
+#ifdef MPT_ENABLE_MIXER_THREADS
+
+void MixerThreadPool::WorkerThread(uint32 thread)
+{
+	uint64 generation = 0;
+	while(true)
+	{
+		Job job;
+		void *context;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation] { return m_quit || m_generation != generation; });
+			if(m_quit)
+				return;
+			generation = m_generation;
+			job = m_job;
+			context = m_context;
+		}
+
+		job(context, thread);
+
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			done = (--m_pending == 0);
+		}
+		if(done)
+			m_doneCondition.notify_one();
+	}
+}
+
+#endif // MPT_ENABLE_MIXER_THREADS
+
+
+OPENMPT_NAMESPACE_END
@@ -0,0 +1,114 @@
+/*
+ * MixerThreadPool.h
+ * -----------------
+ * Purpose: Worker threads for mixing subsets of the active channels in parallel.
+ * Notes  : Each thread mixes into its own partial buffers, which are summed in a fixed order afterwards.
+ *          With the integer mixer, this produces exactly the same output as mixing all channels serially.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "openmpt/all/BuildSettings.hpp"
+
+#include "mpt/mutex/mutex.hpp"
+
+#include "Mixer.h"
+#include "Snd_defs.h"
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if MPT_MUTEX_STD
+#include <condition_variable>
+#include <thread>
+#endif
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+#if MPT_MUTEX_STD
+#define MPT_ENABLE_MIXER_THREADS
+#endif
+
+
+// Destination of a single channel's mix output
+struct MixerChannelTarget
+{
+	mixsample_t *buffer = nullptr;
+	mixsample_t *ofsR = nullptr;
+	mixsample_t *ofsL = nullptr;
+	CHANNELINDEX mixIndex = 0;  // Index into PlayState::ChnMix
+	PLUGINDEX plugin = 0;       // Mix plugin that receives the channel's output, if any
+};
+
+
+// Channels assigned to one thread, and the partial buffers it mixes them into
+struct MixerThreadState
+{
+	std::array<mixsample_t, MIXBUFFERSIZE * 2> dryBuffer;
+	std::array<mixsample_t, MIXBUFFERSIZE * 2> rearBuffer;
+	std::array<mixsample_t, MIXBUFFERSIZE * 2> reverbBuffer;
+	mixsample_t dryOfsR = 0, dryOfsL = 0;
+	mixsample_t rearOfsR = 0, rearOfsL = 0;
+	mixsample_t reverbOfsR = 0, reverbOfsL = 0;
+	bool usesRear = false, usesReverb = false;
+
+	std::array<MixerChannelTarget, MAX_CHANNELS> channels;
+	CHANNELINDEX numChannels = 0;
+	CHANNELINDEX numMixed = 0;
+};
+
+
+class MixerThreadPool
+{
+public:
+	// Upper limit for the number of mixer threads, including the thread calling Run()
+	static constexpr uint32 MaxThreads = 16;
+	// Modules with fewer active channels per thread are not worth the synchronization overhead
+	static constexpr CHANNELINDEX MinChannelsPerThread = 8;
+
+	// Spawns numThreads - 1 workers, as the calling thread does its share of the work as well.
+	explicit MixerThreadPool(uint32 numThreads);
+	~MixerThreadPool();
+
+	MixerThreadPool(const MixerThreadPool &) = delete;
+	MixerThreadPool &operator=(const MixerThreadPool &) = delete;
+
+	uint32 GetNumThreads() const noexcept { return static_cast<uint32>(m_state.size()); }
+	MixerThreadState &GetState(uint32 thread) noexcept { return *m_state[thread]; }
+
+	// Calls func(thread) once for every thread index, index 0 on the calling thread. Returns after all calls have finished.
+	template <typename Func>
+	void Run(Func &&func)
+	{
+		RunJob([](void *context, uint32 thread) { (*static_cast<std::remove_reference_t<Func> *>(context))(thread); }, &func);
+	}
+
+private:
+	using Job = void (*)(void *context, uint32 thread);
+	void RunJob(Job job, void *context);
+
+	std::vector<std::unique_ptr<MixerThreadState>> m_state;
+
+#ifdef MPT_ENABLE_MIXER_THREADS
+	void WorkerThread(uint32 thread);
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition, m_doneCondition;
+	Job m_job = nullptr;
+	void *m_context = nullptr;
+	uint64 m_generation = 0;
+	uint32 m_pending = 0;
+	bool m_quit = false;
+#endif // MPT_ENABLE_MIXER_THREADS
+};
+
+
+OPENMPT_NAMESPACE_END
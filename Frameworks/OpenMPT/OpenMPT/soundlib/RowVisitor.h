@@ -91,6 +91,12 @@ public:
 	// Mark an order/row combination as visited and returns true if it was visited before.
 	bool Visit(ORDERINDEX ord, ROWINDEX row, const ChannelStates &chnState, bool ignoreRow);
 
+	// Returns true if an order/row combination has been visited at least once.
+	[[nodiscard]] bool IsVisited(ORDERINDEX ord, ROWINDEX row) const noexcept
+	{
+		return ord < m_visitedRows.size() && row < m_visitedRows[ord].size() && m_visitedRows[ord][row];
+	}
+
 	// Find the first row that has not been played yet.
 	// The order and row is stored in the order and row variables on success, on failure they contain invalid values.
 	// If onlyUnplayedPatterns is true (default), only completely unplayed patterns are considered, otherwise a song can start anywhere.
@@ -0,0 +1,263 @@
+/*
+ * SampleDecodeQueue.cpp
+ * ---------------------
+ * Purpose: Decoding of compressed sample data on worker threads or when a sample is first played.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+#include "SampleDecodeQueue.h"
+#include "Sndfile.h"
+
+#include <algorithm>
+#include <system_error>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+void SampleDecodeLog::AddToLog(LogLevel level, const mpt::ustring &text) const
+{
+	m_messages.emplace_back(level, text);
+}
+
+
+void SampleDecodeLog::ForwardTo(const CSoundFile &sndFile)
+{
+	for(const auto &[level, text] : m_messages)
+	{
+		sndFile.AddToLog(level, text);
+	}
+	m_messages.clear();
+}
+
+
+SampleDecodeQueue::~SampleDecodeQueue()
+{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	if(m_backgroundThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_backgroundThread.join();
+	}
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+	for(auto &job : m_jobs)
+	{
+		job.sample.FreeSample();
+	}
+}
+
+
+void SampleDecodeQueue::Add(SAMPLEINDEX smp, const ModSample &properties, SampleDecodeFunc func)
+{
+	MPT_ASSERT(m_nextJob == 0);
+	if(smp >= m_jobOfSample.size())
+		m_jobOfSample.resize(smp + 1, NoJob);
+	if(m_jobOfSample[smp] != NoJob)
+	{
+		// Replace previous job for this slot
+		m_jobs[m_jobOfSample[smp]].func = std::move(func);
+		return;
+	}
+	Job &job = m_jobs.emplace_back();
+	job.smp = smp;
+	job.sample = properties;
+	job.sample.pData.pSample = nullptr;
+	job.func = std::move(func);
+	m_jobOfSample[smp] = static_cast<uint32>(m_jobs.size() - 1);
+	m_numPending++;
+}
+
+
+bool SampleDecodeQueue::DecodeAll(CSoundFile &sndFile)
+{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	std::vector<std::thread> threads;
+	if(!m_backgroundThread.joinable())
+	{
+		const uint32 numThreads = std::clamp(std::thread::hardware_concurrency(), 1u, MaxThreads);
+		const size_t numWorkers = std::min(static_cast<size_t>(numThreads - 1), m_jobs.size() - std::min(m_jobs.size(), size_t(1)));
+		try
+		{
+			for(size_t thread = 0; thread < numWorkers; thread++)
+			{
+				threads.emplace_back([this]()
+				{
+					while(Job *job = ClaimNextJob())
+						RunJob(*job);
+				});
+			}
+		} catch(const std::system_error &)
+		{
+			// Could not create all threads, make do with the ones we have.
+		}
+	}
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+
+	while(Job *job = ClaimNextJob())
+	{
+		RunJob(*job);
+	}
+
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	for(auto &thread : threads)
+	{
+		thread.join();
+	}
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+
+	// Hand over results in sample order, so that log messages appear in the same order as with serial decoding
+	bool success = true;
+	for(auto &job : m_jobs)
+	{
+		if(IsPending(job.smp))
+		{
+			WaitForJob(job);
+			if(!Commit(sndFile, job))
+				success = false;
+		}
+	}
+	return success;
+}
+
+
+bool SampleDecodeQueue::Decode(CSoundFile &sndFile, SAMPLEINDEX smp)
+{
+	if(!IsPending(smp))
+		return true;
+	Job &job = m_jobs[m_jobOfSample[smp]];
+	bool claimed = false;
+	{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+		std::lock_guard<std::mutex> lock(m_mutex);
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+		if(job.state == JobState::Queued)
+		{
+			job.state = JobState::Decoding;
+			claimed = true;
+		}
+	}
+	if(claimed)
+		RunJob(job);
+	else
+		WaitForJob(job);
+	return Commit(sndFile, job);
+}
+
+
+void SampleDecodeQueue::StartBackgroundThread()
+{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	if(m_backgroundThread.joinable() || IsEmpty())
+		return;
+	try
+	{
+		m_backgroundThread = std::thread(&SampleDecodeQueue::BackgroundThread, this);
+	} catch(const std::system_error &)
+	{
+		// Samples will be decoded when they are first played.
+	}
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+}
+
+
+SampleDecodeQueue::Job *SampleDecodeQueue::ClaimNextJob()
+{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_quit)
+		return nullptr;
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+	while(m_nextJob < m_jobs.size())
+	{
+		Job &job = m_jobs[m_nextJob++];
+		if(job.state == JobState::Queued)
+		{
+			job.state = JobState::Decoding;
+			return &job;
+		}
+	}
+	return nullptr;
+}
+
+
+void SampleDecodeQueue::RunJob(Job &job)
+{
+	const bool success = job.func(job.sample, job.log);
+	// The compressed data is no longer needed
+	SampleDecodeFunc func = std::move(job.func);
+	{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+		std::lock_guard<std::mutex> lock(m_mutex);
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+		job.success = success;
+		job.state = JobState::Decoded;
+	}
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	m_jobDone.notify_all();
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+}
+
+
+void SampleDecodeQueue::WaitForJob(Job &job)
+{
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobDone.wait(lock, [&job] { return job.state == JobState::Decoded; });
+#else
+	MPT_ASSERT(job.state == JobState::Decoded);
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+}
+
+
+// Replace the module's sample data with the decoded data. The job must have finished decoding.
+bool SampleDecodeQueue::Commit(CSoundFile &sndFile, Job &job)
+{
+	ModSample &sample = sndFile.GetSample(job.smp);
+	const bool success = job.success && job.sample.HasSampleData();
+	if(success)
+	{
+		MPT_ASSERT(job.sample.nLength == sample.nLength || !sample.HasSampleData());
+		void *oldData = sample.samplev();
+		sample.pData.pSample = job.sample.samplev();
+		sample.nLength = job.sample.nLength;
+		job.sample.pData.pSample = nullptr;
+		// Channels that already picked up the placeholder data of a deferred sample must not keep a dangling pointer
+		for(auto &chn : sndFile.m_PlayState.Chn)
+		{
+			if(chn.pCurrentSample == oldData && oldData != nullptr)
+				chn.pCurrentSample = sample.samplev();
+		}
+		ModSample::FreeSample(oldData);
+		sample.PrecomputeLoops(sndFile, false);
+	} else
+	{
+		job.sample.FreeSample();
+	}
+	job.log.ForwardTo(sndFile);
+	m_jobOfSample[job.smp] = NoJob;
+	m_numPending--;
+	return success;
+}
+
+
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+
+void SampleDecodeQueue::BackgroundThread()
+{
+	while(Job *job = ClaimNextJob())
+	{
+		RunJob(*job);
+	}
+}
+
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+
+
+OPENMPT_NAMESPACE_END
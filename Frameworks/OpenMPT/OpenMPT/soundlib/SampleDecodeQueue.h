@@ -0,0 +1,122 @@
+/*
+ * SampleDecodeQueue.h
+ * -------------------
+ * Purpose: Decoding of compressed sample data on worker threads or when a sample is first played.
+ * Notes  : Decode jobs own a copy of their compressed data and only write to a private ModSample,
+ *          so they can run concurrently and after the module file has been closed.
+ *          Decoded data is only ever handed over to the module on the thread that owns it.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "openmpt/all/BuildSettings.hpp"
+
+#include "mpt/mutex/mutex.hpp"
+
+#include "../common/Logging.h"
+#include "Sndfile.h"
+
+#include <utility>
+#include <vector>
+
+#if MPT_MUTEX_STD
+#include <condition_variable>
+#include <thread>
+#endif
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+#if MPT_MUTEX_STD
+#define MPT_ENABLE_SAMPLE_DECODE_THREADS
+#endif
+
+
+// Collects the log messages of a decode job, so that they can be forwarded to the module later.
+class SampleDecodeLog : public ILog
+{
+public:
+	void AddToLog(LogLevel level, const mpt::ustring &text) const override;
+	// Forward all collected messages and forget about them
+	void ForwardTo(const CSoundFile &sndFile);
+
+protected:
+	mutable std::vector<std::pair<LogLevel, mpt::ustring>> m_messages;
+};
+
+
+class SampleDecodeQueue
+{
+public:
+	// Upper limit for the number of threads used by DecodeAll, including the calling thread
+	static constexpr uint32 MaxThreads = 16;
+
+	SampleDecodeQueue() = default;
+	~SampleDecodeQueue();
+
+	SampleDecodeQueue(const SampleDecodeQueue &) = delete;
+	SampleDecodeQueue &operator=(const SampleDecodeQueue &) = delete;
+
+	// Queue a sample for decoding. Must not be called anymore once decoding has started.
+	void Add(SAMPLEINDEX smp, const ModSample &properties, SampleDecodeFunc func);
+
+	// Returns true if the sample's decoded data has not been handed over to the module yet.
+	bool IsPending(SAMPLEINDEX smp) const noexcept { return smp < m_jobOfSample.size() && m_jobOfSample[smp] != NoJob; }
+	bool IsEmpty() const noexcept { return m_numPending == 0; }
+
+	// Decode all pending samples on the calling thread and up to MaxThreads - 1 worker threads, then hand them over to the module.
+	// Returns false if any sample could not be decoded.
+	bool DecodeAll(CSoundFile &sndFile);
+	// Decode a single pending sample (or wait for the background thread to finish decoding it) and hand it over to the module.
+	// Returns false if the sample could not be decoded.
+	bool Decode(CSoundFile &sndFile, SAMPLEINDEX smp);
+	// Start decoding pending samples in sample order on a background thread.
+	// Results are only handed over to the module by Decode and DecodeAll.
+	void StartBackgroundThread();
+
+protected:
+	enum class JobState
+	{
+		Queued,
+		Decoding,
+		Decoded,
+	};
+
+	struct Job
+	{
+		SAMPLEINDEX smp = 0;
+		ModSample sample;
+		SampleDecodeFunc func;
+		SampleDecodeLog log;
+		JobState state = JobState::Queued;
+		bool success = false;
+	};
+
+	static constexpr uint32 NoJob = uint32_max;
+
+	Job *ClaimNextJob();
+	void RunJob(Job &job);
+	void WaitForJob(Job &job);
+	bool Commit(CSoundFile &sndFile, Job &job);
+
+	std::vector<Job> m_jobs;
+	std::vector<uint32> m_jobOfSample;  // Index into m_jobs for every sample slot that is pending
+	size_t m_nextJob = 0;
+	SAMPLEINDEX m_numPending = 0;
+
+#ifdef MPT_ENABLE_SAMPLE_DECODE_THREADS
+	void BackgroundThread();
+
+	std::mutex m_mutex;
+	std::condition_variable m_jobDone;
+	std::thread m_backgroundThread;
+	bool m_quit = false;
+#endif // MPT_ENABLE_SAMPLE_DECODE_THREADS
+};
+
+
+OPENMPT_NAMESPACE_END
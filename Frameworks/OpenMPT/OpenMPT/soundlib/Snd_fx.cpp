@@ -57,12 +57,7 @@ protected:
 
 public:
 	std::unique_ptr<CSoundFile::PlayState> state;
-	struct ChnSettings
-	{
-		uint32 ticksToRender = 0;	// When using sample sync, we still need to render this many ticks
-		bool incChanged = false;	// When using sample sync, note frequency has changed
-		uint8 vol = 0xFF;
-	};
+	using ChnSettings = CSoundFile::GetLengthChnSettings;
 
 	std::vector<ChnSettings> chnSettings;
 	double elapsedTime;
@@ -296,8 +291,6 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 
 	GetLengthMemory memory(*this);
 	CSoundFile::PlayState &playState = *memory.state;
-	// Temporary visited rows vector (so that GetLength() won't interfere with the player code if the module is playing at the same time)
-	RowVisitor visitedRows(*this, sequence);
 	ROWINDEX allowedPatternLoopComplexity = 32768;
 
 	// If sequence starts with some non-existent patterns, find a better start
@@ -309,8 +302,38 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 	retval.startRow = playState.m_nNextRow = playState.m_nRow = target.startRow;
 	retval.startOrder = playState.m_nNextOrder = playState.m_nCurrentOrder = target.startOrder;
 
+	// Seeks can resume from a snapshot taken by an earlier seek from the same start position, as long as it was taken before reaching the target.
+	SeekCheckpointList *checkpoints = nullptr;
+	const SeekCheckpoint *resumeFrom = nullptr;
+	if(m_seekCheckpointInterval && hasSearchTarget && (adjustMode & eAdjust))
+	{
+		checkpoints = &GetSeekCheckpointList(sequence, target.startOrder, target.startRow, adjustSamplePos);
+		bool canResume = true;
+		if(target.mode == GetLengthTarget::SeekPosition)
+		{
+			// A valid target row is marked as visited once it is reached, which tells us if a snapshot was taken before that.
+			const PATTERNINDEX targetPat = target.pos.order < orderList.size() ? orderList[target.pos.order] : orderList.GetInvalidPatIndex();
+			canResume = Patterns.IsValidPat(targetPat) && Patterns[targetPat].IsValidRow(target.pos.row);
+		}
+		for(auto checkpoint = checkpoints->checkpoints.crbegin(); canResume && checkpoint != checkpoints->checkpoints.crend(); checkpoint++)
+		{
+			if(target.mode == GetLengthTarget::SeekSeconds
+				? checkpoint->elapsedTime < target.time
+				: (!checkpoint->visitedRows.IsVisited(target.pos.order, target.pos.row) && !checkpoint->visitedRows.ModuleTooComplex(allowedPatternLoopComplexity)))
+			{
+				resumeFrom = &*checkpoint;
+				break;
+			}
+		}
+	}
+
+	// Temporary visited rows vector (so that GetLength() won't interfere with the player code if the module is playing at the same time)
+	RowVisitor visitedRows = resumeFrom ? resumeFrom->visitedRows : RowVisitor(*this, sequence);
+
 	// Fast LUTs for commands that are too weird / complicated / whatever to emulate in sample position adjust mode.
 	std::bitset<MAX_EFFECTS> forbiddenCommands;
+	// Snapshots are not taken if some channels are not simulated, as the state of those channels would be incomplete.
+	bool ignoringChannels = false;
 
 	if(adjustSamplePos)
 	{
@@ -329,6 +352,7 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 						|| (m->IsNote() && !m->IsPortamento()))
 					{
 						memory.chnSettings[i].ticksToRender = GetLengthMemory::IGNORE_CHANNEL;
+						ignoringChannels = true;
 					}
 				}
 			}
@@ -341,9 +365,47 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 	// If samples are being synced, force them to resync if tick duration changes
 	uint32 oldTickDuration = 0;
 	bool breakToRow = false;
+	uint32 rowCount = 0;
+
+	if(resumeFrom)
+	{
+		*memory.state = *resumeFrom->state;
+		for(CHANNELINDEX chn = 0; chn < GetNumChannels(); chn++)
+		{
+			if(memory.chnSettings[chn].ticksToRender != GetLengthMemory::IGNORE_CHANNEL)
+				memory.chnSettings[chn] = resumeFrom->chnSettings[chn];
+		}
+		memory.elapsedTime = resumeFrom->elapsedTime;
+		retval = resumeFrom->retval;
+		oldTickDuration = resumeFrom->oldTickDuration;
+		rowCount = resumeFrom->rowCount;
+		breakToRow = resumeFrom->breakToRow;
+	}
 
 	for (;;)
 	{
+		// Snapshots can only be taken before the first jump to another sub song, as the state of the previous one would be lost.
+		if(checkpoints && !ignoringChannels && results.empty() && rowCount && !(rowCount % checkpoints->interval)
+			&& (checkpoints->checkpoints.empty() || checkpoints->checkpoints.back().rowCount < rowCount))
+		{
+			if(checkpoints->checkpoints.size() >= MAX_SEEK_CHECKPOINTS)
+			{
+				// Keep every other snapshot
+				checkpoints->interval *= 2;
+				std::vector<SeekCheckpoint> remaining;
+				remaining.reserve(MAX_SEEK_CHECKPOINTS);
+				for(auto &checkpoint : checkpoints->checkpoints)
+				{
+					if(!(checkpoint.rowCount % checkpoints->interval))
+						remaining.push_back(std::move(checkpoint));
+				}
+				checkpoints->checkpoints = std::move(remaining);
+			}
+			if(!(rowCount % checkpoints->interval))
+				checkpoints->checkpoints.push_back({std::make_unique<PlayState>(playState), visitedRows, memory.chnSettings, retval, memory.elapsedTime, oldTickDuration, rowCount, breakToRow});
+		}
+		rowCount++;
+
 		const bool ignoreRow = NextRow(playState, breakToRow).first;
 
 		// Time target reached.
@@ -1358,6 +1420,42 @@ std::vector<GetLengthType> CSoundFile::GetLength(enmGetLengthResetMode adjustMod
 }
 
 
+void CSoundFile::SetSeekCheckpointInterval(ROWINDEX rows)
+{
+	if(rows != m_seekCheckpointInterval)
+		ClearSeekCheckpoints();
+	m_seekCheckpointInterval = rows;
+}
+
+
+void CSoundFile::ClearSeekCheckpoints()
+{
+	m_seekCheckpoints.clear();
+}
+
+
+size_t CSoundFile::GetNumSeekCheckpoints() const noexcept
+{
+	size_t numCheckpoints = 0;
+	for(const auto &list : m_seekCheckpoints)
+		numCheckpoints += list.checkpoints.size();
+	return numCheckpoints;
+}
+
+
+CSoundFile::SeekCheckpointList &CSoundFile::GetSeekCheckpointList(SEQUENCEINDEX sequence, ORDERINDEX startOrder, ROWINDEX startRow, bool adjustSamplePos)
+{
+	// Row durations depend on the tempo factor, which can be changed directly through m_nTempoFactor at any time
+	m_seekCheckpoints.erase(std::remove_if(m_seekCheckpoints.begin(), m_seekCheckpoints.end(), [this](const SeekCheckpointList &list) { return list.tempoFactor != m_nTempoFactor; }), m_seekCheckpoints.end());
+	for(auto &list : m_seekCheckpoints)
+	{
+		if(list.sequence == sequence && list.startOrder == startOrder && list.startRow == startRow && list.adjustSamplePos == adjustSamplePos)
+			return list;
+	}
+	return m_seekCheckpoints.emplace_back(SeekCheckpointList{sequence, startOrder, startRow, adjustSamplePos, m_nTempoFactor, m_seekCheckpointInterval, {}});
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // Effects
 
@@ -36,6 +36,8 @@
 #include "../common/FileReader.h"
 #include "Container.h"
 #include "OPL.h"
+#include "MixerThreadPool.h"
+#include "SampleDecodeQueue.h"
 #include "mpt/io/io.hpp"
 #include "mpt/io/io_stdstream.hpp"
 
@@ -808,6 +810,8 @@ bool CSoundFile::Destroy()
 	}
 
 	Patterns.DestroyPatterns();
+	ClearSeekCheckpoints();
+	m_pendingSamples.reset();
 
 	m_songName.clear();
 	m_songArtist.clear();
@@ -1596,6 +1600,61 @@ bool CSoundFile::DestroySampleThreadsafe(SAMPLEINDEX nSample)
 }
 
 
+bool CSoundFile::DecodeSampleData(SAMPLEINDEX smp, SampleDecodeFunc func, ModLoadingFlags loadFlags)
+{
+	ModSample &sample = Samples[smp];
+	if(!(loadFlags & (loadSamplesParallel | loadSamplesDeferred)))
+	{
+		SampleDecodeLog log;
+		const bool success = func(sample, log);
+		log.ForwardTo(*this);
+		return success;
+	}
+	if(loadFlags & loadSamplesDeferred)
+	{
+		// Playback code has to see the same sample properties as with decoded sample data, so use silence until the sample is decoded.
+		if(!sample.AllocateSample())
+			return true;
+	}
+	if(!m_pendingSamples)
+		m_pendingSamples = std::make_unique<SampleDecodeQueue>();
+	m_pendingSamples->Add(smp, sample, std::move(func));
+	return true;
+}
+
+
+bool CSoundFile::FinishSampleDecoding(ModLoadingFlags loadFlags)
+{
+	if(!m_pendingSamples)
+		return true;
+	if(loadFlags & loadSamplesDeferred)
+	{
+		m_pendingSamples->StartBackgroundThread();
+		return true;
+	}
+	const bool success = m_pendingSamples->DecodeAll(*this);
+	m_pendingSamples.reset();
+	return success;
+}
+
+
+bool CSoundFile::IsSamplePending(SAMPLEINDEX smp) const noexcept
+{
+	return m_pendingSamples && m_pendingSamples->IsPending(smp);
+}
+
+
+void CSoundFile::DecodePendingSample(SAMPLEINDEX smp)
+{
+	if(!IsSamplePending(smp))
+		return;
+	if(!m_pendingSamples->Decode(*this, smp))
+		AddToLog(LogWarning, MPT_UFORMAT("Sample {}: Compressed sample data could not be decoded.")(smp));
+	if(m_pendingSamples->IsEmpty())
+		m_pendingSamples.reset();
+}
+
+
 std::unique_ptr<CTuning> CSoundFile::CreateTuning12TET(const mpt::ustring &name)
 {
 	std::unique_ptr<CTuning> pT = CTuning::CreateGeometric(name, 12, 2, 15);
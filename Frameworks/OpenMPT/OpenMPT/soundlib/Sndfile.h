@@ -19,6 +19,7 @@
 #include "../common/mptFileType.h"
 #include "../common/mptRandom.h"
 #include "../common/version.h"
+#include <functional>
 #include <vector>
 #include <bitset>
 #include <set>
@@ -233,9 +234,17 @@ class CTuningCollection;
 using CTuningCollection = Tuning::CTuningCollection;
 struct CModSpecifications;
 class OPL;
+class MixerThreadPool;
+struct MixerChannelTarget;
+class SampleDecodeQueue;
 class CModDoc;
 
 
+// Decodes sample data into the given sample, which has all properties except for the sample data set up already.
+// Returns false if the sample data could not be decoded.
+using SampleDecodeFunc = std::function<bool(ModSample &sample, const ILog &log)>;
+
+
 /////////////////////////////////////////////////////////////////////////
 // File edit history
 
@@ -624,6 +633,44 @@ protected:
 	// For handling backwards jumps and stuff to prevent infinite loops when counting the mod length or rendering to wav.
 	RowVisitor m_visitedRows;
 
+	// Per-channel sample seeking state of GetLength()
+	struct GetLengthChnSettings
+	{
+		uint32 ticksToRender = 0;  // When using sample sync, we still need to render this many ticks
+		bool incChanged = false;   // When using sample sync, note frequency has changed
+		uint8 vol = 0xFF;
+	};
+
+	// Snapshot of the GetLength() simulation, taken at the start of a row while seeking
+	struct SeekCheckpoint
+	{
+		std::unique_ptr<PlayState> state;
+		RowVisitor visitedRows;
+		std::vector<GetLengthChnSettings> chnSettings;
+		GetLengthType retval;
+		double elapsedTime;
+		uint32 oldTickDuration;
+		uint32 rowCount;  // Rows simulated since the seek start position
+		bool breakToRow;
+	};
+
+	// All snapshots taken by seeks from the same start position, ordered by row count
+	struct SeekCheckpointList
+	{
+		SEQUENCEINDEX sequence;
+		ORDERINDEX startOrder;
+		ROWINDEX startRow;
+		bool adjustSamplePos;
+		uint32 tempoFactor;  // m_nTempoFactor the snapshots were taken with
+		ROWINDEX interval;  // Rows between snapshots, doubled whenever the list is full
+		std::vector<SeekCheckpoint> checkpoints;
+	};
+	// A snapshot holds a complete PlayState, so their number is limited
+	static constexpr size_t MAX_SEEK_CHECKPOINTS = 128;
+
+	std::vector<SeekCheckpointList> m_seekCheckpoints;
+	ROWINDEX m_seekCheckpointInterval = 0;  // Take a snapshot every n rows while seeking, 0 = disabled
+
 public:
 #ifdef MODPLUG_TRACKER
 	std::bitset<MAX_BASECHANNELS> m_bChannelMuteTogglePending;
@@ -634,6 +681,8 @@ public:
 #endif // MODPLUG_TRACKER
 
 	std::unique_ptr<OPL> m_opl;
+	std::unique_ptr<MixerThreadPool> m_mixerThreads;
+	std::unique_ptr<SampleDecodeQueue> m_pendingSamples;  // Compressed samples that have not been decoded yet (see loadSamplesParallel / loadSamplesDeferred)
 
 #ifdef MODPLUG_TRACKER
 public:
@@ -706,6 +755,8 @@ public:
 		loadPluginInstance = 0x08, // If unset, plugins are not instanciated.
 		skipContainer      = 0x10,
 		skipModules        = 0x20,
+		loadSamplesParallel = 0x40, // If set, advise loaders to decode compressed sample data on several threads
+		loadSamplesDeferred = 0x80, // If set, advise loaders to decode compressed sample data in the background or when the sample is first played
 
 		// Shortcuts
 		loadCompleteModule = loadSampleData | loadPatternData | loadPluginData | loadPluginInstance,
@@ -824,6 +875,17 @@ public:
 	// Get song duration in various cases: total length, length to specific order & row, etc.
 	std::vector<GetLengthType> GetLength(enmGetLengthResetMode adjustMode, GetLengthTarget target = GetLengthTarget());
 
+	// Seek checkpoints: If enabled, GetLength() keeps a snapshot of its simulation every few rows when seeking (eAdjust modes),
+	// so that later seeks from the same start position only need to simulate the rows after the closest snapshot.
+	// The interval grows if a song has more than MAX_SEEK_CHECKPOINTS of them, and 0 disables checkpoints.
+	// They have to be cleared whenever anything changes that influences playback.
+	void SetSeekCheckpointInterval(ROWINDEX rows);
+	ROWINDEX GetSeekCheckpointInterval() const noexcept { return m_seekCheckpointInterval; }
+	void ClearSeekCheckpoints();
+	size_t GetNumSeekCheckpoints() const noexcept;
+protected:
+	SeekCheckpointList &GetSeekCheckpointList(SEQUENCEINDEX sequence, ORDERINDEX startOrder, ROWINDEX startRow, bool adjustSamplePos);
+
 public:
 	void RecalculateSamplesPerTick();
 	double GetRowDuration(TEMPO tempo, uint32 speed) const;
@@ -1019,6 +1081,10 @@ public:
 	samplecount_t ReadOneTick();
 private:
 	void CreateStereoMix(int count);
+	MixerChannelTarget GetChannelMixTarget(CHANNELINDEX mixIndex, int count);
+	CHANNELINDEX MixChannel(ModChannel &chn, const MixerChannelTarget &target, int count, bool tooManyChannels);
+	bool CanMixInParallel() const;
+	CHANNELINDEX CreateStereoMixParallel(int count);
 public:
 	bool FadeSong(uint32 msec);
 private:
@@ -1037,6 +1103,9 @@ public:
 	// Mixer Config
 	void SetMixerSettings(const MixerSettings &mixersettings);
 	void SetResamplerSettings(const CResamplerSettings &resamplersettings);
+	// Number of threads that sample channels are mixed on, 1 = mix on the calling thread only
+	void SetMixerThreads(uint32 numThreads);
+	uint32 GetMixerThreads() const;
 	void InitPlayer(bool bReset=false);
 	void SetDspEffects(uint32 DSPMask);
 	uint32 GetSampleRate() const { return m_MixerSettings.gdwMixingFreq; }
@@ -1282,6 +1351,17 @@ public:
 	ModSample &GetSample(SAMPLEINDEX sample) { MPT_ASSERT(sample <= m_nSamples && sample < std::size(Samples)); return Samples[sample]; }
 	const ModSample &GetSample(SAMPLEINDEX sample) const { MPT_ASSERT(sample <= m_nSamples && sample < std::size(Samples)); return Samples[sample]; }
 
+	// Decode compressed sample data right away, or queue it for decoding if the loading flags ask for it. Returns false if immediate decoding failed.
+	bool DecodeSampleData(SAMPLEINDEX smp, SampleDecodeFunc func, ModLoadingFlags loadFlags);
+	// Called by loaders after all sample data has been read: Decode queued samples in parallel, or start decoding deferred samples in the background.
+	// Returns false if any sample could not be decoded.
+	bool FinishSampleDecoding(ModLoadingFlags loadFlags);
+	bool IsSamplePending(SAMPLEINDEX smp) const noexcept;
+	// Ensure that the data of a queued sample is available
+	void DecodePendingSample(SAMPLEINDEX smp);
+	// Decode deferred samples that are about to be played on this channel
+	void DecodeChannelSamples(const ModChannel &chn);
+
 	// Resolve note/instrument combination to real sample index. Return value is guaranteed to be in [0, GetNumSamples()].
 	SAMPLEINDEX GetSampleIndex(ModCommand::NOTE note, uint32 instr) const noexcept;
 
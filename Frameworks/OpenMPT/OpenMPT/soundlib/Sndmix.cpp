@@ -22,6 +22,8 @@
 #include "plugins/PlugInterface.h"
 #endif // NO_PLUGINS
 #include "OPL.h"
+#include "MixerThreadPool.h"
+#include "SampleDecodeQueue.h"
 
 OPENMPT_NAMESPACE_BEGIN
 
@@ -58,6 +60,8 @@ void CSoundFile::SetMixerSettings(const MixerSettings &mixersettings)
 		||
 		(mixersettings.MixerFlags != m_MixerSettings.MixerFlags))
 		reset = true;
+	if(mixersettings.gdwMixingFreq != m_MixerSettings.gdwMixingFreq)
+		ClearSeekCheckpoints();  // Row durations depend on the mixing frequency
 	m_MixerSettings = mixersettings;
 	InitPlayer(reset);
 }
@@ -71,6 +75,26 @@ void CSoundFile::SetResamplerSettings(const CResamplerSettings &resamplersetting
 }
 
 
+void CSoundFile::SetMixerThreads(uint32 numThreads)
+{
+	if(numThreads == GetMixerThreads())
+		return;
+	m_mixerThreads.reset();
+	if(numThreads > 1)
+	{
+		m_mixerThreads = std::make_unique<MixerThreadPool>(numThreads);
+		if(m_mixerThreads->GetNumThreads() < 2)
+			m_mixerThreads.reset();
+	}
+}
+
+
+uint32 CSoundFile::GetMixerThreads() const
+{
+	return m_mixerThreads ? m_mixerThreads->GetNumThreads() : 1;
+}
+
+
 void CSoundFile::InitPlayer(bool bReset)
 {
 	if(bReset)
@@ -2073,6 +2097,17 @@ std::pair<SamplePosition, uint32> CSoundFile::GetChannelIncrement(const ModChann
 ////////////////////////////////////////////////////////////////////////////////////////////
 // Handles envelopes & mixer setup
 
+// Samples with deferred decoding must be decoded before their data is handed to the mixer.
+void CSoundFile::DecodeChannelSamples(const ModChannel &chn)
+{
+	if(chn.pModSample != nullptr)
+		DecodePendingSample(static_cast<SAMPLEINDEX>(chn.pModSample - Samples));
+	// The mixer may swap to this sample on its own
+	if(m_playBehaviour[kMODSampleSwap] && chn.nNewIns <= GetNumSamples())
+		DecodePendingSample(chn.nNewIns);
+}
+
+
 bool CSoundFile::ReadNote()
 {
 #ifdef MODPLUG_TRACKER
@@ -2435,6 +2470,8 @@ bool CSoundFile::ReadNote()
 		chn.nRightVU = (chn.nRightVU > VUMETER_DECAY) ? (chn.nRightVU - VUMETER_DECAY) : 0;
 
 		chn.newLeftVol = chn.newRightVol = 0;
+		if(m_pendingSamples)
+			DecodeChannelSamples(chn);
 		chn.pCurrentSample = (chn.pModSample && chn.pModSample->HasSampleData() && chn.nLength && chn.IsSamplePlaying()) ? chn.pModSample->samplev() : nullptr;
 		if(chn.pCurrentSample || (chn.HasMIDIOutput() && !chn.dwFlags[CHN_KEYOFF | CHN_NOTEFADE]))
 		{
@@ -57,6 +57,8 @@
 #include "../soundlib/SampleNormalize.h"
 #include "../soundlib/ModSampleCopy.h"
 #include "../soundlib/ITCompression.h"
+#include "../soundlib/ITTools.h"
+#include "../soundlib/MixFuncTable.h"
 #include "../soundlib/tuningcollection.h"
 #include "../soundlib/tuning.h"
 #include "openmpt/soundbase/Dither.hpp"
@@ -86,6 +88,7 @@
 #include "../soundlib/plugins/PlugInterface.h"
 #endif
 #include <sstream>
+#include <chrono>
 #include <limits>
 #ifdef LIBOPENMPT_BUILD
 #include <iomanip>
@@ -142,8 +145,12 @@ static MPT_NOINLINE void TestStringIO();
 static MPT_NOINLINE void TestMIDIEvents();
 static MPT_NOINLINE void TestSampleConversion();
 static MPT_NOINLINE void TestITCompression();
+static MPT_NOINLINE void TestMixerKernels();
+static MPT_NOINLINE void TestParallelMixer();
+static MPT_NOINLINE void TestSampleDecoding();
 static MPT_NOINLINE void TestPCnoteSerialization();
 static MPT_NOINLINE void TestLoadSaveFile();
+static MPT_NOINLINE void TestSeekCheckpoints();
 static MPT_NOINLINE void TestEditing();
 
 
@@ -439,9 +446,13 @@ void DoTests()
 	DO_TEST(TestMIDIEvents);
 	DO_TEST(TestSampleConversion);
 	DO_TEST(TestITCompression);
+	DO_TEST(TestMixerKernels);
+	DO_TEST(TestParallelMixer);
+	DO_TEST(TestSampleDecoding);
 
 	// slower tests, require opening a CModDoc
 	DO_TEST(TestPCnoteSerialization);
+	DO_TEST(TestSeekCheckpoints);
 	DO_TEST(TestLoadSaveFile);
 	DO_TEST(TestEditing);
 
@@ -3261,6 +3272,70 @@ static void TestLoadMPTMFile(const CSoundFile &sndFile)
 }
 
 
+// Seeking from a checkpoint has to end up in the same state as simulating the whole sub song.
+static void CheckSeekCheckpoints(CSoundFile &sndFile, const GetLengthType &subSong)
+{
+	const double seekTime = subSong.duration * 0.9;
+
+	for(const auto adjustMode : {eAdjust, eAdjustSamplePositions})
+	{
+		const auto seek = [&](GetLengthTarget target)
+		{
+			sndFile.SetCurrentOrder(subSong.startOrder);
+			return sndFile.GetLength(adjustMode, target.StartPos(0, subSong.startOrder, subSong.startRow)).back();
+		};
+
+		sndFile.SetSeekCheckpointInterval(0);
+		const GetLengthType fullTimeSeek = seek(GetLengthTarget(seekTime));
+		const auto fullTimeState = std::make_unique<CSoundFile::PlayState>(sndFile.m_PlayState);
+		const GetLengthType fullPosSeek = seek(GetLengthTarget(fullTimeSeek.lastOrder, fullTimeSeek.lastRow));
+		const auto fullPosState = std::make_unique<CSoundFile::PlayState>(sndFile.m_PlayState);
+		VERIFY_EQUAL_NONCONT(fullTimeSeek.targetReached, true);
+		VERIFY_EQUAL_NONCONT(fullPosSeek.targetReached, true);
+		VERIFY_EQUAL_NONCONT(sndFile.GetNumSeekCheckpoints(), 0);
+
+		// The first seek takes the snapshots
+		sndFile.SetSeekCheckpointInterval(16);
+		seek(GetLengthTarget(subSong.duration));
+		VERIFY_EQUAL_NONCONT(sndFile.GetNumSeekCheckpoints() > 0, true);
+		const auto numCheckpoints = sndFile.GetNumSeekCheckpoints();
+
+		const GetLengthType timeSeek = seek(GetLengthTarget(seekTime));
+		VERIFY_EQUAL_NONCONT(timeSeek.targetReached, true);
+		VERIFY_EQUAL(timeSeek.duration, fullTimeSeek.duration);
+		VERIFY_EQUAL(timeSeek.lastOrder, fullTimeSeek.lastOrder);
+		VERIFY_EQUAL(timeSeek.lastRow, fullTimeSeek.lastRow);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_lTotalSampleCount, fullTimeState->m_lTotalSampleCount);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nMusicSpeed, fullTimeState->m_nMusicSpeed);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nMusicTempo.GetRaw(), fullTimeState->m_nMusicTempo.GetRaw());
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nGlobalVolume, fullTimeState->m_nGlobalVolume);
+		for(CHANNELINDEX chn = 0; chn < sndFile.GetNumChannels(); chn++)
+		{
+			const ModChannel &chnState = sndFile.m_PlayState.Chn[chn], &fullChnState = fullTimeState->Chn[chn];
+			VERIFY_EQUAL(chnState.pModSample == fullChnState.pModSample, true);
+			VERIFY_EQUAL(chnState.position.GetRaw(), fullChnState.position.GetRaw());
+			VERIFY_EQUAL(chnState.nPeriod, fullChnState.nPeriod);
+			VERIFY_EQUAL(chnState.nVolume, fullChnState.nVolume);
+			VERIFY_EQUAL(chnState.nPan, fullChnState.nPan);
+		}
+
+		const GetLengthType posSeek = seek(GetLengthTarget(fullTimeSeek.lastOrder, fullTimeSeek.lastRow));
+		VERIFY_EQUAL_NONCONT(posSeek.targetReached, true);
+		VERIFY_EQUAL(posSeek.duration, fullPosSeek.duration);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_lTotalSampleCount, fullPosState->m_lTotalSampleCount);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nMusicSpeed, fullPosState->m_nMusicSpeed);
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nMusicTempo.GetRaw(), fullPosState->m_nMusicTempo.GetRaw());
+		VERIFY_EQUAL(sndFile.m_PlayState.m_nGlobalVolume, fullPosState->m_nGlobalVolume);
+
+		// Seeks that end before the last snapshot don't take new ones
+		VERIFY_EQUAL(sndFile.GetNumSeekCheckpoints(), numCheckpoints);
+	}
+
+	sndFile.SetSeekCheckpointInterval(0);
+	VERIFY_EQUAL_NONCONT(sndFile.GetNumSeekCheckpoints(), 0);
+}
+
+
 // Check if our test file was loaded correctly.
 static void TestLoadS3MFile(const CSoundFile &sndFile, bool resaved)
 {
@@ -3845,6 +3920,89 @@ static MPT_NOINLINE void TestLoadSaveFile()
 }
 
 
+static MPT_NOINLINE void TestSeekCheckpoints()
+{
+	if(!ShouldRunTests())
+	{
+		return;
+	}
+
+	TSoundFileContainer sndFileContainer = CreateSoundFileContainer(GetTestFilenameBase() + P_("s3m"));
+	auto &sndFile = GetSoundFile(sndFileContainer);
+	sndFile.ChnSettings[1].dwFlags.reset(CHN_MUTE);
+
+	const auto allSubSongs = sndFile.GetLength(eNoAdjust, GetLengthTarget(true));
+	const GetLengthType &subSong = *std::max_element(allSubSongs.begin(), allSubSongs.end(), [](const GetLengthType &a, const GetLengthType &b) { return a.duration < b.duration; });
+	CheckSeekCheckpoints(sndFile, subSong);
+
+	// Changing the tempo factor the way the "play.tempo_factor" ctl does must not resume from snapshots taken at the old tempo
+	const auto seek = [&](double seconds)
+	{
+		sndFile.SetCurrentOrder(subSong.startOrder);
+		const GetLengthType result = sndFile.GetLength(eAdjust, GetLengthTarget(seconds).StartPos(0, subSong.startOrder, subSong.startRow)).back();
+		VERIFY_EQUAL_NONCONT(result.targetReached, true);
+		return result;
+	};
+	const double seekTime = subSong.duration * 0.5;
+	sndFile.SetSeekCheckpointInterval(16);
+	seek(subSong.duration * 0.9);
+	VERIFY_EQUAL_NONCONT(sndFile.GetNumSeekCheckpoints() > 0, true);
+
+	sndFile.m_nTempoFactor = mpt::saturate_round<uint32>(65536.0 / 1.5);
+	sndFile.RecalculateSamplesPerTick();
+	const GetLengthType timeSeek = seek(seekTime);
+	const CSoundFile::samplecount_t totalSampleCount = sndFile.GetTotalSampleCount();
+
+	sndFile.SetSeekCheckpointInterval(0);
+	const GetLengthType fullTimeSeek = seek(seekTime);
+	VERIFY_EQUAL(timeSeek.lastOrder, fullTimeSeek.lastOrder);
+	VERIFY_EQUAL(timeSeek.lastRow, fullTimeSeek.lastRow);
+	VERIFY_EQUAL_EPS(timeSeek.duration, fullTimeSeek.duration, 0.000001);
+	VERIFY_EQUAL(totalSampleCount, sndFile.GetTotalSampleCount());
+
+	sndFile.m_nTempoFactor = 65536;
+	sndFile.RecalculateSamplesPerTick();
+
+	// A late seek resuming from a checkpoint must cost a fraction of one simulating everything before it.
+	// The test module only plays for a few seconds, so the seeks run through copies of one of its patterns appended to the order list.
+	const PATTERNINDEX longPat = sndFile.Patterns.Duplicate(sndFile.Order()[subSong.startOrder]);
+	VERIFY_EQUAL_NONCONT(longPat != PATTERNINDEX_INVALID, true);
+	for(auto &m : sndFile.Patterns[longPat])
+	{
+		if(m.command == CMD_POSITIONJUMP || m.command == CMD_PATTERNBREAK)
+			m.command = CMD_NONE;
+	}
+	const ORDERINDEX longStart = sndFile.Order().GetLength(), longLength = 500;
+	sndFile.Order().resize(longStart + longLength, longPat);
+	const auto lateSeekLatency = [&](ROWINDEX interval)
+	{
+		const auto lateSeek = [&]()
+		{
+			sndFile.SetCurrentOrder(longStart);
+			const GetLengthType result = sndFile.GetLength(eAdjust, GetLengthTarget(longStart + longLength * 9 / 10, 0).StartPos(0, longStart, 0)).back();
+			VERIFY_EQUAL_NONCONT(result.targetReached, true);
+		};
+		sndFile.SetSeekCheckpointInterval(interval);
+		lateSeek();
+		auto fastest = std::chrono::steady_clock::duration::max();
+		for(int run = 0; run < 16; run++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			lateSeek();
+			fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+		}
+		return fastest;
+	};
+	const auto fullSeekLatency = lateSeekLatency(0);
+	const auto checkpointSeekLatency = lateSeekLatency(16);
+	VERIFY_EQUAL(checkpointSeekLatency * 4 < fullSeekLatency, true);
+	sndFile.SetSeekCheckpointInterval(0);
+	sndFile.Order().resize(longStart);
+
+	DestroySoundFileContainer(sndFileContainer);
+}
+
+
 // Test various editing features
 static MPT_NOINLINE void TestEditing()
 {
@@ -3942,6 +4100,7 @@ static void RunITCompressionTest(const std::vector<int8> &sampleData, FlagSet<Ch
 		std::vector<int8> sampleDataNew(sampleData.size(), 0);
 		smp.pData.pSample = sampleDataNew.data();
 
+		VERIFY_EQUAL_NONCONT(ITDecompression::GetCompressedSize(file, smp), data.size());
 		ITDecompression decompression(file, smp, it215);
 		VERIFY_EQUAL_NONCONT(memcmp(sampleData.data(), sampleDataNew.data(), sampleData.size()), 0);
 	}
@@ -3971,6 +4130,334 @@ static MPT_NOINLINE void TestITCompression()
 
 
 
+// The SIMD interpolation kernels must produce exactly the same output as the scalar mixer templates
+static MPT_NOINLINE void TestMixerKernels()
+{
+	const auto resampler = std::make_unique<CResampler>();
+	constexpr SmpLength sampleLength = 4096;
+	constexpr unsigned int numSamples = 512;
+	// Room for the interpolation lookahead on both sides, in 16-bit stereo frames
+	constexpr SmpLength padding = 8;
+	std::vector<int16> sampleData((sampleLength + 2 * padding) * 2);
+	for(auto &value : sampleData)
+	{
+		value = mpt::random<int16>(*s_PRNG);
+	}
+	const void *sampleStart = sampleData.data() + padding * 2;
+
+	// Upsampling, the three polyphase tables and playing backwards
+	const int64 increments[] = {0x0'5432'1000ll, 0x1'4000'0000ll, 0x1'C000'0000ll, -0x0'E000'0000ll};
+
+	for(const auto kernels : {MixFuncTable::Kernels::SSE2, MixFuncTable::Kernels::AVX2, MixFuncTable::Kernels::NEON})
+	{
+		const MixFuncInterface *functions = MixFuncTable::GetFunctions(kernels);
+		if(!functions)
+			continue;
+		for(const auto resampling : {MixFuncTable::ndxFastSinc, MixFuncTable::ndxKaiser, MixFuncTable::ndxFIRFilter})
+		{
+			bool identical = true;
+			for(uint32 flags = 0; flags < 16; flags++)
+			{
+				for(const auto increment : increments)
+				{
+					ModChannel chn{};
+					chn.pCurrentSample = sampleStart;
+					chn.nLength = sampleLength;
+					chn.position = SamplePosition(sampleLength / 2, mpt::random<uint32>(*s_PRNG));
+					chn.increment = SamplePosition(increment);
+					chn.leftVol = 3000;
+					chn.rightVol = 1000;
+					chn.rampLeftVol = 500 << VOLUMERAMPPRECISION;
+					chn.rampRightVol = 4000 << VOLUMERAMPPRECISION;
+					chn.leftRamp = 1 << VOLUMERAMPPRECISION;
+					chn.rightRamp = -3 << VOLUMERAMPPRECISION;
+					chn.nFilter_A0 = 1 << 22;
+					chn.nFilter_B0 = 1 << 23;
+					chn.nFilter_B1 = -(1 << 21);
+
+					ModChannel chnSIMD = chn;
+					std::vector<mixsample_t> out(numSamples * 2, 0), outSIMD(numSamples * 2, 0);
+					MixFuncTable::Functions[resampling | flags](chn, *resampler, out.data(), numSamples);
+					functions[resampling | flags](chnSIMD, *resampler, outSIMD.data(), numSamples);
+
+					identical = identical && out == outSIMD
+						&& chn.position == chnSIMD.position
+						&& chn.rampLeftVol == chnSIMD.rampLeftVol
+						&& chn.rampRightVol == chnSIMD.rampRightVol
+						&& !std::memcmp(chn.nFilter_Y, chnSIMD.nFilter_Y, sizeof(chn.nFilter_Y));
+				}
+			}
+			VERIFY_EQUAL_NONCONT(identical, true);
+		}
+	}
+}
+
+
+// Collects the mixer output before it is converted to the output format
+class MixOutputCapture
+	: public IAudioTarget
+{
+public:
+	std::vector<mixsample_t> samples;
+
+	void Process(mpt::audio_span_interleaved<MixSampleInt> buffer) override
+	{
+		for(std::size_t frame = 0; frame < buffer.size_frames(); frame++)
+		{
+			for(std::size_t channel = 0; channel < buffer.size_channels(); channel++)
+			{
+				samples.push_back(buffer(channel, frame));
+			}
+		}
+	}
+	void Process(mpt::audio_span_interleaved<MixSampleFloat>) override
+	{
+		MPT_ASSERT_NOTREACHED();
+	}
+};
+
+
+// Mixing on several threads has to produce exactly the same output as mixing on a single thread.
+static MPT_NOINLINE void TestParallelMixer()
+{
+	constexpr CHANNELINDEX numChannels = 32;
+	constexpr uint16 loopedLength = 2048, oneShotLength = 500;  // In words
+	constexpr uint16 periods[] = {428, 381, 339, 320, 285, 254, 226, 214, 190, 170};
+
+	// A 32-channel MOD file with a looped and a one-shot sample
+	std::vector<uint8> data(20 + 31 * 30 + 2 + 128 + 4 + 64 * numChannels * 4 + (loopedLength + oneShotLength) * 2);
+	const auto writeSampleHeader = [&](std::size_t offset, uint16 length, uint16 loopStart, uint16 loopLength)
+	{
+		data[offset + 22] = static_cast<uint8>(length >> 8);
+		data[offset + 23] = static_cast<uint8>(length);
+		data[offset + 25] = 64;
+		data[offset + 26] = static_cast<uint8>(loopStart >> 8);
+		data[offset + 27] = static_cast<uint8>(loopStart);
+		data[offset + 28] = static_cast<uint8>(loopLength >> 8);
+		data[offset + 29] = static_cast<uint8>(loopLength);
+	};
+	writeSampleHeader(20, loopedLength, 0, loopedLength);
+	writeSampleHeader(20 + 30, oneShotLength, 0, 1);
+	for(std::size_t smp = 2; smp < 31; smp++)
+	{
+		data[20 + smp * 30 + 29] = 1;
+	}
+	std::size_t offset = 20 + 31 * 30;
+	data[offset++] = 1;
+	data[offset++] = 127;
+	offset += 128;
+	std::memcpy(&data[offset], "32CH", 4);
+	offset += 4;
+	for(ROWINDEX row = 0; row < 64; row += 16)
+	{
+		for(CHANNELINDEX chn = 0; chn < numChannels; chn++)
+		{
+			// New notes on every channel in the first row, then on half of the channels
+			if(row && (chn + row / 16) % 2)
+				continue;
+			uint8 *command = &data[offset + (row * numChannels + chn) * 4];
+			const uint16 period = periods[(chn + row) % std::size(periods)];
+			const uint8 sample = (chn % 3 == 0) ? 2 : 1;
+			command[0] = static_cast<uint8>(period >> 8);
+			command[1] = static_cast<uint8>(period);
+			command[2] = static_cast<uint8>(sample << 4) | ((chn % 4 == 1) ? 0x0A : 0x00);
+			command[3] = (chn % 4 == 1) ? 0x01 : 0x00;
+		}
+	}
+	offset += 64 * numChannels * 4;
+	for(; offset < data.size(); offset++)
+	{
+		data[offset] = mpt::random<uint8>(*s_PRNG);
+	}
+
+	const auto render = [&data](uint32 numThreads)
+	{
+		FileReader file(mpt::byte_cast<mpt::const_byte_span>(mpt::as_span(data)));
+		auto sndFile = std::make_unique<CSoundFile>();
+		MixOutputCapture output;
+		if(!sndFile->Create(file, CSoundFile::loadCompleteModule))
+			return output.samples;
+		MixerSettings mixerSettings = sndFile->m_MixerSettings;
+		mixerSettings.gdwMixingFreq = 44100;
+		mixerSettings.gnChannels = 4;
+		mixerSettings.DSPMask = SNDDSP_REVERB;
+		sndFile->SetMixerSettings(mixerSettings);
+		sndFile->SetMixerThreads(numThreads);
+		// Route some channels to the rear buffer
+		for(CHANNELINDEX chn = 0; chn < numChannels; chn += 4)
+		{
+			sndFile->m_PlayState.Chn[chn].dwFlags.set(CHN_SURROUND);
+		}
+		for(int i = 0; i < 200; i++)
+		{
+			sndFile->Read(441, output);
+		}
+		return output.samples;
+	};
+
+	const std::vector<mixsample_t> serial = render(1);
+	VERIFY_EQUAL_NONCONT(serial.size(), 200u * 441u * 4u);
+	for(const uint32 numThreads : {2u, 3u, 4u})
+	{
+		VERIFY_EQUAL_NONCONT(render(numThreads) == serial, true);
+	}
+}
+
+
+// Samples that are decoded on several threads or when they are first played must be identical to samples decoded while loading
+static MPT_NOINLINE void TestSampleDecoding()
+{
+	// An IT file with three IT-compressed samples, of which only the first two are played
+	struct SampleInfo
+	{
+		FlagSet<ChannelFlags> format;
+		SmpLength length;
+		bool it215;
+	};
+	const SampleInfo sampleInfos[] = {{CHN_16BIT, 50000, true}, {CHN_STEREO, 3000, false}, {ChannelFlags(0), 1000, false}};
+	constexpr ROWINDEX numRows = 32;
+
+	std::vector<uint8> data(0xC0 + 2 + std::size(sampleInfos) * 4 + 4);
+	const auto write16 = [&data](std::size_t offset, uint16 value) { data[offset] = static_cast<uint8>(value); data[offset + 1] = static_cast<uint8>(value >> 8); };
+	const auto write32 = [&](std::size_t offset, uint32 value) { write16(offset, static_cast<uint16>(value)); write16(offset + 2, static_cast<uint16>(value >> 16)); };
+	std::memcpy(&data[0], "IMPM", 4);
+	write16(0x20, 2);  // Orders
+	write16(0x24, static_cast<uint16>(std::size(sampleInfos)));
+	write16(0x26, 1);  // Patterns
+	write16(0x28, 0x214);
+	write16(0x2A, 0x214);
+	write16(0x2C, 0x09);  // Stereo, linear slides
+	data[0x30] = 128;
+	data[0x31] = 48;
+	data[0x32] = 6;
+	data[0x33] = 125;
+	data[0x34] = 128;
+	for(CHANNELINDEX chn = 0; chn < 64; chn++)
+	{
+		data[0x40 + chn] = (chn < 2) ? 32 : 0xA0;
+		data[0x80 + chn] = 64;
+	}
+	data[0xC0] = 0;
+	data[0xC1] = 0xFF;
+
+	for(std::size_t smp = 0; smp < std::size(sampleInfos); smp++)
+	{
+		const SampleInfo &info = sampleInfos[smp];
+		const std::size_t header = data.size();
+		write32(0xC2 + smp * 4, static_cast<uint32>(header));
+		data.resize(header + 0x50);
+		std::memcpy(&data[header], "IMPS", 4);
+		data[header + 0x11] = 64;
+		data[header + 0x12] = ITSample::sampleDataPresent | ITSample::sampleCompressed | ITSample::sampleLoop
+			| (info.format[CHN_16BIT] ? ITSample::sample16Bit : 0) | (info.format[CHN_STEREO] ? ITSample::sampleStereo : 0);
+		data[header + 0x13] = 64;
+		data[header + 0x2E] = ITSample::cvtSignedSample | (info.it215 ? ITSample::cvtDelta : 0);
+		write32(header + 0x30, info.length);
+		write32(header + 0x34, info.length / 4);
+		write32(header + 0x38, info.length);
+		write32(header + 0x3C, 8363);
+		write32(header + 0x48, static_cast<uint32>(data.size()));
+
+		ModSample sample;
+		sample.uFlags = info.format;
+		sample.nLength = info.length;
+		std::vector<int8> sampleData(sample.GetSampleSizeInBytes());
+		for(auto &v : sampleData)
+		{
+			v = mpt::random<int8>(*s_PRNG);
+		}
+		sample.pData.pSample = sampleData.data();
+		std::ostringstream f;
+		ITCompression compression(sample, info.it215, &f);
+		const std::string compressed = f.str();
+		data.insert(data.end(), compressed.begin(), compressed.end());
+	}
+
+	std::vector<uint8> pattern;
+	for(ROWINDEX row = 0; row < numRows; row++)
+	{
+		if(row % 16 == 0)
+		{
+			for(uint8 chn = 0; chn < 2; chn++)
+			{
+				pattern.insert(pattern.end(), {static_cast<uint8>((chn + 1) | 0x80), 0x03, static_cast<uint8>(60 + row / 2 - chn * 5), static_cast<uint8>(chn + 1)});
+			}
+		}
+		pattern.push_back(0);
+	}
+	const std::size_t patternOffset = data.size();
+	write32(0xC2 + std::size(sampleInfos) * 4, static_cast<uint32>(patternOffset));
+	data.resize(patternOffset + 8);
+	write16(patternOffset, static_cast<uint16>(pattern.size()));
+	write16(patternOffset + 2, static_cast<uint16>(numRows));
+	data.insert(data.end(), pattern.begin(), pattern.end());
+
+	const auto load = [&data](CSoundFile &sndFile, int loadFlags)
+	{
+		FileReader file(mpt::byte_cast<mpt::const_byte_span>(mpt::as_span(data)));
+		return sndFile.Create(file, static_cast<CSoundFile::ModLoadingFlags>(loadFlags));
+	};
+	const auto render = [](CSoundFile &sndFile)
+	{
+		MixOutputCapture output;
+		MixerSettings mixerSettings = sndFile.m_MixerSettings;
+		mixerSettings.gdwMixingFreq = 44100;
+		mixerSettings.gnChannels = 2;
+		sndFile.SetMixerSettings(mixerSettings);
+		for(int i = 0; i < 200; i++)
+		{
+			sndFile.Read(441, output);
+		}
+		return output.samples;
+	};
+	const auto sameSampleData = [](const CSoundFile &a, const CSoundFile &b, SAMPLEINDEX smp)
+	{
+		const ModSample &sampleA = a.GetSample(smp), &sampleB = b.GetSample(smp);
+		return sampleA.HasSampleData() && sampleB.HasSampleData() && sampleA.nLength == sampleB.nLength && sampleA.uFlags == sampleB.uFlags
+			&& !memcmp(sampleA.samplev(), sampleB.samplev(), sampleA.GetSampleSizeInBytes());
+	};
+
+	auto serial = std::make_unique<CSoundFile>();
+	VERIFY_EQUAL_NONCONT(load(*serial, CSoundFile::loadCompleteModule), true);
+	VERIFY_EQUAL_NONCONT(serial->GetNumSamples(), std::size(sampleInfos));
+	VERIFY_EQUAL_NONCONT(serial->IsSamplePending(1), false);
+	const std::vector<mixsample_t> reference = render(*serial);
+
+	auto parallel = std::make_unique<CSoundFile>();
+	VERIFY_EQUAL_NONCONT(load(*parallel, CSoundFile::loadCompleteModule | CSoundFile::loadSamplesParallel), true);
+	for(SAMPLEINDEX smp = 1; smp <= serial->GetNumSamples(); smp++)
+	{
+		VERIFY_EQUAL_NONCONT(parallel->IsSamplePending(smp), false);
+		VERIFY_EQUAL_NONCONT(sameSampleData(*serial, *parallel, smp), true);
+	}
+	VERIFY_EQUAL_NONCONT(render(*parallel) == reference, true);
+
+	auto deferred = std::make_unique<CSoundFile>();
+	VERIFY_EQUAL_NONCONT(load(*deferred, CSoundFile::loadCompleteModule | CSoundFile::loadSamplesDeferred), true);
+	for(SAMPLEINDEX smp = 1; smp <= serial->GetNumSamples(); smp++)
+	{
+		VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(smp), true);
+		VERIFY_EQUAL_NONCONT(deferred->GetSample(smp).nLength, serial->GetSample(smp).nLength);
+	}
+	VERIFY_EQUAL_NONCONT(render(*deferred) == reference, true);
+	VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(1), false);
+	VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(2), false);
+	VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(3), true);
+	deferred->DecodePendingSample(3);
+	for(SAMPLEINDEX smp = 1; smp <= serial->GetNumSamples(); smp++)
+	{
+		VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(smp), false);
+		VERIFY_EQUAL_NONCONT(sameSampleData(*serial, *deferred, smp), true);
+	}
+
+	// Skipping sample data must not queue anything
+	VERIFY_EQUAL_NONCONT(load(*deferred, (CSoundFile::loadCompleteModule & ~CSoundFile::loadSampleData) | CSoundFile::loadSamplesDeferred), true);
+	VERIFY_EQUAL_NONCONT(deferred->IsSamplePending(1), false);
+	VERIFY_EQUAL_NONCONT(deferred->GetSample(1).HasSampleData(), false);
+}
+
+
+
 #if 0
 
 static bool RatioEqual(CTuningBase::RATIOTYPE a, CTuningBase::RATIOTYPE b)
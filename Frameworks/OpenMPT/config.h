@@ -15,5 +15,8 @@
 
 #define MPT_BUILD_XCODE 1
 
+// SSE2 / AVX2 / NEON interpolation kernels in the mixer, and SSE2 in the reverb
+#define MPT_ENABLE_ARCH_INTRINSICS
+
 #endif
 
@@ -0,0 +1,115 @@
+// Rendering speed of a synthetic 32 channel MOD at 48 kHz for each value of
+// the "render.mixer.threads" ctl, with linear and 8 tap sinc interpolation,
+// checking that every thread count renders the same output as one thread.
+// Not part of the project, build it by hand against an OpenMPT/ build,
+// adding NO_ZLIB=1, NO_MPG123=1 and so on for libraries that are not
+// installed, and linking the ones that are:
+//
+// cd OpenMPT && make CONFIG=gcc bin/libopenmpt.a
+// c++ -std=c++17 -O2 -IOpenMPT -o mixer_threads_bench mixer_threads_bench.cpp
+//     OpenMPT/bin/libopenmpt.a -lpthread
+//
+// ./mixer_threads_bench
+//
+// Worker threads only speed up rendering on machines with more than one core;
+// on a single core, the numbers show the synchronization overhead.
+
+#include <libopenmpt/libopenmpt.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr int numChannels = 32;
+static constexpr int sampleRate = 48000;
+static constexpr std::size_t framesPerRead = 480;
+static constexpr int numReads = 400;
+
+// 32CH MOD with one pattern in which every channel starts a looped noise sample on the first row, at ten different pitches
+static std::vector<std::uint8_t> MakeModule()
+{
+	constexpr std::uint16_t loopedLength = 8192;
+	const std::uint16_t periods[] = {428, 381, 339, 320, 285, 254, 226, 214, 190, 170};
+	std::vector<std::uint8_t> data(20 + 31 * 30 + 2 + 128 + 4 + 64 * numChannels * 4 + loopedLength * 2);
+	// Sample 1: length, full volume, loop over the whole sample
+	data[20 + 22] = loopedLength >> 8;
+	data[20 + 23] = loopedLength & 0xFF;
+	data[20 + 25] = 64;
+	data[20 + 28] = loopedLength >> 8;
+	data[20 + 29] = loopedLength & 0xFF;
+	for(int smp = 1; smp < 31; smp++)
+		data[20 + smp * 30 + 29] = 1;
+	std::size_t offset = 20 + 31 * 30;
+	data[offset++] = 1;
+	data[offset++] = 127;
+	offset += 128;
+	std::memcpy(&data[offset], "32CH", 4);
+	offset += 4;
+	for(int chn = 0; chn < numChannels; chn++)
+	{
+		std::uint8_t *cmd = &data[offset + chn * 4];
+		cmd[0] = periods[chn % 10] >> 8;
+		cmd[1] = periods[chn % 10] & 0xFF;
+		cmd[2] = 0x10;
+	}
+	offset += 64 * numChannels * 4;
+	std::mt19937 rng(1);
+	for(; offset < data.size(); offset++)
+		data[offset] = static_cast<std::uint8_t>(rng());
+	return data;
+}
+
+// Renders numReads blocks, returns the time in seconds
+static double Render(const std::vector<std::uint8_t> &data, int filterLength, int threads, std::vector<float> &out)
+{
+	openmpt::module mod(data);
+	mod.set_render_param(openmpt::module::RENDER_INTERPOLATIONFILTER_LENGTH, filterLength);
+	mod.ctl_set_integer("render.mixer.threads", threads);
+	out.assign(framesPerRead * 2 * numReads, 0.0f);
+
+	const auto start = std::chrono::steady_clock::now();
+	for(int block = 0; block < numReads; block++)
+		mod.read_interleaved_stereo(sampleRate, framesPerRead, out.data() + block * framesPerRead * 2);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	const std::vector<std::uint8_t> data = MakeModule();
+	const double seconds = double(framesPerRead) * numReads / sampleRate;
+
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	std::printf("%-7s %7s %12s %s\n", "interp", "threads", "x realtime", "output");
+
+	int result = 0;
+	const struct
+	{
+		const char *name;
+		int filterLength;
+	} interpolators[] =
+	{
+		{"linear", 2},
+		{"sinc8", 8},
+	};
+	for(const auto &interpolator : interpolators)
+	{
+		std::vector<float> reference, out;
+		for(int threads : {1, 2, 4, 8})
+		{
+			const double elapsed = Render(data, interpolator.filterLength, threads, out);
+			if(threads == 1)
+				reference = out;
+			const bool same = (out == reference);
+			if(!same)
+				result = 1;
+			std::printf("%-7s %7d %12.1f %s\n", interpolator.name, threads, seconds / elapsed, same ? "identical" : "differs");
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,127 @@
+// Time of the integer mixer's cubic, Kaiser and FIR interpolators with each
+// function table MixFuncTable::GetFunctions() can hand out, in nanoseconds
+// per output sample, checking that every SIMD table renders the same output
+// as the scalar one. Not part of the project, build it by hand next to the
+// library of an OpenMPT/ build with MPT_ENABLE_ARCH_INTRINSICS set, adding
+// NO_ZLIB=1, NO_MPG123=1 and so on for libraries that are not installed:
+//
+// cd OpenMPT && make CONFIG=gcc "CXX=g++ -DMPT_ENABLE_ARCH_INTRINSICS" bin/libopenmpt.a
+// c++ -std=c++17 -O2 -DLIBOPENMPT_BUILD -DMPT_ENABLE_ARCH_INTRINSICS -IOpenMPT
+//     -IOpenMPT/common -IOpenMPT/src -o mixfunc_bench mixfunc_bench.cpp
+//     OpenMPT/bin/libopenmpt.a
+//
+// ./mixfunc_bench
+
+#include "stdafx.h"
+
+#include "soundlib/MixFuncTable.h"
+#include "soundlib/ModChannel.h"
+#include "soundlib/Resampler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace OpenMPT;
+
+static constexpr SmpLength sampleLength = 1 << 20;
+static constexpr unsigned int blockSize = 512;
+static constexpr int numBlocks = 1500;
+
+// Renders numBlocks blocks at an increment of about 0.56, returns the best of five runs in seconds
+static double Render(const MixFuncInterface mixFunc, const CResampler &resampler, const std::vector<int16> &data, std::vector<mixsample_t> &out)
+{
+	double best = 1e9;
+	for(int run = 0; run < 5; run++)
+	{
+		ModChannel chn{};
+		chn.pCurrentSample = data.data() + 32 * 2;
+		chn.nLength = sampleLength;
+		chn.position = SamplePosition(8, 0);
+		chn.increment = SamplePosition(0x0'9000'0000ll);
+		chn.leftVol = 3000;
+		chn.rightVol = 1000;
+		std::fill(out.begin(), out.end(), 0);
+
+		const auto start = std::chrono::steady_clock::now();
+		for(int block = 0; block < numBlocks; block++)
+		{
+			mixFunc(chn, resampler, out.data() + (block % 4) * blockSize * 2, blockSize);
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		best = std::min(best, seconds);
+	}
+	return best;
+}
+
+int main()
+{
+	const auto resampler = std::make_unique<CResampler>();
+
+	// 8-bit formats read the same buffer, only half of it is used
+	std::vector<int16> data((sampleLength + 64) * 2);
+	std::mt19937 rng(1);
+	for(auto &v : data)
+		v = static_cast<int16>(rng());
+
+	const struct
+	{
+		const char *name;
+		MixFuncTable::ResamplingIndex index;
+	} interpolators[] =
+	{
+		{"cubic", MixFuncTable::ndxFastSinc},
+		{"kaiser", MixFuncTable::ndxKaiser},
+		{"fir", MixFuncTable::ndxFIRFilter},
+	};
+	const struct
+	{
+		const char *name;
+		MixFuncTable::Kernels kernels;
+	} tables[] =
+	{
+		{"scalar", MixFuncTable::Kernels::Scalar},
+		{"sse2", MixFuncTable::Kernels::SSE2},
+		{"avx2", MixFuncTable::Kernels::AVX2},
+		{"neon", MixFuncTable::Kernels::NEON},
+	};
+	const char *formats[] = {"8m", "16m", "8s", "16s"};
+
+	std::printf("%-7s %-4s", "interp", "fmt");
+	for(const auto &table : tables)
+		std::printf(" %9s", table.name);
+	std::printf("\n");
+
+	int result = 0;
+	for(const auto &interpolator : interpolators)
+	{
+		for(int format = 0; format < 4; format++)
+		{
+			std::printf("%-7s %-4s", interpolator.name, formats[format]);
+			std::vector<mixsample_t> reference(blockSize * 2 * 4), out(blockSize * 2 * 4);
+			for(const auto &table : tables)
+			{
+				const MixFuncInterface *functions = MixFuncTable::GetFunctions(table.kernels);
+				if(!functions)
+				{
+					std::printf(" %9s", "-");
+					continue;
+				}
+				const double seconds = Render(functions[interpolator.index | format], *resampler, data, out);
+				if(table.kernels == MixFuncTable::Kernels::Scalar)
+					reference = out;
+				const bool same = (out == reference);
+				if(!same)
+					result = 1;
+				std::printf(" %8.2f%c", seconds * 1e9 / (double(numBlocks) * blockSize), same ? ' ' : '!');
+			}
+			std::printf("\n");
+		}
+	}
+	if(result)
+		std::printf("! output differs from the scalar table\n");
+
+	return result;
+}
@@ -0,0 +1,1010 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_X64) ||               \
+    defined(__amd64__)
+#include <xmmintrin.h>
+#define RESAMPLER_SSE
+#if defined(_MSC_VER) || defined(__clang__) || defined(__GNUC__)
+#include <immintrin.h>
+#define RESAMPLER_AVX2
+#endif
+#endif
+#ifdef __APPLE__
+#include <TargetConditionals.h>
+#if TARGET_CPU_ARM || TARGET_CPU_ARM64
+#define RESAMPLER_NEON
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RESAMPLER_NEON
+#endif
+#ifdef RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#define ALIGNED _declspec(align(16))
+#else
+#define ALIGNED __attribute__((aligned(16)))
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "resampler.h"
+
+enum { RESAMPLER_SHIFT = 10 };
+enum { RESAMPLER_RESOLUTION = 1 << RESAMPLER_SHIFT };
+enum { SINC_WIDTH = 16 };
+enum { SINC_SAMPLES = RESAMPLER_RESOLUTION * SINC_WIDTH };
+enum { CUBIC_SAMPLES = RESAMPLER_RESOLUTION * 4 };
+
+static const float RESAMPLER_BLEP_CUTOFF = 0.90f;
+static const float RESAMPLER_BLAM_CUTOFF = 0.93f;
+static const float RESAMPLER_SINC_CUTOFF = 0.999f;
+
+ALIGNED static float cubic_lut[CUBIC_SAMPLES];
+
+static float sinc_lut[SINC_SAMPLES + 1];
+static float window_lut[SINC_SAMPLES + 1];
+
+enum { resampler_buffer_size = SINC_WIDTH * 4 };
+
+// Every channel gets its own input and output buffer, laid out back to back
+enum { resampler_in_stride = resampler_buffer_size * 2 };
+enum { resampler_out_stride = resampler_buffer_size + SINC_WIDTH * 2 - 1 };
+
+static int fEqual(const float b, const float a) { return fabs(a - b) < 1.0e-6; }
+
+static float sinc(float x) {
+    return fEqual(x, 0.0) ? 1.0 : sin(x * M_PI) / (x * M_PI);
+}
+
+#ifdef RESAMPLER_SSE
+#ifdef _MSC_VER
+#include <intrin.h>
+#define xgetbv(a) _xgetbv(a)
+#elif defined(__clang__) || defined(__GNUC__)
+static inline void __cpuidex(int *data, int selector, int subselector) {
+#if defined(__PIC__) && defined(__i386__)
+    __asm("xchgl %%ebx, %%esi; cpuid; xchgl %%ebx, %%esi"
+          : "=a"(data[0]), "=S"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#elif defined(__PIC__) && defined(__amd64__)
+    __asm("xchg{q} {%%}rbx, %q1; cpuid; xchg{q} {%%}rbx, %q1"
+          : "=a"(data[0]), "=&r"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#else
+    __asm("cpuid"
+          : "=a"(data[0]), "=b"(data[1]), "=c"(data[2]), "=d"(data[3])
+          : "0"(selector), "2"(subselector));
+#endif
+}
+#define __cpuid(a, b) __cpuidex((a), (b), 0)
+
+static inline unsigned long long xgetbv(unsigned int index) {
+    unsigned int eax, edx;
+    // xgetbv, spelled out for assemblers which do not know it
+    __asm(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((unsigned long long)edx << 32) | eax;
+}
+#else
+#define __cpuid(a, b) memset((a), 0, sizeof(int) * 4)
+#define __cpuidex(a, b, c) memset((a), 0, sizeof(int) * 4)
+#define xgetbv(a) 0
+#endif
+
+static int query_cpu_feature_sse() {
+    int buffer[4];
+    __cpuid(buffer, 1);
+    if ((buffer[3] & (1 << 25)) == 0)
+        return 0;
+    return 1;
+}
+
+#ifdef RESAMPLER_AVX2
+static int query_cpu_feature_avx2() {
+    int buffer[4];
+    __cpuid(buffer, 0);
+    if (buffer[0] < 7)
+        return 0;
+    __cpuid(buffer, 1);
+    // AVX, and the OS saving the YMM registers on context switches
+    if ((buffer[2] & (1 << 27)) == 0 || (buffer[2] & (1 << 28)) == 0)
+        return 0;
+    if ((xgetbv(0) & 6) != 6)
+        return 0;
+    __cpuidex(buffer, 7, 0);
+    if ((buffer[1] & (1 << 5)) == 0)
+        return 0;
+    return 1;
+}
+#endif
+#endif
+
+typedef struct resampler {
+    int write_pos, write_filled;
+    int read_pos, read_filled;
+    float phase;
+    float phase_inc;
+    float inv_phase;
+    float inv_phase_inc;
+    unsigned char quality;
+    unsigned char channels;
+    signed char delay_added;
+    signed char delay_removed;
+    float last_amp[RESAMPLER_MAX_CHANNELS];
+    float accumulator[RESAMPLER_MAX_CHANNELS];
+    // Input buffers of all channels, followed by their output buffers
+    float buffers[1];
+} resampler;
+
+static size_t resampler_size(int channels) {
+    return offsetof(resampler, buffers) +
+           channels * (resampler_in_stride + resampler_out_stride) *
+               sizeof(float);
+}
+
+static float *resampler_buffer_in(resampler *r, int channel) {
+    return r->buffers + channel * resampler_in_stride;
+}
+
+static float *resampler_buffer_out(resampler *r, int channel) {
+    return r->buffers + r->channels * resampler_in_stride +
+           channel * resampler_out_stride;
+}
+
+typedef int (*resampler_run)(resampler *r, float **out_, float *out_end);
+
+typedef struct resampler_kernels {
+    resampler_run blep;
+    resampler_run blam;
+    resampler_run cubic;
+    resampler_run sinc;
+} resampler_kernels;
+
+/* The primitives below are what differs between instruction sets. The
+   windowed sinc kernel is built for the current phase, then applied to each
+   channel: summed against the input for sinc, added into the output, scaled
+   by the step in amplitude, for blep and blam. Every set provides them with
+   the same suffix, and resampler.inc builds the loops around them. */
+
+static float resampler_kernel_c(float *kernel, int phase_reduced, int step) {
+    const int window_step = RESAMPLER_RESOLUTION;
+    int phase_adj = phase_reduced * step / RESAMPLER_RESOLUTION;
+    float kernel_sum = 0.0f;
+    int i = SINC_WIDTH;
+
+    for (; i >= -SINC_WIDTH + 1; --i) {
+        int pos = i * step;
+        int window_pos = i * window_step;
+        kernel_sum += kernel[i + SINC_WIDTH - 1] =
+            sinc_lut[abs(phase_adj - pos)] *
+            window_lut[abs(phase_reduced - window_pos)];
+    }
+    return kernel_sum;
+}
+
+static float resampler_sinc_c(const float *in, const float *kernel,
+                              float kernel_sum) {
+    float sample;
+    int i;
+    for (sample = 0, i = 0; i < SINC_WIDTH * 2; ++i)
+        sample += in[i] * kernel[i];
+    return (float)(sample / kernel_sum);
+}
+
+static float resampler_cubic_c(const float *in, const float *kernel) {
+    float sample;
+    int i;
+    for (sample = 0, i = 0; i < 4; ++i)
+        sample += in[i] * kernel[i];
+    return sample;
+}
+
+static void resampler_blep_c(float *out, const float *kernel, float sample) {
+    int i;
+    for (i = 0; i < SINC_WIDTH * 2; ++i)
+        out[i] += sample * kernel[i];
+}
+
+#ifdef RESAMPLER_SSE
+static float resampler_kernel_sse(float *kernel, int phase_reduced, int step) {
+    return resampler_kernel_c(kernel, phase_reduced, step);
+}
+
+static float resampler_sinc_sse(const float *in, const float *kernel,
+                                float kernel_sum) {
+    __m128 temp1, temp2;
+    __m128 samplex = _mm_setzero_ps();
+    float sample;
+    int i;
+    for (i = 0; i < SINC_WIDTH / 2; ++i) {
+        temp1 = _mm_loadu_ps(in + i * 4);
+        temp2 = _mm_load_ps(kernel + i * 4);
+        temp1 = _mm_mul_ps(temp1, temp2);
+        samplex = _mm_add_ps(samplex, temp1);
+    }
+    kernel_sum = 1.0 / kernel_sum;
+    temp1 = _mm_movehl_ps(temp1, samplex);
+    samplex = _mm_add_ps(samplex, temp1);
+    temp1 = samplex;
+    temp1 = _mm_shuffle_ps(temp1, samplex, _MM_SHUFFLE(0, 0, 0, 1));
+    samplex = _mm_add_ps(samplex, temp1);
+    temp1 = _mm_set_ss(kernel_sum);
+    samplex = _mm_mul_ps(samplex, temp1);
+    _mm_store_ss(&sample, samplex);
+    return sample;
+}
+
+static float resampler_cubic_sse(const float *in, const float *kernel) {
+    __m128 temp1, temp2;
+    __m128 samplex = _mm_setzero_ps();
+    float sample;
+    temp1 = _mm_loadu_ps(in);
+    temp2 = _mm_load_ps(kernel);
+    temp1 = _mm_mul_ps(temp1, temp2);
+    samplex = _mm_add_ps(samplex, temp1);
+    temp1 = _mm_movehl_ps(temp1, samplex);
+    samplex = _mm_add_ps(samplex, temp1);
+    temp1 = samplex;
+    temp1 = _mm_shuffle_ps(temp1, samplex, _MM_SHUFFLE(0, 0, 0, 1));
+    samplex = _mm_add_ps(samplex, temp1);
+    _mm_store_ss(&sample, samplex);
+    return sample;
+}
+
+static void resampler_blep_sse(float *out, const float *kernel, float sample) {
+    __m128 temp1, temp2;
+    __m128 samplex = _mm_set1_ps(sample);
+    int i;
+    for (i = 0; i < SINC_WIDTH / 2; ++i) {
+        temp1 = _mm_load_ps(kernel + i * 4);
+        temp1 = _mm_mul_ps(temp1, samplex);
+        temp2 = _mm_loadu_ps(out + i * 4);
+        temp1 = _mm_add_ps(temp1, temp2);
+        _mm_storeu_ps(out + i * 4, temp1);
+    }
+}
+#endif
+
+#ifdef RESAMPLER_AVX2
+#ifdef _MSC_VER
+#define RESAMPLER_AVX2_TARGET
+#else
+#define RESAMPLER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// Builds the kernel eight taps at a time, gathering from both tables
+RESAMPLER_AVX2_TARGET
+static float resampler_kernel_avx2(float *kernel, int phase_reduced,
+                                   int step) {
+    const __m256i lane = _mm256_setr_epi32(-SINC_WIDTH + 1, -SINC_WIDTH + 2,
+                                           -SINC_WIDTH + 3, -SINC_WIDTH + 4,
+                                           -SINC_WIDTH + 5, -SINC_WIDTH + 6,
+                                           -SINC_WIDTH + 7, -SINC_WIDTH + 8);
+    const __m256i eight = _mm256_set1_epi32(8);
+    const __m256i stepx = _mm256_set1_epi32(step);
+    const __m256i phase_adjx =
+        _mm256_set1_epi32(phase_reduced * step / RESAMPLER_RESOLUTION);
+    const __m256i phase_reducedx = _mm256_set1_epi32(phase_reduced);
+    __m256i i = lane;
+    __m256 sumx = _mm256_setzero_ps();
+    __m128 temp;
+    int j;
+    for (j = 0; j < SINC_WIDTH / 4; ++j) {
+        __m256i pos = _mm256_mullo_epi32(i, stepx);
+        __m256i window_pos = _mm256_slli_epi32(i, RESAMPLER_SHIFT);
+        __m256 sincx = _mm256_i32gather_ps(
+            sinc_lut, _mm256_abs_epi32(_mm256_sub_epi32(phase_adjx, pos)), 4);
+        __m256 windowx = _mm256_i32gather_ps(
+            window_lut,
+            _mm256_abs_epi32(_mm256_sub_epi32(phase_reducedx, window_pos)), 4);
+        __m256 kernelx = _mm256_mul_ps(sincx, windowx);
+        _mm256_storeu_ps(kernel + j * 8, kernelx);
+        sumx = _mm256_add_ps(sumx, kernelx);
+        i = _mm256_add_epi32(i, eight);
+    }
+    temp = _mm_add_ps(_mm256_castps256_ps128(sumx),
+                      _mm256_extractf128_ps(sumx, 1));
+    temp = _mm_add_ps(temp, _mm_movehl_ps(temp, temp));
+    temp = _mm_add_ss(temp, _mm_shuffle_ps(temp, temp, _MM_SHUFFLE(0, 0, 0, 1)));
+    return _mm_cvtss_f32(temp);
+}
+
+RESAMPLER_AVX2_TARGET
+static float resampler_sinc_avx2(const float *in, const float *kernel,
+                                 float kernel_sum) {
+    __m256 samplex = _mm256_setzero_ps();
+    __m128 temp;
+    int i;
+    for (i = 0; i < SINC_WIDTH / 4; ++i)
+        samplex = _mm256_add_ps(samplex,
+                                _mm256_mul_ps(_mm256_loadu_ps(in + i * 8),
+                                              _mm256_loadu_ps(kernel + i * 8)));
+    kernel_sum = 1.0 / kernel_sum;
+    temp = _mm_add_ps(_mm256_castps256_ps128(samplex),
+                      _mm256_extractf128_ps(samplex, 1));
+    temp = _mm_add_ps(temp, _mm_movehl_ps(temp, temp));
+    temp = _mm_add_ss(temp, _mm_shuffle_ps(temp, temp, _MM_SHUFFLE(0, 0, 0, 1)));
+    return _mm_cvtss_f32(temp) * kernel_sum;
+}
+
+// Four taps do not fill a wider register
+RESAMPLER_AVX2_TARGET
+static float resampler_cubic_avx2(const float *in, const float *kernel) {
+    return resampler_cubic_sse(in, kernel);
+}
+
+RESAMPLER_AVX2_TARGET
+static void resampler_blep_avx2(float *out, const float *kernel,
+                                float sample) {
+    __m256 samplex = _mm256_set1_ps(sample);
+    int i;
+    for (i = 0; i < SINC_WIDTH / 4; ++i)
+        _mm256_storeu_ps(
+            out + i * 8,
+            _mm256_add_ps(_mm256_loadu_ps(out + i * 8),
+                          _mm256_mul_ps(_mm256_loadu_ps(kernel + i * 8),
+                                        samplex)));
+}
+#endif
+
+#ifdef RESAMPLER_NEON
+static float resampler_kernel_neon(float *kernel, int phase_reduced,
+                                   int step) {
+    return resampler_kernel_c(kernel, phase_reduced, step);
+}
+
+static float resampler_sinc_neon(const float *in, const float *kernel,
+                                 float kernel_sum) {
+    float32x4_t temp1, temp2;
+    float32x4_t samplex = {0};
+    float32x2_t half;
+    int i;
+    for (i = 0; i < SINC_WIDTH / 2; ++i) {
+        temp1 = vld1q_f32((const float32_t *)(in + i * 4));
+        temp2 = vld1q_f32((const float32_t *)(kernel + i * 4));
+        samplex = vmlaq_f32(samplex, temp1, temp2);
+    }
+    kernel_sum = 1.0 / kernel_sum;
+    samplex = vmulq_f32(samplex, vmovq_n_f32(kernel_sum));
+    half = vadd_f32(vget_high_f32(samplex), vget_low_f32(samplex));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+}
+
+static float resampler_cubic_neon(const float *in, const float *kernel) {
+    float32x4_t temp1, temp2;
+    float32x2_t half;
+    temp1 = vld1q_f32((const float32_t *)(in));
+    temp2 = vld1q_f32((const float32_t *)(kernel));
+    temp1 = vmulq_f32(temp1, temp2);
+    half = vadd_f32(vget_high_f32(temp1), vget_low_f32(temp1));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+}
+
+static void resampler_blep_neon(float *out, const float *kernel,
+                                float sample) {
+    float32x4_t temp1, temp2;
+    float32x4_t samplex = vdupq_n_f32(sample);
+    int i;
+    for (i = 0; i < SINC_WIDTH / 2; ++i) {
+        temp1 = vld1q_f32((const float32_t *)(kernel + i * 4));
+        temp2 = vld1q_f32((const float32_t *)out + i * 4);
+        temp2 = vmlaq_f32(temp2, temp1, samplex);
+        vst1q_f32((float32_t *)out + i * 4, temp2);
+    }
+}
+#endif
+
+#define RESAMPLER_PASTE(a, b) a##_##b
+#define RESAMPLER_EVALUATE(a, b) RESAMPLER_PASTE(a, b)
+#define RESAMPLER_FN(name) RESAMPLER_EVALUATE(name, RESAMPLER_SIMD)
+
+#define RESAMPLER_SIMD c
+#define RESAMPLER_TARGET
+#include "resampler.inc"
+
+#ifdef RESAMPLER_SSE
+#define RESAMPLER_SIMD sse
+#define RESAMPLER_TARGET
+#include "resampler.inc"
+#endif
+
+#ifdef RESAMPLER_AVX2
+#define RESAMPLER_SIMD avx2
+#define RESAMPLER_TARGET RESAMPLER_AVX2_TARGET
+#include "resampler.inc"
+#endif
+
+#ifdef RESAMPLER_NEON
+#define RESAMPLER_SIMD neon
+#define RESAMPLER_TARGET
+#include "resampler.inc"
+#endif
+
+static int resampler_simd_max = RESAMPLER_SIMD_NONE;
+static int resampler_simd = RESAMPLER_SIMD_NONE;
+static const resampler_kernels *resampler_simd_kernels = &resampler_kernels_c;
+
+static const resampler_kernels *resampler_kernels_for(int simd) {
+    switch (simd) {
+    case RESAMPLER_SIMD_NONE:
+        return &resampler_kernels_c;
+#ifdef RESAMPLER_SSE
+    case RESAMPLER_SIMD_SSE:
+        return &resampler_kernels_sse;
+#endif
+#ifdef RESAMPLER_AVX2
+    case RESAMPLER_SIMD_AVX2:
+        return &resampler_kernels_avx2;
+#endif
+#ifdef RESAMPLER_NEON
+    case RESAMPLER_SIMD_NEON:
+        return &resampler_kernels_neon;
+#endif
+    default:
+        return 0;
+    }
+}
+
+int resampler_get_simd(void) { return resampler_simd; }
+
+int resampler_set_simd(int simd) {
+    if (simd > resampler_simd_max)
+        simd = resampler_simd_max;
+    while (simd > RESAMPLER_SIMD_NONE && !resampler_kernels_for(simd))
+        --simd;
+    if (simd < RESAMPLER_SIMD_NONE)
+        simd = RESAMPLER_SIMD_NONE;
+    resampler_simd = simd;
+    resampler_simd_kernels = resampler_kernels_for(simd);
+    return simd;
+}
+
+void resampler_init(void) {
+    unsigned i;
+    double dx = (float)(SINC_WIDTH) / SINC_SAMPLES, x = 0.0;
+    for (i = 0; i < SINC_SAMPLES + 1; ++i, x += dx) {
+        float y = x / SINC_WIDTH;
+#if 0
+        // Blackman
+        float window = 0.42659 - 0.49656 * cos(M_PI + M_PI * y) + 0.076849 * cos(2.0 * M_PI * y);
+#elif 1
+        // Nuttal 3 term
+        float window =
+            0.40897 + 0.5 * cos(M_PI * y) + 0.09103 * cos(2.0 * M_PI * y);
+#elif 0
+        // C.R.Helmrich's 2 term window
+        float window =
+            0.79445 * cos(0.5 * M_PI * y) + 0.20555 * cos(1.5 * M_PI * y);
+#elif 0
+        // Lanczos
+        float window = sinc(y);
+#endif
+        sinc_lut[i] = fabs(x) < SINC_WIDTH ? sinc(x) : 0.0;
+        window_lut[i] = window;
+    }
+    dx = 1.0 / (float)(RESAMPLER_RESOLUTION);
+    x = 0.0;
+    for (i = 0; i < RESAMPLER_RESOLUTION; ++i, x += dx) {
+        cubic_lut[i * 4] = (float)(-0.5 * x * x * x + x * x - 0.5 * x);
+        cubic_lut[i * 4 + 1] = (float)(1.5 * x * x * x - 2.5 * x * x + 1.0);
+        cubic_lut[i * 4 + 2] =
+            (float)(-1.5 * x * x * x + 2.0 * x * x + 0.5 * x);
+        cubic_lut[i * 4 + 3] = (float)(0.5 * x * x * x - 0.5 * x * x);
+    }
+    resampler_simd_max = RESAMPLER_SIMD_NONE;
+#ifdef RESAMPLER_NEON
+    resampler_simd_max = RESAMPLER_SIMD_NEON;
+#endif
+#ifdef RESAMPLER_SSE
+    if (query_cpu_feature_sse()) {
+        resampler_simd_max = RESAMPLER_SIMD_SSE;
+#ifdef RESAMPLER_AVX2
+        if (query_cpu_feature_avx2())
+            resampler_simd_max = RESAMPLER_SIMD_AVX2;
+#endif
+    }
+#endif
+    resampler_set_simd(resampler_simd_max);
+}
+
+void *resampler_create(void) { return resampler_create_channels(1); }
+
+void *resampler_create_channels(int channels) {
+    resampler *r;
+    if (channels < 1 || channels > RESAMPLER_MAX_CHANNELS)
+        return 0;
+
+    r = (resampler *)malloc(resampler_size(channels));
+    if (!r)
+        return 0;
+
+    r->write_pos = SINC_WIDTH - 1;
+    r->write_filled = 0;
+    r->read_pos = 0;
+    r->read_filled = 0;
+    r->phase = 0;
+    r->phase_inc = 0;
+    r->inv_phase = 0;
+    r->inv_phase_inc = 0;
+    r->quality = RESAMPLER_QUALITY_MAX;
+    r->channels = (unsigned char)channels;
+    r->delay_added = -1;
+    r->delay_removed = -1;
+    memset(r->last_amp, 0, sizeof(r->last_amp));
+    memset(r->accumulator, 0, sizeof(r->accumulator));
+    memset(r->buffers, 0,
+           channels * (resampler_in_stride + resampler_out_stride) *
+               sizeof(float));
+
+    return r;
+}
+
+void resampler_delete(void *_r) { free(_r); }
+
+void *resampler_dup(const void *_r) {
+    void *r_out = malloc(resampler_get_size(_r));
+    if (!r_out)
+        return 0;
+
+    resampler_dup_inplace(r_out, _r);
+
+    return r_out;
+}
+
+void resampler_dup_inplace(void *_d, const void *_s) {
+    memcpy(_d, _s, resampler_get_size(_s));
+}
+
+size_t resampler_get_size(const void *_r) {
+    const resampler *r = (const resampler *)_r;
+    return resampler_size(r->channels);
+}
+
+int resampler_get_channels(const void *_r) {
+    const resampler *r = (const resampler *)_r;
+    return r->channels;
+}
+
+static void resampler_clear_output(resampler *r) {
+    memset(r->last_amp, 0, sizeof(r->last_amp));
+    memset(r->accumulator, 0, sizeof(r->accumulator));
+    memset(resampler_buffer_out(r, 0), 0,
+           r->channels * resampler_out_stride * sizeof(float));
+}
+
+void resampler_set_quality(void *_r, int quality) {
+    resampler *r = (resampler *)_r;
+    if (quality < RESAMPLER_QUALITY_MIN)
+        quality = RESAMPLER_QUALITY_MIN;
+    else if (quality > RESAMPLER_QUALITY_MAX)
+        quality = RESAMPLER_QUALITY_MAX;
+    if (r->quality != quality) {
+        if (quality == RESAMPLER_QUALITY_BLEP ||
+            r->quality == RESAMPLER_QUALITY_BLEP ||
+            quality == RESAMPLER_QUALITY_BLAM ||
+            r->quality == RESAMPLER_QUALITY_BLAM) {
+            r->read_pos = 0;
+            r->read_filled = 0;
+            resampler_clear_output(r);
+        }
+        r->delay_added = -1;
+        r->delay_removed = -1;
+    }
+    r->quality = (unsigned char)quality;
+}
+
+int resampler_get_free_count(void *_r) {
+    resampler *r = (resampler *)_r;
+    return resampler_buffer_size - r->write_filled;
+}
+
+int resampler_get_padding_size(void) { return SINC_WIDTH - 1; }
+
+static int resampler_min_filled(resampler *r) {
+    switch (r->quality) {
+    default:
+    case RESAMPLER_QUALITY_ZOH:
+    case RESAMPLER_QUALITY_BLEP:
+        return 1;
+
+    case RESAMPLER_QUALITY_LINEAR:
+    case RESAMPLER_QUALITY_BLAM:
+        return 2;
+
+    case RESAMPLER_QUALITY_CUBIC:
+        return 4;
+
+    case RESAMPLER_QUALITY_SINC:
+        return SINC_WIDTH * 2;
+    }
+}
+
+static int resampler_input_delay(resampler *r) {
+    switch (r->quality) {
+    default:
+    case RESAMPLER_QUALITY_ZOH:
+    case RESAMPLER_QUALITY_BLEP:
+    case RESAMPLER_QUALITY_LINEAR:
+    case RESAMPLER_QUALITY_BLAM:
+        return 0;
+
+    case RESAMPLER_QUALITY_CUBIC:
+        return 1;
+
+    case RESAMPLER_QUALITY_SINC:
+        return SINC_WIDTH - 1;
+    }
+}
+
+static int resampler_output_delay(resampler *r) {
+    switch (r->quality) {
+    default:
+    case RESAMPLER_QUALITY_ZOH:
+    case RESAMPLER_QUALITY_LINEAR:
+    case RESAMPLER_QUALITY_CUBIC:
+    case RESAMPLER_QUALITY_SINC:
+        return 0;
+
+    case RESAMPLER_QUALITY_BLEP:
+    case RESAMPLER_QUALITY_BLAM:
+        return SINC_WIDTH - 1;
+    }
+}
+
+int resampler_ready(void *_r) {
+    resampler *r = (resampler *)_r;
+    return r->write_filled > resampler_min_filled(r);
+}
+
+void resampler_clear(void *_r) {
+    resampler *r = (resampler *)_r;
+    int ch;
+    r->write_pos = SINC_WIDTH - 1;
+    r->write_filled = 0;
+    r->read_pos = 0;
+    r->read_filled = 0;
+    r->phase = 0;
+    r->delay_added = -1;
+    r->delay_removed = -1;
+    for (ch = 0; ch < r->channels; ++ch) {
+        float *in = resampler_buffer_in(r, ch);
+        memset(in, 0, (SINC_WIDTH - 1) * sizeof(in[0]));
+        memset(in + resampler_buffer_size, 0,
+               (SINC_WIDTH - 1) * sizeof(in[0]));
+    }
+    if (r->quality == RESAMPLER_QUALITY_BLEP ||
+        r->quality == RESAMPLER_QUALITY_BLAM) {
+        r->inv_phase = 0;
+        resampler_clear_output(r);
+    }
+}
+
+void resampler_set_rate(void *_r, double new_factor) {
+    resampler *r = (resampler *)_r;
+    r->phase_inc = new_factor;
+    new_factor = 1.0 / new_factor;
+    r->inv_phase_inc = new_factor;
+}
+
+static int resampler_write_begin(resampler *r) {
+    if (r->delay_added < 0) {
+        r->delay_added = 0;
+        r->write_filled = resampler_input_delay(r);
+    }
+
+    return r->write_filled < resampler_buffer_size;
+}
+
+static void resampler_write(resampler *r, int channel, float s) {
+    float *in = resampler_buffer_in(r, channel);
+    in[r->write_pos] = s;
+    in[r->write_pos + resampler_buffer_size] = s;
+}
+
+static void resampler_write_end(resampler *r) {
+    ++r->write_filled;
+
+    r->write_pos = (r->write_pos + 1) % resampler_buffer_size;
+}
+
+void resampler_write_sample(void *_r, short s) {
+    resampler_write_sample_float(_r, s);
+}
+
+void resampler_write_sample_fixed(void *_r, int s, unsigned char depth) {
+    float s32 = s;
+    s32 /= (double)(1 << (depth - 1));
+    resampler_write_sample_float(_r, s32);
+}
+
+void resampler_write_sample_float(void *_r, float s) {
+    resampler *r = (resampler *)_r;
+    int ch;
+
+    if (resampler_write_begin(r)) {
+        for (ch = 0; ch < r->channels; ++ch)
+            resampler_write(r, ch, s);
+        resampler_write_end(r);
+    }
+}
+
+void resampler_write_frame(void *_r, const short *frame) {
+    resampler *r = (resampler *)_r;
+    int ch;
+
+    if (resampler_write_begin(r)) {
+        for (ch = 0; ch < r->channels; ++ch)
+            resampler_write(r, ch, frame[ch]);
+        resampler_write_end(r);
+    }
+}
+
+void resampler_write_frame_float(void *_r, const float *frame) {
+    resampler *r = (resampler *)_r;
+    int ch;
+
+    if (resampler_write_begin(r)) {
+        for (ch = 0; ch < r->channels; ++ch)
+            resampler_write(r, ch, frame[ch]);
+        resampler_write_end(r);
+    }
+}
+
+static int resampler_run_zoh(resampler *r, float **out_, float *out_end) {
+    int in_size = r->write_filled;
+    float const *in_ = resampler_buffer_in(r, 0) + resampler_buffer_size +
+                       r->write_pos - r->write_filled;
+    int used = 0;
+    in_size -= 1;
+    if (in_size > 0) {
+        const int channels = r->channels;
+        float *out = *out_;
+        float const *in = in_;
+        float const *const in_end = in + in_size;
+        float phase = r->phase;
+        float phase_inc = r->phase_inc;
+        int ch;
+
+        do {
+            if (out >= out_end)
+                break;
+
+            for (ch = 0; ch < channels; ++ch)
+                out[ch * resampler_out_stride] = in[ch * resampler_in_stride];
+            ++out;
+
+            phase += phase_inc;
+
+            in += (int)phase;
+
+            phase = fmod(phase, 1.0f);
+        } while (in < in_end);
+
+        r->phase = phase;
+        *out_ = out;
+
+        used = (int)(in - in_);
+
+        r->write_filled -= used;
+    }
+
+    return used;
+}
+
+static int resampler_run_linear(resampler *r, float **out_, float *out_end) {
+    int in_size = r->write_filled;
+    float const *in_ = resampler_buffer_in(r, 0) + resampler_buffer_size +
+                       r->write_pos - r->write_filled;
+    int used = 0;
+    in_size -= 2;
+    if (in_size > 0) {
+        const int channels = r->channels;
+        float *out = *out_;
+        float const *in = in_;
+        float const *const in_end = in + in_size;
+        float phase = r->phase;
+        float phase_inc = r->phase_inc;
+        int ch;
+
+        do {
+            if (out >= out_end)
+                break;
+
+            for (ch = 0; ch < channels; ++ch) {
+                float const *inc = in + ch * resampler_in_stride;
+                out[ch * resampler_out_stride] =
+                    inc[0] + (inc[1] - inc[0]) * phase;
+            }
+            ++out;
+
+            phase += phase_inc;
+
+            in += (int)phase;
+
+            phase = fmod(phase, 1.0f);
+        } while (in < in_end);
+
+        r->phase = phase;
+        *out_ = out;
+
+        used = (int)(in - in_);
+
+        r->write_filled -= used;
+    }
+
+    return used;
+}
+
+// The blep and blam kernels write ahead of the output position, past the end
+// of the ring buffer, so the start of it is mirrored there while they run
+static int resampler_wrap_output(resampler *r, int write_pos) {
+    int ch, write_extra = 0;
+    if (write_pos >= r->read_pos)
+        write_extra = r->read_pos;
+    if (write_extra > SINC_WIDTH * 2 - 1)
+        write_extra = SINC_WIDTH * 2 - 1;
+    for (ch = 0; ch < r->channels; ++ch) {
+        float *out = resampler_buffer_out(r, ch);
+        memcpy(out + resampler_buffer_size, out, write_extra * sizeof(out[0]));
+    }
+    return write_extra;
+}
+
+static void resampler_unwrap_output(resampler *r, int write_extra) {
+    int ch;
+    for (ch = 0; ch < r->channels; ++ch) {
+        float *out = resampler_buffer_out(r, ch);
+        memcpy(out, out + resampler_buffer_size, write_extra * sizeof(out[0]));
+    }
+}
+
+static void resampler_fill(resampler *r) {
+    const resampler_kernels *kernels = resampler_simd_kernels;
+    int min_filled = resampler_min_filled(r);
+    int quality = r->quality;
+    float *buffer_out = resampler_buffer_out(r, 0);
+    while (r->write_filled > min_filled &&
+           r->read_filled < resampler_buffer_size) {
+        int write_pos = (r->read_pos + r->read_filled) % resampler_buffer_size;
+        int write_size = resampler_buffer_size - write_pos;
+        float *out = buffer_out + write_pos;
+        if (write_size > (resampler_buffer_size - r->read_filled))
+            write_size = resampler_buffer_size - r->read_filled;
+        switch (quality) {
+        case RESAMPLER_QUALITY_ZOH:
+            resampler_run_zoh(r, &out, out + write_size);
+            break;
+
+        case RESAMPLER_QUALITY_BLEP: {
+            int used;
+            int write_extra = resampler_wrap_output(r, write_pos);
+            used = kernels->blep(r, &out, out + write_size + write_extra);
+            resampler_unwrap_output(r, write_extra);
+            if (!used)
+                return;
+            break;
+        }
+
+        case RESAMPLER_QUALITY_LINEAR:
+            resampler_run_linear(r, &out, out + write_size);
+            break;
+
+        case RESAMPLER_QUALITY_BLAM: {
+            float *out_ = out;
+            int write_extra = resampler_wrap_output(r, write_pos);
+            kernels->blam(r, &out, out + write_size + write_extra);
+            resampler_unwrap_output(r, write_extra);
+            if (out == out_)
+                return;
+            break;
+        }
+
+        case RESAMPLER_QUALITY_CUBIC:
+            kernels->cubic(r, &out, out + write_size);
+            break;
+
+        case RESAMPLER_QUALITY_SINC:
+            kernels->sinc(r, &out, out + write_size);
+            break;
+        }
+        r->read_filled += out - buffer_out - write_pos;
+    }
+}
+
+static void resampler_fill_and_remove_delay(resampler *r) {
+    resampler_fill(r);
+    if (r->delay_removed < 0) {
+        int delay = resampler_output_delay(r);
+        r->delay_removed = 0;
+        while (delay--)
+            resampler_remove_sample(r, 1);
+    }
+}
+
+int resampler_get_sample_count(void *_r) {
+    resampler *r = (resampler *)_r;
+    if (r->read_filled < 1 && ((r->quality != RESAMPLER_QUALITY_BLEP &&
+                                r->quality != RESAMPLER_QUALITY_BLAM) ||
+                               r->inv_phase_inc))
+        resampler_fill_and_remove_delay(r);
+    return r->read_filled;
+}
+
+static float resampler_read(resampler *r, int channel) {
+    float sample = resampler_buffer_out(r, channel)[r->read_pos];
+    if (r->quality == RESAMPLER_QUALITY_BLEP ||
+        r->quality == RESAMPLER_QUALITY_BLAM)
+        sample += r->accumulator[channel];
+    return sample;
+}
+
+int resampler_get_sample(void *_r) {
+    resampler *r = (resampler *)_r;
+    if (r->read_filled < 1 && r->phase_inc)
+        resampler_fill_and_remove_delay(r);
+    if (r->read_filled < 1)
+        return 0;
+    return (int)resampler_read(r, 0);
+}
+
+float resampler_get_sample_float(void *_r) {
+    resampler *r = (resampler *)_r;
+    if (r->read_filled < 1 && r->phase_inc)
+        resampler_fill_and_remove_delay(r);
+    if (r->read_filled < 1)
+        return 0;
+    return resampler_read(r, 0);
+}
+
+void resampler_get_frame(void *_r, short *frame) {
+    resampler *r = (resampler *)_r;
+    int ch;
+    if (r->read_filled < 1 && r->phase_inc)
+        resampler_fill_and_remove_delay(r);
+    for (ch = 0; ch < r->channels; ++ch) {
+        float sample = r->read_filled < 1 ? 0 : resampler_read(r, ch);
+        if (sample > 32767.0f)
+            sample = 32767.0f;
+        else if (sample < -32768.0f)
+            sample = -32768.0f;
+        frame[ch] = (short)sample;
+    }
+}
+
+void resampler_get_frame_float(void *_r, float *frame) {
+    resampler *r = (resampler *)_r;
+    int ch;
+    if (r->read_filled < 1 && r->phase_inc)
+        resampler_fill_and_remove_delay(r);
+    for (ch = 0; ch < r->channels; ++ch)
+        frame[ch] = r->read_filled < 1 ? 0 : resampler_read(r, ch);
+}
+
+void resampler_remove_sample(void *_r, int decay) {
+    resampler *r = (resampler *)_r;
+    int ch;
+    if (r->read_filled > 0) {
+        if (r->quality == RESAMPLER_QUALITY_BLEP ||
+            r->quality == RESAMPLER_QUALITY_BLAM) {
+            for (ch = 0; ch < r->channels; ++ch) {
+                float *out = resampler_buffer_out(r, ch);
+                float accumulator = r->accumulator[ch] + out[r->read_pos];
+                out[r->read_pos] = 0;
+                if (decay) {
+                    accumulator -= accumulator * (1.0f / 8192.0f);
+                    if (fabs(accumulator) < 1e-20f)
+                        accumulator = 0;
+                }
+                r->accumulator[ch] = accumulator;
+            }
+        }
+        --r->read_filled;
+        r->read_pos = (r->read_pos + 1) % resampler_buffer_size;
+    }
+}
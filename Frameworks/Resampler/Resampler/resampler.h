@@ -0,0 +1,80 @@
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Builds the lookup tables and picks the fastest kernels this CPU supports.
+   Must be called at least once before any resampler is used. */
+void resampler_init(void);
+
+enum {
+    RESAMPLER_SIMD_NONE = 0,
+    RESAMPLER_SIMD_SSE = 1,
+    RESAMPLER_SIMD_AVX2 = 2,
+    RESAMPLER_SIMD_NEON = 3
+};
+
+/* The kernels in use, which resampler_init sets to the best available.
+   Asking for a set which was not compiled in or which the CPU lacks picks
+   the best available one below it instead. Returns the set now in use. */
+int resampler_get_simd(void);
+int resampler_set_simd(int simd);
+
+enum { RESAMPLER_MAX_CHANNELS = 8 };
+
+/* resampler_create makes a single channel resampler. Resamplers with more
+   channels share the phase and kernel between them, which is cheaper than
+   running one resampler per channel. */
+void *resampler_create(void);
+void *resampler_create_channels(int channels);
+void resampler_delete(void *);
+void *resampler_dup(const void *);
+/* The destination must have as many channels as the source. */
+void resampler_dup_inplace(void *, const void *);
+/* Size of the whole state, which contains no pointers and may be copied. */
+size_t resampler_get_size(const void *);
+int resampler_get_channels(const void *);
+
+enum {
+    RESAMPLER_QUALITY_MIN = 0,
+    RESAMPLER_QUALITY_ZOH = 0,
+    RESAMPLER_QUALITY_BLEP = 1,
+    RESAMPLER_QUALITY_LINEAR = 2,
+    RESAMPLER_QUALITY_BLAM = 3,
+    RESAMPLER_QUALITY_CUBIC = 4,
+    RESAMPLER_QUALITY_SINC = 5,
+    RESAMPLER_QUALITY_MAX = 5
+};
+
+void resampler_set_quality(void *, int quality);
+
+int resampler_get_free_count(void *);
+int resampler_get_padding_size(void);
+/* The single sample functions write the same sample to every channel, and
+   read from the first one. */
+void resampler_write_sample(void *, short sample);
+void resampler_write_sample_fixed(void *, int sample, unsigned char depth);
+void resampler_write_sample_float(void *, float sample);
+/* Frames hold one sample per channel. */
+void resampler_write_frame(void *, const short *frame);
+void resampler_write_frame_float(void *, const float *frame);
+void resampler_set_rate(void *, double new_factor);
+int resampler_ready(void *);
+void resampler_clear(void *);
+int resampler_get_sample_count(void *);
+int resampler_get_sample(void *);
+float resampler_get_sample_float(void *);
+/* Clips to 16 bits. */
+void resampler_get_frame(void *, short *frame);
+void resampler_get_frame_float(void *, float *frame);
+void resampler_remove_sample(void *, int decay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
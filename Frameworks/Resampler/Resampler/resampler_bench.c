@@ -0,0 +1,92 @@
+/* Throughput benchmark for the resampler, for each quality and each set of
+   kernels the current CPU can run. Not part of any of the projects, build it
+   by hand:
+
+   cc -O2 -o resampler_bench resampler_bench.c resampler.c -lm
+   ./resampler_bench [seconds of audio per run] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "resampler.h"
+
+static const char *const simd_names[] = {"none", "sse", "avx2", "neon"};
+static const char *const quality_names[] = {"zoh",  "blep",  "linear",
+                                            "blam", "cubic", "sinc"};
+
+static const double ratios[] = {44100.0 / 48000.0, 48000.0 / 44100.0,
+                                32000.0 / 96000.0};
+
+// Returns output frames per second of CPU time
+static double run(int quality, int channels, double ratio, long frames_in) {
+    void *r = resampler_create_channels(channels);
+    float frame[RESAMPLER_MAX_CHANNELS];
+    unsigned int seed = 1;
+    long written = 0, read = 0;
+    clock_t start, end;
+    int ch;
+
+    resampler_set_quality(r, quality);
+    resampler_set_rate(r, ratio);
+
+    start = clock();
+    while (written < frames_in) {
+        while (written < frames_in && resampler_get_free_count(r)) {
+            // Noise, held for a few samples so that blep has steps to find
+            if ((written & 3) == 0)
+                for (ch = 0; ch < channels; ++ch) {
+                    seed = seed * 1103515245 + 12345;
+                    frame[ch] = (float)((int)(seed >> 16) - 32768);
+                }
+            resampler_write_frame_float(r, frame);
+            ++written;
+        }
+        while (resampler_get_sample_count(r)) {
+            resampler_get_frame_float(r, frame);
+            resampler_remove_sample(r, 1);
+            ++read;
+        }
+    }
+    end = clock();
+
+    resampler_delete(r);
+
+    return read / ((double)(end - start) / CLOCKS_PER_SEC);
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 10.0;
+    long frames_in = (long)(seconds * 44100.0);
+    int best, simd, quality, channels;
+    unsigned i;
+
+    resampler_init();
+    best = resampler_get_simd();
+
+    printf("%-6s %-7s %-4s", "simd", "quality", "ch");
+    for (i = 0; i < sizeof(ratios) / sizeof(ratios[0]); ++i)
+        printf(" %10.4f", ratios[i]);
+    printf("   (million output frames per second)\n");
+
+    for (simd = RESAMPLER_SIMD_NONE; simd <= RESAMPLER_SIMD_NEON; ++simd) {
+        if (resampler_set_simd(simd) != simd)
+            continue;
+        for (quality = RESAMPLER_QUALITY_MIN; quality <= RESAMPLER_QUALITY_MAX;
+             ++quality) {
+            for (channels = 1; channels <= 2; ++channels) {
+                printf("%-6s %-7s %-4d", simd_names[simd],
+                       quality_names[quality], channels);
+                for (i = 0; i < sizeof(ratios) / sizeof(ratios[0]); ++i)
+                    printf(" %10.2f",
+                           run(quality, channels, ratios[i], frames_in) / 1e6);
+                printf("\n");
+                fflush(stdout);
+            }
+        }
+    }
+
+    resampler_set_simd(best);
+
+    return 0;
+}
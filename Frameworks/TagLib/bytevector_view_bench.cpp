@@ -0,0 +1,170 @@
+// Time and large allocations of parsing an in-memory ID3v2 tag the way
+// TagLibID3v2Reader does, once from a copied ByteVector and once from a
+// ByteVector::fromRawData() view. Not part of the project, build it by hand
+// against the sources TagLib.xcodeproj compiles:
+//
+// c++ -O2 -DHAVE_CONFIG_H -Itaglib -Itaglib/taglib -Itaglib/taglib/toolkit -o bytevector_view_bench
+//     bytevector_view_bench.cpp <TagLib sources or library> -lz
+//
+// ./bytevector_view_bench [file.mp3 ...]
+//
+// Without files it parses synthetic ID3v2.3 and ID3v2.4 tags carrying a
+// 4 MB cover.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <taglib/fileref.h>
+#include <taglib/mpeg/id3v2/frames/attachedpictureframe.h>
+#include <taglib/mpeg/id3v2/id3v2tag.h>
+#include <taglib/mpeg/mpegfile.h>
+#include <taglib/toolkit/tbytevectorstream.h>
+
+// Everything from 64 KB up counts as a copy of the tag or the picture
+static size_t largeBytes = 0;
+static size_t largeCount = 0;
+
+// Kept out of line, otherwise GCC sees malloc() and free() through inlined
+// calls and warns about mismatched new and delete
+
+__attribute__((noinline)) void *operator new(size_t size)
+{
+  if(size >= 65536) {
+    largeBytes += size;
+    largeCount++;
+  }
+  void *p = malloc(size);
+  if(!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+static void appendSize(std::string &s, size_t size, bool synchsafe)
+{
+  const int shift = synchsafe ? 7 : 8;
+  for(int i = 3; i >= 0; i--)
+    s += char((size >> (i * shift)) & (synchsafe ? 0x7f : 0xff));
+}
+
+static std::string frame(int version, const char *id, const std::string &body)
+{
+  std::string s(id, 4);
+  appendSize(s, body.size(), version == 4);
+  s.append(2, '\0');
+  return s + body;
+}
+
+static std::string syntheticFile(int version)
+{
+  std::string picture("\0image/jpeg\0\3cover\0", 19);
+  for(size_t i = 0; i < 4000000; i++)
+    picture += char(i * 7 + 1);
+
+  std::string frames = frame(version, "TIT2", std::string("\3Title", 6)) +
+                       frame(version, "TPE1", std::string("\3Artist", 7)) +
+                       frame(version, "APIC", picture);
+
+  std::string file("ID3", 3);
+  file += char(version);
+  file.append(2, '\0');
+  appendSize(file, frames.size(), true);
+  file += frames;
+
+  // A few 128 kbps 44.1 kHz layer III frames for the MPEG properties
+  for(int i = 0; i < 8; i++) {
+    std::string mpeg(417, '\0');
+    mpeg.replace(0, 4, "\xff\xfb\x90\x00", 4);
+    file += mpeg;
+  }
+  return file;
+}
+
+// Returns the picture size, as TagLibID3v2Reader copies it out
+static size_t parse(const std::string &file, bool view)
+{
+  const TagLib::ByteVector vector = view
+    ? TagLib::ByteVector::fromRawData(file.data(), (unsigned int)file.size())
+    : TagLib::ByteVector(file.data(), (unsigned int)file.size());
+  TagLib::ByteVectorStream vectorStream(vector);
+
+  TagLib::FileRef f(&vectorStream, false);
+  TagLib::MPEG::File *mf = dynamic_cast<TagLib::MPEG::File *>(f.file());
+  if(!mf || !mf->ID3v2Tag())
+    return 0;
+
+  TagLib::ID3v2::FrameList pictures = mf->ID3v2Tag()->frameListMap()["APIC"];
+  if(pictures.isEmpty())
+    return 0;
+
+  const TagLib::ByteVector picture =
+    static_cast<TagLib::ID3v2::AttachedPictureFrame *>(pictures.front())->picture();
+  std::vector<char> image(picture.size());
+  memcpy(image.data(), picture.data(), picture.size());
+  return picture.size();
+}
+
+static void bench(const char *name, const std::string &file)
+{
+  const int runs = 50;
+
+  for(int view = 0; view < 2; view++) {
+    largeBytes = largeCount = 0;
+    size_t pictureSize = 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < runs; i++)
+      pictureSize = parse(file, view != 0);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-24.24s %-5s %10zu %10.3f %12.1f %10.1f\n", name, view ? "view" : "copy",
+           pictureSize, seconds * 1000.0 / runs, (double)largeCount / runs,
+           largeBytes / 1048576.0 / runs);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  printf("%-24s %-5s %10s %10s %12s %10s\n", "tag", "mode", "picture", "ms/parse",
+         "large/parse", "MB/parse");
+
+  if(argc < 2) {
+    bench("synthetic ID3v2.3", syntheticFile(3));
+    bench("synthetic ID3v2.4", syntheticFile(4));
+  }
+
+  int result = 0;
+  for(int i = 1; i < argc; i++) {
+    FILE *fp = fopen(argv[i], "rb");
+    if(!fp) {
+      fprintf(stderr, "Cannot open %s\n", argv[i]);
+      result = 1;
+      continue;
+    }
+    std::string file;
+    char buffer[65536];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+      file.append(buffer, n);
+    fclose(fp);
+
+    const char *name = strrchr(argv[i], '/');
+    bench(name ? name + 1 : argv[i], file);
+  }
+
+  return result;
+}
@@ -258,18 +258,21 @@ public:
   ByteVectorPrivate(unsigned int l, char c) :
     counter(new RefCounter()),
     data(new std::vector<char>(l, c)),
+    raw(0),
     offset(0),
     length(l) {}
 
-  ByteVectorPrivate(const char *s, unsigned int l) :
+  ByteVectorPrivate(const char *s, unsigned int l, bool borrow = false) :
     counter(new RefCounter()),
-    data(new std::vector<char>(s, s + l)),
+    data(borrow ? 0 : new std::vector<char>(s, s + l)),
+    raw(borrow ? s : 0),
     offset(0),
     length(l) {}
 
   ByteVectorPrivate(const ByteVectorPrivate &d, unsigned int o, unsigned int l) :
     counter(d.counter),
     data(d.data),
+    raw(d.raw),
     offset(d.offset + o),
     length(l)
   {
@@ -284,8 +287,18 @@ public:
     }
   }
 
+  // Start of this vector's bytes, in the shared buffer or in the caller's
+  // memory for vectors made by fromRawData().
+  char *begin() const
+  {
+    if(!data)
+      return const_cast<char *>(raw) + offset;
+    return data->empty() ? 0 : &data->front() + offset;
+  }
+
   RefCounter        *counter;
   std::vector<char> *data;
+  const char        *raw;
   unsigned int       offset;
   unsigned int       length;
 };
@@ -304,6 +317,14 @@ ByteVector ByteVector::fromCString(const char *s, unsigned int length)
     return ByteVector(s, length);
 }
 
+ByteVector ByteVector::fromRawData(const char *data, unsigned int length)
+{
+  ByteVector v;
+  delete v.d;
+  v.d = new ByteVectorPrivate(data, length, true);
+  return v;
+}
+
 ByteVector ByteVector::fromUInt(unsigned int value, bool mostSignificantByteFirst)
 {
   return fromNumber<unsigned int>(value, mostSignificantByteFirst);
@@ -398,12 +419,12 @@ ByteVector &ByteVector::setData(const char *data)
 char *ByteVector::data()
 {
   detach();
-  return (size() > 0) ? (&(*d->data)[d->offset]) : 0;
+  return (size() > 0) ? d->begin() : 0;
 }
 
 const char *ByteVector::data() const
 {
-  return (size() > 0) ? (&(*d->data)[d->offset]) : 0;
+  return (size() > 0) ? d->begin() : 0;
 }
 
 ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
@@ -416,7 +437,7 @@ ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
 
 char ByteVector::at(unsigned int index) const
 {
-  return (index < size()) ? (*d->data)[d->offset + index] : 0;
+  return (index < size()) ? d->begin()[index] : 0;
 }
 
 int ByteVector::find(const ByteVector &pattern, unsigned int offset, int byteAlign) const
@@ -615,51 +636,43 @@ ByteVector &ByteVector::resize(unsigned int size, char padding)
 ByteVector::Iterator ByteVector::begin()
 {
   detach();
-  return d->data->begin() + d->offset;
+  return d->begin();
 }
 
 ByteVector::ConstIterator ByteVector::begin() const
 {
-  return d->data->begin() + d->offset;
+  return d->begin();
 }
 
 ByteVector::Iterator ByteVector::end()
 {
   detach();
-  return d->data->begin() + d->offset + d->length;
+  return d->begin() + d->length;
 }
 
 ByteVector::ConstIterator ByteVector::end() const
 {
-  return d->data->begin() + d->offset + d->length;
+  return d->begin() + d->length;
 }
 
 ByteVector::ReverseIterator ByteVector::rbegin()
 {
-  detach();
-  return d->data->rbegin() + (d->data->size() - (d->offset + d->length));
+  return ReverseIterator(end());
 }
 
 ByteVector::ConstReverseIterator ByteVector::rbegin() const
 {
-  // Workaround for the Solaris Studio 12.4 compiler.
-  // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - (d->offset + d->length));
+  return ConstReverseIterator(end());
 }
 
 ByteVector::ReverseIterator ByteVector::rend()
 {
-  detach();
-  return d->data->rbegin() + (d->data->size() - d->offset);
+  return ReverseIterator(begin());
 }
 
 ByteVector::ConstReverseIterator ByteVector::rend() const
 {
-  // Workaround for the Solaris Studio 12.4 compiler.
-  // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - d->offset);
+  return ConstReverseIterator(begin());
 }
 
 bool ByteVector::isNull() const
@@ -803,13 +816,13 @@ long double ByteVector::toFloat80BE(size_t offset) const
 
 const char &ByteVector::operator[](int index) const
 {
-  return (*d->data)[d->offset + index];
+  return d->begin()[index];
 }
 
 char &ByteVector::operator[](int index)
 {
   detach();
-  return (*d->data)[d->offset + index];
+  return d->begin()[index];
 }
 
 bool ByteVector::operator==(const ByteVector &v) const
@@ -1023,9 +1036,9 @@ ByteVector ByteVector::toBase64() const
 
 void ByteVector::detach()
 {
-  if(d->counter->count() > 1) {
+  if(!d->data || d->counter->count() > 1) {
     if(!isEmpty())
-      ByteVector(&d->data->front() + d->offset, d->length).swap(*this);
+      ByteVector(d->begin(), d->length).swap(*this);
     else
       ByteVector().swap(*this);
   }
@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <iostream>
+#include <iterator>
 
 namespace TagLib {
 
@@ -46,10 +47,10 @@ namespace TagLib {
   {
   public:
 #ifndef DO_NOT_DOCUMENT
-    typedef std::vector<char>::iterator Iterator;
-    typedef std::vector<char>::const_iterator ConstIterator;
-    typedef std::vector<char>::reverse_iterator ReverseIterator;
-    typedef std::vector<char>::const_reverse_iterator ConstReverseIterator;
+    typedef char *Iterator;
+    typedef const char *ConstIterator;
+    typedef std::reverse_iterator<char *> ReverseIterator;
+    typedef std::reverse_iterator<const char *> ConstReverseIterator;
 #endif
 
     /*!
@@ -514,6 +515,16 @@ namespace TagLib {
      */
     static ByteVector fromCString(const char *s, unsigned int length = 0xffffffff);
 
+    /*!
+     * Returns a ByteVector that reads the first \a length bytes of \a data in
+     * place instead of copying them.  Copies and mid() of it share the same
+     * memory; the bytes are only copied once one of them is modified.
+     *
+     * \warning \a data must stay valid and unchanged for as long as any
+     * ByteVector made from it, including copies and mid(), is alive.
+     */
+    static ByteVector fromRawData(const char *data, unsigned int length);
+
     /*!
      * Returns a const reference to the byte at \a index.
      */
@@ -45,6 +45,10 @@ namespace TagLib {
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
      * be a C-string in the local file system encoding.
+     *
+     * The stream shares \a data, so blocks read from a ByteVector made by
+     * ByteVector::fromRawData() point into the caller's memory.  The data is
+     * only copied when the stream is written to.
      */
     ByteVectorStream(const ByteVector &data);
 
@@ -52,6 +52,7 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testAppend1);
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
+  CPPUNIT_TEST(testFromRawData);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -593,6 +594,42 @@ public:
 
   }
 
+  void testFromRawData()
+  {
+    char raw[] = "abcdef";
+
+    const ByteVector v1 = ByteVector::fromRawData(raw, 6);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), v1);
+    CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(raw), v1.data());
+    const ByteVector mid = v1.mid(2, 3);
+    CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(raw + 2), mid.data());
+    CPPUNIT_ASSERT_EQUAL('c', v1[2]);
+    CPPUNIT_ASSERT_EQUAL('f', v1.at(5));
+    CPPUNIT_ASSERT_EQUAL('f', *v1.rbegin());
+    CPPUNIT_ASSERT_EQUAL(3, v1.find("de"));
+
+    ByteVector v2 = v1.mid(1, 4);
+    v2[0] = 'B';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Bcde"), v2);
+    CPPUNIT_ASSERT(v2.data() != raw + 1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), v1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), ByteVector(raw));
+
+    ByteVector v3 = ByteVector::fromRawData(raw, 6);
+    v3.append('g');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefg"), v3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), ByteVector(raw));
+
+    ByteVector v4 = ByteVector::fromRawData(raw, 6);
+    v4.resize(3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), v4);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), ByteVector(raw));
+
+    CPPUNIT_ASSERT(ByteVector::fromRawData(raw, 0).isEmpty());
+    CPPUNIT_ASSERT(ByteVector::fromRawData(0, 0).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("x"), ByteVector::fromRawData(0, 0).append('x'));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVector);
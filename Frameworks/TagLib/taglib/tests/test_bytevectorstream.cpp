@@ -39,6 +39,7 @@ class TestByteVectorStream : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveBlock);
   CPPUNIT_TEST(testInsert);
   CPPUNIT_TEST(testSeekEnd);
+  CPPUNIT_TEST(testRawData);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -126,6 +127,23 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
   }
 
+  void testRawData()
+  {
+    char raw[] = "abcd";
+    ByteVectorStream stream(ByteVector::fromRawData(raw, 4));
+
+    stream.seek(1);
+    const ByteVector block = stream.readBlock(2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("bc"), block);
+    CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(raw + 1), block.data());
+
+    stream.seek(0);
+    stream.writeBlock(ByteVector("x"));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("xbcd"), *stream.data());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), ByteVector(raw));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("bc"), block);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVectorStream);
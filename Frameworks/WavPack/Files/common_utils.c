@@ -362,6 +362,10 @@ WavpackContext *WavpackCloseFile (WavpackContext *wpc)
     if (wpc->close_callback)
         wpc->close_callback (wpc);
 
+#ifdef ENABLE_THREADS
+    unpack_threads_free (wpc);
+#endif
+
     if (wpc->streams) {
         free_streams (wpc);
 
@@ -233,6 +233,11 @@ WavpackContext *WavpackOpenFileInputEx64 (WavpackStreamReader64 *reader, void *w
             wpc->config.sample_rate = sample_rates [(wps->wphdr.flags & SRATE_MASK) >> SRATE_LSB];
     }
 
+#ifdef ENABLE_THREADS
+    if (flags & OPEN_THREADS_MASK)
+        unpack_threads_init (wpc, (flags & OPEN_THREADS_MASK) >> OPEN_THREADS_SHFT);
+#endif
+
     return wpc;
 }
 
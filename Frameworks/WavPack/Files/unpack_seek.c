@@ -51,6 +51,10 @@ int WavpackSeekSample64 (WavpackContext *wpc, int64_t sample)
         return seek_sample3 (wpc, (uint32_t) sample);
 #endif
 
+#ifdef ENABLE_THREADS
+    unpack_threads_reset (wpc);     // anything decoded ahead is from the old file position
+#endif
+
 #ifdef ENABLE_DSD
     if (wpc->decimation_context) {      // the decimation code needs some context to be sample accurate
         if (sample < 16) {
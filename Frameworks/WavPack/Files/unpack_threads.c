@@ -0,0 +1,717 @@
+////////////////////////////////////////////////////////////////////////////
+//                           **** WAVPACK ****                            //
+//                  Hybrid Lossless Wavefile Compressor                   //
+//                Copyright (c) 1998 - 2019 David Bryant.                 //
+//                          All Rights Reserved.                          //
+//      Distributed under the BSD Software License (see license.txt)      //
+////////////////////////////////////////////////////////////////////////////
+
+// unpack_threads.c
+
+// This module decodes upcoming blocks ahead of the application on a pool of
+// worker threads (enabled with the OPEN_THREADS_MASK bits in the open flags).
+// The calling thread still does all the file reading: it reads each complete
+// set of blocks (every stream of a multichannel sequence, plus the matching
+// .wvc blocks) into a job, and any idle worker (or the calling thread itself,
+// when it is waiting on a job nobody has picked up yet) decodes that job from
+// memory into its own private copy of the context. Jobs are handed back to
+// the application strictly in file order, so the samples returned are
+// identical to single-threaded decoding. Seeking cancels everything read
+// ahead and the pipeline restarts once the sought block set is exhausted.
+
+#ifdef ENABLE_THREADS
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "wavpack_local.h"
+
+///////////////////////////// local table storage ////////////////////////////
+
+typedef struct {
+    unsigned char *data;
+    uint32_t bytes, alloc, pos;
+} BlockData;
+
+#define JOB_FREE    0   // slot is available for reading the next block set into
+#define JOB_QUEUED  1   // block set read and waiting for a decoder
+#define JOB_BUSY    2   // being decoded
+#define JOB_DONE    3   // samples ready to be handed back
+
+typedef struct {
+    BlockData wv, wvc;
+    int64_t sample_index;
+    uint32_t num_samples, samples_unpacked, samples_alloc, crc_errors;
+    int32_t *samples;
+    int state, lossy_blocks, dsd;
+    char error_message [80];
+} DecodeJob;
+
+typedef struct WorkerContext WorkerContext;
+
+typedef struct {
+    WorkerContext *wc;
+    WavpackContext *clone;
+    pthread_t thread;
+} Worker;
+
+struct WorkerContext {
+    pthread_mutex_t mutex;
+    pthread_cond_t job_queued, job_done;
+    DecodeJob *jobs;
+    int num_jobs, head, tail, count;
+    Worker *workers;
+    int num_workers, quit;
+    WavpackContext *clone;              // used by the calling thread
+    int64_t next_index;                 // sample index the next block set read should start at
+    uint32_t head_offset;               // samples already returned from the job at "head"
+    int active, file_done;
+};
+
+///////////////////////////// memory block reader ////////////////////////////
+
+// The cloned contexts read their job's blocks through this reader, so the
+// regular unpacking code (including hybrid .wvc matching and the recovery
+// done after CRC errors) works on them unchanged.
+
+static int32_t block_read_bytes (void *id, void *data, int32_t bcount)
+{
+    BlockData *bd = id;
+
+    if (bcount > (int32_t)(bd->bytes - bd->pos))
+        bcount = (int32_t)(bd->bytes - bd->pos);
+
+    memcpy (data, bd->data + bd->pos, bcount);
+    bd->pos += bcount;
+    return bcount;
+}
+
+static int32_t block_write_bytes (void *id, void *data, int32_t bcount)
+{
+    return 0;
+}
+
+static int64_t block_get_pos (void *id)
+{
+    return ((BlockData *) id)->pos;
+}
+
+static int block_set_pos_abs (void *id, int64_t pos)
+{
+    BlockData *bd = id;
+
+    if (pos < 0 || pos > bd->bytes)
+        return -1;
+
+    bd->pos = (uint32_t) pos;
+    return 0;
+}
+
+static int block_set_pos_rel (void *id, int64_t delta, int mode)
+{
+    BlockData *bd = id;
+
+    if (mode == SEEK_SET)
+        return block_set_pos_abs (id, delta);
+    else if (mode == SEEK_END)
+        return block_set_pos_abs (id, bd->bytes + delta);
+    else
+        return block_set_pos_abs (id, bd->pos + delta);
+}
+
+static int block_push_back_byte (void *id, int c)
+{
+    BlockData *bd = id;
+
+    if (!bd->pos)
+        return EOF;
+
+    bd->data [--bd->pos] = c;
+    return c;
+}
+
+static int64_t block_get_length (void *id)
+{
+    return ((BlockData *) id)->bytes;
+}
+
+static int block_can_seek (void *id)
+{
+    return 1;
+}
+
+static WavpackStreamReader64 block_reader = {
+    block_read_bytes, block_write_bytes, block_get_pos, block_set_pos_abs, block_set_pos_rel,
+    block_push_back_byte, block_get_length, block_can_seek, NULL, NULL
+};
+
+static int block_data_reserve (BlockData *bd, uint32_t bcount)
+{
+    if (bd->bytes + bcount > bd->alloc) {
+        unsigned char *data = realloc (bd->data, bd->alloc = (bd->bytes + bcount) * 2);
+
+        if (!data)
+            return FALSE;
+
+        bd->data = data;
+    }
+
+    return TRUE;
+}
+
+// Append the block with the specified (native endian) header to the job data,
+// reading the rest of the block from the file. The header is stored in its
+// original little-endian form so it can be read again by read_next_header().
+
+static int append_block (WavpackContext *wpc, void *id, WavpackHeader *wphdr, BlockData *bd)
+{
+    uint32_t data_bytes = wphdr->ckSize - 24;
+    int32_t bytes_read;
+
+    if (!block_data_reserve (bd, sizeof (WavpackHeader) + data_bytes))
+        return FALSE;
+
+    memcpy (bd->data + bd->bytes, wphdr, sizeof (WavpackHeader));
+    WavpackNativeToLittleEndian (bd->data + bd->bytes, WavpackHeaderFormat);
+    bd->bytes += sizeof (WavpackHeader);
+
+    bytes_read = wpc->reader->read_bytes (id, bd->data + bd->bytes, data_bytes);
+    bd->bytes += bytes_read > 0 ? bytes_read : 0;
+    return bytes_read == data_bytes;
+}
+
+///////////////////////////// executable code ////////////////////////////////
+
+// Create a private copy of the context for decoding jobs from memory. It shares
+// nothing that is allocated with the original (metadata, wrapper, tags, etc.)
+// and does not collect wrapper data; the block sets decoded by workers only
+// contain audio blocks anyway because anything else is handled by read_job().
+
+static WavpackContext *clone_context (WavpackContext *wpc)
+{
+    WavpackContext *clone = (WavpackContext *)malloc (sizeof (WavpackContext));
+
+    if (!clone)
+        return NULL;
+
+    memcpy (clone, wpc, sizeof (WavpackContext));
+
+    clone->metadata = NULL;
+    clone->metabytes = clone->metacount = 0;
+    clone->wrapper_data = NULL;
+    clone->wrapper_bytes = 0;
+    clone->open_flags &= ~OPEN_WRAPPER;
+    clone->reader = &block_reader;
+    clone->wv_in = clone->wvc_in = NULL;
+    CLEAR (clone->m_tag);
+    clone->stream3 = NULL;
+    clone->channel_reordering = clone->channel_identities = NULL;
+    clone->decimation_context = NULL;
+    clone->worker_context = NULL;
+    clone->close_callback = NULL;
+    clone->error_message [0] = 0;
+    clone->current_stream = 0;
+    clone->num_streams = 1;
+    clone->streams = (WavpackStream **)malloc (sizeof (WavpackStream *));
+
+    if (!clone->streams || !(clone->streams [0] = (WavpackStream *)malloc (sizeof (WavpackStream)))) {
+        if (clone->streams) free (clone->streams);
+        free (clone);
+        return NULL;
+    }
+
+    CLEAR (*clone->streams [0]);
+    return clone;
+}
+
+// Decode one block set with the specified cloned context. Only the clone and
+// the job are touched here, so this is called without holding the mutex.
+
+static void decode_job (WavpackContext *clone, DecodeJob *job)
+{
+    int num_channels = clone->reduced_channels ? clone->reduced_channels : clone->config.num_channels;
+    WavpackStream *wps = clone->streams [0];
+
+    job->samples_unpacked = 0;
+
+    if (!job->num_samples)
+        return;
+
+    if (job->samples_alloc < job->num_samples) {
+        free (job->samples);
+        job->samples = (int32_t *)malloc (job->num_samples * num_channels * sizeof (int32_t));
+        job->samples_alloc = job->samples ? job->num_samples : 0;
+    }
+
+    if (!job->samples) {
+        strcpy (job->error_message, "can't allocate memory for decoding!");
+        return;
+    }
+
+    job->wv.pos = job->wvc.pos = 0;
+    clone->wv_in = &job->wv;
+    clone->wvc_in = &job->wvc;
+    clone->crc_errors = 0;
+    clone->lossy_blocks = 0;
+    clone->error_message [0] = 0;
+
+    free_streams (clone);
+    wps->wphdr.block_samples = 0;
+    wps->sample_index = job->sample_index;
+
+    job->samples_unpacked = unpack_samples_interleaved (clone, job->samples, job->num_samples);
+    job->crc_errors = clone->crc_errors;
+    job->lossy_blocks = clone->lossy_blocks;
+    strcpy (job->error_message, clone->error_message);
+
+    free_streams (clone);
+}
+
+// Return the oldest job waiting for a decoder (mutex must be held).
+
+static DecodeJob *next_queued_job (WorkerContext *wc)
+{
+    int i;
+
+    for (i = 0; i < wc->count; ++i) {
+        DecodeJob *job = wc->jobs + (wc->head + i) % wc->num_jobs;
+
+        if (job->state == JOB_QUEUED)
+            return job;
+    }
+
+    return NULL;
+}
+
+static void *worker_thread (void *arg)
+{
+    Worker *worker = arg;
+    WorkerContext *wc = worker->wc;
+
+    pthread_mutex_lock (&wc->mutex);
+
+    while (1) {
+        DecodeJob *job = NULL;
+
+        while (!wc->quit && !(job = next_queued_job (wc)))
+            pthread_cond_wait (&wc->job_queued, &wc->mutex);
+
+        if (wc->quit)
+            break;
+
+        job->state = JOB_BUSY;
+        pthread_mutex_unlock (&wc->mutex);
+        decode_job (worker->clone, job);
+        pthread_mutex_lock (&wc->mutex);
+        job->state = JOB_DONE;
+        pthread_cond_broadcast (&wc->job_done);
+    }
+
+    pthread_mutex_unlock (&wc->mutex);
+    return NULL;
+}
+
+// Process a block without audio (typically the trailing RIFF wrapper and MD5
+// sum at the end of the file) on the application's context exactly as the
+// regular unpacking code would, so its metadata is not lost to a clone.
+
+static void process_nonaudio_block (WavpackContext *wpc, WavpackHeader *wphdr)
+{
+    WavpackStream *wps = wpc->streams [0];
+    int64_t sample_index = wps->sample_index;
+    WavpackHeader saved_wphdr = wps->wphdr;
+
+    free_streams (wpc);
+    wps->wphdr = *wphdr;
+    wps->blockbuff = (unsigned char *)malloc (wphdr->ckSize + 8);
+
+    if (wps->blockbuff) {
+        memcpy (wps->blockbuff, wphdr, 32);
+
+        if (wpc->reader->read_bytes (wpc->wv_in, wps->blockbuff + 32, wphdr->ckSize - 24) == wphdr->ckSize - 24 &&
+            WavpackVerifySingleBlock (wps->blockbuff, !(wpc->open_flags & OPEN_NO_CHECKSUM)) && !unpack_init (wpc))
+                wpc->crc_errors++;
+    }
+
+    free_streams (wpc);
+    wps->wphdr = saved_wphdr;
+    wps->sample_index = sample_index;
+}
+
+// Read the next complete set of blocks from the file(s) into the specified job.
+// Returns FALSE at the end of the file (or on a fatal read error).
+
+static int read_job (WavpackContext *wpc, WorkerContext *wc, DecodeJob *job)
+{
+    int num_blocks = 0, last_block = FALSE;
+    WavpackHeader wphdr, first_wphdr;
+    int64_t end_index;
+    uint32_t bcount;
+
+    CLEAR (first_wphdr);
+    job->wv.bytes = job->wvc.bytes = 0;
+    job->error_message [0] = 0;
+
+    while (!last_block) {
+        if (!num_blocks && wpc->wrapper_bytes >= MAX_WRAPPER_BYTES)
+            return FALSE;
+
+        bcount = read_next_header (wpc->reader, wpc->wv_in, &wphdr);
+
+        if (bcount == (uint32_t) -1)
+            break;
+
+        if (!num_blocks) {
+            if (!wphdr.block_samples) {
+                process_nonaudio_block (wpc, &wphdr);
+                continue;
+            }
+
+            // skip orphaned blocks from a multichannel sequence (which includes the streams
+            // not decoded with OPEN_2CH_MAX), counting errors as the regular code does
+
+            if (!(wphdr.flags & INITIAL_BLOCK)) {
+                if (GET_BLOCK_INDEX (wphdr) - wpc->initial_index != wc->next_index)
+                    wpc->crc_errors++;
+
+                append_block (wpc, wpc->wv_in, &wphdr, &job->wv);
+                job->wv.bytes = 0;
+                continue;
+            }
+
+            // once all the audio has been read, only blocks without audio (like the one with
+            // the trailing wrapper) are still of interest
+
+            if (wpc->total_samples != -1 && wc->next_index >= wpc->total_samples)
+                return FALSE;
+
+            first_wphdr = wphdr;
+            job->dsd = (wphdr.flags & DSD_FLAG) ? TRUE : FALSE;
+        }
+
+        if (!append_block (wpc, wpc->wv_in, &wphdr, &job->wv))
+            wc->file_done = TRUE;
+
+        last_block = wc->file_done || (wphdr.flags & FINAL_BLOCK) || wpc->reduced_channels ||
+            ++num_blocks == wpc->max_streams;
+    }
+
+    if (!job->wv.bytes)
+        return FALSE;
+
+    // collect the .wvc blocks for this sequence, leaving the file positioned at the next one
+
+    while (wpc->wvc_flag) {
+        int64_t file2pos = wpc->reader->get_pos (wpc->wvc_in);
+
+        bcount = read_next_header (wpc->reader, wpc->wvc_in, &wphdr);
+
+        if (bcount == (uint32_t) -1)
+            break;
+
+        if (GET_BLOCK_INDEX (wphdr) > GET_BLOCK_INDEX (first_wphdr)) {
+            wpc->reader->set_pos_abs (wpc->wvc_in, file2pos);
+            break;
+        }
+
+        if (!append_block (wpc, wpc->wvc_in, &wphdr, &job->wvc))
+            break;
+    }
+
+    // the job covers everything from the end of the previous one (so any gap is filled
+    // with silence by the unpacking code) to the end of this block set
+
+    end_index = GET_BLOCK_INDEX (first_wphdr) - wpc->initial_index + first_wphdr.block_samples;
+
+    if (wpc->total_samples != -1 && end_index > wpc->total_samples)
+        end_index = wpc->total_samples;
+
+    if (end_index > wc->next_index && end_index - wc->next_index <= first_wphdr.block_samples + 262144) {
+        job->sample_index = wc->next_index;
+        job->num_samples = (uint32_t) (end_index - wc->next_index);
+        wc->next_index = end_index;
+    }
+    else {
+        job->sample_index = wc->next_index;
+        job->num_samples = 0;
+        wpc->crc_errors++;
+    }
+
+    return TRUE;
+}
+
+// Read block sets into every free job slot and hand them to the workers.
+
+static void fill_jobs (WavpackContext *wpc, WorkerContext *wc)
+{
+    while (wc->count < wc->num_jobs && !wc->file_done) {
+        DecodeJob *job = wc->jobs + wc->tail;
+
+        if (!read_job (wpc, wc, job)) {
+            wc->file_done = TRUE;
+            break;
+        }
+
+        pthread_mutex_lock (&wc->mutex);
+        job->state = JOB_QUEUED;
+        wc->tail = (wc->tail + 1) % wc->num_jobs;
+        wc->count++;
+        pthread_cond_signal (&wc->job_queued);
+        pthread_mutex_unlock (&wc->mutex);
+    }
+}
+
+// Start the requested number of worker threads for the specified context (called
+// at the end of opening the file). Returns FALSE if threading cannot be used for
+// this file (which then just decodes in the calling thread).
+
+int unpack_threads_init (WavpackContext *wpc, int num_threads)
+{
+    WorkerContext *wc;
+    int i;
+
+    if (num_threads <= 0 || wpc->stream3 || (wpc->open_flags & OPEN_STREAMING) ||
+        !wpc->streams || !wpc->reader->can_seek (wpc->wv_in) ||
+        (wpc->wvc_flag && !wpc->reader->can_seek (wpc->wvc_in)))
+            return FALSE;
+
+    wc = (WorkerContext *)malloc (sizeof (WorkerContext));
+
+    if (!wc)
+        return FALSE;
+
+    CLEAR (*wc);
+    wc->num_jobs = (num_threads + 1) * 2;
+    wc->jobs = (DecodeJob *)calloc (wc->num_jobs, sizeof (DecodeJob));
+    wc->workers = (Worker *)calloc (num_threads, sizeof (Worker));
+    wc->clone = clone_context (wpc);
+
+    if (!wc->jobs || !wc->workers || !wc->clone) {
+        if (wc->clone) WavpackCloseFile (wc->clone);
+        free (wc->workers);
+        free (wc->jobs);
+        free (wc);
+        return FALSE;
+    }
+
+    pthread_mutex_init (&wc->mutex, NULL);
+    pthread_cond_init (&wc->job_queued, NULL);
+    pthread_cond_init (&wc->job_done, NULL);
+    wpc->worker_context = wc;
+
+    for (i = 0; i < num_threads; ++i) {
+        Worker *worker = wc->workers + wc->num_workers;
+
+        worker->wc = wc;
+
+        if (!(worker->clone = clone_context (wpc)))
+            break;
+
+        if (pthread_create (&worker->thread, NULL, worker_thread, worker)) {
+            WavpackCloseFile (worker->clone);
+            break;
+        }
+
+        wc->num_workers++;
+    }
+
+    return TRUE;
+}
+
+// Unpack samples using the worker pool; this is called from WavpackUnpackSamples()
+// in place of unpack_samples_interleaved() and returns exactly what that would.
+
+uint32_t unpack_threads_samples (WavpackContext *wpc, int32_t *buffer, uint32_t samples)
+{
+    int num_channels = wpc->reduced_channels ? wpc->reduced_channels : wpc->config.num_channels;
+    WorkerContext *wc = wpc->worker_context;
+    WavpackStream *wps = wpc->streams [0];
+    uint32_t samples_unpacked = 0;
+
+    // after opening or seeking, the context already has a block set loaded, and the file
+    // is only positioned after it once it has been fully unpacked in the regular way
+
+    if (!wc->active) {
+        if (wps->wphdr.block_samples && (wps->wphdr.flags & INITIAL_BLOCK) && wps->blockbuff &&
+            wps->sample_index < GET_BLOCK_INDEX (wps->wphdr) + wps->wphdr.block_samples) {
+                uint32_t samples_to_unpack = (uint32_t) (GET_BLOCK_INDEX (wps->wphdr) + wps->wphdr.block_samples - wps->sample_index);
+
+                if (samples_to_unpack > samples)
+                    samples_to_unpack = samples;
+
+                samples_unpacked = unpack_samples_interleaved (wpc, buffer, samples_to_unpack);
+
+                if (samples_unpacked < samples_to_unpack || samples_unpacked == samples ||
+                    (wpc->total_samples != -1 && wps->sample_index == wpc->total_samples))
+                        return samples_unpacked;
+
+                buffer += samples_unpacked * num_channels;
+                samples -= samples_unpacked;
+        }
+
+        free_streams (wpc);
+        wc->next_index = wps->sample_index;
+        wc->head_offset = 0;
+        wc->file_done = FALSE;
+        wc->active = TRUE;
+    }
+
+    while (samples) {
+        DecodeJob *job = wc->jobs + wc->head;
+        uint32_t samples_to_copy;
+
+        fill_jobs (wpc, wc);
+
+        if (!wc->count)
+            break;
+
+        pthread_mutex_lock (&wc->mutex);
+
+        // rather than waiting for a worker to get to the job we need next, decode it here
+
+        if (job->state == JOB_QUEUED) {
+            job->state = JOB_BUSY;
+            pthread_mutex_unlock (&wc->mutex);
+            decode_job (wc->clone, job);
+            pthread_mutex_lock (&wc->mutex);
+            job->state = JOB_DONE;
+        }
+
+        while (job->state != JOB_DONE)
+            pthread_cond_wait (&wc->job_done, &wc->mutex);
+
+        pthread_mutex_unlock (&wc->mutex);
+
+        // if a block set came back short without an error, its first block was rejected as
+        // corrupt and the regular code would fill in silence once it reaches more audio
+
+        if (job->samples_unpacked < job->num_samples && !job->error_message [0] && wc->count > 1) {
+            int32_t *zptr = job->samples + job->samples_unpacked * num_channels, zvalue = job->dsd ? 0x55 : 0;
+            uint32_t samples_to_zero = (job->num_samples - job->samples_unpacked) * num_channels;
+
+            while (samples_to_zero--)
+                *zptr++ = zvalue;
+
+            job->samples_unpacked = job->num_samples;
+            wpc->crc_errors++;
+        }
+
+        samples_to_copy = job->samples_unpacked - wc->head_offset;
+
+        if (samples_to_copy > samples)
+            samples_to_copy = samples;
+
+        memcpy (buffer, job->samples + wc->head_offset * num_channels, samples_to_copy * num_channels * sizeof (int32_t));
+        buffer += samples_to_copy * num_channels;
+        samples_unpacked += samples_to_copy;
+        samples -= samples_to_copy;
+        wc->head_offset += samples_to_copy;
+        wps->sample_index = job->sample_index + wc->head_offset;
+
+        if (wc->head_offset == job->samples_unpacked) {
+            wpc->crc_errors += job->crc_errors;
+
+            if (job->lossy_blocks)
+                wpc->lossy_blocks = TRUE;
+
+            if (job->error_message [0])
+                strcpy (wpc->error_message, job->error_message);
+
+            pthread_mutex_lock (&wc->mutex);
+            job->state = JOB_FREE;
+            wc->head = (wc->head + 1) % wc->num_jobs;
+            wc->count--;
+            pthread_mutex_unlock (&wc->mutex);
+            wc->head_offset = 0;
+
+            // a short block set means the file ended (or broke) inside it, so stop here
+
+            if (job->samples_unpacked < job->num_samples) {
+                unpack_threads_reset (wpc);
+                wc->active = wc->file_done = TRUE;
+                break;
+            }
+        }
+    }
+
+    return samples_unpacked;
+}
+
+// Discard every block set read ahead, waiting for any being decoded. This must be
+// done before the file position is changed (i.e. seeking); the next unpack starts
+// again from whatever block set is then loaded in the context.
+
+void unpack_threads_reset (WavpackContext *wpc)
+{
+    WorkerContext *wc = wpc->worker_context;
+    int i;
+
+    if (!wc || !wc->active)
+        return;
+
+    pthread_mutex_lock (&wc->mutex);
+
+    for (i = 0; i < wc->num_jobs; ++i)
+        if (wc->jobs [i].state == JOB_QUEUED)
+            wc->jobs [i].state = JOB_FREE;
+
+    for (i = 0; i < wc->num_jobs; ++i) {
+        while (wc->jobs [i].state == JOB_BUSY)
+            pthread_cond_wait (&wc->job_done, &wc->mutex);
+
+        wc->jobs [i].state = JOB_FREE;
+    }
+
+    wc->head = wc->tail = wc->count = 0;
+    pthread_mutex_unlock (&wc->mutex);
+
+    wc->head_offset = 0;
+    wc->active = FALSE;
+
+    // the file positions no longer match the loaded headers, so force a full search
+
+    free_streams (wpc);
+    wpc->streams [0]->wphdr.block_samples = 0;
+}
+
+// Stop the worker threads and free everything (called from WavpackCloseFile()).
+
+void unpack_threads_free (WavpackContext *wpc)
+{
+    WorkerContext *wc = wpc->worker_context;
+    int i;
+
+    if (!wc)
+        return;
+
+    unpack_threads_reset (wpc);
+
+    pthread_mutex_lock (&wc->mutex);
+    wc->quit = TRUE;
+    pthread_cond_broadcast (&wc->job_queued);
+    pthread_mutex_unlock (&wc->mutex);
+
+    for (i = 0; i < wc->num_workers; ++i) {
+        pthread_join (wc->workers [i].thread, NULL);
+        WavpackCloseFile (wc->workers [i].clone);
+    }
+
+    for (i = 0; i < wc->num_jobs; ++i) {
+        free (wc->jobs [i].wv.data);
+        free (wc->jobs [i].wvc.data);
+        free (wc->jobs [i].samples);
+    }
+
+    WavpackCloseFile (wc->clone);
+    pthread_cond_destroy (&wc->job_done);
+    pthread_cond_destroy (&wc->job_queued);
+    pthread_mutex_destroy (&wc->mutex);
+    free (wc->workers);
+    free (wc->jobs);
+    free (wc);
+
+    wpc->worker_context = NULL;
+}
+
+#endif
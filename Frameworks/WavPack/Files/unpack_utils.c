@@ -36,16 +36,38 @@
 
 uint32_t WavpackUnpackSamples (WavpackContext *wpc, int32_t *buffer, uint32_t samples)
 {
-    WavpackStream *wps = wpc->streams ? wpc->streams [wpc->current_stream = 0] : NULL;
-    int num_channels = wpc->config.num_channels, file_done = FALSE;
-    uint32_t bcount, samples_unpacked = 0, samples_to_unpack;
-    int32_t *bptr = buffer;
+    uint32_t samples_unpacked;
 
 #ifdef ENABLE_LEGACY
     if (wpc->stream3)
         return unpack_samples3 (wpc, buffer, samples);
 #endif
 
+#ifdef ENABLE_THREADS
+    if (wpc->worker_context)
+        samples_unpacked = unpack_threads_samples (wpc, buffer, samples);
+    else
+#endif
+        samples_unpacked = unpack_samples_interleaved (wpc, buffer, samples);
+
+#ifdef ENABLE_DSD
+    if (wpc->decimation_context)
+        decimate_dsd_run (wpc->decimation_context, buffer, samples_unpacked);
+#endif
+
+    return samples_unpacked;
+}
+
+// This is the single-threaded worker for WavpackUnpackSamples() (minus the DSD
+// decimation), also used by the decode-ahead threads on their own contexts.
+
+uint32_t unpack_samples_interleaved (WavpackContext *wpc, int32_t *buffer, uint32_t samples)
+{
+    WavpackStream *wps = wpc->streams ? wpc->streams [wpc->current_stream = 0] : NULL;
+    int num_channels = wpc->config.num_channels, file_done = FALSE;
+    uint32_t bcount, samples_unpacked = 0, samples_to_unpack;
+    int32_t *bptr = buffer;
+
     while (samples) {
 
         // if the current block has no audio, or it's not the first block of a multichannel
@@ -402,10 +424,5 @@ uint32_t WavpackUnpackSamples (WavpackContext *wpc, int32_t *buffer, uint32_t sa
             break;
     }
 
-#ifdef ENABLE_DSD
-    if (wpc->decimation_context)
-        decimate_dsd_run (wpc->decimation_context, buffer, samples_unpacked);
-#endif
-
     return samples_unpacked;
 }
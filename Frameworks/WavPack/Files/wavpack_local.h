@@ -335,6 +335,9 @@ struct WavpackContext {
     void *decimation_context;
     char file_extension [8];
 
+    // decode-ahead worker pool, when opened with OPEN_THREADS_MASK set
+    void *worker_context;
+
     void (*close_callback)(void *wpc);
     char error_message [80];
 };
@@ -443,6 +446,14 @@ uint32_t get_sample_index3 (WavpackContext *wpc);
 void free_stream3 (WavpackContext *wpc);
 int get_version3 (WavpackContext *wpc);
 
+///////////////////////////// multi-threaded decoding ////////////////////////////
+// modules: unpack_threads.c
+
+int unpack_threads_init (WavpackContext *wpc, int num_threads);
+uint32_t unpack_threads_samples (WavpackContext *wpc, int32_t *buffer, uint32_t samples);
+void unpack_threads_reset (WavpackContext *wpc);
+void unpack_threads_free (WavpackContext *wpc);
+
 ////////////////////////////// bitstream macros & functions /////////////////////////////
 
 #define bs_is_open(bs) ((bs)->ptr != NULL)
@@ -617,6 +628,8 @@ WavpackContext *WavpackOpenFileInput (const char *infilename, char *error, int f
 #define OPEN_ALT_TYPES  0x400   // application is aware of alternate file types & qmode
                                 // (just affects retrieving wrappers & MD5 checksums)
 #define OPEN_NO_CHECKSUM 0x800  // don't verify block checksums before decoding
+#define OPEN_THREADS_SHFT 12    // specify number of additional worker threads here for
+#define OPEN_THREADS_MASK 0xF000 // decode; 0 to disable, otherwise 1-15 added threads
 
 int WavpackGetMode (WavpackContext *wpc);
 
@@ -681,6 +694,7 @@ void WavpackNativeToLittleEndian (void *data, char *format);
 void WavpackBigEndianToNative (void *data, char *format);
 void WavpackNativeToBigEndian (void *data, char *format);
 
+uint32_t unpack_samples_interleaved (WavpackContext *wpc, int32_t *buffer, uint32_t samples);
 void install_close_callback (WavpackContext *wpc, void cb_func (void *wpc));
 void free_dsd_tables (WavpackStream *wps);
 void free_streams (WavpackContext *wpc);
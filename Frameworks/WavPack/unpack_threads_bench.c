@@ -0,0 +1,285 @@
+// Decode throughput of the WavPack library with and without the decode-ahead
+// worker threads (OPEN_THREADS_MASK), checking that every thread count returns
+// exactly the same samples, both straight through and after seeking. Not part
+// of the project, build it by hand:
+//
+// cc -O2 -DENABLE_DSD -DENABLE_LEGACY -DENABLE_THREADS -IFiles -o unpack_threads_bench
+//     unpack_threads_bench.c Files/*.c -lm -lpthread
+//
+// ./unpack_threads_bench [file.wv [max threads]]
+//
+// The file (and its .wvc, if there is one) is decoded from memory. Without a
+// file it encodes two minutes of synthetic stereo in "very high, extra" mode.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wavpack.h"
+
+typedef struct {
+    unsigned char *data;
+    int64_t size, alloc, pos;
+} MemFile;
+
+static int32_t mem_read_bytes (void *id, void *data, int32_t bcount)
+{
+    MemFile *mf = id;
+
+    if (bcount > mf->size - mf->pos)
+        bcount = (int32_t) (mf->size - mf->pos);
+
+    memcpy (data, mf->data + mf->pos, bcount);
+    mf->pos += bcount;
+    return bcount;
+}
+
+static int32_t mem_write_bytes (void *id, void *data, int32_t bcount)
+{
+    MemFile *mf = id;
+
+    if (mf->size + bcount > mf->alloc) {
+        mf->alloc = (mf->size + bcount) * 2;
+        mf->data = realloc (mf->data, mf->alloc);
+    }
+
+    memcpy (mf->data + mf->size, data, bcount);
+    mf->size += bcount;
+    return bcount;
+}
+
+static int64_t mem_get_pos (void *id)
+{
+    return ((MemFile *) id)->pos;
+}
+
+static int mem_set_pos_abs (void *id, int64_t pos)
+{
+    MemFile *mf = id;
+
+    if (pos < 0 || pos > mf->size)
+        return -1;
+
+    mf->pos = pos;
+    return 0;
+}
+
+static int mem_set_pos_rel (void *id, int64_t delta, int mode)
+{
+    MemFile *mf = id;
+
+    if (mode == SEEK_SET)
+        return mem_set_pos_abs (id, delta);
+    else if (mode == SEEK_END)
+        return mem_set_pos_abs (id, mf->size + delta);
+    else
+        return mem_set_pos_abs (id, mf->pos + delta);
+}
+
+static int mem_push_back_byte (void *id, int c)
+{
+    MemFile *mf = id;
+
+    if (!mf->pos)
+        return EOF;
+
+    mf->pos--;
+    return c;
+}
+
+static int64_t mem_get_length (void *id)
+{
+    return ((MemFile *) id)->size;
+}
+
+static int mem_can_seek (void *id)
+{
+    return 1;
+}
+
+static WavpackStreamReader64 mem_reader = {
+    mem_read_bytes, mem_write_bytes, mem_get_pos, mem_set_pos_abs, mem_set_pos_rel,
+    mem_push_back_byte, mem_get_length, mem_can_seek, NULL, NULL
+};
+
+static int block_output (void *id, void *data, int32_t bcount)
+{
+    return mem_write_bytes (id, data, bcount) == bcount;
+}
+
+static int load_file (const char *filename, MemFile *mf)
+{
+    FILE *file = fopen (filename, "rb");
+    unsigned char chunk [65536];
+    size_t bcount;
+
+    if (!file)
+        return 0;
+
+    while ((bcount = fread (chunk, 1, sizeof (chunk), file)) != 0)
+        mem_write_bytes (mf, chunk, (int32_t) bcount);
+
+    fclose (file);
+    return 1;
+}
+
+static void make_synthetic (MemFile *wv)
+{
+    const uint32_t sample_rate = 44100, num_samples = sample_rate * 120, chunk = 4096;
+    int32_t *buffer = malloc (chunk * 2 * sizeof (int32_t));
+    WavpackContext *wpc = WavpackOpenFileOutput (block_output, wv, NULL);
+    WavpackConfig config;
+    uint32_t i, j, seed = 1;
+
+    memset (&config, 0, sizeof (config));
+    config.bytes_per_sample = 2;
+    config.bits_per_sample = 16;
+    config.channel_mask = 3;
+    config.num_channels = 2;
+    config.sample_rate = sample_rate;
+    config.flags = CONFIG_VERY_HIGH_FLAG | CONFIG_EXTRA_MODE;
+    config.xmode = 4;
+
+    WavpackSetConfiguration64 (wpc, &config, num_samples, NULL);
+    WavpackPackInit (wpc);
+
+    for (i = 0; i < num_samples; i += chunk) {
+        for (j = 0; j < chunk; ++j) {
+            double t = (double) (i + j) / sample_rate;
+            double tone = sin (t * 220.0 * 6.2832 * (1.0 + 0.1 * sin (t * 0.5))) * 9000.0 +
+                sin (t * 331.0 * 6.2832) * 6000.0 * sin (t * 0.25);
+
+            seed = seed * 1664525 + 1013904223;
+            buffer [j * 2] = (int32_t) (tone + (int32_t) (seed >> 20) - 2048);
+            seed = seed * 1664525 + 1013904223;
+            buffer [j * 2 + 1] = (int32_t) (tone * 0.7 + (int32_t) (seed >> 20) - 2048);
+        }
+
+        WavpackPackSamples (wpc, buffer, i + chunk > num_samples ? num_samples - i : chunk);
+    }
+
+    WavpackFlushSamples (wpc);
+    WavpackCloseFile (wpc);
+    free (buffer);
+}
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static WavpackContext *open_mem (MemFile *wv, MemFile *wvc, int threads)
+{
+    char error [80];
+    WavpackContext *wpc;
+
+    wv->pos = wvc->pos = 0;
+    wpc = WavpackOpenFileInputEx64 (&mem_reader, wv, wvc->size ? wvc : NULL, error,
+        OPEN_WVC | OPEN_DSD_AS_PCM | (threads << OPEN_THREADS_SHFT), 0);
+
+    if (!wpc)
+        fprintf (stderr, "can't open: %s\n", error);
+
+    return wpc;
+}
+
+int main (int argc, char **argv)
+{
+    const uint32_t chunk = 4096;
+    MemFile wv = { 0 }, wvc = { 0 };
+    int32_t *reference = NULL, *decoded, *buffer;
+    int64_t num_samples, done;
+    int num_channels, threads, max_threads = argc > 2 ? atoi (argv [2]) : 4;
+    uint32_t seed = 12345;
+
+    if (argc > 1) {
+        char *wvc_name = malloc (strlen (argv [1]) + 2);
+
+        if (!load_file (argv [1], &wv)) {
+            fprintf (stderr, "can't read %s\n", argv [1]);
+            return 1;
+        }
+
+        strcat (strcpy (wvc_name, argv [1]), "c");
+        load_file (wvc_name, &wvc);
+        free (wvc_name);
+    }
+    else
+        make_synthetic (&wv);
+
+    printf ("%-8s %12s %12s %10s %10s\n", "threads", "ms", "x realtime", "output", "seeks");
+
+    for (threads = 0; threads <= max_threads && threads <= 15; ++threads) {
+        WavpackContext *wpc = open_mem (&wv, &wvc, threads);
+        double start, elapsed;
+        uint32_t samples;
+        int i, seeks_ok = 1;
+
+        if (!wpc)
+            return 1;
+
+        num_samples = WavpackGetNumSamples64 (wpc);
+        num_channels = WavpackGetNumChannels (wpc);
+        decoded = malloc (num_samples * num_channels * sizeof (int32_t));
+        done = 0;
+
+        start = now ();
+
+        while ((samples = WavpackUnpackSamples (wpc, decoded + done * num_channels,
+            num_samples - done < chunk ? (uint32_t) (num_samples - done) : chunk)) != 0)
+                if ((done += samples) == num_samples)
+                    break;
+
+        elapsed = now () - start;
+
+        if (!reference)
+            reference = decoded;
+
+        // seek around and compare with the straight-through reference
+
+        buffer = malloc (chunk * num_channels * sizeof (int32_t));
+
+        for (i = 0; i < 64; ++i) {
+            int64_t sample;
+
+            seed = seed * 1664525 + 1013904223;
+            sample = (int64_t) ((double) seed / 4294967296.0 * num_samples);
+
+            if (!WavpackSeekSample64 (wpc, sample)) {
+                seeks_ok = 0;
+                break;
+            }
+
+            samples = WavpackUnpackSamples (wpc, buffer, chunk);
+
+            if (sample + samples > num_samples || (samples != chunk && sample + samples != num_samples) ||
+                memcmp (buffer, reference + sample * num_channels, samples * num_channels * sizeof (int32_t))) {
+                    seeks_ok = 0;
+                    break;
+            }
+        }
+
+        free (buffer);
+
+        printf ("%-8d %12.1f %12.1f %10s %10s\n", threads, elapsed * 1000.0,
+            num_samples / (double) WavpackGetSampleRate (wpc) / elapsed,
+            decoded == reference ? "reference" : (done == num_samples &&
+                !memcmp (decoded, reference, num_samples * num_channels * sizeof (int32_t))) ? "same" : "DIFFERENT",
+            seeks_ok ? "same" : "DIFFERENT");
+
+        WavpackCloseFile (wpc);
+
+        if (decoded != reference)
+            free (decoded);
+    }
+
+    free (reference);
+    free (wv.data);
+    free (wvc.data);
+    return 0;
+}
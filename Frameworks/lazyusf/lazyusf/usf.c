@@ -12,7 +12,7 @@
 
 #include "types.h"
 
-#include "resampler.h"
+#include <Resampler/resampler.h>
 
 #include "usf_internal.h"
 
@@ -71,7 +71,9 @@ void usf_clear(void * state) {
 
 	PreAllocate_Memory(USF_STATE);
     
-	USF_STATE->resampler = resampler_create();
+	resampler_init();
+	USF_STATE->resampler = resampler_create_channels(2);
+	resampler_set_quality(USF_STATE->resampler, RESAMPLER_QUALITY_CUBIC);
 
 #ifdef DEBUG_INFO
 	USF_STATE->debug_log = fopen("/tmp/lazyusf.log", "w");
@@ -344,7 +346,7 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
 				samples_to_remove = count;
 			count -= samples_to_remove;
 			while (samples_to_remove--)
-				resampler_remove_sample(USF_STATE->resampler);
+				resampler_remove_sample(USF_STATE->resampler, 0);
 			if (!count)
 				return 0;
 		}
@@ -368,7 +370,7 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
 			if (j > USF_STATE->samples_in_buffer_2)
 				j = (int)USF_STATE->samples_in_buffer_2;
 			for (i = 0; i < j; ++i) {
-				resampler_write_sample(USF_STATE->resampler, USF_STATE->samplebuf2[i*2], USF_STATE->samplebuf2[i*2+1]);
+				resampler_write_frame(USF_STATE->resampler, USF_STATE->samplebuf2 + i*2);
 			}
 			if (i) {
 				memmove(USF_STATE->samplebuf2, USF_STATE->samplebuf2 + i * 2, (USF_STATE->samples_in_buffer_2 - i) * sizeof(short) * 2);
@@ -377,8 +379,8 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
 		}
 
 		while ( count && resampler_get_sample_count(USF_STATE->resampler) ) {
-			resampler_get_sample(USF_STATE->resampler, buffer, buffer + 1);
-			resampler_remove_sample(USF_STATE->resampler);
+			resampler_get_frame(USF_STATE->resampler, buffer);
+			resampler_remove_sample(USF_STATE->resampler, 0);
 			buffer += 2;
 			--count;
 		}
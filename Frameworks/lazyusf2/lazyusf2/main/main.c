@@ -122,6 +122,14 @@ static void connect_all(
     connect_vi(vi, r4300);
 }
 
+static void connect_audio_sink(usf_state_t* state)
+{
+    /* connect external audio sink to AI component */
+    state->g_ai.user_data = state;
+    state->g_ai.set_audio_format = usf_set_audio_format;
+    state->g_ai.push_audio_samples = usf_push_audio_samples;
+}
+
 /*********************************************************************************************************
 * emulation thread - runs the core
 */
@@ -157,10 +165,7 @@ m64p_error main_start(usf_state_t * state)
 
     init_memory(state, (disable_extra_mem == 0) ? 0x800000 : 0x400000);
 
-    /* connect external audio sink to AI component */
-    state->g_ai.user_data = state;
-    state->g_ai.set_audio_format = usf_set_audio_format;
-    state->g_ai.push_audio_samples = usf_push_audio_samples;
+    connect_audio_sink(state);
 
     /* call r4300 CPU core and run the game */
     r4300_reset_hard(state);
@@ -199,6 +204,18 @@ m64p_error main_start(usf_state_t * state)
     return M64ERR_SUCCESS;
 }
 
+/* Points all components back at the memory of this state, after its contents
+ * were copied from a snapshot which may have been taken at another address. */
+void main_reconnect(usf_state_t * state)
+{
+    connect_all(state, &state->g_r4300, &state->g_dp, &state->g_sp,
+                &state->g_ai, &state->g_pi, &state->g_ri, &state->g_si, &state->g_vi,
+                state->g_rdram, state->g_ri.rdram.dram_size,
+                state->g_rom, state->g_rom_size);
+
+    connect_audio_sink(state);
+}
+
 void main_run(usf_state_t * state)
 {
     r4300_execute(state);
@@ -22,12 +22,14 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "usf/usf.h"
 
 #include "usf/usf_internal.h"
+#include <Resampler/resampler.h>
 
 #define M64P_CORE_PROTOTYPES 1
 #include "api/m64p_types.h"
@@ -643,3 +645,356 @@ int savestates_load(usf_state_t * state, unsigned char * ptr, unsigned int size,
     else
         return savestates_load_pj64(state, ptr, size);
 }
+
+/* Snapshots are raw images of the emulator state, meant for seeking within
+ * the same build of the library. They store no pointers: those are rebuilt
+ * when a snapshot is loaded, so it may be loaded into a state at any address.
+ * Recompiled code is not stored either, and is invalidated on load. */
+
+static const unsigned char snapshot_magic[4] = { 'U', 'S', 'F', 'S' };
+static const uint32_t snapshot_version = 1;
+
+struct snapshot_header
+{
+    unsigned char magic[4];
+    uint32_t version;
+    uint32_t state_size;
+    uint32_t r4300emu;
+    uint32_t dram_size;
+    uint32_t resampler_size;
+    uint32_t pc;
+    int32_t queue_first;
+    int32_t queue_next[POOL_CAPACITY];
+    int32_t queue_stack[POOL_CAPACITY];
+};
+
+/* Parts of the state which are stored as they are. The rest is either RDRAM
+ * and the TLB lookup tables, stored without their unused pages, or tables and
+ * caches which are the same for every snapshot of a given ROM. */
+static const struct
+{
+    size_t start, end;
+} snapshot_ranges[] =
+{
+    { offsetof(usf_state_t, VR), offsetof(usf_state_t, EmptySpace) },
+    { offsetof(usf_state_t, g_rom), offsetof(usf_state_t, tlb_LUT_r) },
+    { offsetof(usf_state_t, tlb_LUT_w) + sizeof(((usf_state_t *)0)->tlb_LUT_w), offsetof(usf_state_t, invalid_code) }
+};
+
+enum { SNAPSHOT_RANGES_COUNT = sizeof(snapshot_ranges) / sizeof(snapshot_ranges[0]) };
+
+/* Sparse arrays are stored as one byte per page telling whether it is in use,
+ * followed by the pages which are. */
+enum { SNAPSHOT_PAGE_WORDS = 0x400 };
+
+static int snapshot_page_used(const uint32_t * page)
+{
+    size_t i;
+    for (i = 0; i < SNAPSHOT_PAGE_WORDS; ++i)
+    {
+        if (page[i])
+            return 1;
+    }
+    return 0;
+}
+
+static size_t snapshot_sparse_size(const uint32_t * data, size_t words)
+{
+    size_t size = words / SNAPSHOT_PAGE_WORDS;
+    size_t i;
+    for (i = 0; i < words; i += SNAPSHOT_PAGE_WORDS)
+    {
+        if (snapshot_page_used(data + i))
+            size += SNAPSHOT_PAGE_WORDS * 4;
+    }
+    return size;
+}
+
+static unsigned char * snapshot_sparse_write(unsigned char * curr, const uint32_t * data, size_t words)
+{
+    unsigned char * used = curr;
+    size_t i;
+    curr += words / SNAPSHOT_PAGE_WORDS;
+    for (i = 0; i < words; i += SNAPSHOT_PAGE_WORDS)
+    {
+        *used = (unsigned char)snapshot_page_used(data + i);
+        if (*used++)
+        {
+            memcpy(curr, data + i, SNAPSHOT_PAGE_WORDS * 4);
+            curr += SNAPSHOT_PAGE_WORDS * 4;
+        }
+    }
+    return curr;
+}
+
+/* Returns the stored size of a sparse array, or 0 if it is truncated. */
+static size_t snapshot_sparse_check(const unsigned char * curr, const unsigned char * end, size_t words)
+{
+    size_t pages = words / SNAPSHOT_PAGE_WORDS;
+    size_t size = pages;
+    size_t i;
+    if ((size_t)(end - curr) < pages)
+        return 0;
+    for (i = 0; i < pages; ++i)
+    {
+        if (curr[i])
+            size += SNAPSHOT_PAGE_WORDS * 4;
+    }
+    return ((size_t)(end - curr) < size) ? 0 : size;
+}
+
+static const unsigned char * snapshot_sparse_read(const unsigned char * curr, uint32_t * data, size_t words)
+{
+    const unsigned char * used = curr;
+    size_t i;
+    curr += words / SNAPSHOT_PAGE_WORDS;
+    for (i = 0; i < words; i += SNAPSHOT_PAGE_WORDS)
+    {
+        if (*used++)
+        {
+            memcpy(data + i, curr, SNAPSHOT_PAGE_WORDS * 4);
+            curr += SNAPSHOT_PAGE_WORDS * 4;
+        }
+        else
+            memset(data + i, 0, SNAPSHOT_PAGE_WORDS * 4);
+    }
+    return curr;
+}
+
+static size_t snapshot_fixed_size(usf_state_t * state)
+{
+    size_t size = sizeof(struct snapshot_header) + resampler_get_size(state->resampler);
+    int i;
+    for (i = 0; i < SNAPSHOT_RANGES_COUNT; ++i)
+        size += snapshot_ranges[i].end - snapshot_ranges[i].start;
+    return size;
+}
+
+static int32_t snapshot_node_index(usf_state_t * state, const struct node * node)
+{
+    return node ? (int32_t)(node - state->q.pool.nodes) : -1;
+}
+
+static struct node * snapshot_node(usf_state_t * state, int32_t index)
+{
+    return (index >= 0) ? &state->q.pool.nodes[index] : NULL;
+}
+
+static int snapshot_node_valid(int32_t index)
+{
+    return index >= -1 && index < POOL_CAPACITY;
+}
+
+size_t savestates_snapshot_size(usf_state_t * state)
+{
+    return snapshot_fixed_size(state)
+         + snapshot_sparse_size(state->g_rdram, state->g_ri.rdram.dram_size / 4)
+         + snapshot_sparse_size(state->tlb_LUT_r, 0x100000)
+         + snapshot_sparse_size(state->tlb_LUT_w, 0x100000);
+}
+
+size_t savestates_save_snapshot(usf_state_t * state, unsigned char * ptr, size_t size)
+{
+    struct snapshot_header header;
+    unsigned char * curr = ptr;
+    int i;
+
+    if (size < savestates_snapshot_size(state))
+        return 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshot_magic, 4);
+    header.version = snapshot_version;
+    header.state_size = sizeof(usf_state_t);
+    header.r4300emu = state->r4300emu;
+    header.dram_size = (uint32_t)state->g_ri.rdram.dram_size;
+    header.resampler_size = (uint32_t)resampler_get_size(state->resampler);
+#ifdef NEW_DYNAREC
+    if (state->r4300emu == CORE_DYNAREC)
+        header.pc = state->pcaddr;
+    else
+        header.pc = state->PC->addr;
+#else
+    header.pc = state->PC->addr;
+#endif
+    header.queue_first = snapshot_node_index(state, state->q.first);
+    for (i = 0; i < POOL_CAPACITY; ++i)
+    {
+        header.queue_next[i] = snapshot_node_index(state, state->q.pool.nodes[i].next);
+        header.queue_stack[i] = snapshot_node_index(state, state->q.pool.stack[i]);
+    }
+
+    memcpy(curr, &header, sizeof(header));
+    curr += sizeof(header);
+
+    for (i = 0; i < SNAPSHOT_RANGES_COUNT; ++i)
+    {
+        size_t length = snapshot_ranges[i].end - snapshot_ranges[i].start;
+        memcpy(curr, (unsigned char *)state + snapshot_ranges[i].start, length);
+        curr += length;
+    }
+
+    resampler_dup_inplace(curr, state->resampler);
+    curr += resampler_get_size(state->resampler);
+
+    curr = snapshot_sparse_write(curr, state->g_rdram, state->g_ri.rdram.dram_size / 4);
+    curr = snapshot_sparse_write(curr, state->tlb_LUT_r, 0x100000);
+    curr = snapshot_sparse_write(curr, state->tlb_LUT_w, 0x100000);
+
+    return curr - ptr;
+}
+
+int savestates_load_snapshot(usf_state_t * state, const unsigned char * ptr, size_t size)
+{
+    struct snapshot_header header;
+    const unsigned char * curr = ptr;
+    const unsigned char * end = ptr + size;
+    size_t length, sparse_length;
+    int i;
+
+    /* Members which belong to the state being loaded into, rather than to
+     * the emulated machine. */
+    unsigned char * save_state;
+    unsigned int save_state_size;
+    void * barray_rom, * barray_ram_read, * barray_ram_written_first;
+    size_t sample_buffer_count;
+    int16_t * sample_buffer;
+    void * resampler;
+    unsigned char * g_rom;
+    int g_rom_size;
+    precomp_instr interp_PC;
+    cpu_instruction_table current_instruction_table;
+    unsigned int skip_jump;
+
+    if (size < snapshot_fixed_size(state))
+        return 0;
+
+    memcpy(&header, curr, sizeof(header));
+    curr += sizeof(header);
+
+    if (memcmp(header.magic, snapshot_magic, 4) != 0 ||
+        header.version != snapshot_version ||
+        header.state_size != sizeof(usf_state_t) ||
+        header.r4300emu != state->r4300emu ||
+        header.dram_size != state->g_ri.rdram.dram_size ||
+        header.resampler_size != resampler_get_size(state->resampler) ||
+        !snapshot_node_valid(header.queue_first))
+        return 0;
+
+    for (i = 0; i < POOL_CAPACITY; ++i)
+    {
+        if (!snapshot_node_valid(header.queue_next[i]) ||
+            !snapshot_node_valid(header.queue_stack[i]))
+            return 0;
+    }
+
+    /* check the sparse arrays before anything is overwritten */
+    length = snapshot_fixed_size(state) - sizeof(header);
+    sparse_length = snapshot_sparse_check(curr + length, end, header.dram_size / 4);
+    if (!sparse_length)
+        return 0;
+    length += sparse_length;
+    sparse_length = snapshot_sparse_check(curr + length, end, 0x100000);
+    if (!sparse_length)
+        return 0;
+    length += sparse_length;
+    sparse_length = snapshot_sparse_check(curr + length, end, 0x100000);
+    if (!sparse_length || curr + length + sparse_length != end)
+        return 0;
+
+    save_state = state->save_state;
+    save_state_size = state->save_state_size;
+    barray_rom = state->barray_rom;
+    barray_ram_read = state->barray_ram_read;
+    barray_ram_written_first = state->barray_ram_written_first;
+    sample_buffer_count = state->sample_buffer_count;
+    sample_buffer = state->sample_buffer;
+    resampler = state->resampler;
+    g_rom = state->g_rom;
+    g_rom_size = state->g_rom_size;
+    interp_PC = state->interp_PC;
+    current_instruction_table = state->current_instruction_table;
+
+    for (i = 0; i < SNAPSHOT_RANGES_COUNT; ++i)
+    {
+        length = snapshot_ranges[i].end - snapshot_ranges[i].start;
+        memcpy((unsigned char *)state + snapshot_ranges[i].start, curr, length);
+        curr += length;
+    }
+
+    state->save_state = save_state;
+    state->save_state_size = save_state_size;
+    state->barray_rom = barray_rom;
+    state->barray_ram_read = barray_ram_read;
+    state->barray_ram_written_first = barray_ram_written_first;
+    state->sample_buffer_count = sample_buffer_count;
+    state->sample_buffer = sample_buffer;
+    state->resampler = resampler;
+    state->g_rom = g_rom;
+    state->g_rom_size = g_rom_size;
+    state->interp_PC = interp_PC;
+    state->current_instruction_table = current_instruction_table;
+    state->last_error = 0;
+
+    resampler_dup_inplace(state->resampler, curr);
+    curr += resampler_get_size(state->resampler);
+
+    curr = snapshot_sparse_read(curr, state->g_rdram, header.dram_size / 4);
+    curr = snapshot_sparse_read(curr, state->tlb_LUT_r, 0x100000);
+    curr = snapshot_sparse_read(curr, state->tlb_LUT_w, 0x100000);
+
+    main_reconnect(state);
+    set_fpr_pointers(state, state->g_cp0_regs[CP0_STATUS_REG]);
+
+    state->q.first = snapshot_node(state, header.queue_first);
+    for (i = 0; i < POOL_CAPACITY; ++i)
+    {
+        state->q.pool.nodes[i].next = snapshot_node(state, header.queue_next[i]);
+        state->q.pool.stack[i] = snapshot_node(state, header.queue_stack[i]);
+    }
+
+    state->rdword = &state->cpu_dword;
+    if (state->r4300emu == CORE_PURE_INTERPRETER)
+        state->PC = &state->interp_PC;
+
+    /* The detected ucodes are cached as function pointers */
+    state->hle.cached_ucodes.count = 0;
+
+    skip_jump = state->skip_jump;
+    state->skip_jump = 0;
+
+#ifdef NEW_DYNAREC
+    if (state->r4300emu == CORE_DYNAREC) {
+        state->pcaddr = header.pc;
+        state->pending_exception = 1;
+        invalidate_all_pages(state);
+    } else {
+        if(state->r4300emu != CORE_PURE_INTERPRETER)
+        {
+            for (i = 0; i < 0x100000; i++)
+                state->invalid_code[i] = 1;
+        }
+        generic_jump_to(state, header.pc);
+    }
+#else
+    if(state->r4300emu != CORE_PURE_INTERPRETER)
+    {
+        for (i = 0; i < 0x100000; i++)
+            state->invalid_code[i] = 1;
+    }
+#ifdef DYNAREC
+    {
+        unsigned long long dummy;
+        *(void **)&state->return_address = (void *)&dummy;
+        generic_jump_to(state, header.pc);
+        *(void **)&state->return_address = (void *)0;
+    }
+#else
+    generic_jump_to(state, header.pc);
+#endif
+#endif
+
+    state->skip_jump = skip_jump;
+
+    return 1;
+}
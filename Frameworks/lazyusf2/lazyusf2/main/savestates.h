@@ -27,5 +27,9 @@
 
 int savestates_load(usf_state_t *, unsigned char * ptr, unsigned int size, unsigned int is_m64p);
 
+size_t savestates_snapshot_size(usf_state_t *);
+size_t savestates_save_snapshot(usf_state_t *, unsigned char * ptr, size_t size);
+int savestates_load_snapshot(usf_state_t *, const unsigned char * ptr, size_t size);
+
 #endif /* __SAVESTAVES_H__ */
 
@@ -14,7 +14,7 @@
 #include "r4300/cached_interp.h"
 #include "r4300/r4300.h"
 
-#include "resampler.h"
+#include <Resampler/resampler.h>
 
 #include "barray.h"
 
@@ -55,7 +55,9 @@ void usf_clear(void * state)
         USF_STATE->EmptySpace[offset / 4] = (uint32_t)((offset << 16) | offset);
     }
 
-    USF_STATE->resampler = resampler_create();
+    resampler_init();
+    USF_STATE->resampler = resampler_create_channels(2);
+    resampler_set_quality(USF_STATE->resampler, RESAMPLER_QUALITY_CUBIC);
 
 #ifdef DEBUG_INFO
     USF_STATE->debug_log = NULL;
@@ -335,8 +337,68 @@ const char * usf_render(void * state, int16_t * buffer, size_t count, int32_t *
     return USF_STATE->last_error;
 }
 
+static void usf_clear_checkpoints(usf_state_t * state)
+{
+    unsigned int i;
+    for (i = 0; i < state->checkpoint_count; ++i)
+        free(state->checkpoints[i].data);
+    state->checkpoint_count = 0;
+    state->checkpoint_rate = 0;
+}
+
+static void usf_save_checkpoint(usf_state_t * state, int32_t sample_rate)
+{
+    struct usf_checkpoint * checkpoint;
+    unsigned int i;
+    size_t size;
+    unsigned char * data;
+
+    if (state->checkpoint_rate != sample_rate)
+    {
+        usf_clear_checkpoints(state);
+        state->checkpoint_rate = sample_rate;
+        state->checkpoint_interval = (uint64_t)state->checkpoint_interval_ms * sample_rate / 1000;
+        if (!state->checkpoint_interval)
+            state->checkpoint_interval = 1;
+        state->checkpoint_next = state->checkpoint_interval;
+        if (state->resampled_position < state->checkpoint_next)
+            return;
+    }
+
+    if (state->checkpoint_count == state->checkpoint_max)
+    {
+        for (i = 0; i < state->checkpoint_count; ++i)
+        {
+            if (i & 1)
+                free(state->checkpoints[i].data);
+            else
+                state->checkpoints[i / 2] = state->checkpoints[i];
+        }
+        state->checkpoint_count = (state->checkpoint_count + 1) / 2;
+        state->checkpoint_interval *= 2;
+    }
+
+    state->checkpoint_next = state->resampled_position + state->checkpoint_interval;
+
+    size = savestates_snapshot_size(state);
+    data = (unsigned char *) malloc(size);
+    if (!data)
+        return;
+
+    checkpoint = &state->checkpoints[state->checkpoint_count++];
+    checkpoint->position = state->resampled_position;
+    checkpoint->size = savestates_save_snapshot(state, data, size);
+    checkpoint->data = data;
+}
+
 const char * usf_render_resampled(void * state, int16_t * buffer, size_t count, int32_t sample_rate)
 {
+    if ( USF_STATE->checkpoint_max && USF_STATE->MemoryState && !USF_STATE->enable_trimming_mode &&
+         ( USF_STATE->checkpoint_rate != sample_rate || USF_STATE->resampled_position >= USF_STATE->checkpoint_next ) )
+        usf_save_checkpoint( USF_STATE, sample_rate );
+
+    USF_STATE->resampled_position += count;
+
     if ( !buffer )
     {
         unsigned long samples_buffered = resampler_get_sample_count( USF_STATE->resampler );
@@ -348,7 +410,7 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
                 samples_to_remove = count;
             count -= samples_to_remove;
             while (samples_to_remove--)
-                resampler_remove_sample(USF_STATE->resampler);
+                resampler_remove_sample(USF_STATE->resampler, 0);
             if (!count)
                 return 0;
         }
@@ -377,7 +439,7 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
                 j = (int)USF_STATE->samples_in_buffer_2;
             for (i = 0; i < j; ++i)
             {
-                resampler_write_sample(USF_STATE->resampler, USF_STATE->samplebuf2[i*2], USF_STATE->samplebuf2[i*2+1]);
+                resampler_write_frame(USF_STATE->resampler, USF_STATE->samplebuf2 + i*2);
             }
             memmove(USF_STATE->samplebuf2, USF_STATE->samplebuf2 + i * 2, (USF_STATE->samples_in_buffer_2 - i) * sizeof(short) * 2);
             USF_STATE->samples_in_buffer_2 -= i;
@@ -385,8 +447,8 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
 
         while ( count && resampler_get_sample_count(USF_STATE->resampler) )
         {
-            resampler_get_sample(USF_STATE->resampler, buffer, buffer + 1);
-            resampler_remove_sample(USF_STATE->resampler);
+            resampler_get_frame(USF_STATE->resampler, buffer);
+            resampler_remove_sample(USF_STATE->resampler, 0);
             buffer += 2;
             --count;
         }
@@ -430,6 +492,109 @@ void usf_restart(void * state)
     USF_STATE->samples_in_buffer_2 = 0;
 
     resampler_clear(USF_STATE->resampler);
+
+    USF_STATE->resampled_position = 0;
+    if ( USF_STATE->checkpoint_count )
+        USF_STATE->checkpoint_next = USF_STATE->checkpoints[USF_STATE->checkpoint_count - 1].position + USF_STATE->checkpoint_interval;
+    else
+        USF_STATE->checkpoint_next = USF_STATE->checkpoint_interval;
+}
+
+size_t usf_get_snapshot_size(void * state)
+{
+    if ( USF_STATE->enable_trimming_mode )
+        return 0;
+
+    if ( !USF_STATE->MemoryState )
+    {
+        if ( usf_startup( USF_STATE ) < 0 )
+            return 0;
+    }
+
+    return savestates_snapshot_size( USF_STATE );
+}
+
+size_t usf_save_snapshot(void * state, void * buffer, size_t size)
+{
+    if ( !usf_get_snapshot_size( state ) )
+        return 0;
+
+    return savestates_save_snapshot( USF_STATE, (unsigned char *) buffer, size );
+}
+
+int usf_restore_snapshot(void * state, const void * buffer, size_t size)
+{
+    if ( USF_STATE->enable_trimming_mode )
+        return -1;
+
+    if ( !USF_STATE->MemoryState )
+    {
+        if ( usf_startup( USF_STATE ) < 0 )
+            return -1;
+    }
+
+    if ( !savestates_load_snapshot( USF_STATE, (const unsigned char *) buffer, size ) )
+        return -1;
+
+    return 0;
+}
+
+void usf_set_checkpoints(void * state, unsigned int interval_ms, unsigned int count)
+{
+    usf_clear_checkpoints( USF_STATE );
+    free( USF_STATE->checkpoints );
+    USF_STATE->checkpoints = 0;
+    USF_STATE->checkpoint_max = 0;
+    USF_STATE->checkpoint_interval_ms = interval_ms;
+
+    if ( !interval_ms || !count )
+        return;
+
+    // Dropping every other checkpoint needs at least two of them
+    if ( count < 2 )
+        count = 2;
+
+    USF_STATE->checkpoints = (struct usf_checkpoint *) calloc( count, sizeof(struct usf_checkpoint) );
+    if ( USF_STATE->checkpoints )
+        USF_STATE->checkpoint_max = count;
+}
+
+const char * usf_seek_resampled(void * state, uint64_t position, int32_t sample_rate)
+{
+    if ( USF_STATE->checkpoint_count && USF_STATE->checkpoint_rate == sample_rate )
+    {
+        const struct usf_checkpoint * checkpoint = 0;
+        unsigned int i;
+
+        for ( i = 0; i < USF_STATE->checkpoint_count && USF_STATE->checkpoints[i].position <= position; ++i )
+            checkpoint = &USF_STATE->checkpoints[i];
+
+        // Only worth it if it gets us closer than rendering from where we are
+        if ( checkpoint && ( position < USF_STATE->resampled_position || checkpoint->position > USF_STATE->resampled_position ) )
+            usf_restore_snapshot( state, checkpoint->data, checkpoint->size );
+    }
+
+    if ( position < USF_STATE->resampled_position )
+        usf_restart( state );
+
+    // Render into a scratch buffer rather than discarding samples, which
+    // would also discard the resampler's history, so that playback continues
+    // exactly as if it had never been interrupted. This also keeps
+    // checkpoints along the way.
+    while ( USF_STATE->resampled_position < position )
+    {
+        int16_t buffer[1024 * 2];
+        const char * err;
+        uint64_t count = position - USF_STATE->resampled_position;
+        if ( count > 1024 )
+            count = 1024;
+
+        err = usf_render_resampled( state, buffer, (size_t) count, sample_rate );
+        if ( err )
+            return err;
+    }
+
+    return 0;
 }
 
 void usf_shutdown(void * state)
@@ -457,6 +622,7 @@ void usf_shutdown(void * state)
 #endif
     resampler_delete(USF_STATE->resampler);
     USF_STATE->resampler = 0;
+    usf_set_checkpoints(state, 0, 0);
 }
 
 void * usf_get_rom_coverage_barray(void * state)
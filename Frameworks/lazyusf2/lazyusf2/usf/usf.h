@@ -84,6 +84,43 @@ const char * usf_render_resampled(void * state, int16_t * buffer, size_t count,
    discards any buffered sample data. */
 void usf_restart(void * state);
 
+/* Snapshots capture the complete emulation state at the current position,
+   including any buffered sample data, so that it can be resumed later on.
+   They do not depend on where the state is located in memory, and may be
+   restored into any state which has the same ROM, save state and options
+   uploaded, and was created by the same build of the library. They can not
+   be taken or restored while trimming mode is enabled.
+   These will start emulation first, if it has not started yet. */
+
+/* Returns the size of a snapshot of the current position, or 0 on failure. */
+size_t usf_get_snapshot_size(void * state);
+
+/* Writes a snapshot to the buffer passed in. Returns its size, or 0 if the
+   buffer is too small or on failure. */
+size_t usf_save_snapshot(void * state, void * buffer, size_t size);
+
+/* Returns -1 on invalid or incompatible data, or 0 on success, in which case
+   the next usf_render call continues from the snapshot's position. */
+int usf_restore_snapshot(void * state, const void * buffer, size_t size);
+
+/* Keeps a snapshot every interval_ms of output rendered by
+   usf_render_resampled, so that usf_seek_resampled can resume from the
+   nearest one instead of restarting emulation. At most count snapshots are
+   kept. When they are all in use, every other one is dropped and the
+   interval doubles, so they keep covering the whole track. Each one takes
+   roughly as much memory as the RDRAM in use by the game.
+   Checkpoints are kept across usf_restart. An interval of zero discards them
+   and disables this, which is the default. */
+void usf_set_checkpoints(void * state, unsigned int interval_ms, unsigned int count);
+
+/* Moves to the given position, in samples of output from
+   usf_render_resampled at the sample rate passed in, counted from the start
+   of emulation. Seeking backwards restarts emulation unless a checkpoint is
+   available. Either way, the output which follows is the same as if
+   rendering had continued up to this position.
+   Returns 0 on success, or a pointer to the last error message on failure. */
+const char * usf_seek_resampled(void * state, uint64_t position, int32_t sample_rate);
+
 /* Frees all allocated memory associated with the emulator state. Necessary
    after at least one call to usf_render, or else the memory will be leaked. */
 void usf_shutdown(void * state);
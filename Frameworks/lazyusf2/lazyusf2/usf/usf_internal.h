@@ -189,6 +189,13 @@ typedef struct _precomp_block
 } precomp_block;
 #endif
 
+struct usf_checkpoint
+{
+    uint64_t position;
+    size_t size;
+    unsigned char * data;
+};
+
 struct usf_state
 {
     // main/main.c
@@ -277,6 +284,10 @@ struct usf_state
     void * resampler;
     int16_t samplebuf2[8192];
     size_t samples_in_buffer_2;
+
+    // Number of samples requested from usf_render_resampled() since the
+    // emulator was last started, used to locate seek checkpoints
+    uint64_t resampled_position;
     
     // This buffer does not really need to be that large, as it is likely
     // to only accumulate a handlful of error messages, at which point
@@ -472,6 +483,16 @@ struct usf_state
 
 #endif
     
+    // usf/usf.c, seek checkpoints. These are not part of the snapshots
+    // themselves, and stay in place when one is restored.
+    unsigned int checkpoint_interval_ms;
+    unsigned int checkpoint_max;
+    unsigned int checkpoint_count;
+    int32_t checkpoint_rate; // sample rate the positions below are counted in
+    uint64_t checkpoint_interval;
+    uint64_t checkpoint_next; // resampled_position when the next one is due
+    struct usf_checkpoint * checkpoints; // ascending by position
+
     // logging
 #ifdef DEBUG_INFO
     FILE * debug_log;
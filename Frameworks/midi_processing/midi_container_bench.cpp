@@ -0,0 +1,138 @@
+// Time of building MIDI tracks the way the XMI and HMI loaders do, with note
+// offs generated ahead of the events that follow them, once through
+// midi_track::add_event() and once through append_event() and finalize(),
+// checking that both produce the same track. Not part of the project, build
+// it by hand:
+//
+// c++ -std=c++11 -O2 -I. -o midi_container_bench midi_container_bench.cpp
+//     midi_processing/*.cpp
+//
+// ./midi_container_bench [file.xmi ...]
+//
+// Files given on the command line are loaded with midi_processor instead,
+// which appends, and only their load time is reported.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include <midi_processing/midi_processor.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const uint8_t end_of_track[2] = { 0xFF, 0x2F };
+
+// Note ons with their note offs right behind them, as decoded from XMI
+static void make_events( std::vector<midi_event> & p_events, unsigned long p_notes )
+{
+    uint32_t seed = 1;
+    unsigned long timestamp = 0;
+    uint8_t data[2];
+
+    p_events.clear();
+    for ( unsigned long i = 0; i < p_notes; i++ )
+    {
+        seed = seed * 1664525 + 1013904223;
+        timestamp += ( seed >> 8 ) % 24;
+        data[ 0 ] = 36 + ( seed >> 16 ) % 48;
+        data[ 1 ] = 100;
+        p_events.push_back( midi_event( timestamp, midi_event::note_on, i & 15, data, 2 ) );
+        data[ 1 ] = 0;
+        p_events.push_back( midi_event( timestamp + 1 + ( seed >> 20 ) % 1920, midi_event::note_on, i & 15, data, 2 ) );
+    }
+    p_events.push_back( midi_event( timestamp, midi_event::extended, 0, end_of_track, 2 ) );
+}
+
+static bool same_event( const midi_event & a, const midi_event & b )
+{
+    return a.m_timestamp == b.m_timestamp && a.m_type == b.m_type && a.m_channel == b.m_channel &&
+        a.m_data_count == b.m_data_count && !memcmp( a.m_data, b.m_data, a.m_data_count ) && a.m_ext_data == b.m_ext_data;
+}
+
+static void bench_synthetic( unsigned long p_notes )
+{
+    std::vector<midi_event> events;
+    make_events( events, p_notes );
+
+    midi_track inserted, appended;
+
+    double start = now();
+    for ( std::size_t i = 0; i < events.size(); i++ ) inserted.add_event( events[ i ] );
+    double inserted_seconds = now() - start;
+
+    start = now();
+    for ( std::size_t i = 0; i < events.size(); i++ ) appended.append_event( events[ i ] );
+    appended.finalize();
+    double appended_seconds = now() - start;
+
+    bool same = inserted.get_count() == appended.get_count();
+    for ( std::size_t i = 0; same && i < inserted.get_count(); i++ )
+        same = same_event( inserted[ i ], appended[ i ] );
+
+    printf( "%-24s %10lu %12.3f %12.3f %8.1fx %s\n", "synthetic XMI track", (unsigned long)events.size(),
+        inserted_seconds * 1000.0, appended_seconds * 1000.0, inserted_seconds / appended_seconds, same ? "same" : "differs" );
+}
+
+static int bench_file( const char * p_filename )
+{
+    FILE * f = fopen( p_filename, "rb" );
+    if ( !f )
+    {
+        fprintf( stderr, "Cannot open %s\n", p_filename );
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[65536];
+    std::size_t count;
+    while ( ( count = fread( buffer, 1, sizeof( buffer ), f ) ) > 0 )
+        data.insert( data.end(), buffer, buffer + count );
+    fclose( f );
+
+    const char * name = strrchr( p_filename, '/' );
+    name = name ? name + 1 : p_filename;
+    const char * extension = strrchr( name, '.' );
+    extension = extension ? extension + 1 : "";
+
+    const unsigned runs = 20;
+    unsigned tracks = 0;
+    double start = now();
+    for ( unsigned i = 0; i < runs; i++ )
+    {
+        midi_container midi;
+        if ( !midi_processor::process_file( data, extension, midi ) )
+        {
+            fprintf( stderr, "Cannot load %s\n", p_filename );
+            return 1;
+        }
+        tracks = midi.get_track_count();
+    }
+    double seconds = ( now() - start ) / runs;
+
+    printf( "%-24.24s %10u %12s %12.3f\n", name, tracks, "-", seconds * 1000.0 );
+    return 0;
+}
+
+int main( int argc, char ** argv )
+{
+    int result = 0;
+
+    printf( "%-24s %10s %12s %12s\n", "track", "events", "add_event ms", "append ms" );
+
+    if ( argc < 2 )
+    {
+        bench_synthetic( 1000 );
+        bench_synthetic( 10000 );
+        bench_synthetic( 100000 );
+    }
+    for ( int i = 1; i < argc; i++ )
+        result |= bench_file( argv[ i ] );
+
+    return result;
+}
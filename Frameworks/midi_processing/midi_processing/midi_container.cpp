@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <functional>
 
 midi_event::midi_event( const midi_event & p_in )
 {
@@ -53,13 +54,82 @@ void midi_event::copy_data( uint8_t * p_out, unsigned long p_offset, unsigned lo
     if ( p_count ) memcpy( p_out, &m_ext_data[0], p_count );
 }
 
+static bool is_end_of_track( const midi_event & p_event )
+{
+    return p_event.m_type == midi_event::extended && p_event.get_data_count() >= 2 &&
+        p_event.m_data[ 0 ] == 0xFF && p_event.m_data[ 1 ] == 0x2F;
+}
+
 midi_track::midi_track(const midi_track & p_in)
 {
     m_events = p_in.m_events;
+    m_appending = p_in.m_appending;
+    m_end_of_track = p_in.m_end_of_track;
+    m_timestamp_last = p_in.m_timestamp_last;
+}
+
+void midi_track::append_event( const midi_event & p_event )
+{
+    if ( !m_appending )
+    {
+        m_appending = true;
+        m_end_of_track = ~0UL;
+        m_timestamp_last = 0;
+        if ( m_events.size() )
+        {
+            const midi_event & event = m_events.back();
+            if ( is_end_of_track( event ) ) m_end_of_track = m_events.size() - 1;
+            m_timestamp_last = event.m_timestamp;
+        }
+    }
+
+    /*
+     * Mirror add_event(): an end of track event which sorts last stays last,
+     * and is pushed back to the time of every event added after it.
+     */
+    if ( m_end_of_track != ~0UL )
+    {
+        midi_event & event = m_events[ m_end_of_track ];
+        if ( event.m_timestamp < p_event.m_timestamp )
+            event.m_timestamp = p_event.m_timestamp;
+    }
+    else if ( p_event.m_timestamp >= m_timestamp_last )
+    {
+        if ( is_end_of_track( p_event ) ) m_end_of_track = m_events.size();
+        m_timestamp_last = p_event.m_timestamp;
+    }
+
+    m_events.push_back( p_event );
+}
+
+static bool compare_event_timestamp( const midi_event & p_a, const midi_event & p_b )
+{
+    return p_a.m_timestamp < p_b.m_timestamp;
+}
+
+void midi_track::finalize()
+{
+    if ( !m_appending ) return;
+
+    m_appending = false;
+
+    if ( m_end_of_track != ~0UL )
+    {
+        midi_event end_of_track = m_events[ m_end_of_track ];
+        m_events.erase( m_events.begin() + m_end_of_track );
+        std::stable_sort( m_events.begin(), m_events.end(), compare_event_timestamp );
+        m_events.push_back( end_of_track );
+    }
+    else
+    {
+        std::stable_sort( m_events.begin(), m_events.end(), compare_event_timestamp );
+    }
 }
 
 void midi_track::add_event( const midi_event & p_event )
 {
+    finalize();
+
     auto it = m_events.end();
 
     if ( m_events.size() )
@@ -102,6 +172,7 @@ midi_event & midi_track::operator [] ( std::size_t p_index )
 
 void midi_track::remove_event( unsigned long index )
 {
+    finalize();
     m_events.erase( m_events.begin() + index );
 }
 
@@ -361,9 +432,12 @@ void midi_container::add_track( const midi_track & p_track )
 
     m_tracks.push_back( p_track );
 
-    for ( i = 0; i < p_track.get_count(); ++i )
+    midi_track & track = m_tracks.back();
+    track.finalize();
+
+    for ( i = 0; i < track.get_count(); ++i )
     {
-        const midi_event & event = p_track[ i ];
+        const midi_event & event = track[ i ];
         if ( event.m_type == midi_event::extended && event.get_data_count() >= 5 &&
             event.m_data[ 0 ] == 0xFF && event.m_data[ 1 ] == 0x51 )
         {
@@ -424,12 +498,12 @@ void midi_container::add_track( const midi_track & p_track )
         }
     }
 
-    if ( i && m_form != 2 && p_track[ i - 1 ].m_timestamp > m_timestamp_end[ 0 ] )
-        m_timestamp_end[ 0 ] = p_track[ i - 1 ].m_timestamp;
+    if ( i && m_form != 2 && track[ i - 1 ].m_timestamp > m_timestamp_end[ 0 ] )
+        m_timestamp_end[ 0 ] = track[ i - 1 ].m_timestamp;
     else if ( m_form == 2 )
     {
         if ( i )
-            m_timestamp_end.push_back( p_track[ i - 1 ].m_timestamp );
+            m_timestamp_end.push_back( track[ i - 1 ].m_timestamp );
         else
             m_timestamp_end.push_back( (unsigned)0 );
     }
@@ -594,21 +668,36 @@ void midi_container::serialize_as_stream( unsigned long subsong,
         }
     }
 
-    for (;;)
+    /*
+     * Merge the tracks through a min-heap keyed on ( timestamp, track index ),
+     * so events with equal timestamps are taken from the lowest track first.
+     */
+    std::vector< std::pair<unsigned long, std::size_t> > track_heap;
+    std::greater< std::pair<unsigned long, std::size_t> > track_heap_compare;
+    std::size_t event_count = 0;
+
+    track_heap.reserve( track_count );
+
+    for ( unsigned i = 0; i < track_count; ++i )
     {
-        unsigned long next_timestamp = ~0UL;
-        std::size_t next_track = 0;
-        for ( unsigned i = 0; i < track_count; ++i )
-        {
-            if ( track_positions[ i ] >= m_tracks[ i ].get_count() ) continue;
-            if ( m_tracks[ i ][ track_positions[ i ] ].m_timestamp < next_timestamp )
-            {
-                next_timestamp = m_tracks[ i ][ track_positions[ i ] ].m_timestamp;
-                next_track = i;
-            }
-        }
+        if ( track_positions[ i ] >= m_tracks[ i ].get_count() ) continue;
+        event_count += m_tracks[ i ].get_count() - track_positions[ i ];
+        track_heap.push_back( std::make_pair( m_tracks[ i ][ track_positions[ i ] ].m_timestamp, (std::size_t) i ) );
+    }
+
+    std::make_heap( track_heap.begin(), track_heap.end(), track_heap_compare );
+
+    p_stream.reserve( p_stream.size() + event_count );
+
+    while ( track_heap.size() )
+    {
+        unsigned long next_timestamp = track_heap.front().first;
+        std::size_t next_track = track_heap.front().second;
         if ( next_timestamp == ~0UL ) break;
 
+        std::pop_heap( track_heap.begin(), track_heap.end(), track_heap_compare );
+        track_heap.pop_back();
+
         bool filtered = false;
 
         if ( clean_instruments || clean_banks )
@@ -716,7 +805,11 @@ void midi_container::serialize_as_stream( unsigned long subsong,
             }
         }
 
-        track_positions[ next_track ]++;
+        if ( ++track_positions[ next_track ] < m_tracks[ next_track ].get_count() )
+        {
+            track_heap.push_back( std::make_pair( m_tracks[ next_track ][ track_positions[ next_track ] ].m_timestamp, next_track ) );
+            std::push_heap( track_heap.begin(), track_heap.end(), track_heap_compare );
+        }
     }
 
     loop_start = local_loop_start;
@@ -50,11 +50,29 @@ class midi_track
 {
     std::vector<midi_event> m_events;
 
+    /*
+     * Batch construction state, see append_event()
+     */
+    bool m_appending;
+    std::size_t m_end_of_track;
+    unsigned long m_timestamp_last;
+
 public:
-    midi_track() { }
+    midi_track() : m_appending(false), m_end_of_track(0), m_timestamp_last(0) { }
     midi_track(const midi_track & p_in);
 
     void add_event( const midi_event & p_event );
+
+    /*
+     * Appends an event without keeping the track ordered, then finalize() sorts
+     * everything appended at once. The result is identical to calling add_event()
+     * for each event in the same order. The track must be finalized before its
+     * events are read; add_event(), remove_event() and midi_container::add_track()
+     * do so implicitly.
+     */
+    void append_event( const midi_event & p_event );
+    void finalize();
+
     std::size_t get_count() const;
     const midi_event & operator [] ( std::size_t p_index ) const;
     midi_event & operator [] ( std::size_t p_index );
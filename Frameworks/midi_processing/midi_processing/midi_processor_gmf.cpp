@@ -24,7 +24,7 @@ bool midi_processor::process_gmf( std::vector<uint8_t> const& p_file, midi_conta
     buffer[3] = tempo_scaled >> 8;
     buffer[4] = tempo_scaled;
 
-    track.add_event( midi_event( 0, midi_event::extended, 0, buffer, 5 ) );
+    track.append_event( midi_event( 0, midi_event::extended, 0, buffer, 5 ) );
 
     buffer[0] = 0xF0;
     buffer[1] = 0x41;
@@ -37,12 +37,12 @@ bool midi_processor::process_gmf( std::vector<uint8_t> const& p_file, midi_conta
     buffer[8] = 0x01;
     buffer[9] = 0xF7;
 
-    track.add_event( midi_event( 0, midi_event::extended, 0, buffer, 10 ) );
+    track.append_event( midi_event( 0, midi_event::extended, 0, buffer, 10 ) );
 
     buffer[0] = 0xFF;
     buffer[1] = 0x2F;
 
-    track.add_event( midi_event( 0, midi_event::extended, 0, buffer, 2 ) );
+    track.append_event( midi_event( 0, midi_event::extended, 0, buffer, 2 ) );
 
     p_out.add_track( track );
 
@@ -163,7 +163,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
         if ( patch.midi_instrument != last_instrument[ chan ] )
         {
             buffer[ 0 ] = patch.midi_instrument;
-            track.add_event( midi_event( current_timestamp, midi_event::program_change, channel, buffer, 1 ) );
+            track.append_event( midi_event( current_timestamp, midi_event::program_change, channel, buffer, 1 ) );
             last_instrument[ chan ] = patch.midi_instrument;
         }
     }
@@ -189,7 +189,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
     {
         buffer[ 0 ] = 7;
         buffer[ 1 ] = volume;
-        track.add_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ chan ], buffer, 2 ) );
+        track.append_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ chan ], buffer, 2 ) );
         last_sent_volume[ channel ] = volume;
     }
 
@@ -197,7 +197,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
     {
         buffer[ 0 ] = saved_last_note;
         buffer[ 1 ] = 127;
-        track.add_event( midi_event( current_timestamp, midi_event::note_off, last_channel[ chan ], buffer, 2 ) );
+        track.append_event( midi_event( current_timestamp, midi_event::note_off, last_channel[ chan ], buffer, 2 ) );
         last_note[ chan ] = 0xFF;
 #ifdef ENABLE_WHEEL
         if ( channel != 9 )
@@ -208,7 +208,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
             {
                 buffer[ 0 ] = 0;
                 buffer[ 1 ] = 64;
-                track.add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                track.append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                 last_pitch_wheel[ channel ] = 0;
             }
         }
@@ -219,7 +219,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
     {
         buffer[ 0 ] = WHEEL_SCALE_LOW( c->lasttune );
         buffer[ 1 ] = WHEEL_SCALE_HIGH( c->lasttune );
-        track.add_event( midi_event( current_timestamp, midi_event::pitch_wheel, channel, buffer, 2 ) );
+        track.append_event( midi_event( current_timestamp, midi_event::pitch_wheel, channel, buffer, 2 ) );
         last_pitch_wheel[ channel ] = c->lasttune;
     }
     if( !patch.glide || last_note[ chan ] == 0xFF )
@@ -231,7 +231,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
         {
             buffer[ 0 ] = note >> 4;
             buffer[ 1 ] = patch.midi_velocity;
-            track.add_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
+            track.append_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
             last_note[ chan ] = note >> 4;
             last_channel[ chan ] = channel;
 #ifdef ENABLE_WHEEL
@@ -245,7 +245,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
             c->portspeed = patch.portamento;
             buffer[ 0 ] = last_note[ chan ] = saved_last_note;
             buffer[ 1 ] = patch.midi_velocity;
-            track.add_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
+            track.append_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
         }
 #endif
     }
@@ -254,7 +254,7 @@ void playsound( uint8_t current_instrument[], std::vector<sound_patch> const& pa
     {
         buffer[ 0 ] = note >> 4;
         buffer[ 1 ] = patch.midi_velocity;
-        track.add_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
+        track.append_event( midi_event( current_timestamp, midi_event::note_on, channel, buffer, 2 ) );
         last_note[ chan ] = note >> 4;
         last_channel[ chan ] = channel;
         c->gototune = patch.glide;
@@ -471,38 +471,38 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
 
     {
         midi_track track;
-        track.add_event( midi_event( 0, midi_event::extended, 0, lds_default_tempo, _countof( lds_default_tempo ) ) );
+        track.append_event( midi_event( 0, midi_event::extended, 0, lds_default_tempo, _countof( lds_default_tempo ) ) );
         for ( unsigned i = 0; i < 11; ++i )
         {
             buffer[ 0 ] = 120;
             buffer[ 1 ] = 0;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
             buffer[ 0 ] = 121;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
 #ifdef ENABLE_WHEEL
             buffer[ 0 ] = 0x65;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
             buffer[ 0 ] = 0x64;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
             buffer[ 0 ] = 0x06;
             buffer[ 1 ] = WHEEL_RANGE_HIGH;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
             buffer[ 0 ] = 0x26;
             buffer[ 1 ] = WHEEL_RANGE_LOW;
-            track.add_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::control_change, i, buffer, 2 ) );
             buffer[ 0 ] = 0;
             buffer[ 1 ] = 64;
-            track.add_event( midi_event( 0, midi_event::pitch_wheel, i, buffer, 2 ) );
+            track.append_event( midi_event( 0, midi_event::pitch_wheel, i, buffer, 2 ) );
 #endif
         }
-        track.add_event( midi_event( 0, midi_event::extended, 0, end_of_track, _countof( end_of_track ) ) );
+        track.append_event( midi_event( 0, midi_event::extended, 0, end_of_track, _countof( end_of_track ) ) );
         p_out.add_track( track );
     }
 
     std::vector<midi_track> tracks;
     {
         midi_track track;
-        track.add_event( midi_event( 0, midi_event::extended, 0, end_of_track, _countof( end_of_track ) ) );
+        track.append_event( midi_event( 0, midi_event::extended, 0, end_of_track, _countof( end_of_track ) ) );
         tracks.resize( 10, track );
     }
 
@@ -629,7 +629,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                                     {
                                         buffer[ 0 ] = 7;
                                         buffer[ 1 ] = volume;
-                                        tracks[ _chan ].add_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ _chan ], buffer, 2 ) );
+                                        tracks[ _chan ].append_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ _chan ], buffer, 2 ) );
                                         last_sent_volume[ last_channel [ _chan ] ] = volume;
                                     }
                                 }
@@ -700,11 +700,11 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                             case 0xf1:
                                 buffer[ 0 ] = 10;
                                 buffer[ 1 ] = ( comlo & 0x3F ) * 127 / 63;
-                                tracks[ _chan ].add_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ _chan ], buffer, 2 ) );
+                                tracks[ _chan ].append_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ _chan ], buffer, 2 ) );
                                 break;
                             case 0xf0:
                                 buffer[ 0 ] = comlo & 0x7F;
-                                tracks[ _chan ].add_event( midi_event( current_timestamp, midi_event::program_change, last_channel[ _chan ], buffer, 1 ) );
+                                tracks[ _chan ].append_event( midi_event( current_timestamp, midi_event::program_change, last_channel[ _chan ], buffer, 1 ) );
                                 break;
                             default:
 #ifdef ENABLE_WHEEL
@@ -804,14 +804,14 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                 {
                     buffer[ 0 ] = last_note[ chan ];
                     buffer[ 1 ] = 127;
-                    tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::note_off, last_channel[ chan ], buffer, 2 ) );
+                    tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::note_off, last_channel[ chan ], buffer, 2 ) );
                     last_note[ chan ] = 0xFF;
 #ifdef ENABLE_WHEEL
                     if ( 0 != last_pitch_wheel[ last_channel[ chan ] ] )
                     {
                         buffer[ 0 ] = 0;
                         buffer[ 1 ] = 64;
-                        tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                        tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                         last_pitch_wheel[ last_channel[ chan ] ] = 0;
                         c->lasttune = 0;
                         c->gototune = 0;
@@ -887,7 +887,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                 {
                     buffer[ 0 ] = WHEEL_SCALE_LOW( arpreg );
                     buffer[ 1 ] = WHEEL_SCALE_HIGH( arpreg );
-                    tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                    tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                     last_pitch_wheel[ last_channel[ chan ] ] = arpreg;
                 }
             } else
@@ -913,7 +913,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                         {
                             buffer[ 0 ] = WHEEL_SCALE_LOW( tune );
                             buffer[ 1 ] = WHEEL_SCALE_HIGH( tune );
-                            tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                            tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                             last_pitch_wheel[ last_channel[ chan ] ] = tune;
                         }
 
@@ -928,7 +928,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                         {
                             buffer[ 0 ] = WHEEL_SCALE_LOW( tune );
                             buffer[ 1 ] = WHEEL_SCALE_HIGH( tune );
-                            tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                            tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                             last_pitch_wheel[ last_channel[ chan ] ] = tune;
                         }
                     }
@@ -952,7 +952,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
                         {
                             buffer[ 0 ] = WHEEL_SCALE_LOW( tune );
                             buffer[ 1 ] = WHEEL_SCALE_HIGH( tune );
-                            tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
+                            tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::pitch_wheel, last_channel[ chan ], buffer, 2 ) );
                             last_pitch_wheel[ last_channel[ chan ] ] = tune;
                         }
                     }
@@ -1009,7 +1009,7 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
             {
                 buffer[ 0 ] = 7;
                 buffer[ 1 ] = volume;
-                tracks[ chan ].add_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ chan ], buffer, 2 ) );
+                tracks[ chan ].append_event( midi_event( current_timestamp, midi_event::control_change, last_channel[ chan ], buffer, 2 ) );
                 last_sent_volume[ last_channel[ chan ] ] = volume;
             }
 #endif
@@ -1031,13 +1031,13 @@ bool midi_processor::process_lds( std::vector<uint8_t> const& p_file, midi_conta
             {
                 buffer[ 0 ] = last_note[ i ];
                 buffer[ 1 ] = 127;
-                track.add_event( midi_event( current_timestamp + channel[ i ].keycount, midi_event::note_off, last_channel[ i ], buffer, 2 ) );
+                track.append_event( midi_event( current_timestamp + channel[ i ].keycount, midi_event::note_off, last_channel[ i ], buffer, 2 ) );
 #ifdef ENABLE_WHEEL
                 if ( last_pitch_wheel[ last_channel[ i ] ] != 0 )
                 {
                     buffer[ 0 ] = 0;
                     buffer[ 1 ] = 0x40;
-                    track.add_event( midi_event( current_timestamp + channel[ i ].keycount, midi_event::pitch_wheel, last_channel[ i ], buffer, 2 ) );
+                    track.append_event( midi_event( current_timestamp + channel[ i ].keycount, midi_event::pitch_wheel, last_channel[ i ], buffer, 2 ) );
                 }
 #endif
             }
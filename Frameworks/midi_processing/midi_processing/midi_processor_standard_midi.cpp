@@ -74,7 +74,7 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
         {
             if ( last_sysex_length )
             {
-                track.add_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
+                track.append_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
                 last_sysex_length = 0;
             }
 
@@ -102,13 +102,13 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
                 ++data_bytes_read;
             }
             if ( !command_valid ) break;
-            track.add_event( midi_event( last_event_timestamp = current_timestamp, (midi_event::event_type)(( event_code >> 4 ) - 8), event_code & 0x0F, &buffer[0], data_bytes_read ) );
+            track.append_event( midi_event( last_event_timestamp = current_timestamp, (midi_event::event_type)(( event_code >> 4 ) - 8), event_code & 0x0F, &buffer[0], data_bytes_read ) );
         }
         else if ( event_code == 0xF0 )
         {
             if ( last_sysex_length )
             {
-                track.add_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
+                track.append_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
                 last_sysex_length = 0;
             }
 
@@ -139,7 +139,7 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
         {
             if ( last_sysex_length )
             {
-                track.add_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
+                track.append_event( midi_event( last_event_timestamp = last_sysex_timestamp, midi_event::extended, 0, &buffer[0], last_sysex_length ) );
                 last_sysex_length = 0;
             }
 
@@ -158,7 +158,7 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
                 current_timestamp = last_event_timestamp;
             else
                 last_event_timestamp = current_timestamp;
-            track.add_event( midi_event( current_timestamp, midi_event::extended, 0, &buffer[0], data_count + 2 ) );
+            track.append_event( midi_event( current_timestamp, midi_event::extended, 0, &buffer[0], data_count + 2 ) );
 
             if ( meta_type == 0x2F )
             {
@@ -170,7 +170,7 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
         {
             /* Sequencer specific events, single byte */
             buffer[ 0 ] = event_code;
-            track.add_event( midi_event( last_event_timestamp = current_timestamp, midi_event::extended, 0, &buffer[0], 1 ) );
+            track.append_event( midi_event( last_event_timestamp = current_timestamp, midi_event::extended, 0, &buffer[0], 1 ) );
         }
         else break; /*throw exception_io_data("Unhandled MIDI status code");*/
     }
@@ -179,7 +179,7 @@ void midi_processor::process_standard_midi_track( std::vector<uint8_t>::const_it
     {
         buffer[ 0 ] = 0xFF;
         buffer[ 1 ] = 0x2F;
-        track.add_event( midi_event( last_event_timestamp, midi_event::extended, 0, &buffer[0], 2 ) );
+        track.append_event( midi_event( last_event_timestamp, midi_event::extended, 0, &buffer[0], 2 ) );
     }
 
     p_out.add_track( track );
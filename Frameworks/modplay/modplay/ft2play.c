@@ -56,7 +56,7 @@
 #include <math.h>
 #include <assert.h>
 #include <limits.h>
-#include "resampler.h"
+#include <Resampler/resampler.h>
 #include "barray.h"
 #include "ft2play.h"
 
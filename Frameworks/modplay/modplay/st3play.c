@@ -77,7 +77,7 @@
 #endif
 
 #include "dbopl.h"
-#include "resampler.h"
+#include <Resampler/resampler.h>
 #include "st3play.h"
 
 #define USE_VOL_RAMP
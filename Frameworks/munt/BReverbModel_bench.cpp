@@ -0,0 +1,109 @@
+// Time of BReverbModel::process for each reverb mode of the MT-32 and CM-32L
+// models, fed with bursts of noise standing in for LA32 output, with a hash
+// of the rendered output. Not part of the project, build it by hand from
+// this directory:
+//
+// c++ -O2 -Imunt/mt32emu/src -o BReverbModel_bench BReverbModel_bench.cpp
+//     munt/mt32emu/src/BReverbModel.cpp
+//
+// ./BReverbModel_bench
+//
+// To time the model from before it processed filters in blocks, build a
+// second binary against the earlier sources; the hashes of both runs must
+// match:
+//
+// mkdir -p /tmp/breverb_old
+// git show f2e225b~1:Frameworks/munt/munt/mt32emu/src/BReverbModel.cpp > /tmp/breverb_old/BReverbModel.cpp
+// git show f2e225b~1:Frameworks/munt/munt/mt32emu/src/BReverbModel.h > /tmp/breverb_old/BReverbModel.h
+// c++ -O2 -I/tmp/breverb_old -Imunt/mt32emu/src -o BReverbModel_bench_old
+//     BReverbModel_bench.cpp /tmp/breverb_old/BReverbModel.cpp
+//
+// Integer samples are timed by setting MT32EMU_USE_FLOAT_SAMPLES to 0 in
+// mt32emu.h, and the precise integer mode by also setting
+// MT32EMU_BOSS_REVERB_PRECISE_MODE to 1 in internals.h.
+
+#include <stdio.h>
+#include <time.h>
+
+#include <vector>
+
+#include "mt32emu.h"
+#include "BReverbModel.h"
+
+using namespace MT32Emu;
+
+// Samples per process call, what Synth hands the reverb at most
+static const Bit32u samples_per_call = 512;
+static const Bit32u seconds = 60;
+
+static Bit32u seed = 1;
+
+static float noise() {
+	seed = seed * 1664525 + 1013904223;
+	return float(Bit32s(seed)) / 2147483648.0f;
+}
+
+// Notes of a quarter to half a second with a decaying envelope, separated by gaps of silence long enough for the reverb
+// to go inactive every few seconds
+static void make_input(std::vector<Sample> &left, std::vector<Sample> &right) {
+	Bit32u position = 0;
+	while (position < left.size()) {
+		const Bit32u length = Bit32u(SAMPLE_RATE / 4 + (noise() + 1.0f) * SAMPLE_RATE / 8);
+		const Bit32u gap = (noise() > 0.6f) ? SAMPLE_RATE * 3 : SAMPLE_RATE / 10;
+		for (Bit32u i = 0; i < length && position < left.size(); i++, position++) {
+			const float envelope = 0.5f * (1.0f - float(i) / length);
+#if MT32EMU_USE_FLOAT_SAMPLES
+			left[position] = noise() * envelope;
+			right[position] = noise() * envelope;
+#else
+			left[position] = Sample(noise() * envelope * 32767.0f);
+			right[position] = Sample(noise() * envelope * 32767.0f);
+#endif
+		}
+		for (Bit32u i = 0; i < gap && position < left.size(); i++, position++) {
+			left[position] = 0;
+			right[position] = 0;
+		}
+	}
+}
+
+static Bit32u hash(Bit32u h, const std::vector<Sample> &samples) {
+	const unsigned char *bytes = (const unsigned char *)&samples[0];
+	for (size_t i = 0; i < samples.size() * sizeof(Sample); i++) {
+		h = (h ^ bytes[i]) * 16777619;
+	}
+	return h;
+}
+
+int main() {
+	const Bit32u sample_count = SAMPLE_RATE * seconds;
+	std::vector<Sample> inLeft(sample_count), inRight(sample_count), outLeft(sample_count), outRight(sample_count);
+	make_input(inLeft, inRight);
+
+	const char *mode_names[] = { "room", "hall", "plate", "tap delay" };
+
+	printf("%-7s %-10s %10s %10s\n", "model", "mode", "x RT", "hash");
+	double total = 0;
+	for (int compatible = 0; compatible < 2; compatible++) {
+		for (int mode = 0; mode < 4; mode++) {
+			BReverbModel model((ReverbMode)mode, compatible != 0);
+			model.open();
+			model.setParameters(5, 3);
+
+			const clock_t start = clock();
+			for (Bit32u done = 0; done < sample_count; done += samples_per_call) {
+				const Bit32u count = (sample_count - done < samples_per_call) ? sample_count - done : samples_per_call;
+				model.process(&inLeft[done], &inRight[done], &outLeft[done], &outRight[done], count);
+			}
+			const double elapsed = double(clock() - start) / CLOCKS_PER_SEC;
+			total += elapsed;
+
+			printf("%-7s %-10s %10.1f %10.8x\n", compatible ? "MT-32" : "CM-32L", mode_names[mode], seconds / elapsed,
+				hash(hash(2166136261u, outLeft), outRight));
+			model.close();
+		}
+	}
+	printf("total %.3f s\n", total);
+
+	return 0;
+}
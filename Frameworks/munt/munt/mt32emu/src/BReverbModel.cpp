@@ -34,6 +34,9 @@ static const Bit32u PROCESS_DELAY = 1;
 static const Bit32u MODE_3_ADDITIONAL_DELAY = 1;
 static const Bit32u MODE_3_FEEDBACK_DELAY = 1;
 
+// Number of samples each filter stage processes at once. Must not exceed the size of the comb filters which have output taps.
+static const Bit32u PROCESS_BLOCK_SIZE = 256;
+
 // Default reverb settings for "new" reverb model implemented in CM-32L / LAPC-I.
 // Found by tracing reverb RAM data lines (thanks go to Lord_Nightmare & balrog).
 const BReverbSettings &BReverbModel::getCM32L_LAPCSettings(const ReverbMode mode) {
@@ -193,6 +196,24 @@ static Sample weirdMul(Sample a, Bit8u addMask, Bit8u carryMask) {
 #endif
 }
 
+static void mixCombOutputs(const Sample *out1, const Sample *out2, const Sample *out3, Sample *out, const Bit32u count, const Bit32u wetLevel) {
+	for (Bit32u i = 0; i < count; i++) {
+#if MT32EMU_USE_FLOAT_SAMPLES
+		Sample outSample = 1.5f * (out1[i] + out2[i]) + out3[i];
+#elif MT32EMU_BOSS_REVERB_PRECISE_MODE
+		/* NOTE:
+		 *   Thanks to Mok for discovering, the adder in BOSS reverb chip is found to perform addition with saturation to avoid integer overflow.
+		 *   Analysing of the algorithm suggests that the overflow is most probable when the combs output is added below.
+		 *   So, despite this isn't actually accurate, we only add the check here for performance reasons.
+		 */
+		Sample outSample = Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx((SampleEx)out1[i] + SampleEx(out1[i] >> 1)) + (SampleEx)out2[i]) + SampleEx(out2[i] >> 1)) + (SampleEx)out3[i]);
+#else
+		Sample outSample = Synth::clipSampleEx((SampleEx)out1[i] + SampleEx(out1[i] >> 1) + (SampleEx)out2[i] + SampleEx(out2[i] >> 1) + (SampleEx)out3[i]);
+#endif
+		out[i] = weirdMul(outSample, wetLevel, 0xFF);
+	}
+}
+
 RingBuffer::RingBuffer(Bit32u newsize) : size(newsize), index(0) {
 	buffer = new Sample[size];
 }
@@ -202,11 +223,30 @@ RingBuffer::~RingBuffer() {
 	buffer = NULL;
 }
 
-Sample RingBuffer::next() {
-	if (++index >= size) {
-		index = 0;
+// Returns the position where the next sample goes, run is set to the number of the following samples stored contiguously
+Bit32u RingBuffer::nextRun(const Bit32u count, Bit32u &run) const {
+	Bit32u position = index + 1;
+	if (position >= size) {
+		position = 0;
+	}
+	run = size - position;
+	if (run > count) {
+		run = count;
+	}
+	return position;
+}
+
+void RingBuffer::copyFrom(Bit32u position, Sample *out, Bit32u count) const {
+	while (count > 0) {
+		Bit32u run = size - position;
+		if (run > count) {
+			run = count;
+		}
+		memcpy(out, buffer + position, run * sizeof(Sample));
+		out += run;
+		count -= run;
+		position = 0;
 	}
-	return buffer[index];
 }
 
 bool RingBuffer::isEmpty() const {
@@ -229,46 +269,80 @@ void RingBuffer::mute() {
 	Synth::muteSampleBuffer(buffer, size);
 }
 
+void RingBuffer::readDelayedHead(const Bit32u delay, Sample *out, const Bit32u count) const {
+	// The sample output delay steps before the next one is the oldest in the buffer when delay == size
+	copyFrom((index + 1 + size - delay) % size, out, delay < count ? delay : count);
+}
+
+void RingBuffer::readDelayedTail(const Bit32u delay, Sample *out, const Bit32u count) const {
+	if (delay >= count) return;
+	// The first sample of the block just processed
+	copyFrom((index + 1 + size - count) % size, out + delay, count - delay);
+}
+
 AllpassFilter::AllpassFilter(const Bit32u useSize) : RingBuffer(useSize) {}
 
-Sample AllpassFilter::process(const Sample in) {
+void AllpassFilter::process(const Sample *in, Sample *out, Bit32u count) {
 	// This model corresponds to the allpass filter implementation of the real CM-32L device
 	// found from sample analysis
 
-	const Sample bufferOut = next();
+	while (count > 0) {
+		Bit32u run;
+		Sample *buf = buffer + nextRun(count, run);
+
+		// Each sample only depends on the one stored size samples ago, so there is no dependency within a run
+		for (Bit32u i = 0; i < run; i++) {
+			const Sample bufferOut = buf[i];
 
 #if MT32EMU_USE_FLOAT_SAMPLES
-	// store input - feedback / 2
-	buffer[index] = in - 0.5f * bufferOut;
+			// store input - feedback / 2
+			const Sample stored = in[i] - 0.5f * bufferOut;
+			buf[i] = stored;
 
-	// return buffer output + feedforward / 2
-	return bufferOut + 0.5f * buffer[index];
+			// return buffer output + feedforward / 2
+			out[i] = bufferOut + 0.5f * stored;
 #else
-	// store input - feedback / 2
-	buffer[index] = in - (bufferOut >> 1);
+			// store input - feedback / 2
+			const Sample stored = in[i] - (bufferOut >> 1);
+			buf[i] = stored;
 
-	// return buffer output + feedforward / 2
-	return bufferOut + (buffer[index] >> 1);
+			// return buffer output + feedforward / 2
+			out[i] = bufferOut + (stored >> 1);
 #endif
+		}
+
+		index = Bit32u(buf - buffer) + run - 1;
+		in += run;
+		out += run;
+		count -= run;
+	}
 }
 
 CombFilter::CombFilter(const Bit32u useSize, const Bit32u useFilterFactor) : RingBuffer(useSize), filterFactor(useFilterFactor) {}
 
-void CombFilter::process(const Sample in) {
+void CombFilter::process(const Sample *in, Bit32u count) {
 	// This model corresponds to the comb filter implementation of the real CM-32L device
 
 	// the previously stored value
-	const Sample last = buffer[index];
+	Sample last = buffer[index];
 
-	// prepare input + feedback
-	const Sample filterIn = in + weirdMul(next(), feedbackFactor, 0xF0);
+	while (count > 0) {
+		Bit32u run;
+		Sample *buf = buffer + nextRun(count, run);
 
-	// store input + feedback processed by a low-pass filter
-	buffer[index] = weirdMul(last, filterFactor, 0xC0) - filterIn;
-}
+		for (Bit32u i = 0; i < run; i++) {
+			// prepare input + feedback
+			const Sample filterIn = in[i] + weirdMul(buf[i], feedbackFactor, 0xF0);
+
+			// store input + feedback processed by a low-pass filter
+			last = weirdMul(last, filterFactor, 0xC0) - filterIn;
+			buf[i] = last;
+		}
 
-Sample CombFilter::getOutputAt(const Bit32u outIndex) const {
-	return buffer[(size + index - outIndex) % size];
+		index = Bit32u(buf - buffer) + run - 1;
+		in += run;
+		count -= run;
+	}
 }
 
 void CombFilter::setFeedbackFactor(const Bit32u useFeedbackFactor) {
@@ -278,43 +352,76 @@ void CombFilter::setFeedbackFactor(const Bit32u useFeedbackFactor) {
 DelayWithLowPassFilter::DelayWithLowPassFilter(const Bit32u useSize, const Bit32u useFilterFactor, const Bit32u useAmp)
 	: CombFilter(useSize, useFilterFactor), amp(useAmp) {}
 
-void DelayWithLowPassFilter::process(const Sample in) {
+void DelayWithLowPassFilter::process(const Sample *in, Sample *out, Bit32u count) {
 	// the previously stored value
-	const Sample last = buffer[index];
+	Sample last = buffer[index];
+
+	while (count > 0) {
+		Bit32u run;
+		Sample *buf = buffer + nextRun(count, run);
 
-	// move to the next index
-	next();
+		for (Bit32u i = 0; i < run; i++) {
+			// low-pass filter process
+			const Sample lpfOut = weirdMul(last, filterFactor, 0xFF) + in[i];
 
-	// low-pass filter process
-	Sample lpfOut = weirdMul(last, filterFactor, 0xFF) + in;
+			// the oldest value leaves the delay line
+			out[i] = buf[i];
+
+			// store lpfOut multiplied by LPF amp factor
+			last = weirdMul(lpfOut, amp, 0xFF);
+			buf[i] = last;
+		}
 
-	// store lpfOut multiplied by LPF amp factor
-	buffer[index] = weirdMul(lpfOut, amp, 0xFF);
+		index = Bit32u(buf - buffer) + run - 1;
+		in += run;
+		out += run;
+		count -= run;
+	}
 }
 
 TapDelayCombFilter::TapDelayCombFilter(const Bit32u useSize, const Bit32u useFilterFactor) : CombFilter(useSize, useFilterFactor) {}
 
-void TapDelayCombFilter::process(const Sample in) {
+void TapDelayCombFilter::process(const Sample *in, Bit32u count) {
 	// the previously stored value
-	const Sample last = buffer[index];
-
-	// move to the next index
-	next();
+	Sample last = buffer[index];
 
-	// prepare input + feedback
 	// Actually, the size of the filter varies with the TIME parameter, the feedback sample is taken from the position just below the right output
-	const Sample filterIn = in + weirdMul(getOutputAt(outR + MODE_3_FEEDBACK_DELAY), feedbackFactor, 0xF0);
+	const Bit32u feedbackDelay = outR + MODE_3_FEEDBACK_DELAY;
+	Bit32u feedbackPosition = (index + 1 + size - feedbackDelay) % size;
+
+	while (count > 0) {
+		Bit32u run;
+		Sample *buf = buffer + nextRun(count, run);
+		if (run > size - feedbackPosition) {
+			run = size - feedbackPosition;
+		}
+		const Sample *feedback = buffer + feedbackPosition;
+
+		for (Bit32u i = 0; i < run; i++) {
+			// prepare input + feedback
+			const Sample filterIn = in[i] + weirdMul(feedback[i], feedbackFactor, 0xF0);
 
-	// store input + feedback processed by a low-pass filter
-	buffer[index] = weirdMul(last, filterFactor, 0xF0) - filterIn;
+			// store input + feedback processed by a low-pass filter
+			last = weirdMul(last, filterFactor, 0xF0) - filterIn;
+			buf[i] = last;
+		}
+
+		index = Bit32u(buf - buffer) + run - 1;
+		feedbackPosition += run;
+		if (feedbackPosition >= size) {
+			feedbackPosition = 0;
+		}
+		in += run;
+		count -= run;
+	}
 }
 
-Sample TapDelayCombFilter::getLeftOutput() const {
-	return getOutputAt(outL + PROCESS_DELAY + MODE_3_ADDITIONAL_DELAY);
+Bit32u TapDelayCombFilter::getLeftDelay() const {
+	return outL + PROCESS_DELAY + MODE_3_ADDITIONAL_DELAY;
 }
 
-Sample TapDelayCombFilter::getRightOutput() const {
-	return getOutputAt(outR + PROCESS_DELAY + MODE_3_ADDITIONAL_DELAY);
+Bit32u TapDelayCombFilter::getRightDelay() const {
+	return outR + PROCESS_DELAY + MODE_3_ADDITIONAL_DELAY;
 }
 
 void TapDelayCombFilter::setOutputPositions(const Bit32u useOutL, const Bit32u useOutR) {
@@ -437,91 +544,99 @@ void BReverbModel::process(const Sample *inLeft, const Sample *inRight, Sample *
 		return;
 	}
 
-	Sample dry;
+	while (numSamples > 0) {
+		Bit32u count = numSamples > PROCESS_BLOCK_SIZE ? PROCESS_BLOCK_SIZE : Bit32u(numSamples);
+		processBlock(inLeft, inRight, outLeft, outRight, count);
+		inLeft += count;
+		inRight += count;
+		if (outLeft != NULL) outLeft += count;
+		if (outRight != NULL) outRight += count;
+		numSamples -= count;
+	}
+}
 
-	while ((numSamples--) > 0) {
+void BReverbModel::processBlock(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, const Bit32u count) {
+	Sample link[PROCESS_BLOCK_SIZE];
+
+	for (Bit32u i = 0; i < count; i++) {
+		Sample dry;
 		if (tapDelayMode) {
 #if MT32EMU_USE_FLOAT_SAMPLES
-			dry = (*(inLeft++) * 0.5f) + (*(inRight++) * 0.5f);
+			dry = (inLeft[i] * 0.5f) + (inRight[i] * 0.5f);
 #else
-			dry = (*(inLeft++) >> 1) + (*(inRight++) >> 1);
+			dry = (inLeft[i] >> 1) + (inRight[i] >> 1);
 #endif
 		} else {
 #if MT32EMU_USE_FLOAT_SAMPLES
-			dry = (*(inLeft++) * 0.25f) + (*(inRight++) * 0.25f);
+			dry = (inLeft[i] * 0.25f) + (inRight[i] * 0.25f);
 #elif MT32EMU_BOSS_REVERB_PRECISE_MODE
-			dry = (*(inLeft++) >> 1) / 2 + (*(inRight++) >> 1) / 2;
+			dry = (inLeft[i] >> 1) / 2 + (inRight[i] >> 1) / 2;
 #else
-			dry = (*(inLeft++) >> 2) + (*(inRight++) >> 2);
+			dry = (inLeft[i] >> 2) + (inRight[i] >> 2);
 #endif
 		}
 
 		// Looks like dryAmp doesn't change in MT-32 but it does in CM-32L / LAPC-I
-		dry = weirdMul(dry, dryAmp, 0xFF);
+		link[i] = weirdMul(dry, dryAmp, 0xFF);
+	}
 
-		if (tapDelayMode) {
-			TapDelayCombFilter *comb = static_cast<TapDelayCombFilter *> (*combs);
-			comb->process(dry);
-			if (outLeft != NULL) {
-				*(outLeft++) = weirdMul(comb->getLeftOutput(), wetLevel, 0xFF);
+	if (tapDelayMode) {
+		TapDelayCombFilter *comb = static_cast<TapDelayCombFilter *> (*combs);
+		const Bit32u delayL = comb->getLeftDelay();
+		const Bit32u delayR = comb->getRightDelay();
+		if (outLeft != NULL) comb->readDelayedHead(delayL, outLeft, count);
+		if (outRight != NULL) comb->readDelayedHead(delayR, outRight, count);
+		comb->process(link, count);
+		if (outLeft != NULL) {
+			comb->readDelayedTail(delayL, outLeft, count);
+			for (Bit32u i = 0; i < count; i++) {
+				outLeft[i] = weirdMul(outLeft[i], wetLevel, 0xFF);
 			}
-			if (outRight != NULL) {
-				*(outRight++) = weirdMul(comb->getRightOutput(), wetLevel, 0xFF);
+		}
+		if (outRight != NULL) {
+			comb->readDelayedTail(delayR, outRight, count);
+			for (Bit32u i = 0; i < count; i++) {
+				outRight[i] = weirdMul(outRight[i], wetLevel, 0xFF);
 			}
-		} else {
-			// If the output position is equal to the comb size, get it now in order not to loose it
-			Sample link = combs[0]->getOutputAt(currentSettings.combSizes[0] - 1);
+		}
+		return;
+	}
 
-			// Entrance LPF. Note, comb.process() differs a bit here.
-			combs[0]->process(dry);
+	// Entrance LPF. Note, comb.process() differs a bit here.
+	static_cast<DelayWithLowPassFilter *> (combs[0])->process(link, link, count);
 
 #if !MT32EMU_USE_FLOAT_SAMPLES
-			// This introduces reverb noise which actually makes output from the real Boss chip nondeterministic
-			link = link - 1;
+	// This introduces reverb noise which actually makes output from the real Boss chip nondeterministic
+	for (Bit32u i = 0; i < count; i++) {
+		link[i] = link[i] - 1;
+	}
 #endif
-			link = allpasses[0]->process(link);
-			link = allpasses[1]->process(link);
-			link = allpasses[2]->process(link);
-
-			// If the output position is equal to the comb size, get it now in order not to loose it
-			Sample outL1 = combs[1]->getOutputAt(currentSettings.outLPositions[0] - 1);
 
-			combs[1]->process(link);
-			combs[2]->process(link);
-			combs[3]->process(link);
+	allpasses[0]->process(link, link, count);
+	allpasses[1]->process(link, link, count);
+	allpasses[2]->process(link, link, count);
+
+	// Comb outputs, in the order they are mixed for each channel
+	Sample outL[3][PROCESS_BLOCK_SIZE];
+	Sample outR[3][PROCESS_BLOCK_SIZE];
+	// Output positions are the delays of the taps, except that the first left one is taken before processing the current sample
+	const Bit32u *delayL = currentSettings.outLPositions;
+	const Bit32u *delayR = currentSettings.outRPositions;
+
+	for (Bit32u i = 0; i < 3; i++) {
+		CombFilter *comb = combs[i + 1];
+		if (outLeft != NULL) comb->readDelayedHead(delayL[i], outL[i], count);
+		if (outRight != NULL) comb->readDelayedHead(delayR[i], outR[i], count);
+		comb->process(link, count);
+		if (outLeft != NULL) comb->readDelayedTail(delayL[i], outL[i], count);
+		if (outRight != NULL) comb->readDelayedTail(delayR[i], outR[i], count);
+	}
 
-			if (outLeft != NULL) {
-				Sample outL2 = combs[2]->getOutputAt(currentSettings.outLPositions[1]);
-				Sample outL3 = combs[3]->getOutputAt(currentSettings.outLPositions[2]);
-#if MT32EMU_USE_FLOAT_SAMPLES
-				Sample outSample = 1.5f * (outL1 + outL2) + outL3;
-#elif MT32EMU_BOSS_REVERB_PRECISE_MODE
-				/* NOTE:
-				 *   Thanks to Mok for discovering, the adder in BOSS reverb chip is found to perform addition with saturation to avoid integer overflow.
-				 *   Analysing of the algorithm suggests that the overflow is most probable when the combs output is added below.
-				 *   So, despite this isn't actually accurate, we only add the check here for performance reasons.
-				 */
-				Sample outSample = Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx((SampleEx)outL1 + SampleEx(outL1 >> 1)) + (SampleEx)outL2) + SampleEx(outL2 >> 1)) + (SampleEx)outL3);
-#else
-				Sample outSample = Synth::clipSampleEx((SampleEx)outL1 + SampleEx(outL1 >> 1) + (SampleEx)outL2 + SampleEx(outL2 >> 1) + (SampleEx)outL3);
-#endif
-				*(outLeft++) = weirdMul(outSample, wetLevel, 0xFF);
-			}
-			if (outRight != NULL) {
-				Sample outR1 = combs[1]->getOutputAt(currentSettings.outRPositions[0]);
-				Sample outR2 = combs[2]->getOutputAt(currentSettings.outRPositions[1]);
-				Sample outR3 = combs[3]->getOutputAt(currentSettings.outRPositions[2]);
-#if MT32EMU_USE_FLOAT_SAMPLES
-				Sample outSample = 1.5f * (outR1 + outR2) + outR3;
-#elif MT32EMU_BOSS_REVERB_PRECISE_MODE
-				// See the note above for the left channel output.
-				Sample outSample = Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx(Synth::clipSampleEx((SampleEx)outR1 + SampleEx(outR1 >> 1)) + (SampleEx)outR2) + SampleEx(outR2 >> 1)) + (SampleEx)outR3);
-#else
-				Sample outSample = Synth::clipSampleEx((SampleEx)outR1 + SampleEx(outR1 >> 1) + (SampleEx)outR2 + SampleEx(outR2 >> 1) + (SampleEx)outR3);
-#endif
-				*(outRight++) = weirdMul(outSample, wetLevel, 0xFF);
-			}
-		}
+	if (outLeft != NULL) {
+		mixCombOutputs(outL[0], outL[1], outL[2], outLeft, count, wetLevel);
+	}
+	if (outRight != NULL) {
+		mixCombOutputs(outR[0], outR[1], outR[2], outRight, count, wetLevel);
 	}
 }
 
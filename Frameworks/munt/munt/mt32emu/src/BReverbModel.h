@@ -34,24 +34,36 @@ struct BReverbSettings {
 	const Bit32u lpfAmp;
 };
 
+// Filters process whole blocks of samples. Within a block, the samples are stored in the ring buffer in at most two
+// contiguous runs, so the inner loops neither wrap nor call virtual functions and compilers can vectorize the stages
+// which have no feedback from the previous sample.
 class RingBuffer {
 protected:
 	Sample *buffer;
 	const Bit32u size;
 	Bit32u index;
 
+	Bit32u nextRun(const Bit32u count, Bit32u &run) const;
+	void copyFrom(Bit32u position, Sample *out, Bit32u count) const;
+
 public:
 	RingBuffer(const Bit32u size);
 	virtual ~RingBuffer();
-	Sample next();
 	bool isEmpty() const;
 	void mute();
+	// Reading delayed output of a block is done in two steps, as the oldest samples are overwritten by the block itself.
+	// The delay must not exceed the size, and count must not exceed the size either.
+	// Before processing the block, stores the samples which were output before the block started.
+	void readDelayedHead(const Bit32u delay, Sample *out, const Bit32u count) const;
+	// After processing the block, stores the samples which were output by the block itself.
+	void readDelayedTail(const Bit32u delay, Sample *out, const Bit32u count) const;
 };
 
 class AllpassFilter : public RingBuffer {
 public:
 	AllpassFilter(const Bit32u size);
-	Sample process(const Sample in);
+	// out may be the same as in
+	void process(const Sample *in, Sample *out, Bit32u count);
 };
 
 class CombFilter : public RingBuffer {
@@ -61,8 +73,7 @@ protected:
 
 public:
 	CombFilter(const Bit32u size, const Bit32u useFilterFactor);
-	virtual void process(const Sample in);
-	Sample getOutputAt(const Bit32u outIndex) const;
+	void process(const Sample *in, Bit32u count);
 	void setFeedbackFactor(const Bit32u useFeedbackFactor);
 };
 
@@ -71,7 +82,8 @@ class DelayWithLowPassFilter : public CombFilter {
 
 public:
 	DelayWithLowPassFilter(const Bit32u useSize, const Bit32u useFilterFactor, const Bit32u useAmp);
-	void process(const Sample in);
+	// Stores the samples leaving the delay line to out, which may be the same as in
+	void process(const Sample *in, Sample *out, Bit32u count);
 	void setFeedbackFactor(const Bit32u) {}
 };
 
@@ -81,9 +93,9 @@ class TapDelayCombFilter : public CombFilter {
 
 public:
 	TapDelayCombFilter(const Bit32u useSize, const Bit32u useFilterFactor);
-	void process(const Sample in);
-	Sample getLeftOutput() const;
-	Sample getRightOutput() const;
+	void process(const Sample *in, Bit32u count);
+	Bit32u getLeftDelay() const;
+	Bit32u getRightDelay() const;
 	void setOutputPositions(const Bit32u useOutL, const Bit32u useOutR);
 };
 
@@ -99,6 +111,8 @@ class BReverbModel {
 	static const BReverbSettings &getCM32L_LAPCSettings(const ReverbMode mode);
 	static const BReverbSettings &getMT32Settings(const ReverbMode mode);
 
+	void processBlock(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, const Bit32u count);
+
 public:
 	BReverbModel(const ReverbMode mode, const bool mt32CompatibleModel = false);
 	~BReverbModel();
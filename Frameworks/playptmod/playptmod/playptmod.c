@@ -80,7 +80,7 @@
 #define _USE_MATH_DEFINES /* visual studio */
 
 #include "playptmod.h"
-#include "resampler.h"
+#include <Resampler/resampler.h>
 
 #include <stdio.h>
 #include <string.h> /* memcpy() */
@@ -0,0 +1,250 @@
+/* Probe latency of init_vgmstream over a set of files, with the count of reads each open does on the file
+ * and of filename lookups (about one per init function that runs, as most check the extension first),
+ * for each pass over the same files. Also checks every pass finds the same format and sample count.
+ * The probe index in base/probe_index.c learns during the first pass: the first file of each kind (same
+ * extension, subsong and header bytes) runs the whole init table, and later ones skip the functions it
+ * rejected. For the synthetic corpus, a table per kind compares that first file with the rest of the
+ * kind on the first pass. Not part of the project, build it by hand:
+ *
+ * cc -O2 -std=gnu99 -w -DBUILD_VGMSTREAM -Ivgmstream/src -Ivgmstream/ext_includes -o probe_bench
+ *    probe_bench.c $(find vgmstream/src -name '*.c') -lm -lpthread
+ *
+ * ./probe_bench [-p passes] [file ...]
+ *
+ * Without files it writes a small corpus to a temp dir: RIFF WAVs and SShd/SSbd ADSs, accepted early in
+ * the table, raw .int PCM, accepted near its end, and junk with known and unknown extensions. Junk goes
+ * through the whole table on every pass, since skipped functions are retried when nothing accepts a file.
+ * Real rips are better; with files, the first pass also pays for the OS cache.
+ */
+
+#include "vgmstream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FILES_PER_KIND  50
+
+static const char* kinds[] = { "wav", "ads", "int", "junk.wav", "junk.bin", "junk.xyz" };
+#define KIND_COUNT  (sizeof(kinds) / sizeof(kinds[0]))
+
+typedef struct {
+    STREAMFILE vt;
+    STREAMFILE* inner_sf;
+    long reads;
+    long names;
+} count_streamfile_t;
+
+static size_t count_read(count_streamfile_t* sf, uint8_t* dst, offv_t offset, size_t length) {
+    sf->reads++;
+    return sf->inner_sf->read(sf->inner_sf, dst, offset, length);
+}
+static size_t count_get_size(count_streamfile_t* sf) {
+    return sf->inner_sf->get_size(sf->inner_sf);
+}
+static offv_t count_get_offset(count_streamfile_t* sf) {
+    return sf->inner_sf->get_offset(sf->inner_sf);
+}
+static void count_get_name(count_streamfile_t* sf, char* name, size_t name_size) {
+    sf->names++;
+    sf->inner_sf->get_name(sf->inner_sf, name, name_size);
+}
+static STREAMFILE* count_open(count_streamfile_t* sf, const char* const filename, size_t buf_size) {
+    return sf->inner_sf->open(sf->inner_sf, filename, buf_size);
+}
+static void count_close(count_streamfile_t* sf) {
+    /* lives in the caller's stack */
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    int meta_type;          /* -1 if not recognized */
+    int num_samples;
+    double time;            /* on the first pass */
+    long lookups;
+} result_t;
+
+/* opens the file like init_vgmstream, returns the time taken in seconds */
+static double probe(const char* filename, result_t* result, long* reads, long* lookups) {
+    count_streamfile_t sf = {0};
+    VGMSTREAM* vgmstream;
+    double start, elapsed;
+
+    sf.inner_sf = open_stdio_streamfile(filename);
+    if (!sf.inner_sf) {
+        result->meta_type = -1;
+        result->num_samples = 0;
+        return 0;
+    }
+    sf.vt.read = (void*)count_read;
+    sf.vt.get_size = (void*)count_get_size;
+    sf.vt.get_offset = (void*)count_get_offset;
+    sf.vt.get_name = (void*)count_get_name;
+    sf.vt.open = (void*)count_open;
+    sf.vt.close = (void*)count_close;
+
+    start = now();
+    vgmstream = init_vgmstream_from_STREAMFILE(&sf.vt);
+    elapsed = now() - start;
+
+    result->meta_type = vgmstream ? (int)vgmstream->meta_type : -1;
+    result->num_samples = vgmstream ? vgmstream->num_samples : 0;
+    *reads += sf.reads;
+    *lookups += sf.names;
+
+    close_vgmstream(vgmstream);
+    close_streamfile(sf.inner_sf);
+    return elapsed;
+}
+
+static int write_file(const char* filename, const uint8_t* data, size_t size) {
+    FILE* f = fopen(filename, "wb");
+    if (!f)
+        return 0;
+    fwrite(data, 1, size, f);
+    fclose(f);
+    return 1;
+}
+
+/* writes the synthetic corpus, returns the number of files */
+static int make_corpus(const char* dir, char*** p_names) {
+    char** names = malloc(sizeof(char*) * KIND_COUNT * FILES_PER_KIND);
+    uint8_t buf[0x1000 + 0x40];
+    int count = 0, kind, i, j;
+
+    for (kind = 0; kind < KIND_COUNT; kind++) {
+        for (i = 0; i < FILES_PER_KIND; i++) {
+            char filename[PATH_LIMIT];
+            size_t size;
+            const char* ext = strrchr(kinds[kind], '.') ? strrchr(kinds[kind], '.') + 1 : kinds[kind];
+
+            memset(buf, 0, sizeof(buf));
+            if (kind == 0) { /* RIFF PCM16 stereo, length varies per file */
+                size_t data_size = 0x800 + i * 0x10;
+                memcpy(buf + 0x00, "RIFF", 4); put_32bitLE(buf + 0x04, 0x24 + data_size);
+                memcpy(buf + 0x08, "WAVEfmt ", 8); put_32bitLE(buf + 0x10, 0x10);
+                buf[0x14] = 1; buf[0x16] = 2;
+                put_32bitLE(buf + 0x18, 44100); put_32bitLE(buf + 0x1c, 44100 * 4);
+                buf[0x20] = 4; buf[0x22] = 16;
+                memcpy(buf + 0x24, "data", 4); put_32bitLE(buf + 0x28, data_size);
+                size = 0x2c + data_size;
+            }
+            else if (kind == 1) { /* SShd + SSbd PCM16 stereo */
+                memcpy(buf + 0x00, "SShd", 4); put_32bitLE(buf + 0x04, 0x18);
+                put_32bitLE(buf + 0x08, 0x10); put_32bitLE(buf + 0x0c, 44100);
+                put_32bitLE(buf + 0x10, 2); put_32bitLE(buf + 0x14, 0x400);
+                put_32bitLE(buf + 0x18, 0xFFFFFFFF); put_32bitLE(buf + 0x1c, 0xFFFFFFFF);
+                memcpy(buf + 0x20, "SSbd", 4); put_32bitLE(buf + 0x24, 0x1000);
+                size = 0x28 + 0x1000;
+            }
+            else { /* .int raw PCM, accepted near the end of the table, or junk; same data for all files of a kind */
+                for (j = 0; j < 0x1000; j++)
+                    buf[j] = (uint8_t)(j * 7 + kind);
+                size = 0x1000;
+            }
+
+            snprintf(filename, sizeof(filename), "%s/file%03d_%d.%s", dir, i, kind, ext);
+            if (!write_file(filename, buf, size))
+                return 0;
+            names[count++] = strdup(filename);
+        }
+    }
+
+    *p_names = names;
+    return count;
+}
+
+int main(int argc, char** argv) {
+    char** names;
+    int count, passes = 3, first = 1, pass, i, kind, mismatches = 0, recognized = 0;
+    char dir[] = "/tmp/probe_benchXXXXXX";
+    int synthetic = 0;
+    result_t* results;
+
+    if (argc > 2 && strcmp(argv[1], "-p") == 0) {
+        passes = atoi(argv[2]);
+        first = 3;
+    }
+
+    if (first >= argc) {
+        if (!mkdtemp(dir)) {
+            fprintf(stderr, "can't create temp dir\n");
+            return 1;
+        }
+        count = make_corpus(dir, &names);
+        if (count != KIND_COUNT * FILES_PER_KIND) {
+            fprintf(stderr, "can't write corpus\n");
+            return 1;
+        }
+        synthetic = 1;
+    }
+    else {
+        names = argv + first;
+        count = argc - first;
+    }
+
+    results = calloc(count, sizeof(result_t));
+
+    printf("%d files\n", count);
+    printf("%-6s %12s %12s %10s %10s\n", "pass", "ms total", "us per file", "reads", "names");
+    for (pass = 0; pass < passes; pass++) {
+        double total = 0;
+        long reads = 0, lookups = 0;
+
+        for (i = 0; i < count; i++) {
+            result_t result;
+            long file_lookups = 0;
+            result.time = probe(names[i], &result, &reads, &file_lookups);
+            result.lookups = file_lookups;
+            total += result.time;
+            lookups += file_lookups;
+
+            if (pass == 0) {
+                results[i] = result;
+                if (result.meta_type >= 0)
+                    recognized++;
+            }
+            else if (result.meta_type != results[i].meta_type || result.num_samples != results[i].num_samples) {
+                printf("%s: meta %d, %d samples on pass %d, meta %d, %d samples on the first\n",
+                        names[i], result.meta_type, result.num_samples, pass + 1, results[i].meta_type, results[i].num_samples);
+                mismatches++;
+            }
+        }
+
+        printf("%-6d %12.2f %12.1f %10ld %10ld\n", pass + 1, total * 1e3, total * 1e6 / count, reads, lookups);
+    }
+    printf("%d files recognized, %d mismatches\n", recognized, mismatches);
+
+    if (synthetic) {
+        printf("\n%-10s %12s %12s %12s %12s\n", "kind", "first us", "others us", "first names", "others names");
+        for (kind = 0; kind < KIND_COUNT; kind++) {
+            const result_t* kind_results = results + kind * FILES_PER_KIND;
+            double others_time = 0;
+            long others_lookups = 0;
+
+            for (i = 1; i < FILES_PER_KIND; i++) {
+                others_time += kind_results[i].time;
+                others_lookups += kind_results[i].lookups;
+            }
+            printf("%-10s %12.1f %12.1f %12ld %12.1f\n", kinds[kind],
+                    kind_results[0].time * 1e6, others_time * 1e6 / (FILES_PER_KIND - 1),
+                    kind_results[0].lookups, (double)others_lookups / (FILES_PER_KIND - 1));
+        }
+
+        for (i = 0; i < count; i++) {
+            remove(names[i]);
+            free(names[i]);
+        }
+        free(names);
+        remove(dir);
+    }
+    free(results);
+
+    return mismatches != 0;
+}
@@ -768,6 +768,45 @@ int decode_get_shortframe_size(VGMSTREAM* vgmstream) {
     }
 }
 
+/* Codecs that decode to float internally and may output it directly, while the rest are converted
+ * from their usual 16-bit samples (see render_vgmstream_f32). */
+bool decode_uses_f32(VGMSTREAM* vgmstream) {
+    switch (vgmstream->coding_type) {
+#ifdef VGM_USE_VORBIS
+        case coding_OGG_VORBIS:
+            return true;
+#endif
+#ifdef VGM_USE_FFMPEG
+        case coding_FFmpeg:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/* Same as decode_vgmstream but for codecs in decode_uses_f32, writing floats in 16-bit range */
+void decode_vgmstream_f32(VGMSTREAM* vgmstream, int samples_written, int samples_to_do, float* buffer) {
+
+    buffer += samples_written * vgmstream->channels;
+
+    switch (vgmstream->coding_type) {
+#ifdef VGM_USE_VORBIS
+        case coding_OGG_VORBIS:
+            decode_ogg_vorbis_f32(vgmstream->codec_data, buffer, samples_to_do, vgmstream->channels);
+            break;
+#endif
+#ifdef VGM_USE_FFMPEG
+        case coding_FFmpeg:
+            decode_ffmpeg_f32(vgmstream, buffer, samples_to_do, vgmstream->channels);
+            break;
+#endif
+        default:
+            memset(buffer, 0, samples_to_do * vgmstream->channels * sizeof(float));
+            break;
+    }
+}
+
 /* Decode samples into the buffer. Assume that we have written samples_written into the
  * buffer already, and we have samples_to_do consecutive samples ahead of us (won't call
  * more than one frame if configured above to do so).
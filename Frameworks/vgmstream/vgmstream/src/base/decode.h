@@ -11,6 +11,10 @@ void decode_reset(VGMSTREAM* vgmstream);
  * buffer already, and we have samples_to_do consecutive samples ahead of us. */
 void decode_vgmstream(VGMSTREAM* vgmstream, int samples_written, int samples_to_do, sample_t* buffer);
 
+/* Same as decode_vgmstream but with float samples in 16-bit range, for codecs where decode_uses_f32 is set. */
+bool decode_uses_f32(VGMSTREAM* vgmstream);
+void decode_vgmstream_f32(VGMSTREAM* vgmstream, int samples_written, int samples_to_do, float* buffer);
+
 /* Detect loop start and save values, or detect loop end and restore (loop back). Returns 1 if loop was done. */
 int decode_do_loop(VGMSTREAM* vgmstream);
 
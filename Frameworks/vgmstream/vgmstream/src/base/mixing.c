@@ -68,7 +68,8 @@ static void sbuf_copy_f32_to_s16(int16_t* buf_s16, float* buf_f32, int samples,
     }
 }
 
-void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream) {
+/* mixes outbuf or outbuf_f32 (whichever is set) */
+static void mix_vgmstream_internal(sample_t *outbuf, float *outbuf_f32, int32_t sample_count, VGMSTREAM* vgmstream) {
     mixing_data *data = vgmstream->mixing_data;
     int ch, s, m, ok;
 
@@ -76,6 +77,7 @@ void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream)
     float temp_f, temp_min, temp_max, cur_vol = 0.0f;
     float *temp_mixbuf;
     sample_t *temp_outbuf;
+    float *temp_outbuf_f32;
 
     const float limiter_max = 32767.0f;
     const float limiter_min = -32768.0f;
@@ -98,6 +100,7 @@ void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream)
     /* use advancing buffer pointers to simplify logic */
     temp_mixbuf = data->mixbuf; /* you'd think using a int32 temp buf would be faster but somehow it's slower? */
     temp_outbuf = outbuf;
+    temp_outbuf_f32 = outbuf_f32;
 
     /* mixing ops are designed to apply in order, all channels per 1 sample 'step'. Since some ops change
      * total channels, channel number meaning varies as ops move them around, ex:
@@ -115,8 +118,15 @@ void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream)
         float *stpbuf = temp_mixbuf;
         int step_channels = vgmstream->channels;
 
-        for (ch = 0; ch < step_channels; ch++) {
-            stpbuf[ch] = temp_outbuf[ch]; /* copy current 'lane' */
+        if (temp_outbuf_f32) {
+            for (ch = 0; ch < step_channels; ch++) {
+                stpbuf[ch] = temp_outbuf_f32[ch]; /* copy current 'lane' */
+            }
+        }
+        else {
+            for (ch = 0; ch < step_channels; ch++) {
+                stpbuf[ch] = temp_outbuf[ch]; /* copy current 'lane' */
+            }
         }
 
         for (m = 0; m < data->mixing_count; m++) {
@@ -212,11 +222,25 @@ void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream)
         current_subpos++;
 
         temp_mixbuf += step_channels;
-        temp_outbuf += vgmstream->channels;
+        if (temp_outbuf_f32)
+            temp_outbuf_f32 += vgmstream->channels;
+        else
+            temp_outbuf += vgmstream->channels;
     }
 
-    /* copy resulting temp mix to output */
-    sbuf_copy_f32_to_s16(outbuf, data->mixbuf, sample_count, data->output_channels);
+    /* copy resulting temp mix to output (float keeps values over 16-bit range) */
+    if (outbuf_f32)
+        memcpy(outbuf_f32, data->mixbuf, sample_count * data->output_channels * sizeof(float));
+    else
+        sbuf_copy_f32_to_s16(outbuf, data->mixbuf, sample_count, data->output_channels);
+}
+
+void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream) {
+    mix_vgmstream_internal(outbuf, NULL, sample_count, vgmstream);
+}
+
+void mix_vgmstream_f32(float *outbuf, int32_t sample_count, VGMSTREAM* vgmstream) {
+    mix_vgmstream_internal(NULL, outbuf, sample_count, vgmstream);
 }
 
 /* ******************************************************************* */
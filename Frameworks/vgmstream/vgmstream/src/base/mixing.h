@@ -7,6 +7,9 @@
  * outbuf must big enough to hold output_channels*samples_to_do */
 void mix_vgmstream(sample_t *outbuf, int32_t sample_count, VGMSTREAM* vgmstream);
 
+/* Same but with float samples (in 16-bit range), results aren't clamped. */
+void mix_vgmstream_f32(float *outbuf, int32_t sample_count, VGMSTREAM* vgmstream);
+
 /* internal mixing pre-setup for vgmstream (doesn't imply usage).
  * If init somehow fails next calls are ignored. */
 void mixing_init(VGMSTREAM* vgmstream);
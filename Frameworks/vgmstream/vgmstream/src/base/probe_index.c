@@ -0,0 +1,229 @@
+#include "probe_index.h"
+#include "../vgmstream.h"
+#include "../util.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+/* PROBE INDEX
+ * Finding a file's format means calling every init function in order until one accepts it, and most
+ * of them only reject it after checking the extension and a few header bytes. Since there is no info
+ * about what each function checks, the index learns it: during probing the streamfile is wrapped to
+ * see what each function touched, and rejections that only depended on the extension, subsong and
+ * the first 0/4/8/16 bytes are stored per key. Next files with the same key skip those functions.
+ *
+ * Functions that got the size, opened companion files, looked at the filename beyond its extension (like
+ * formats that check name prefixes) or read further aren't indexed. Order is kept
+ * (skipped functions can't accept the file), and if nothing accepts it the caller retries the skipped
+ * ones anyway, so a wrong entry can't make a file unplayable. The index is shared between threads,
+ * but it's only locked when loading/saving masks and never while init functions run. */
+
+#define INDEX_ENTRIES  256
+
+typedef struct {
+    int used;
+    int level;
+    int stream_index;
+    char ext[PROBE_INDEX_MAX_EXT];
+    uint8_t header[PROBE_INDEX_MAX_HEADER];
+    int header_size;
+    uint32_t rejects[PROBE_INDEX_MASK_WORDS];
+} index_entry_t;
+
+static index_entry_t index_entries[INDEX_ENTRIES];
+
+static const int level_sizes[PROBE_INDEX_LEVELS] = { 0x00, 0x04, 0x08, 0x10 };
+
+#if defined(_WIN32)
+static SRWLOCK index_lock = SRWLOCK_INIT;
+static void lock_index(void)   { AcquireSRWLockExclusive(&index_lock); }
+static void unlock_index(void) { ReleaseSRWLockExclusive(&index_lock); }
+#else
+static pthread_mutex_t index_lock = PTHREAD_MUTEX_INITIALIZER;
+static void lock_index(void)   { pthread_mutex_lock(&index_lock); }
+static void unlock_index(void) { pthread_mutex_unlock(&index_lock); }
+#endif
+
+
+/* header bytes that are part of the key for a level (files smaller than the level use what they have) */
+static int get_level_size(probe_index_t* pi, int level) {
+    int size = level_sizes[level];
+    return size > pi->header_size ? pi->header_size : size;
+}
+
+static int find_entry(probe_index_t* pi, int level, int create) {
+    int size = get_level_size(pi, level);
+    uint32_t hash = 2166136261u; /* FNV-1a */
+    const char* ext;
+    int i;
+    index_entry_t* entry;
+
+    for (ext = pi->ext; *ext; ext++) {
+        hash = (hash ^ (uint8_t)*ext) * 16777619u;
+    }
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ pi->header[i]) * 16777619u;
+    }
+    hash = (hash ^ (uint32_t)level) * 16777619u;
+    hash = (hash ^ (uint32_t)pi->vt.stream_index) * 16777619u;
+
+    i = hash % INDEX_ENTRIES;
+    entry = &index_entries[i];
+    if (entry->used && entry->level == level && entry->stream_index == pi->vt.stream_index
+            && entry->header_size == size && strcmp(entry->ext, pi->ext) == 0
+            && memcmp(entry->header, pi->header, size) == 0)
+        return i;
+
+    if (!create)
+        return -1;
+
+    /* new key or collision: replace old entry */
+    memset(entry, 0, sizeof(index_entry_t));
+    entry->used = 1;
+    entry->level = level;
+    entry->stream_index = pi->vt.stream_index;
+    strcpy(entry->ext, pi->ext);
+    memcpy(entry->header, pi->header, size);
+    entry->header_size = size;
+    return i;
+}
+
+
+static size_t probe_read(probe_index_t* pi, uint8_t* dst, offv_t offset, size_t length) {
+    if (length > 0 && offset + length > pi->max_read)
+        pi->max_read = offset + length;
+    return pi->inner_sf->read(pi->inner_sf, dst, offset, length);
+}
+static size_t probe_get_size(probe_index_t* pi) {
+    pi->used_size = 1;
+    return pi->inner_sf->get_size(pi->inner_sf);
+}
+static offv_t probe_get_offset(probe_index_t* pi) {
+    pi->used_size = 1;
+    return pi->inner_sf->get_offset(pi->inner_sf);
+}
+static void probe_get_name(probe_index_t* pi, char* name, size_t name_size) {
+    pi->used_name = 1;
+    pi->inner_sf->get_name(pi->inner_sf, name, name_size);
+}
+static STREAMFILE* probe_open(probe_index_t* pi, const char* const filename, size_t buf_size) {
+    pi->used_open = 1;
+    return pi->inner_sf->open(pi->inner_sf, filename, buf_size);
+}
+static void probe_close(probe_index_t* pi) {
+    /* lives in the caller's stack, init functions shouldn't close it anyway */
+}
+
+
+void probe_index_open(probe_index_t* pi, STREAMFILE* sf) {
+    char filename[PATH_LIMIT];
+    const char* ext;
+    int level, i;
+
+    memset(pi, 0, sizeof(probe_index_t));
+
+    pi->vt.read = (void*)probe_read;
+    pi->vt.get_size = (void*)probe_get_size;
+    pi->vt.get_offset = (void*)probe_get_offset;
+    pi->vt.get_name = (void*)probe_get_name;
+    pi->vt.open = (void*)probe_open;
+    pi->vt.close = (void*)probe_close;
+    pi->vt.stream_index = sf->stream_index;
+
+    pi->inner_sf = sf;
+
+    /* case is kept as a few formats compare extensions directly */
+    sf->get_name(sf, filename, sizeof(filename));
+    ext = filename_extension(filename);
+    if (strlen(ext) >= sizeof(pi->ext))
+        return; /* not indexed */
+    strcpy(pi->ext, ext);
+
+    pi->header_size = sf->read(sf, pi->header, 0x00, sizeof(pi->header));
+    if (pi->header_size < 0 || pi->header_size > sizeof(pi->header))
+        return;
+
+    pi->enabled = 1;
+
+    lock_index();
+    for (level = 0; level < PROBE_INDEX_LEVELS; level++) {
+        int pos = find_entry(pi, level, 0);
+        if (pos < 0)
+            continue;
+        for (i = 0; i < PROBE_INDEX_MASK_WORDS; i++) {
+            pi->skip[i] |= index_entries[pos].rejects[i];
+        }
+    }
+    unlock_index();
+}
+
+int probe_index_skip(probe_index_t* pi, int index) {
+    return (pi->skip[index / 32] >> (index % 32)) & 1;
+}
+
+STREAMFILE* probe_index_start(probe_index_t* pi) {
+    pi->used_size = 0;
+    pi->used_open = 0;
+    pi->used_name = 0;
+    pi->max_read = 0;
+    return &pi->vt;
+}
+
+void probe_index_reject(probe_index_t* pi, int index) {
+    int level;
+
+    if (!pi->enabled || pi->used_size || pi->used_open || pi->used_name)
+        return;
+
+    /* smallest level that covers all reads */
+    for (level = 0; level < PROBE_INDEX_LEVELS; level++) {
+        if (pi->max_read <= level_sizes[level])
+            break;
+    }
+    if (level == PROBE_INDEX_LEVELS)
+        return;
+
+    pi->rejects[level][index / 32] |= 1u << (index % 32);
+    pi->rejected = 1;
+}
+
+void probe_index_close(probe_index_t* pi) {
+    int level, i;
+
+    if (!pi->enabled || !pi->rejected)
+        return;
+
+    lock_index();
+    for (level = 0; level < PROBE_INDEX_LEVELS; level++) {
+        int pos, empty = 1;
+        for (i = 0; i < PROBE_INDEX_MASK_WORDS; i++) {
+            if (pi->rejects[level][i]) {
+                empty = 0;
+                break;
+            }
+        }
+        if (empty)
+            continue;
+
+        pos = find_entry(pi, level, 1);
+        for (i = 0; i < PROBE_INDEX_MASK_WORDS; i++) {
+            index_entries[pos].rejects[i] |= pi->rejects[level][i];
+        }
+    }
+    unlock_index();
+}
+
+int probe_index_get_name_for_ext(STREAMFILE* sf, char* name, size_t name_size) {
+    probe_index_t* pi;
+
+    if (sf->get_name != (void*)probe_get_name)
+        return 0;
+
+    pi = (probe_index_t*)sf;
+    pi->inner_sf->get_name(pi->inner_sf, name, name_size);
+    return 1;
+}
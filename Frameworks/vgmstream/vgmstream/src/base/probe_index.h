@@ -0,0 +1,55 @@
+#ifndef _PROBE_INDEX_H
+#define _PROBE_INDEX_H
+
+#include "../streamfile.h"
+
+/* Max init functions tracked by the index (checked when the init table is built). */
+#define PROBE_INDEX_MAX_FUNCTIONS  1024
+#define PROBE_INDEX_MASK_WORDS     (PROBE_INDEX_MAX_FUNCTIONS / 32)
+#define PROBE_INDEX_MAX_HEADER     0x10
+#define PROBE_INDEX_LEVELS         4        /* header prefixes of 0, 4, 8 and 16 bytes */
+#define PROBE_INDEX_MAX_EXT        0x10
+
+/* Per-call probing state, lives in the caller's stack. Tracks which init functions can be skipped
+ * for the current file and which ones rejected it in a way that only depends on the index key. */
+typedef struct {
+    STREAMFILE vt;
+    STREAMFILE* inner_sf;
+
+    /* current probe */
+    int used_size;          /* called get_size/get_offset */
+    int used_open;          /* opened other files */
+    int used_name;          /* got the filename for more than its extension */
+    offv_t max_read;        /* end of furthest read */
+
+    /* key */
+    int enabled;
+    char ext[PROBE_INDEX_MAX_EXT];
+    uint8_t header[PROBE_INDEX_MAX_HEADER];
+    int header_size;        /* bytes actually available */
+
+    uint32_t skip[PROBE_INDEX_MASK_WORDS];
+    uint32_t rejects[PROBE_INDEX_LEVELS][PROBE_INDEX_MASK_WORDS];
+    int rejected;
+} probe_index_t;
+
+/* Sets up state for sf and loads the known rejections for its key. */
+void probe_index_open(probe_index_t* pi, STREAMFILE* sf);
+
+/* Returns true if function 'index' is known to reject this file. */
+int probe_index_skip(probe_index_t* pi, int index);
+
+/* Returns the streamfile that the init function 'index' must be called with. */
+STREAMFILE* probe_index_start(probe_index_t* pi);
+
+/* Marks that the last started init function rejected the file. */
+void probe_index_reject(probe_index_t* pi, int index);
+
+/* Saves the rejections found during this call in the shared index. */
+void probe_index_close(probe_index_t* pi);
+
+/* Copies the filename of sf, if it's the probe streamfile, without counting it as a name check.
+ * For helpers that only look at the extension, which is already part of the key. Returns false otherwise. */
+int probe_index_get_name_for_ext(STREAMFILE* sf, char* name, size_t name_size);
+
+#endif
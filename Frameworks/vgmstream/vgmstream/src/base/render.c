@@ -347,19 +347,40 @@ static void render_trim(VGMSTREAM* vgmstream) {
     }
 }
 
-static int render_pad_begin(VGMSTREAM* vgmstream, sample_t* buf, int samples_to_do) {
+/* Output buffers may be 16-bit samples or floats (in 16-bit range while rendering). Float mode avoids
+ * clamping and quantizing between codecs, mixing and fades, and is set once per render call. */
+typedef struct {
+    sample_t* s16;
+    float* f32;
+} render_buf_t;
+
+static void render_buf_skip(render_buf_t* rb, int samples, int channels) {
+    if (rb->f32)
+        rb->f32 += samples * channels;
+    else
+        rb->s16 += samples * channels;
+}
+
+static void render_buf_silence(render_buf_t* rb, int start, int samples, int channels) {
+    if (rb->f32)
+        memset(rb->f32 + start * channels, 0, samples * sizeof(float) * channels);
+    else
+        memset(rb->s16 + start * channels, 0, samples * sizeof(sample_t) * channels);
+}
+
+static int render_pad_begin(VGMSTREAM* vgmstream, render_buf_t* rb, int samples_to_do) {
     int channels = vgmstream->pstate.output_channels;
     int to_do = vgmstream->pstate.pad_begin_left;
     if (to_do > samples_to_do)
         to_do = samples_to_do;
 
-    memset(buf, 0, to_do * sizeof(sample_t) * channels);
+    render_buf_silence(rb, 0, to_do, channels);
     vgmstream->pstate.pad_begin_left -= to_do;
 
     return to_do;
 }
 
-static int render_fade(VGMSTREAM* vgmstream, sample_t* buf, int samples_left) {
+static int render_fade(VGMSTREAM* vgmstream, render_buf_t* rb, int samples_left) {
     play_state_t* ps = &vgmstream->pstate;
     //play_config_t* pc = &vgmstream->config;
 
@@ -386,22 +407,34 @@ static int render_fade(VGMSTREAM* vgmstream, sample_t* buf, int samples_left) {
             to_do = samples_left - start;
 
         //TODO: use delta fadedness to improve performance?
-        for (s = start; s < start + to_do; s++, fade_pos++) {
-            double fadedness = (double)(ps->fade_duration - fade_pos) / ps->fade_duration;
-            for (ch = 0; ch < channels; ch++) {
-                buf[s*channels + ch] = (sample_t)buf[s*channels + ch] * fadedness;
+        if (rb->f32) {
+            float* buf = rb->f32;
+            for (s = start; s < start + to_do; s++, fade_pos++) {
+                float fadedness = (float)(ps->fade_duration - fade_pos) / ps->fade_duration;
+                for (ch = 0; ch < channels; ch++) {
+                    buf[s*channels + ch] = buf[s*channels + ch] * fadedness;
+                }
+            }
+        }
+        else {
+            sample_t* buf = rb->s16;
+            for (s = start; s < start + to_do; s++, fade_pos++) {
+                double fadedness = (double)(ps->fade_duration - fade_pos) / ps->fade_duration;
+                for (ch = 0; ch < channels; ch++) {
+                    buf[s*channels + ch] = (sample_t)buf[s*channels + ch] * fadedness;
+                }
             }
         }
 
         ps->fade_left -= to_do;
 
         /* next samples after fade end would be pad end/silence, so we can just memset */
-        memset(buf + (start + to_do) * channels, 0, (samples_left - to_do - start) * sizeof(sample_t) * channels);
+        render_buf_silence(rb, start + to_do, samples_left - to_do - start, channels);
         return start + to_do;
     }
 }
 
-static int render_pad_end(VGMSTREAM* vgmstream, sample_t* buf, int samples_left) {
+static int render_pad_end(VGMSTREAM* vgmstream, render_buf_t* rb, int samples_left) {
     play_state_t* ps = &vgmstream->pstate;
     int channels = vgmstream->pstate.output_channels;
     int skip = 0;
@@ -421,25 +454,73 @@ static int render_pad_end(VGMSTREAM* vgmstream, sample_t* buf, int samples_left)
     if (to_do > samples_left - skip)
         to_do = samples_left - skip;
 
-    memset(buf + (skip * channels), 0, to_do * sizeof(sample_t) * channels);
+    render_buf_silence(rb, skip, to_do, channels);
     return skip + to_do;
 }
 
+/* float version of render_layout: codecs that decode to float write directly, others are converted */
+static int render_layout_f32(float* buf, int32_t sample_count, VGMSTREAM* vgmstream) {
+    int channels = vgmstream->channels;
+
+    if (vgmstream->layout_type == layout_none && decode_uses_f32(vgmstream)
+            && vgmstream->current_sample <= vgmstream->num_samples) {
+        render_vgmstream_flat_f32(buf, sample_count, vgmstream);
+
+        /* same as render_layout */
+        if (vgmstream->current_sample > vgmstream->num_samples) {
+            int32_t excess, decoded;
+
+            excess = (vgmstream->current_sample - vgmstream->num_samples);
+            if (excess > sample_count)
+                excess = sample_count;
+            decoded = sample_count - excess;
+
+            memset(buf + decoded * channels, 0, excess * sizeof(float) * channels);
+        }
+    }
+    else {
+        sample_t* tmpbuf = vgmstream->tmpbuf;
+        int32_t buf_samples = vgmstream->tmpbuf_size / channels;
+        int32_t samples_done = 0;
+
+        while (samples_done < sample_count) {
+            int s;
+            int to_do = sample_count - samples_done;
+            if (to_do > buf_samples)
+                to_do = buf_samples;
+
+            render_layout(tmpbuf, to_do, vgmstream);
+            for (s = 0; s < to_do * channels; s++) {
+                buf[samples_done * channels + s] = tmpbuf[s];
+            }
+            samples_done += to_do;
+        }
+    }
+
+    return sample_count;
+}
+
 
 /* Decode data into sample buffer. Controls the "external" part of the decoding,
  * while layout/decode control the "internal" part. */
-int render_vgmstream(sample_t* buf, int32_t sample_count, VGMSTREAM* vgmstream) {
+static int render_internal(render_buf_t* rb, int32_t sample_count, VGMSTREAM* vgmstream) {
     play_state_t* ps = &vgmstream->pstate;
     int samples_to_do = sample_count;
     int samples_done = 0;
     int done;
-    sample_t* tmpbuf = buf;
+    render_buf_t tmpbuf = *rb;
 
 
     /* simple mode with no settings (just skip everything below) */
     if (!vgmstream->config_enabled) {
-        render_layout(buf, samples_to_do, vgmstream);
-        mix_vgmstream(buf, samples_to_do, vgmstream);
+        if (rb->f32) {
+            render_layout_f32(rb->f32, samples_to_do, vgmstream);
+            mix_vgmstream_f32(rb->f32, samples_to_do, vgmstream);
+        }
+        else {
+            render_layout(rb->s16, samples_to_do, vgmstream);
+            mix_vgmstream(rb->s16, samples_to_do, vgmstream);
+        }
         return samples_to_do;
     }
 
@@ -451,43 +532,48 @@ int render_vgmstream(sample_t* buf, int32_t sample_count, VGMSTREAM* vgmstream)
 
     /* adds empty samples to buf */
     if (ps->pad_begin_left) {
-        done = render_pad_begin(vgmstream, tmpbuf, samples_to_do);
+        done = render_pad_begin(vgmstream, &tmpbuf, samples_to_do);
         samples_done += done;
         samples_to_do -= done;
-        tmpbuf += done * vgmstream->pstate.output_channels; /* as if mixed */
+        render_buf_skip(&tmpbuf, done, vgmstream->pstate.output_channels); /* as if mixed */
     }
 
     /* end padding (before to avoid decoding if possible, but must be inside pad region) */
     if (!vgmstream->config.play_forever
             && ps->play_position /*+ samples_to_do*/ >= ps->pad_end_start
             && samples_to_do) {
-        done = render_pad_end(vgmstream, tmpbuf, samples_to_do);
+        done = render_pad_end(vgmstream, &tmpbuf, samples_to_do);
         samples_done += done;
         samples_to_do -= done;
-        tmpbuf += done * vgmstream->pstate.output_channels; /* as if mixed */
+        render_buf_skip(&tmpbuf, done, vgmstream->pstate.output_channels); /* as if mixed */
     }
 
     /* main decode */
     { //if (samples_to_do)  /* 0 ok, less likely */
-        done = render_layout(tmpbuf, samples_to_do, vgmstream);
-
-        mix_vgmstream(tmpbuf, done, vgmstream);
+        if (tmpbuf.f32) {
+            done = render_layout_f32(tmpbuf.f32, samples_to_do, vgmstream);
+            mix_vgmstream_f32(tmpbuf.f32, done, vgmstream);
+        }
+        else {
+            done = render_layout(tmpbuf.s16, samples_to_do, vgmstream);
+            mix_vgmstream(tmpbuf.s16, done, vgmstream);
+        }
 
         samples_done += done;
 
         if (!vgmstream->config.play_forever) {
             /* simple fadeout */
             if (ps->fade_left && ps->play_position + done >= ps->fade_start) {
-                render_fade(vgmstream, tmpbuf, done);
+                render_fade(vgmstream, &tmpbuf, done);
             }
 
             /* silence leftover buf samples (rarely used when no fade is set) */
             if (ps->play_position + done >= ps->pad_end_start) {
-                render_pad_end(vgmstream, tmpbuf, done);
+                render_pad_end(vgmstream, &tmpbuf, done);
             }
         }
 
-        tmpbuf += done * vgmstream->pstate.output_channels;
+        render_buf_skip(&tmpbuf, done, vgmstream->pstate.output_channels);
     }
 
 
@@ -507,3 +593,24 @@ int render_vgmstream(sample_t* buf, int32_t sample_count, VGMSTREAM* vgmstream)
 
     return samples_done;
 }
+
+int render_vgmstream(sample_t* buf, int32_t sample_count, VGMSTREAM* vgmstream) {
+    render_buf_t rb = { buf, NULL };
+    return render_internal(&rb, sample_count, vgmstream);
+}
+
+int render_vgmstream_f32(float* buf, int32_t sample_count, VGMSTREAM* vgmstream) {
+    render_buf_t rb = { NULL, buf };
+    int channels, samples_done, s;
+
+    mixing_info(vgmstream, NULL, &channels);
+
+    samples_done = render_internal(&rb, sample_count, vgmstream);
+
+    /* whole buffer as render_vgmstream also writes past stream end */
+    for (s = 0; s < sample_count * channels; s++) {
+        buf[s] = buf[s] * (1.0f / 32768.0f);
+    }
+
+    return samples_done;
+}
@@ -17,11 +17,58 @@ static void seek_force_loop(VGMSTREAM* vgmstream, int loop_count) {
     decode_do_loop(vgmstream);
 }
 
+/* Layouts can move to a sample without decoding everything before it: segmented seeks inside the segment
+ * that has the sample and layered seeks each layer separately, so sub-layouts get the same treatment.
+ * Moves stop at loop points so loop state is saved/applied as if decoding. */
+static void seek_force_layout(VGMSTREAM* vgmstream, int32_t samples) {
+
+    while (samples > 0) {
+        int32_t current = vgmstream->current_sample;
+        int32_t to_do = samples;
+        int hit_loop = vgmstream->hit_loop;
+
+        if (vgmstream->loop_flag) {
+            if (!vgmstream->hit_loop && current <= vgmstream->loop_start_sample && current + to_do > vgmstream->loop_start_sample)
+                to_do = vgmstream->loop_start_sample - current;
+            else if (current <= vgmstream->loop_end_sample && current + to_do > vgmstream->loop_end_sample)
+                to_do = vgmstream->loop_end_sample - current;
+        }
+
+        if (to_do > 0) {
+            if (vgmstream->layout_type == layout_segmented)
+                seek_layout_segmented(vgmstream, current + to_do);
+            else
+                seek_layout_layered(vgmstream, current + to_do);
+            samples -= to_do;
+        }
+
+        if (samples <= 0 || !vgmstream->loop_flag)
+            continue;
+
+        /* save loop start or loop back (done by the layout's render otherwise) */
+        if (decode_do_loop(vgmstream)) {
+            /* full loops don't change anything unless counting them */
+            int32_t loop_body = vgmstream->loop_end_sample - vgmstream->loop_start_sample;
+            if (!vgmstream->loop_target && loop_body > 0)
+                samples = samples % loop_body;
+        }
+        else if (to_do == 0 && hit_loop == vgmstream->hit_loop) {
+            VGM_LOG("SEEK: can't move layout at %i\n", current);
+            break;
+        }
+    }
+}
+
 static void seek_force_decode(VGMSTREAM* vgmstream, int samples) {
     sample_t* tmpbuf = vgmstream->tmpbuf;
     size_t tmpbuf_size = vgmstream->tmpbuf_size;
     int32_t buf_samples = tmpbuf_size / vgmstream->channels; /* base channels, no need to apply mixing */
 
+    if (vgmstream->layout_type == layout_segmented || vgmstream->layout_type == layout_layered) {
+        seek_force_layout(vgmstream, samples);
+        return;
+    }
+
     while (samples) {
         int to_do = samples;
         if (to_do > buf_samples)
@@ -49,26 +96,6 @@ void seek_vgmstream(VGMSTREAM* vgmstream, int32_t seek_sample) {
     if (vgmstream->config_enabled && seek_sample > ps->play_duration && !play_forever)
         seek_sample = ps->play_duration;
 
-#if 0 //todo move below, needs to clamp in decode part
-    /* optimize as layouts can seek faster internally */
-    if (vgmstream->layout_type == layout_segmented) {
-        seek_layout_segmented(vgmstream, seek_sample);
-
-        if (vgmstream->config_enabled) {
-            vgmstream->pstate.play_position = seek_sample;
-        }
-        return;
-    }
-    else if (vgmstream->layout_type == layout_layered) {
-        seek_layout_layered(vgmstream, seek_sample);
-
-        if (vgmstream->config_enabled) {
-            vgmstream->pstate.play_position = seek_sample;
-        }
-        return;
-    }
-#endif
-
     /* will decode and loop until seek sample, but slower */
     //todo apply same loop logic as below, or pretend we have play_forever + settings?
     if (!vgmstream->config_enabled) {
@@ -389,6 +389,7 @@ typedef struct { //todo simplify
 
 ogg_vorbis_codec_data* init_ogg_vorbis(STREAMFILE* sf, off_t start, off_t size, ogg_vorbis_io* io);
 void decode_ogg_vorbis(ogg_vorbis_codec_data* data, sample_t* outbuf, int32_t samples_to_do, int channels);
+void decode_ogg_vorbis_f32(ogg_vorbis_codec_data* data, float* outbuf, int32_t samples_to_do, int channels);
 void reset_ogg_vorbis(ogg_vorbis_codec_data* data);
 void seek_ogg_vorbis(ogg_vorbis_codec_data* data, int32_t num_sample);
 void free_ogg_vorbis(ogg_vorbis_codec_data* data);
@@ -606,6 +607,7 @@ ffmpeg_codec_data* init_ffmpeg_header_offset(STREAMFILE* sf, uint8_t* header, ui
 ffmpeg_codec_data* init_ffmpeg_header_offset_subsong(STREAMFILE* sf, uint8_t* header, uint64_t header_size, uint64_t start, uint64_t size, int target_subsong);
 
 void decode_ffmpeg(VGMSTREAM* vgmstream, sample_t* outbuf, int32_t samples_to_do, int channels);
+void decode_ffmpeg_f32(VGMSTREAM* vgmstream, float* outbuf, int32_t samples_to_do, int channels);
 void reset_ffmpeg(ffmpeg_codec_data* data);
 void seek_ffmpeg(ffmpeg_codec_data* data, int32_t num_sample);
 void free_ffmpeg(ffmpeg_codec_data* data);
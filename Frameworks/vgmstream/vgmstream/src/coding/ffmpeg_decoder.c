@@ -101,6 +101,25 @@ static void remap_audio(sample_t* outbuf, int sample_count, int channels, int* c
     }
 }
 
+static void remap_audio_f32(float* outbuf, int sample_count, int channels, int* channel_mappings) {
+    int ch_from,ch_to,s;
+    float temp;
+    for (s = 0; s < sample_count; s++) {
+        for (ch_from = 0; ch_from < channels; ch_from++) {
+            if (ch_from > 32)
+                continue;
+
+            ch_to = channel_mappings[ch_from];
+            if (ch_to < 1 || ch_to > 32 || ch_to > channels-1 || ch_from == ch_to)
+                continue;
+
+            temp = outbuf[s*channels + ch_from];
+            outbuf[s*channels + ch_from] = outbuf[s*channels + ch_to];
+            outbuf[s*channels + ch_to] = temp;
+        }
+    }
+}
+
 /**
  * Special patching for FFmpeg's buggy seek code.
  *
@@ -738,6 +757,115 @@ static void samples_dblp_to_s16(sample_t* obuf, double** inbuf, int ichs, int sa
     }
 }
 
+/* float versions (scaled to 16-bit range but not clamped), mainly to avoid quantizing float codecs */
+static void samples_u8_to_f32(float* obuf, uint8_t* ibuf, int ichs, int samples, int skip) {
+    int s, total_samples = samples * ichs;
+    for (s = 0; s < total_samples; s++) {
+        obuf[s] = ((int)ibuf[skip*ichs + s] - 0x80) * 256.0f;
+    }
+}
+static void samples_u8p_to_f32(float* obuf, uint8_t** ibuf, int ichs, int samples, int skip) {
+    int s, ch;
+    for (ch = 0; ch < ichs; ch++) {
+        for (s = 0; s < samples; s++) {
+            obuf[s*ichs + ch] = ((int)ibuf[ch][skip + s] - 0x80) * 256.0f;
+        }
+    }
+}
+static void samples_s16_to_f32(float* obuf, int16_t* ibuf, int ichs, int samples, int skip) {
+    int s, total_samples = samples * ichs;
+    for (s = 0; s < total_samples; s++) {
+        obuf[s] = ibuf[skip*ichs + s];
+    }
+}
+static void samples_s16p_to_f32(float* obuf, int16_t** ibuf, int ichs, int samples, int skip) {
+    int s, ch;
+    for (ch = 0; ch < ichs; ch++) {
+        for (s = 0; s < samples; s++) {
+            obuf[s*ichs + ch] = ibuf[ch][skip + s];
+        }
+    }
+}
+static void samples_s32_to_f32(float* obuf, int32_t* ibuf, int ichs, int samples, int skip) {
+    int s, total_samples = samples * ichs;
+    for (s = 0; s < total_samples; s++) {
+        obuf[s] = ibuf[skip*ichs + s] / 65536.0f;
+    }
+}
+static void samples_s32p_to_f32(float* obuf, int32_t** ibuf, int ichs, int samples, int skip) {
+    int s, ch;
+    for (ch = 0; ch < ichs; ch++) {
+        for (s = 0; s < samples; s++) {
+            obuf[s*ichs + ch] = ibuf[ch][skip + s] / 65536.0f;
+        }
+    }
+}
+static void samples_flt_to_f32(float* obuf, float* ibuf, int ichs, int samples, int skip, int invert) {
+    int s, total_samples = samples * ichs;
+    float scale = invert ? -32768.0f : 32768.0f;
+    for (s = 0; s < total_samples; s++) {
+        obuf[s] = ibuf[skip*ichs + s] * scale;
+    }
+}
+static void samples_fltp_to_f32(float* obuf, float** ibuf, int ichs, int samples, int skip, int invert) {
+    int s, ch;
+    float scale = invert ? -32768.0f : 32768.0f;
+    for (ch = 0; ch < ichs; ch++) {
+        for (s = 0; s < samples; s++) {
+            obuf[s*ichs + ch] = ibuf[ch][skip + s] * scale;
+        }
+    }
+}
+static void samples_dbl_to_f32(float* obuf, double* ibuf, int ichs, int samples, int skip) {
+    int s, total_samples = samples * ichs;
+    for (s = 0; s < total_samples; s++) {
+        obuf[s] = ibuf[skip*ichs + s] * 32768.0;
+    }
+}
+static void samples_dblp_to_f32(float* obuf, double** inbuf, int ichs, int samples, int skip) {
+    int s, ch;
+    for (ch = 0; ch < ichs; ch++) {
+        for (s = 0; s < samples; s++) {
+            obuf[s*ichs + ch] = inbuf[ch][skip + s] * 32768.0;
+        }
+    }
+}
+
+static void copy_samples_f32(ffmpeg_codec_data* data, float* outbuf, int samples_to_do) {
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(59, 24, 100)
+    int channels = data->codecCtx->channels;
+#else
+    int channels = data->codecCtx->ch_layout.nb_channels;
+#endif
+    int is_planar = av_sample_fmt_is_planar(data->codecCtx->sample_fmt) && (channels > 1);
+    void* ibuf;
+
+    if (is_planar) {
+        ibuf = data->frame->extended_data;
+    }
+    else {
+        ibuf = data->frame->data[0];
+    }
+
+    switch (data->codecCtx->sample_fmt) {
+        case AV_SAMPLE_FMT_U8P:  if (is_planar) { samples_u8p_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break; }
+        case AV_SAMPLE_FMT_U8:   samples_u8_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break;
+        case AV_SAMPLE_FMT_S16P: if (is_planar) { samples_s16p_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break; }
+        case AV_SAMPLE_FMT_S16:  samples_s16_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break;
+        case AV_SAMPLE_FMT_S32P: if (is_planar) { samples_s32p_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break; }
+        case AV_SAMPLE_FMT_S32:  samples_s32_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break;
+        case AV_SAMPLE_FMT_FLTP: if (is_planar) { samples_fltp_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed, data->invert_floats_set); break; }
+        case AV_SAMPLE_FMT_FLT:  samples_flt_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed, data->invert_floats_set); break;
+        case AV_SAMPLE_FMT_DBLP: if (is_planar) { samples_dblp_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break; }
+        case AV_SAMPLE_FMT_DBL:  samples_dbl_to_f32(outbuf, ibuf, channels, samples_to_do, data->samples_consumed); break;
+        default:
+            break;
+    }
+
+    if (data->channel_remap_set)
+        remap_audio_f32(outbuf, samples_to_do, channels, data->channel_remap);
+}
+
 static void copy_samples(ffmpeg_codec_data* data, sample_t* outbuf, int samples_to_do) {
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(59, 24, 100)
     int channels = data->codecCtx->channels;
@@ -778,8 +906,8 @@ static void copy_samples(ffmpeg_codec_data* data, sample_t* outbuf, int samples_
         remap_audio(outbuf, samples_to_do, channels, data->channel_remap);
 }
 
-/* decode samples of any kind of FFmpeg format */
-void decode_ffmpeg(VGMSTREAM* vgmstream, sample_t* outbuf, int32_t samples_to_do, int channels) {
+/* decode samples of any kind of FFmpeg format, to outbuf or outbuf_f32 (whichever is set) */
+static void decode_ffmpeg_internal(VGMSTREAM* vgmstream, sample_t* outbuf, float* outbuf_f32, int32_t samples_to_do, int channels) {
     ffmpeg_codec_data* data = vgmstream->codec_data;
 
 
@@ -800,10 +928,16 @@ void decode_ffmpeg(VGMSTREAM* vgmstream, sample_t* outbuf, int32_t samples_to_do
                 if (samples_to_get > samples_to_do)
                     samples_to_get = samples_to_do;
 
-                copy_samples(data, outbuf, samples_to_get);
+                if (outbuf_f32) {
+                    copy_samples_f32(data, outbuf_f32, samples_to_get);
+                    outbuf_f32 += samples_to_get * channels;
+                }
+                else {
+                    copy_samples(data, outbuf, samples_to_get);
+                    outbuf += samples_to_get * channels;
+                }
 
                 samples_to_do -= samples_to_get;
-                outbuf += samples_to_get * channels;
             }
 
             /* mark consumed samples */
@@ -819,7 +953,18 @@ void decode_ffmpeg(VGMSTREAM* vgmstream, sample_t* outbuf, int32_t samples_to_do
 
 decode_fail:
     VGM_LOG("FFMPEG: decode fail, missing %i samples\n", samples_to_do);
-    samples_silence_s16(outbuf, channels, samples_to_do);
+    if (outbuf_f32)
+        memset(outbuf_f32, 0, samples_to_do * channels * sizeof(float));
+    else
+        samples_silence_s16(outbuf, channels, samples_to_do);
+}
+
+void decode_ffmpeg(VGMSTREAM* vgmstream, sample_t* outbuf, int32_t samples_to_do, int channels) {
+    decode_ffmpeg_internal(vgmstream, outbuf, NULL, samples_to_do, channels);
+}
+
+void decode_ffmpeg_f32(VGMSTREAM* vgmstream, float* outbuf, int32_t samples_to_do, int channels) {
+    decode_ffmpeg_internal(vgmstream, NULL, outbuf, samples_to_do, channels);
 }
 
 
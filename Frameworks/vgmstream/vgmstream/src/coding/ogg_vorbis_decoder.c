@@ -26,6 +26,7 @@ struct ogg_vorbis_codec_data {
 
 
 static void pcm_convert_float_to_16(int channels, sample_t* outbuf, int start_sample, int samples_to_do, float** pcm, int disable_ordering);
+static void pcm_convert_float_to_f32(int channels, float* outbuf, int start_sample, int samples_to_do, float** pcm, int disable_ordering);
 
 static size_t ov_read_func(void* ptr, size_t size, size_t nmemb, void* datasource);
 static int ov_seek_func(void* datasource, ogg_int64_t offset, int whence);
@@ -177,7 +178,8 @@ static int ov_close_func(void* datasource) {
 
 /* ********************************************** */
 
-void decode_ogg_vorbis(ogg_vorbis_codec_data* data, sample_t* outbuf, int32_t samples_to_do, int channels) {
+/* decodes to outbuf or outbuf_f32 (whichever is set) */
+static void decode_ogg_vorbis_internal(ogg_vorbis_codec_data* data, sample_t* outbuf, float* outbuf_f32, int32_t samples_to_do, int channels) {
     int samples_done = 0;
     long start, rc;
     float** pcm_channels; /* pointer to Xiph's double array buffer */
@@ -203,9 +205,14 @@ void decode_ogg_vorbis(ogg_vorbis_codec_data* data, sample_t* outbuf, int32_t sa
             start = 0;
         }
 
-        pcm_convert_float_to_16(channels, outbuf, start, rc, pcm_channels, data->disable_reordering);
-
-        outbuf += (rc - start) * channels;
+        if (outbuf_f32) {
+            pcm_convert_float_to_f32(channels, outbuf_f32, start, rc, pcm_channels, data->disable_reordering);
+            outbuf_f32 += (rc - start) * channels;
+        }
+        else {
+            pcm_convert_float_to_16(channels, outbuf, start, rc, pcm_channels, data->disable_reordering);
+            outbuf += (rc - start) * channels;
+        }
         samples_done += (rc - start);
 
 
@@ -232,7 +239,18 @@ void decode_ogg_vorbis(ogg_vorbis_codec_data* data, sample_t* outbuf, int32_t sa
     return;
 fail:
     VGM_LOG("OGG: error %lx during decode\n", rc);
-    memset(outbuf, 0, (samples_to_do - samples_done) * channels * sizeof(sample));
+    if (outbuf_f32)
+        memset(outbuf_f32, 0, (samples_to_do - samples_done) * channels * sizeof(float));
+    else
+        memset(outbuf, 0, (samples_to_do - samples_done) * channels * sizeof(sample));
+}
+
+void decode_ogg_vorbis(ogg_vorbis_codec_data* data, sample_t* outbuf, int32_t samples_to_do, int channels) {
+    decode_ogg_vorbis_internal(data, outbuf, NULL, samples_to_do, channels);
+}
+
+void decode_ogg_vorbis_f32(ogg_vorbis_codec_data* data, float* outbuf, int32_t samples_to_do, int channels) {
+    decode_ogg_vorbis_internal(data, NULL, outbuf, samples_to_do, channels);
 }
 
 /* vorbis encodes channels in non-standard order, so we remap during conversion to fix this oddity.
@@ -274,6 +292,25 @@ static void pcm_convert_float_to_16(int channels, sample_t* outbuf, int start_sa
     }
 }
 
+/* same but keeping floats (scaled to 16-bit range but not clamped) */
+static void pcm_convert_float_to_f32(int channels, float* outbuf, int start_sample, int samples_to_do, float** pcm, int disable_ordering) {
+    int ch, s, ch_map;
+    float *ptr;
+    float *channel;
+
+    for (ch = 0; ch < channels; ch++) {
+        ch_map = disable_ordering ?
+                ch :
+                (channels > 8) ? ch : xiph_channel_map[channels - 1][ch];
+        ptr = outbuf + ch;
+        channel = pcm[ch_map];
+        for (s = start_sample; s < samples_to_do; s++) {
+            *ptr = channel[s] * 32768.0f;
+            ptr += channels;
+        }
+    }
+}
+
 /* ********************************************** */
 
 void reset_ogg_vorbis(ogg_vorbis_codec_data* data) {
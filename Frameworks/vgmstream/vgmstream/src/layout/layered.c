@@ -79,9 +79,19 @@ decode_fail:
 void seek_layout_layered(VGMSTREAM* vgmstream, int32_t seek_sample) {
     int layer;
     layered_layout_data* data = vgmstream->layout_data;
-
-    for (layer = 0; layer < data->layer_count; layer++) {
-        seek_vgmstream(data->layers[layer], seek_sample);
+    int32_t seek_relative = seek_sample - vgmstream->current_sample;
+
+    /* each layer seeks on its own (only decoding itself, and sub-layouts may seek faster too),
+     * though layers aren't decoded past the end */
+    for (layer = 0; layer < data->layer_count && seek_sample < vgmstream->num_samples; layer++) {
+        VGMSTREAM* layer_vgmstream = data->layers[layer];
+
+        /* layers with config use the layout's position, while internal loops may be a bit off vs the layout's
+         * so moving forward must advance the same samples as decoding would */
+        if (layer_vgmstream->config_enabled || seek_relative < 0)
+            seek_vgmstream(layer_vgmstream, seek_sample);
+        else
+            seek_vgmstream(layer_vgmstream, layer_vgmstream->current_sample + seek_relative);
     }
 
     vgmstream->current_sample = seek_sample;
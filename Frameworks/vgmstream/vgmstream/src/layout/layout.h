@@ -53,6 +53,7 @@ void block_update_tt_ad(off_t block_offset, VGMSTREAM* vgmstream);
 void render_vgmstream_interleave(sample_t* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
 
 void render_vgmstream_flat(sample_t* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
+void render_vgmstream_flat_f32(float* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
 
 void render_vgmstream_segmented(sample_t* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
 segmented_layout_data* init_layout_segmented(int segment_count);
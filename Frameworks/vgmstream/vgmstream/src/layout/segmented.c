@@ -116,30 +116,43 @@ static inline void copy_samples(sample_t* outbuf, segmented_layout_data* data, i
 
 
 void seek_layout_segmented(VGMSTREAM* vgmstream, int32_t seek_sample) {
-    int segment, total_samples;
+    int segment;
+    int32_t total_samples, segment_samples = 0;
     segmented_layout_data* data = vgmstream->layout_data;
 
-    segment = 0;
+    /* find segment where sample falls (or the last one's end when seeking to max, left for next loop/segment change) */
     total_samples = 0;
-    while (total_samples < vgmstream->num_samples) {
-        int32_t segment_samples = vgmstream_get_samples(data->segments[segment]);
-
-        /* find if sample falls within segment's samples */
-        if (seek_sample >= total_samples && seek_sample < total_samples + segment_samples) {
-            int32_t seek_relative = seek_sample - total_samples;
-
-            seek_vgmstream(data->segments[segment], seek_relative);
-            data->current_segment = segment;
-            vgmstream->samples_into_block = seek_relative;
+    for (segment = 0; segment < data->segment_count; segment++) {
+        segment_samples = vgmstream_get_samples(data->segments[segment]);
+        if (seek_sample < total_samples + segment_samples || segment + 1 == data->segment_count)
             break;
-        }
         total_samples += segment_samples;
-        segment++;
     }
 
     if (segment == data->segment_count) {
         VGM_LOG("SEGMENTED: can't find seek segment\n");
+        return;
     }
+
+    /* past the end (when decoding more than num_samples) */
+    if (seek_sample > total_samples + segment_samples) {
+        data->current_segment = data->segment_count;
+        vgmstream->current_sample = seek_sample;
+        return;
+    }
+
+    if (seek_sample - total_samples < segment_samples) {
+        VGMSTREAM* segment_vgmstream = data->segments[segment];
+
+        /* same as when reaching a segment while decoding, then only decodes inside */
+        if (data->current_segment >= data->segment_count || segment_vgmstream != data->segments[data->current_segment])
+            reset_vgmstream(segment_vgmstream);
+        seek_vgmstream(segment_vgmstream, seek_sample - total_samples);
+    }
+
+    data->current_segment = segment;
+    vgmstream->current_sample = seek_sample;
+    vgmstream->samples_into_block = seek_sample - total_samples;
 }
 
 void loop_layout_segmented(VGMSTREAM* vgmstream, int32_t loop_sample) {
@@ -2,6 +2,7 @@
 #include "../vgmstream.h"
 #include "reader_sf.h"
 #include "paths.h"
+#include "../base/probe_index.h"
 
 
 /* change pathname's extension to another (or add it if extensionless) */
@@ -95,6 +96,12 @@ STREAMFILE* open_streamfile_by_filename(STREAMFILE* sf, const char* filename) {
 
 /* ************************************************************************* */
 
+/* name for helpers that only use the extension, which the probe index doesn't need to know about */
+static void get_streamfile_name_for_ext(STREAMFILE* sf, char* buffer, size_t size) {
+    if (!probe_index_get_name_for_ext(sf, buffer, size))
+        sf->get_name(sf, buffer, size);
+}
+
 int check_extensions(STREAMFILE* sf, const char* cmp_exts) {
     char filename[PATH_LIMIT];
     const char* ext = NULL;
@@ -102,7 +109,7 @@ int check_extensions(STREAMFILE* sf, const char* cmp_exts) {
     const char* ststr_res = NULL;
     size_t ext_len, cmp_len;
 
-    sf->get_name(sf, filename, sizeof(filename));
+    get_streamfile_name_for_ext(sf, filename, sizeof(filename));
     ext = filename_extension(filename);
     ext_len = strlen(ext);
 
@@ -188,7 +195,7 @@ void get_streamfile_ext(STREAMFILE* sf, char* buffer, size_t size) {
     char filename[PATH_LIMIT];
     const char* extension = NULL;
 
-    get_streamfile_name(sf, filename, sizeof(filename));
+    get_streamfile_name_for_ext(sf, filename, sizeof(filename));
     extension = filename_extension(filename);
     if (!extension) {
         buffer[0] = '\n';
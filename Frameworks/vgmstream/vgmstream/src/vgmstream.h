@@ -358,6 +358,10 @@ int32_t get_vgmstream_play_samples(double looptimes, double fadeseconds, double
 /* Decode data into sample buffer. Returns < sample_count on stream end */
 int render_vgmstream(sample_t* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
 
+/* Same as render_vgmstream but with float samples in the -1.0..1.0 range (not clamped). Codecs that decode to
+ * float internally aren't quantized to 16-bit, and mixing/fades are applied over floats. */
+int render_vgmstream_f32(float* buffer, int32_t sample_count, VGMSTREAM* vgmstream);
+
 /* Seek to sample position (next render starts from that point). Use only after config is set (vgmstream_apply_config) */
 void seek_vgmstream(VGMSTREAM* vgmstream, int32_t seek_sample);
 
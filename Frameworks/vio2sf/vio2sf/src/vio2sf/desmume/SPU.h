@@ -28,7 +28,7 @@
 #include <math.h>
 #include <assert.h>
 
-#include "resampler.h"
+#include <Resampler/resampler.h>
 
 #ifdef _MSC_VER
 #define FORCEINLINE __forceinline
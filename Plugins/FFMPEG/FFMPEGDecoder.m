@@ -678,7 +678,8 @@ static void setDictionary(NSMutableDictionary *dict, NSString *tag, NSString *va
 }
 
 - (void)updateID3Metadata {
-	NSData *tag = [NSData dataWithBytes:lastReadPacket->data length:lastReadPacket->size];
+	// The reader copies out what it keeps, so the packet can back the tag directly
+	NSData *tag = [NSData dataWithBytesNoCopy:lastReadPacket->data length:lastReadPacket->size freeWhenDone:NO];
 	Class tagReader = NSClassFromString(@"TagLibID3v2Reader");
 	if(tagReader && [tagReader respondsToSelector:@selector(metadataForTag:)]) {
 		NSDictionary *_id3Metadata = [tagReader metadataForTag:tag];
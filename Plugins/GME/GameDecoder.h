@@ -22,7 +22,7 @@ extern gme_err_t readCallback(void* data, void* out, int count);
 	long fade;
 	NSString* codec;
 	
-	int16_t sampleBuffer[1024 * 2];
+	float sampleBuffer[1024 * 2];
 }
 
 - (void)setSource:(id<CogSource>)s;
@@ -69,6 +69,9 @@ gme_err_t readCallback(void *data, void *out, int count) {
 		return NO;
 	}
 
+	// Snapshot every 5 seconds so seeking backwards doesn't replay the track
+	gme_set_seek_checkpoints(emu, 5000, 32);
+
 	[source seek:0 whence:SEEK_END];
 	long size = [source tell];
 	[source seek:0 whence:SEEK_SET];
@@ -163,7 +166,8 @@ gme_err_t readCallback(void *data, void *out, int count) {
 	return @{ @"bitrate": @(0),
 		      @"sampleRate": @(sampleRate),
 		      @"totalFrames": @((long)(length * (sampleRate * 0.001))),
-		      @"bitsPerSample": @(sizeof(short) * 8), // Samples are short
+		      @"bitsPerSample": @(32),
+		      @"floatingPoint": @(YES),
 		      @"channels": @(2), // output from gme_play is in stereo
 		      @"seekable": @(YES),
 		      @"endian": @"host",
@@ -192,7 +196,7 @@ gme_err_t readCallback(void *data, void *out, int count) {
 	else
 		gme_set_fade(emu, (int)(length - fade), (int)fade);
 
-	gme_play(emu, numSamples, (short int *)buf);
+	gme_play_float(emu, numSamples, (float *)buf);
 
 	// Some formats support length, but we'll add that in the future.
 	//(From gme.txt) If track length, then use it. If loop length, play for intro + loop * 2. Otherwise, default to 2.5 minutes
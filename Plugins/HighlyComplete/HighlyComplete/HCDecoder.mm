@@ -899,7 +899,8 @@ static int usf_info(void *context, const char *name, const char *value) {
 		sega_enable_dry(emulatorCore, 1);
 		sega_enable_dsp(emulatorCore, 1);
 
-		sega_enable_dsp_dynarec(emulatorCore, 0);
+		sega_enable_dsp_dynarec(emulatorCore, 1);
+		sega_prepare_dynacode(emulatorCore);
 
 		uint32_t start = *(uint32_t *)state.data;
 		size_t length = state.data_size;
@@ -1368,6 +1369,9 @@ static int usf_info(void *context, const char *name, const char *value) {
 		} else if(type == 0x25) {
 			Player *player = (Player *)emulatorCore;
 			delete player;
+		} else if(type == 0x11 || type == 0x12) {
+			sega_unprepare_dynacode(emulatorCore);
+			free(emulatorCore);
 		} else {
 			free(emulatorCore);
 		}
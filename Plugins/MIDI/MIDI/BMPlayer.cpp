@@ -17,6 +17,8 @@
 
 #define _countof(arr) (sizeof(arr) / sizeof((arr)[0]))
 
+#define BLOCK_SIZE (4096)
+
 struct Cached_SoundFont {
 	unsigned long ref_count;
 	std::chrono::steady_clock::time_point time_released;
@@ -290,10 +292,74 @@ void BMPlayer::send_sysex(const uint8_t *data, size_t size, size_t port) {
 	BASS_MIDI_StreamEvents(_stream, BASS_MIDI_EVENTS_RAW, data, static_cast<unsigned int>(size));
 }
 
+unsigned int BMPlayer::send_event_needs_time() {
+	return BLOCK_SIZE;
+}
+
 void BMPlayer::render(float *out, unsigned long count) {
+	render_queued(out, count);
+}
+
+void BMPlayer::render_chunk(float *out, unsigned long count) {
+	if(_delayedEvents.size()) {
+		// With BASS_MIDI_EVENTS_TIME, each position is relative to the event before it
+		for(size_t i = _delayedEvents.size() - 1; i > 0; --i)
+			_delayedEvents[i].pos -= _delayedEvents[i - 1].pos;
+		BASS_MIDI_StreamEvents(_stream, BASS_MIDI_EVENTS_STRUCT | BASS_MIDI_EVENTS_TIME, &_delayedEvents[0], (unsigned int)_delayedEvents.size());
+		_delayedEvents.clear();
+	}
 	BASS_ChannelGetData(_stream, out, BASS_DATA_FLOAT | (unsigned int)(count * sizeof(float) * 2));
 }
 
+bool BMPlayer::can_delay_event(uint32_t b) {
+	// Controllers and program changes stay raw, BASSMIDI tracks bank, RPN and
+	// mode state for those. Everything else maps to a single event type.
+	const unsigned command = b & 0xF0;
+	return command == 0x80 || command == 0x90 || command == 0xA0 || command == 0xD0 || command == 0xE0;
+}
+
+void BMPlayer::send_event_delayed(uint32_t b, unsigned long delay) {
+	const unsigned data1 = (b >> 8) & 0x7F;
+	const unsigned data2 = (b >> 16) & 0x7F;
+	unsigned port = (b >> 24) & 0x7F;
+	if(port > 2) port = 0;
+
+	BASS_MIDI_EVENT event;
+	event.chan = (b & 0x0F) + port * 16;
+	event.tick = 0;
+	event.pos = (unsigned int)(delay * sizeof(float) * 2);
+	switch(b & 0xF0) {
+		case 0x80:
+			event.event = MIDI_EVENT_NOTE;
+			event.param = data1;
+			break;
+
+		case 0x90:
+			event.event = MIDI_EVENT_NOTE;
+			event.param = data1 | (data2 << 8);
+			break;
+
+		case 0xA0:
+			event.event = MIDI_EVENT_KEYPRES;
+			event.param = data1 | (data2 << 8);
+			break;
+
+		case 0xD0:
+			event.event = MIDI_EVENT_CHANPRES;
+			event.param = data1;
+			break;
+
+		case 0xE0:
+			event.event = MIDI_EVENT_PITCH;
+			event.param = data1 | (data2 << 7);
+			break;
+
+		default:
+			return;
+	}
+	_delayedEvents.push_back(event);
+}
+
 void BMPlayer::setSoundFont(const char *in) {
 	sSoundFontName = in;
 	shutdown();
@@ -307,6 +373,7 @@ void BMPlayer::setFileSoundFont(const char *in) {
 void BMPlayer::shutdown() {
 	if(_stream) BASS_StreamFree(_stream);
 	_stream = NULL;
+	_delayedEvents.clear();
 	for(unsigned long i = 0; i < _soundFonts.size(); ++i) {
 		cache_close_font(_soundFonts[i]);
 	}
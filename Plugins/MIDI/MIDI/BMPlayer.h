@@ -21,9 +21,13 @@ class BMPlayer : public MIDIPlayer {
 	void setSincInterpolation(bool enable = true);
 
 	private:
+	virtual unsigned int send_event_needs_time();
 	virtual void send_event(uint32_t b);
 	virtual void send_sysex(const uint8_t* data, size_t size, size_t port);
 	virtual void render(float* out, unsigned long count);
+	virtual void render_chunk(float* out, unsigned long count);
+	virtual bool can_delay_event(uint32_t b);
+	virtual void send_event_delayed(uint32_t b, unsigned long delay);
 
 	virtual void shutdown();
 	virtual bool startup();
@@ -37,6 +41,9 @@ class BMPlayer : public MIDIPlayer {
 
 	HSTREAM _stream;
 
+	// Timestamped events for the next render_chunk
+	std::vector<BASS_MIDI_EVENT> _delayedEvents;
+
 	bool bSincInterpolation;
 };
 
@@ -1,16 +1,39 @@
 #include <assert.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "MIDIPlayer.h"
 
+// Number of stream events between seek checkpoints
+static const unsigned long seek_checkpoint_interval = 4096;
+
+static bool syx_is_reset(const uint8_t *data);
+
 MIDIPlayer::MIDIPlayer() {
 	uSamplesRemaining = 0;
 	uSampleRate = 1000;
 	uTimeCurrent = 0;
 	uTimeEnd = 0;
 	uTimeLoopStart = 0;
+	uPortCount = 1;
+	uBlockPosition = 0;
+	uBlockFilled = 0;
 	initialized = false;
 }
 
+MIDIPlayer::seek_channel_state::seek_channel_state() {
+	m_program = -1;
+	m_pitch_wheel = -1;
+	m_pressure = -1;
+	m_parameter_type = 0;
+	m_reset_controllers = false;
+	m_notes_off = false;
+	memset(m_controllers, -1, sizeof(m_controllers));
+	memset(m_notes, 0, sizeof(m_notes));
+	memset(m_released, 0, sizeof(m_released));
+}
+
 void MIDIPlayer::setSampleRate(unsigned long rate) {
 	if(mStream.size()) {
 		for(unsigned long i = 0; i < mStream.size(); i++) {
@@ -101,6 +124,8 @@ bool MIDIPlayer::Load(const midi_container &midi_file, unsigned subsong, unsigne
 			setSampleRate(rate);
 		}
 
+		build_seek_index();
+
 		return true;
 	}
 
@@ -112,23 +137,16 @@ unsigned long MIDIPlayer::Play(float *out, unsigned long count) {
 
 	if(!startup()) return 0;
 
-	unsigned long done = 0;
-
 	const unsigned int needs_block_size = send_event_needs_time();
-	unsigned int into_block = 0;
 
-	// This should be a multiple of block size, and have leftover
+	if(needs_block_size)
+		return play_blocks(out, count, needs_block_size);
+
+	unsigned long done = 0;
 
 	while(uSamplesRemaining && done < count) {
 		unsigned long todo = uSamplesRemaining;
 		if(todo > count - done) todo = count - done;
-		if(needs_block_size && todo > needs_block_size)
-			todo = needs_block_size;
-		if(todo < needs_block_size) {
-			uSamplesRemaining = 0;
-			into_block = todo;
-			break;
-		}
 		render(out + done * 2, todo);
 		uSamplesRemaining -= todo;
 		done += todo;
@@ -148,35 +166,23 @@ unsigned long MIDIPlayer::Play(float *out, unsigned long count) {
 			for(; uStreamPosition < stream_end; uStreamPosition++) {
 				const midi_stream_event &me = mStream.at(uStreamPosition);
 
-				unsigned long samples_todo = me.m_timestamp - uTimeCurrent - into_block;
+				unsigned long samples_todo = me.m_timestamp - uTimeCurrent;
 				if(samples_todo) {
 					if(samples_todo > count - done) {
 						uSamplesRemaining = samples_todo - (count - done);
 						samples_todo = count - done;
 					}
-					if(!needs_block_size && samples_todo) {
+					if(samples_todo) {
 						render(out + done * 2, samples_todo);
 						done += samples_todo;
 						uTimeCurrent += samples_todo;
 					}
 
-					if(uSamplesRemaining) {
-						uSamplesRemaining += into_block;
+					if(uSamplesRemaining)
 						return done;
-					}
 				}
 
-				if(needs_block_size) {
-					into_block += samples_todo;
-					while(into_block >= needs_block_size) {
-						render(out + done * 2, needs_block_size);
-						done += needs_block_size;
-						into_block -= needs_block_size;
-						uTimeCurrent += needs_block_size;
-					}
-					send_event_time_filtered(me.m_event, into_block);
-				} else
-					send_event_filtered(me.m_event);
+				send_event_filtered(me.m_event);
 			}
 		}
 
@@ -187,36 +193,23 @@ unsigned long MIDIPlayer::Play(float *out, unsigned long count) {
 			else
 				samples_todo = uTimeEnd;
 			samples_todo -= uTimeCurrent;
-			if(needs_block_size)
-				into_block = samples_todo;
 			if(samples_todo > count - done)
 				samples_todo = count - done;
-			if(needs_block_size && samples_todo > needs_block_size)
-				samples_todo = needs_block_size;
-			if(samples_todo >= needs_block_size) {
-				render(out + done * 2, samples_todo);
-				done += samples_todo;
-				uTimeCurrent += samples_todo;
-				if(needs_block_size)
-					into_block -= samples_todo;
-			}
+			render(out + done * 2, samples_todo);
+			done += samples_todo;
 		}
 
-		if(!needs_block_size)
-			uTimeCurrent = time_target;
+		uTimeCurrent = time_target;
 
 		if(time_target >= uTimeEnd) {
 			if(uStreamPosition < mStream.size()) {
 				for(; uStreamPosition < mStream.size(); uStreamPosition++) {
-					if(needs_block_size)
-						send_event_time_filtered(mStream.at(uStreamPosition).m_event, into_block);
-					else
-						send_event_filtered(mStream.at(uStreamPosition).m_event);
+					send_event_filtered(mStream.at(uStreamPosition).m_event);
 				}
 			}
 
 			if((uLoopMode & (loop_mode_enable | loop_mode_force)) == (loop_mode_enable | loop_mode_force)) {
-				if(uStreamLoopStart == ~0) {
+				if(uStreamLoopStart == ~0UL) {
 					uStreamPosition = 0;
 					uTimeCurrent = 0;
 				} else {
@@ -228,11 +221,92 @@ unsigned long MIDIPlayer::Play(float *out, unsigned long count) {
 		}
 	}
 
-	uSamplesRemaining = into_block;
+	return done;
+}
+
+// Renders whole blocks of the size the synthesizer asked for, timestamping
+// every event with its offset into the block, so event density no longer
+// decides how often render is called. Requests which do not fall on a block
+// boundary are served from the last block rendered.
+unsigned long MIDIPlayer::play_blocks(float *out, unsigned long count, unsigned int block_size) {
+	unsigned long done = 0;
+
+	if(mBlock.size() != block_size * 2) {
+		mBlock.resize(block_size * 2);
+		uBlockPosition = 0;
+		uBlockFilled = 0;
+	}
+
+	while(done < count) {
+		if(uBlockPosition < uBlockFilled) {
+			unsigned long todo = uBlockFilled - uBlockPosition;
+			if(todo > count - done) todo = count - done;
+			memcpy(out + done * 2, &mBlock[uBlockPosition * 2], todo * sizeof(float) * 2);
+			uBlockPosition += todo;
+			done += todo;
+			continue;
+		}
+
+		if(count - done >= block_size) {
+			const unsigned long rendered = render_block(out + done * 2, block_size);
+			if(!rendered) break;
+			done += rendered;
+		} else {
+			uBlockFilled = render_block(&mBlock[0], block_size);
+			uBlockPosition = 0;
+			if(!uBlockFilled) break;
+		}
+	}
 
 	return done;
 }
 
+unsigned long MIDIPlayer::render_block(float *out, unsigned int block_size) {
+	unsigned long filled = 0;
+
+	while(filled < block_size) {
+		if(uTimeCurrent >= uTimeEnd) {
+			// Whatever is left, such as the note offs added at the loop end, goes out right after the last frame
+			for(; uStreamPosition < mStream.size(); uStreamPosition++) {
+				send_event_time_filtered(mStream.at(uStreamPosition).m_event, (unsigned int)filled);
+			}
+
+			if((uLoopMode & (loop_mode_enable | loop_mode_force)) == (loop_mode_enable | loop_mode_force)) {
+				if(uStreamLoopStart == ~0UL) {
+					uStreamPosition = 0;
+					uTimeCurrent = 0;
+				} else {
+					uStreamPosition = uStreamLoopStart;
+					uTimeCurrent = uTimeLoopStart;
+				}
+				if(uTimeCurrent >= uTimeEnd)
+					break;
+			} else
+				break;
+		}
+
+		unsigned long todo = uTimeEnd - uTimeCurrent;
+		if(todo > block_size - filled) todo = block_size - filled;
+
+		const unsigned long time_target = todo + uTimeCurrent;
+
+		for(; uStreamPosition < mStream.size(); uStreamPosition++) {
+			const midi_stream_event &me = mStream.at(uStreamPosition);
+			if(me.m_timestamp >= time_target) break;
+			const unsigned long offset = me.m_timestamp > uTimeCurrent ? me.m_timestamp - uTimeCurrent : 0;
+			send_event_time_filtered(me.m_event, (unsigned int)(filled + offset));
+		}
+
+		filled += todo;
+		uTimeCurrent = time_target;
+	}
+
+	if(filled)
+		render(out, filled);
+
+	return filled;
+}
+
 void MIDIPlayer::Seek(unsigned long sample) {
 	if(sample >= uTimeEnd) {
 		if((uLoopMode & (loop_mode_enable | loop_mode_force)) == (loop_mode_enable | loop_mode_force)) {
@@ -242,108 +316,407 @@ void MIDIPlayer::Seek(unsigned long sample) {
 		}
 	}
 
-	if(uTimeCurrent > sample) {
-		uStreamPosition = 0;
+	mQueue.clear();
+	mQueueSysex.clear();
+	uBlockPosition = 0;
+	uBlockFilled = 0;
+
+	const unsigned long stream_target = std::lower_bound(mStream.begin(), mStream.end(), sample, [](const midi_stream_event &e, unsigned long t) { return e.m_timestamp < t; }) - mStream.begin();
 
+	std::vector<seek_channel_state> channels;
+	std::vector<uint32_t> events;
+	unsigned long stream_start;
+
+	if(uTimeCurrent > sample && mCheckpoints.size()) {
 		shutdown();
-	}
 
-	if(!startup()) return;
+		if(!startup()) return;
 
-	uTimeCurrent = sample;
+		// Restore the last checkpoint at or before the target, with every system exclusive message leading up to it
+		std::vector<seek_checkpoint>::const_iterator cp = std::upper_bound(mCheckpoints.begin(), mCheckpoints.end(), stream_target, [](unsigned long p, const seek_checkpoint &c) { return p < c.m_position; }) - 1;
+
+		channels = cp->m_channels;
+		stream_start = cp->m_position;
+
+		events.reserve(cp->m_sysex_count);
+		for(unsigned long i = 0; i < cp->m_sysex_count; i++) {
+			events.push_back(mStream.at(mSysexPositions[i]).m_event);
+		}
+	} else {
+		if(!startup()) return;
 
-	std::vector<midi_stream_event> filler;
+		channels.resize(uPortCount * 16);
+		stream_start = std::min(uStreamPosition, stream_target);
+	}
+
+	for(unsigned long i = stream_start; i < stream_target; i++) {
+		const uint32_t b = mStream.at(i).m_event;
+		if(b & 0x80000000u)
+			events.push_back(b);
+		seek_state_update(channels, b);
+	}
 
-	unsigned long stream_start = uStreamPosition;
+	seek_state_serialize(channels, events);
 
-	for(; uStreamPosition < mStream.size() && mStream.at(uStreamPosition).m_timestamp < uTimeCurrent; uStreamPosition++)
-		;
+	uTimeCurrent = sample;
+	uStreamPosition = stream_target;
 
 	if(uStreamPosition == mStream.size())
 		uSamplesRemaining = uTimeEnd - uTimeCurrent;
 	else
 		uSamplesRemaining = mStream.at(uStreamPosition).m_timestamp - uTimeCurrent;
 
-	if(uStreamPosition > stream_start) {
-		filler.resize(uStreamPosition - stream_start);
-		filler.assign(mStream.begin() + stream_start, mStream.begin() + uStreamPosition);
+	if(events.size())
+		send_seek_events(events);
+}
+
+void MIDIPlayer::build_seek_index() {
+	mSysexPositions.clear();
+	mCheckpoints.clear();
+
+	uPortCount = 1;
+	for(unsigned long i = 0; i < mStream.size(); i++) {
+		const uint32_t b = mStream.at(i).m_event;
+		size_t port;
+		if(b & 0x80000000u) {
+			const uint8_t *p_data;
+			size_t p_size;
+			mSysexMap.get_entry(b & 0xffffff, p_data, p_size, port);
+		} else {
+			port = (b >> 24) & 0x7F;
+		}
+		if(port >= uPortCount)
+			uPortCount = port + 1;
+	}
+
+	std::vector<seek_channel_state> channels(uPortCount * 16);
 
-		unsigned long i, j;
+	for(unsigned long i = 0; i < mStream.size(); i++) {
+		if(!(i % seek_checkpoint_interval)) {
+			seek_checkpoint cp;
+			cp.m_position = i;
+			cp.m_sysex_count = mSysexPositions.size();
+			cp.m_channels = channels;
+			mCheckpoints.push_back(cp);
+		}
 
-		for(i = 0, stream_start = uStreamPosition - stream_start; i < stream_start; i++) {
-			midi_stream_event &e = filler.at(i);
-			if((e.m_event & 0x800000F0) == 0x90 && (e.m_event & 0xFF0000)) // note on
-			{
-				if((e.m_event & 0x0F) == 9) // hax
-				{
-					e.m_event = 0;
-					continue;
-				}
-				const uint32_t m = (e.m_event & 0x7F00FF0F) | 0x80; // note off
-				const uint32_t m2 = (e.m_event & 0x7F00FFFF); // also note off
-				for(j = i + 1; j < stream_start; j++) {
-					midi_stream_event &e2 = filler.at(j);
-					if((e2.m_event & 0xFF00FFFF) == m || e2.m_event == m2) {
-						// kill 'em
-						e.m_event = 0;
-						e2.m_event = 0;
+		const uint32_t b = mStream.at(i).m_event;
+		if(b & 0x80000000u)
+			mSysexPositions.push_back(i);
+		seek_state_update(channels, b);
+	}
+}
+
+void MIDIPlayer::seek_state_update(std::vector<seek_channel_state> &channels, uint32_t b) {
+	if(b & 0x80000000u) {
+		// A reset message discards everything sent to its port so far
+		const uint8_t *p_data;
+		size_t p_size, p_port;
+		mSysexMap.get_entry(b & 0xffffff, p_data, p_size, p_port);
+		if(syx_is_reset(p_data)) {
+			for(size_t i = p_port * 16; i < p_port * 16 + 16 && i < channels.size(); i++)
+				channels[i] = seek_channel_state();
+		}
+		return;
+	}
+
+	const size_t index = ((b >> 24) & 0x7F) * 16 + (b & 0x0F);
+	if(index >= channels.size())
+		return;
+
+	seek_channel_state &c = channels[index];
+	const uint8_t d1 = (b >> 8) & 0x7F;
+	const uint8_t d2 = (b >> 16) & 0x7F;
+
+	switch(b & 0xF0) {
+		case 0x90:
+			if(d2) {
+				c.m_notes[d1] = d2;
+				break;
+			}
+			// fall through
+
+		case 0x80:
+			if(c.m_notes[d1])
+				c.m_notes[d1] = 0;
+			else
+				c.m_released[d1 >> 3] |= 1 << (d1 & 7);
+			break;
+
+		case 0xB0:
+			switch(d1) {
+				case 6:
+				case 38:
+				case 96:
+				case 97: {
+					if(!c.m_parameter_type)
 						break;
+					uint16_t number;
+					if(c.m_parameter_type == 1)
+						number = ((c.m_controllers[101] & 0x7F) << 7) | (c.m_controllers[100] & 0x7F);
+					else
+						number = 0x4000 | ((c.m_controllers[99] & 0x7F) << 7) | (c.m_controllers[98] & 0x7F);
+					if((number & 0x3FFF) == 0x3FFF) // null parameter
+						break;
+					std::vector<seek_parameter>::iterator p = c.m_parameters.begin();
+					while(p != c.m_parameters.end() && p->m_number != number) ++p;
+					if(p == c.m_parameters.end()) {
+						seek_parameter param = { number, -1, -1 };
+						p = c.m_parameters.insert(p, param);
 					}
+					if(d1 == 6)
+						p->m_data_msb = d2;
+					else if(d1 == 38)
+						p->m_data_lsb = d2;
+					else if(d1 == 96 && p->m_data_msb >= 0 && p->m_data_msb < 127)
+						p->m_data_msb++;
+					else if(d1 == 97 && p->m_data_msb > 0)
+						p->m_data_msb--;
+					break;
 				}
+
+				case 98:
+				case 99:
+					c.m_controllers[d1] = d2;
+					c.m_parameter_type = 2;
+					break;
+
+				case 100:
+				case 101:
+					c.m_controllers[d1] = d2;
+					c.m_parameter_type = 1;
+					break;
+
+				case 120:
+				case 123:
+				case 124:
+				case 125:
+				case 126:
+				case 127:
+					c.m_notes_off = true;
+					memset(c.m_notes, 0, sizeof(c.m_notes));
+					memset(c.m_released, 0, sizeof(c.m_released));
+					break;
+
+				case 121:
+					// Reset All Controllers leaves bank, volume, pan and effect depths alone
+					for(unsigned int i = 1; i < 120; i++) {
+						if(i != 7 && i != 10 && i != 32 && (i < 91 || i > 95))
+							c.m_controllers[i] = -1;
+					}
+					c.m_parameter_type = 0;
+					c.m_pitch_wheel = -1;
+					c.m_pressure = -1;
+					c.m_reset_controllers = true;
+					break;
+
+				case 122:
+					break;
+
+				default:
+					c.m_controllers[d1] = d2;
+					break;
 			}
+			break;
+
+		case 0xC0:
+			c.m_program = d1;
+			break;
+
+		case 0xD0:
+			c.m_pressure = d1;
+			break;
+
+		case 0xE0:
+			c.m_pitch_wheel = d1 | (d2 << 7);
+			break;
+	}
+}
+
+void MIDIPlayer::seek_state_serialize(const std::vector<seek_channel_state> &channels, std::vector<uint32_t> &out) {
+	static const uint8_t select_rpn_last[] = { 99, 98, 101, 100 };
+	static const uint8_t select_nrpn_last[] = { 101, 100, 99, 98 };
+
+	for(size_t index = 0; index < channels.size(); index++) {
+		const seek_channel_state &c = channels[index];
+		const uint32_t base = static_cast<uint32_t>(((index >> 4) << 24) | (index & 0x0F));
+		unsigned int i;
+
+		if(c.m_notes_off)
+			out.push_back(base | 0xB0 | (123 << 8));
+
+		for(i = 0; i < 128; i++) {
+			if(c.m_released[i >> 3] & (1 << (i & 7)))
+				out.push_back(base | 0x80 | (i << 8));
 		}
 
-		float *temp;
-		const unsigned int needs_time = send_event_needs_time();
-
-		if(needs_time) {
-			temp = new float[needs_time * 2];
-			if(temp) {
-				render(temp, needs_time); // flush events
-				unsigned int render_junk = 0;
-				bool timestamp_set = false;
-				unsigned last_timestamp = 0;
-				for(i = 0; i < stream_start; i++) {
-					if(filler[i].m_event) {
-						send_event_time_filtered(filler[i].m_event, render_junk);
-						if(timestamp_set) {
-							if(filler[i].m_timestamp != last_timestamp) {
-								render_junk += 16;
-							}
-						}
-						last_timestamp = filler[i].m_timestamp;
-						timestamp_set = true;
-						if(render_junk >= needs_time) {
-							render(temp, needs_time);
-							render_junk -= needs_time;
-						}
-					}
-				}
-				render(temp, needs_time);
-				delete[] temp;
+		if(c.m_reset_controllers)
+			out.push_back(base | 0xB0 | (121 << 8));
+
+		if(c.m_controllers[0] >= 0)
+			out.push_back(base | 0xB0 | (c.m_controllers[0] << 16));
+		if(c.m_controllers[32] >= 0)
+			out.push_back(base | 0xB0 | (32 << 8) | (c.m_controllers[32] << 16));
+		if(c.m_program >= 0)
+			out.push_back(base | 0xC0 | (c.m_program << 8));
+
+		for(i = 1; i < 120; i++) {
+			if(i == 6 || i == 32 || i == 38 || (i >= 96 && i <= 101))
+				continue;
+			if(c.m_controllers[i] >= 0)
+				out.push_back(base | 0xB0 | (i << 8) | (c.m_controllers[i] << 16));
+		}
+
+		for(std::vector<seek_parameter>::const_iterator p = c.m_parameters.begin(); p != c.m_parameters.end(); ++p) {
+			const uint32_t msb = (p->m_number >> 7) & 0x7F;
+			const uint32_t lsb = p->m_number & 0x7F;
+			if(p->m_number & 0x4000) {
+				out.push_back(base | 0xB0 | (99 << 8) | (msb << 16));
+				out.push_back(base | 0xB0 | (98 << 8) | (lsb << 16));
+			} else {
+				out.push_back(base | 0xB0 | (101 << 8) | (msb << 16));
+				out.push_back(base | 0xB0 | (100 << 8) | (lsb << 16));
 			}
-		} else {
-			temp = new float[16 * 2];
-			if(temp) {
-				render(temp, 16);
-				bool timestamp_set = false;
-				unsigned last_timestamp = 0;
-				for(i = 0; i < stream_start; i++) {
-					if(filler[i].m_event) {
-						if(timestamp_set) {
-							if(filler[i].m_timestamp != last_timestamp) {
-								render(temp, 16);
-							}
-						}
-						last_timestamp = filler[i].m_timestamp;
-						timestamp_set = true;
-						send_event_filtered(filler[i].m_event);
-					}
+			if(p->m_data_msb >= 0)
+				out.push_back(base | 0xB0 | (6 << 8) | (p->m_data_msb << 16));
+			if(p->m_data_lsb >= 0)
+				out.push_back(base | 0xB0 | (38 << 8) | (p->m_data_lsb << 16));
+		}
+
+		// Leave the parameter selection as the stream left it
+		if(c.m_parameter_type) {
+			const uint8_t *select = c.m_parameter_type == 2 ? select_nrpn_last : select_rpn_last;
+			for(i = 0; i < 4; i++) {
+				if(c.m_controllers[select[i]] >= 0)
+					out.push_back(base | 0xB0 | (select[i] << 8) | (c.m_controllers[select[i]] << 16));
+			}
+		} else if(c.m_parameters.size()) {
+			out.push_back(base | 0xB0 | (101 << 8) | (127 << 16));
+			out.push_back(base | 0xB0 | (100 << 8) | (127 << 16));
+		}
+
+		if(c.m_pitch_wheel >= 0)
+			out.push_back(base | 0xE0 | ((c.m_pitch_wheel & 0x7F) << 8) | ((c.m_pitch_wheel >> 7) << 16));
+		if(c.m_pressure >= 0)
+			out.push_back(base | 0xD0 | (c.m_pressure << 8));
+
+		// Notes still held at the target, except drums
+		if((index & 0x0F) != 9) {
+			for(i = 0; i < 128; i++) {
+				if(c.m_notes[i])
+					out.push_back(base | 0x90 | (i << 8) | (c.m_notes[i] << 16));
+			}
+		}
+	}
+}
+
+void MIDIPlayer::send_seek_events(const std::vector<uint32_t> &events) {
+	const unsigned int needs_time = send_event_needs_time();
+	const unsigned int block_size = needs_time ? needs_time : 16;
+
+	std::vector<float> temp(block_size * 2);
+
+	render(&temp[0], block_size); // flush events
+
+	unsigned int render_junk = 0;
+	for(std::vector<uint32_t>::const_iterator it = events.begin(); it != events.end(); ++it) {
+		const uint32_t b = *it;
+		if(needs_time)
+			send_event_time_filtered(b, render_junk);
+		else
+			send_event_filtered(b);
+
+		// Give the synthesizer time to act on each system exclusive message
+		if(b & 0x80000000u) {
+			if(needs_time) {
+				render_junk += 16;
+				if(render_junk >= needs_time) {
+					render(&temp[0], needs_time);
+					render_junk -= needs_time;
 				}
-				render(temp, 16);
-				delete[] temp;
+			} else {
+				render(&temp[0], 16);
+			}
+		}
+	}
+
+	render(&temp[0], block_size);
+}
+
+void MIDIPlayer::send_event_time(uint32_t b, unsigned int time) {
+	queued_event e;
+	e.m_time = time;
+	e.m_event = b;
+	e.m_port = 0;
+	e.m_sysex_offset = 0;
+	e.m_sysex_size = 0;
+	if(mQueue.size() && e.m_time < mQueue.back().m_time)
+		e.m_time = mQueue.back().m_time;
+	mQueue.push_back(e);
+}
+
+void MIDIPlayer::send_sysex_time(const uint8_t *event, size_t size, size_t port, unsigned int time) {
+	// The data may be a temporary, such as the messages built by sysex_reset_sc
+	queued_event e;
+	e.m_time = time;
+	e.m_event = 0;
+	e.m_port = port;
+	e.m_sysex_offset = mQueueSysex.size();
+	e.m_sysex_size = size;
+	if(mQueue.size() && e.m_time < mQueue.back().m_time)
+		e.m_time = mQueue.back().m_time;
+	mQueueSysex.insert(mQueueSysex.end(), event, event + size);
+	mQueue.push_back(e);
+}
+
+void MIDIPlayer::render_queued(float *out, unsigned long count, unsigned int granularity) {
+	unsigned long done = 0;
+	size_t i = 0;
+
+	while(done < count) {
+		for(; i < mQueue.size(); i++) {
+			const queued_event &e = mQueue[i];
+			const unsigned long time = e.m_time - e.m_time % granularity;
+			if(time > done) break;
+			if(e.m_sysex_size)
+				send_sysex(&mQueueSysex[e.m_sysex_offset], e.m_sysex_size, e.m_port);
+			else
+				send_event(e.m_event);
+		}
+
+		// The chunk ends at the next event which has to be sent as it happens
+		unsigned long next = count;
+		for(size_t j = i; j < mQueue.size(); j++) {
+			const queued_event &e = mQueue[j];
+			const unsigned long time = e.m_time - e.m_time % granularity;
+			if(time >= count) break;
+			if(e.m_sysex_size || !can_delay_event(e.m_event)) {
+				next = time;
+				break;
 			}
 		}
+
+		// Everything before it is scheduled, events at the same offset go out with it, in order
+		for(; i < mQueue.size(); i++) {
+			const queued_event &e = mQueue[i];
+			const unsigned long time = e.m_time - e.m_time % granularity;
+			if(time >= next) break;
+			send_event_delayed(e.m_event, time - done);
+		}
+
+		render_chunk(out + done * 2, next - done);
+		done = next;
+	}
+
+	// Anything timed past this block is kept for the next one
+	if(i < mQueue.size()) {
+		mQueue.erase(mQueue.begin(), mQueue.begin() + i);
+		for(i = 0; i < mQueue.size(); i++) {
+			mQueue[i].m_time = mQueue[i].m_time > count ? (unsigned int)(mQueue[i].m_time - count) : 0;
+		}
+	} else {
+		mQueue.clear();
+		mQueueSysex.clear();
 	}
 }
 
@@ -423,7 +796,7 @@ void MIDIPlayer::sysex_send_gs(size_t port, uint8_t *data, size_t size, unsigned
 		checksum += data[i];
 	checksum = (128 - checksum) & 127;
 	data[i] = checksum;
-	if(time)
+	if(time || send_event_needs_time())
 		send_sysex_time(data, size, port, time);
 	else
 		send_sysex(data, size, port);
@@ -473,7 +846,10 @@ void MIDIPlayer::sysex_reset_sc(uint32_t port, unsigned int time) {
 
 void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 	if(initialized) {
-		if(time) {
+		// Synthesizers rendering in blocks get these in order with the events around them
+		const bool timed = time || send_event_needs_time();
+
+		if(timed) {
 			send_sysex_time(&syx_reset_xg[0], sizeof(syx_reset_xg), port, time);
 			send_sysex_time(&syx_reset_gm2[0], sizeof(syx_reset_gm2), port, time);
 			send_sysex_time(&syx_reset_gm[0], sizeof(syx_reset_gm), port, time);
@@ -494,7 +870,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 				break;
 
 			case filter_gm2:
-				if(time)
+				if(timed)
 					send_sysex_time(&syx_reset_gm2[0], sizeof(syx_reset_gm2), port, time);
 				else
 					send_sysex(&syx_reset_gm2[0], sizeof(syx_reset_gm2), port);
@@ -505,7 +881,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 			case filter_sc88pro:
 			case filter_sc8850:
 			case filter_default:
-				if(time)
+				if(timed)
 					send_sysex_time(&syx_reset_gs[0], sizeof(syx_reset_gs), port, time);
 				else
 					send_sysex(&syx_reset_gs[0], sizeof(syx_reset_gs), port);
@@ -513,7 +889,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 				break;
 
 			case filter_xg:
-				if(time)
+				if(timed)
 					send_sysex_time(&syx_reset_xg[0], sizeof(syx_reset_xg), port, time);
 				else
 					send_sysex(&syx_reset_xg[0], sizeof(syx_reset_xg), port);
@@ -523,7 +899,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 		{
 			unsigned int i;
 			for(i = 0; i < 16; ++i) {
-				if(time) {
+				if(timed) {
 					send_event_time(0x78B0 + i + (port << 24), time);
 					send_event_time(0x79B0 + i + (port << 24), time);
 					if(mode != filter_xg || i != 9) {
@@ -544,7 +920,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 		}
 
 		if(mode == filter_xg) {
-			if(time) {
+			if(timed) {
 				send_event_time(0x20B9 + (port << 24), time);
 				send_event_time(0x7F00B9 + (port << 24), time);
 				send_event_time(0xC9 + (port << 24), time);
@@ -557,7 +933,7 @@ void MIDIPlayer::sysex_reset(size_t port, unsigned int time) {
 
 		if(reverb_chorus_disabled) {
 			unsigned int i;
-			if(time) {
+			if(timed) {
 				for(i = 0; i < 16; ++i) {
 					send_event_time(0x5BB0 + i + (port << 24), time);
 					send_event_time(0x5DB0 + i + (port << 24), time);
@@ -59,8 +59,28 @@ class MIDIPlayer {
 	}
 
 	// time should only be block level offset
-	virtual void send_event_time(uint32_t b, unsigned int time){};
-	virtual void send_sysex_time(const uint8_t* event, size_t size, size_t port, unsigned int time){};
+	// by default these queue the event for render_queued
+	virtual void send_event_time(uint32_t b, unsigned int time);
+	virtual void send_sysex_time(const uint8_t* event, size_t size, size_t port, unsigned int time);
+
+	// For synthesizers which only take events as they happen: renders the
+	// block with render_chunk, split wherever queued events fall, and sends
+	// each event before the chunk it lands in. Offsets are rounded down to a
+	// multiple of granularity, for synthesizers which only apply events at
+	// their own block boundaries anyway.
+	void render_queued(float* out, unsigned long count, unsigned int granularity = 1);
+	virtual void render_chunk(float* out, unsigned long count) {
+	}
+
+	// For synthesizers which can schedule some events themselves: events
+	// accepted by can_delay_event are handed to send_event_delayed with their
+	// offset from the current render position, and only the others split
+	// the block.
+	virtual bool can_delay_event(uint32_t b) {
+		return false;
+	}
+	virtual void send_event_delayed(uint32_t b, unsigned long delay) {
+	}
 
 	unsigned long uSampleRate;
 	system_exclusive_table mSysexMap;
@@ -79,6 +99,58 @@ class MIDIPlayer {
 	void sysex_send_gs(size_t port, uint8_t* data, size_t size, unsigned int time);
 	void sysex_reset_sc(uint32_t port, unsigned int time);
 
+	// Channel state accumulated while seeking, replayed in place of the event stream
+	struct seek_parameter {
+		uint16_t m_number; // bit 14 set for NRPN, then MSB << 7 | LSB
+		int8_t m_data_msb;
+		int8_t m_data_lsb;
+	};
+
+	struct seek_channel_state {
+		int16_t m_program;
+		int16_t m_pitch_wheel;
+		int8_t m_pressure;
+		int8_t m_parameter_type; // 0 = none, 1 = RPN, 2 = NRPN
+		bool m_reset_controllers;
+		bool m_notes_off;
+		int8_t m_controllers[128];
+		uint8_t m_notes[128];
+		uint8_t m_released[16];
+		std::vector<seek_parameter> m_parameters;
+
+		seek_channel_state();
+	};
+
+	struct seek_checkpoint {
+		unsigned long m_position;
+		unsigned long m_sysex_count;
+		std::vector<seek_channel_state> m_channels;
+	};
+
+	void build_seek_index();
+	void seek_state_update(std::vector<seek_channel_state>& channels, uint32_t b);
+	void seek_state_serialize(const std::vector<seek_channel_state>& channels, std::vector<uint32_t>& out);
+	void send_seek_events(const std::vector<uint32_t>& events);
+
+	unsigned long play_blocks(float* out, unsigned long count, unsigned int block_size);
+	unsigned long render_block(float* out, unsigned int block_size);
+
+	struct queued_event {
+		unsigned int m_time;
+		uint32_t m_event;
+		size_t m_port;
+		size_t m_sysex_offset;
+		size_t m_sysex_size; // system exclusive if non-zero, stored in mQueueSysex
+	};
+
+	std::vector<queued_event> mQueue;
+	std::vector<uint8_t> mQueueSysex;
+
+	// Output of the last fixed size block not yet returned by Play
+	std::vector<float> mBlock;
+	unsigned long uBlockPosition;
+	unsigned long uBlockFilled;
+
 	unsigned long uSamplesRemaining;
 
 	unsigned uLoopMode;
@@ -92,6 +164,10 @@ class MIDIPlayer {
 	unsigned long uStreamLoopStart;
 	unsigned long uTimeLoopStart;
 	unsigned long uStreamEnd;
+
+	unsigned long uPortCount;
+	std::vector<unsigned long> mSysexPositions;
+	std::vector<seek_checkpoint> mCheckpoints;
 };
 
 #endif
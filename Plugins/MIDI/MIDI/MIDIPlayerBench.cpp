@@ -0,0 +1,190 @@
+// Counts render calls and CPU time per second of audio for MIDIPlayer, with
+// events delivered one render call at a time and in fixed blocks of each
+// size, using the Doom OPL synth. Not part of the project, build it by hand:
+//
+// c++ -std=c++11 -O2 -I../../../Frameworks/midi_processing -I. -o MIDIPlayerBench
+//     MIDIPlayerBench.cpp MIDIPlayer.cpp MSPlayer.cpp resampler.c
+//     synthlib_doom/i_oplmusic.cpp synthlib_opl3w/opl3midi.cpp fmopl3lib/*.cpp
+//     ../../../Frameworks/midi_processing/midi_processing/*.cpp
+//
+// ./MIDIPlayerBench [file.mid]
+//
+// Without a file it plays a minute of drum rolls and controller sweeps.
+//
+// Block-rendered output has to match per-event output exactly, the bench
+// fails if any sample differs.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include <midi_processing/midi_processor.h>
+
+#include "MSPlayer.h"
+
+class BenchPlayer : public MSPlayer {
+	public:
+	BenchPlayer(unsigned int block_size)
+	: uBlockSize(block_size), uRenderCalls(0), uSynthCalls(0) {
+	}
+
+	unsigned int uBlockSize;
+	unsigned long uRenderCalls;
+	unsigned long uSynthCalls;
+
+	protected:
+	virtual unsigned int send_event_needs_time() {
+		return uBlockSize;
+	}
+
+	virtual void render(float* out, unsigned long count) {
+		++uRenderCalls;
+		if(uBlockSize)
+			MSPlayer::render(out, count);
+		else
+			render_chunk(out, count);
+	}
+
+	virtual void render_chunk(float* out, unsigned long count) {
+		++uSynthCalls;
+		MSPlayer::render_chunk(out, count);
+	}
+};
+
+static void make_dense(midi_container& midi) {
+	static const unsigned dtx = 960; // 0.52 ms per tick at the default tempo
+	static const unsigned long length = dtx * 2 * 60;
+
+	midi.initialize(1, dtx);
+
+	midi_track track;
+	uint8_t data[2];
+
+	data[0] = 0;
+	track.add_event(midi_event(0, midi_event::program_change, 0, data, 1));
+
+	for(unsigned long t = 0; t < length; t++) {
+		// 64th note drum roll
+		if(t % (dtx / 16) == 0) {
+			data[0] = (t / (dtx / 16)) & 1 ? 38 : 40;
+			data[1] = 100;
+			track.add_event(midi_event(t, midi_event::note_on, 9, data, 2));
+			data[1] = 0;
+			track.add_event(midi_event(t + dtx / 32, midi_event::note_on, 9, data, 2));
+		}
+		// Held chord with a modulation sweep and pitch bends under it
+		if(t % (dtx * 4) == 0) {
+			for(unsigned i = 0; i < 3; i++) {
+				data[0] = 48 + i * 4;
+				data[1] = 90;
+				track.add_event(midi_event(t, midi_event::note_on, 0, data, 2));
+				data[1] = 0;
+				track.add_event(midi_event(t + dtx * 4 - 1, midi_event::note_on, 0, data, 2));
+			}
+		}
+		if(t % 2 == 0) {
+			data[0] = 1;
+			data[1] = (t / 2) & 127;
+			track.add_event(midi_event(t, midi_event::control_change, 0, data, 2));
+		}
+		if(t % 3 == 0) {
+			const unsigned bend = 8192 + (unsigned)(2048 * sin(t * 0.01));
+			data[0] = bend & 127;
+			data[1] = bend >> 7;
+			track.add_event(midi_event(t, midi_event::pitch_wheel, 0, data, 2));
+		}
+	}
+
+	midi.add_track(track);
+}
+
+static double render_all(MIDIPlayer& player, std::vector<float>& out) {
+	float buffer[1024 * 2];
+	unsigned long done;
+
+	out.clear();
+
+	const clock_t start = clock();
+	while((done = player.Play(buffer, 1024)) != 0)
+		out.insert(out.end(), buffer, buffer + done * 2);
+	const clock_t end = clock();
+
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char** argv) {
+	static const unsigned int block_sizes[] = { 0, 512, 1024, 2048, 4096 };
+	static const unsigned long sample_rate = 44100;
+
+	midi_container midi;
+
+	if(argc > 1) {
+		FILE* f = fopen(argv[1], "rb");
+		if(!f) {
+			fprintf(stderr, "Cannot open %s\n", argv[1]);
+			return 1;
+		}
+		std::vector<uint8_t> file;
+		uint8_t chunk[4096];
+		size_t read;
+		while((read = fread(chunk, 1, sizeof(chunk), f)) != 0)
+			file.insert(file.end(), chunk, chunk + read);
+		fclose(f);
+
+		const char* ext = strrchr(argv[1], '.');
+		if(!midi_processor::process_file(file, ext ? ext + 1 : "mid", midi)) {
+			fprintf(stderr, "Cannot parse %s\n", argv[1]);
+			return 1;
+		}
+	} else {
+		make_dense(midi);
+	}
+
+	std::vector<float> reference, out;
+	bool identical = true;
+
+	printf("%-8s %12s %12s %12s %12s\n", "block", "renders/s", "synth/s", "cpu ms/s", "max diff");
+
+	for(unsigned i = 0; i < sizeof(block_sizes) / sizeof(block_sizes[0]); i++) {
+		BenchPlayer player(block_sizes[i]);
+		player.set_synth(0);
+		player.set_bank(0);
+		player.set_extp(1);
+		player.setSampleRate(sample_rate);
+		player.setFilterMode(MIDIPlayer::filter_default, false);
+		if(!player.Load(midi, 0, 0, midi_container::clean_flag_emidi)) {
+			fprintf(stderr, "Nothing to play\n");
+			return 1;
+		}
+
+		const double cpu = render_all(player, i ? out : reference);
+		const std::vector<float>& result = i ? out : reference;
+		const double seconds = (double)(result.size() / 2) / sample_rate;
+
+		double max_diff = 0;
+		for(size_t j = 0; j < result.size() && j < reference.size(); j++) {
+			const double diff = fabs(result[j] - reference[j]);
+			if(diff > max_diff) max_diff = diff;
+		}
+		if(max_diff != 0 || result.size() != reference.size())
+			identical = false;
+
+		char name[16];
+		if(block_sizes[i])
+			snprintf(name, sizeof(name), "%u", block_sizes[i]);
+		else
+			snprintf(name, sizeof(name), "events");
+
+		printf("%-8s %12.1f %12.1f %12.2f %12g\n", name, player.uRenderCalls / seconds, player.uSynthCalls / seconds, cpu * 1000.0 / seconds, max_diff);
+	}
+
+	if(!identical) {
+		fprintf(stderr, "Block rendered output differs from per-event output\n");
+		return 1;
+	}
+
+	return 0;
+}
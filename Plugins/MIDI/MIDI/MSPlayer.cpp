@@ -3,6 +3,8 @@
 
 #include "MSPlayer.h"
 
+#define BLOCK_SIZE (4096)
+
 MSPlayer::MSPlayer() {
 	synth = 0;
 }
@@ -33,7 +35,15 @@ void MSPlayer::send_event(uint32_t b) {
 void MSPlayer::send_sysex(const uint8_t* data, size_t size, size_t port) {
 }
 
+unsigned int MSPlayer::send_event_needs_time() {
+	return BLOCK_SIZE;
+}
+
 void MSPlayer::render(float* out, unsigned long count) {
+	render_queued(out, count);
+}
+
+void MSPlayer::render_chunk(float* out, unsigned long count) {
 	float const scaler = 1.0f / 8192.0f;
 	short buffer[512];
 	while(count) {
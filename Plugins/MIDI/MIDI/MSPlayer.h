@@ -24,9 +24,11 @@ class MSPlayer : public MIDIPlayer {
 	void enum_synthesizers(enum_callback callback);
 
 	protected:
+	virtual unsigned int send_event_needs_time();
 	virtual void send_event(uint32_t b);
 	virtual void send_sysex(const uint8_t* data, size_t size, size_t port);
 	virtual void render(float* out, unsigned long count);
+	virtual void render_chunk(float* out, unsigned long count);
 
 	virtual void shutdown();
 	virtual bool startup();
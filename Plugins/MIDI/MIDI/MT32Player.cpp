@@ -2,6 +2,8 @@
 
 #include <stdio.h>
 
+#define BLOCK_SIZE (4096)
+
 MT32Player::MT32Player(bool gm, unsigned gm_set)
 : bGM(gm), uGMSet(gm_set), MIDIPlayer() {
 	_synth = NULL;
@@ -9,6 +11,7 @@ MT32Player::MT32Player(bool gm, unsigned gm_set)
 	pcmRom = NULL;
 	controlRomFile = NULL;
 	pcmRomFile = NULL;
+	uRenderedSamples = 0;
 }
 
 MT32Player::~MT32Player() {
@@ -40,6 +43,19 @@ void MT32Player::send_event(uint32_t b) {
 
 void MT32Player::render(float *out, unsigned long count) {
 	_synth->render(out, (MT32Emu::Bit32u)count);
+	uRenderedSamples += (MT32Emu::Bit32u)count;
+}
+
+unsigned int MT32Player::send_event_needs_time() {
+	return BLOCK_SIZE;
+}
+
+void MT32Player::send_event_time(uint32_t b, unsigned int time) {
+	_synth->playMsg(b & 0xFFFFFF, uRenderedSamples + time);
+}
+
+void MT32Player::send_sysex_time(const uint8_t *event, size_t size, size_t port, unsigned int time) {
+	_synth->playSysex(event, (MT32Emu::Bit32u)size, uRenderedSamples + time);
 }
 
 void MT32Player::setBasePath(const char *in) {
@@ -92,6 +108,9 @@ bool MT32Player::startup() {
 		_synth = 0;
 		return false;
 	}
+	// Room for a whole block of dense events, since they are all queued before it renders
+	_synth->setMIDIEventQueueSize(32768);
+	uRenderedSamples = 0;
 	reset();
 	return true;
 }
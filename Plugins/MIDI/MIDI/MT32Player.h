@@ -19,9 +19,13 @@ class MT32Player : public MIDIPlayer {
 	void setBasePath(const char *in);
 
 	protected:
+	virtual unsigned int send_event_needs_time();
 	virtual void send_event(uint32_t b);
 	virtual void render(float *out, unsigned long count);
 
+	virtual void send_event_time(uint32_t b, unsigned int time);
+	virtual void send_sysex_time(const uint8_t *event, size_t size, size_t port, unsigned int time);
+
 	virtual void shutdown();
 	virtual bool startup();
 
@@ -35,6 +39,9 @@ class MT32Player : public MIDIPlayer {
 	bool bGM;
 	unsigned uGMSet;
 
+	// Frames rendered since the synth was opened, which is the clock munt timestamps events against
+	MT32Emu::Bit32u uRenderedSamples;
+
 	void reset();
 
 	MT32Emu::File *openFile(const char *filename);
@@ -12,6 +12,11 @@
 
 #define _countof(x) (sizeof((x)) / sizeof(((x)[0])))
 
+#define BLOCK_SIZE (4096)
+
+// FluidSynth only applies events between its own blocks of this many frames
+#define FLUID_BLOCK_SIZE (64)
+
 SFPlayer::SFPlayer()
 : MIDIPlayer() {
 	_synth[0] = 0;
@@ -96,7 +101,15 @@ void SFPlayer::send_sysex(const uint8_t *data, size_t size, size_t port) {
 	}
 }
 
+unsigned int SFPlayer::send_event_needs_time() {
+	return BLOCK_SIZE;
+}
+
 void SFPlayer::render(float *out, unsigned long count) {
+	render_queued(out, count, FLUID_BLOCK_SIZE);
+}
+
+void SFPlayer::render_chunk(float *out, unsigned long count) {
 	unsigned long done = 0;
 	memset(out, 0, sizeof(float) * 2 * count);
 	while(done < count) {
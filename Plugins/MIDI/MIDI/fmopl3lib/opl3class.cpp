@@ -15,7 +15,7 @@
 #include "opl3class.h"
 #include <string.h>
 
-#include "../resampler.h"
+#include <Resampler/resampler.h>
 
 const Bit64u lat = (50 * 49716) / 1000;
 
@@ -29,8 +29,10 @@ int opl3class::fm_init(unsigned int rate) {
 	lastwrite = 0;
 	strpos = 0;
 	endpos = 0;
-	resampler = resampler_create();
+	resampler_init();
+	resampler = resampler_create_channels(2);
 	if(!resampler) return 0;
+	resampler_set_quality(resampler, RESAMPLER_QUALITY_SINC);
 	resampler_set_rate(resampler, 49716.0 / (double)rate);
 
 	return 1;
@@ -61,18 +63,12 @@ void opl3class::fm_generate_one(signed short *buffer) {
 
 void opl3class::fm_generate(signed short *buffer, unsigned int length) {
 	for(; length--;) {
-		sample_t ls, rs;
-		unsigned int to_write = resampler_get_min_fill(resampler);
-		while(to_write) {
+		while(!resampler_get_sample_count(resampler)) {
 			fm_generate_one(samples);
-			resampler_write_pair(resampler, samples[0], samples[1]);
-			--to_write;
+			resampler_write_frame(resampler, samples);
 		}
-		resampler_read_pair(resampler, &ls, &rs);
-		if((ls + 0x8000) & 0xFFFF0000) ls = (ls >> 31) ^ 0x7FFF;
-		if((rs + 0x8000) & 0xFFFF0000) rs = (rs >> 31) ^ 0x7FFF;
-		buffer[0] = (short)ls;
-		buffer[1] = (short)rs;
+		resampler_get_frame(resampler, buffer);
+		resampler_remove_sample(resampler, 0);
 		buffer += 2;
 	}
 }
@@ -52,7 +52,8 @@
 	//
 	//	}
 
-	TagLib::ByteVector vector((const char *)[tagBlock bytes], (unsigned int)[tagBlock length]);
+	// Parse the tag in place, tagBlock outlives every TagLib object below
+	TagLib::ByteVector vector = TagLib::ByteVector::fromRawData((const char *)[tagBlock bytes], (unsigned int)[tagBlock length]);
 	TagLib::ByteVectorStream vectorStream(vector);
 
 	TagLib::FileRef f(&vectorStream, false);
@@ -148,7 +149,9 @@
 				if(!pictures.isEmpty()) {
 					TagLib::ID3v2::AttachedPictureFrame *pic = static_cast<TagLib::ID3v2::AttachedPictureFrame *>(pictures.front());
 
-					image = [NSData dataWithBytes:pic->picture().data() length:pic->picture().size()];
+					// Const, so that reading it does not detach a copy of the picture
+					const TagLib::ByteVector picture = pic->picture();
+					image = [NSData dataWithBytes:picture.data() length:picture.size()];
 				}
 			}
 
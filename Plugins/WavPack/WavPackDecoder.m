@@ -136,6 +136,12 @@ int32_t WriteBytesProc(void *ds, void *data, int32_t bcount) {
 
 	if(![s seekable])
 		open_flags |= OPEN_STREAMING;
+	else {
+		// Decode upcoming blocks on up to two spare cores
+		NSUInteger threads = [[NSProcessInfo processInfo] activeProcessorCount];
+		threads = threads > 1 ? MIN(threads - 1, 2) : 0;
+		open_flags |= (int)threads << OPEN_THREADS_SHFT;
+	}
 
 	wpc = WavpackOpenFileInputEx(&reader, (__bridge void *)(wv), (__bridge void *)(wvc), error, open_flags, 0);
 	if(!wpc) {
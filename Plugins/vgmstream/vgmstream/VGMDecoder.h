@@ -27,6 +27,7 @@
 
 @interface VGMDecoder : NSObject <CogDecoder> {
 	VGMSTREAM *stream;
+	float *sampleBuffer;
 
 	BOOL playForever;
 	BOOL canPlayForever;
@@ -153,8 +153,8 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 	NSDictionary *properties = @{ @"bitrate": @(bitrate / 1000),
 		                          @"sampleRate": @(sampleRate),
 		                          @"totalFrames": @(totalFrames),
-		                          @"bitsPerSample": @(16),
-		                          @"floatingPoint": @(NO),
+		                          @"bitsPerSample": @(32),
+		                          @"floatingPoint": @(YES),
 		                          @"channels": @(channels),
 		                          @"seekable": @(YES),
 		                          @"replaygain_album_gain": rgAlbumGain,
@@ -285,6 +285,11 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 	channels = output_channels;
 	totalFrames = vgmstream_get_samples(stream);
 
+	/* layouts render all input channels before downmixing */
+	sampleBuffer = (float *)malloc(1024 * MAX(stream->channels, output_channels) * sizeof(float));
+	if(!sampleBuffer)
+		return NO;
+
 	framesRead = 0;
 
 	bitrate = get_vgmstream_average_bitrate(stream);
@@ -299,8 +304,8 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 	return @{ @"bitrate": @(bitrate / 1000),
 		      @"sampleRate": @(sampleRate),
 		      @"totalFrames": @(totalFrames),
-		      @"bitsPerSample": @(16),
-		      @"floatingPoint": @(NO),
+		      @"bitsPerSample": @(32),
+		      @"floatingPoint": @(YES),
 		      @"channels": @(channels),
 		      @"seekable": @(YES),
 		      @"endian": @"host",
@@ -319,9 +324,6 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 	id audioChunkClass = NSClassFromString(@"AudioChunk");
 	AudioChunk *chunk = [[audioChunkClass alloc] initWithProperties:[self properties]];
 
-	int16_t buffer[1024 * channels];
-	void *buf = (void *)buffer;
-
 	if(canPlayForever) {
 		BOOL repeatone = IsRepeatOneSet();
 
@@ -336,32 +338,14 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 	if(frames > framesMax)
 		frames = 0; // integer overflow?
 
-	while(frames) {
-		sample sample_buffer[MAX_BUFFER_SAMPLES * VGMSTREAM_MAX_CHANNELS];
-
-		UInt32 frames_to_do = frames;
-		if(frames_to_do > MAX_BUFFER_SAMPLES)
-			frames_to_do = MAX_BUFFER_SAMPLES;
-
-		memset(sample_buffer, 0, frames_to_do * channels * sizeof(sample_buffer[0]));
-
-		render_vgmstream(sample_buffer, frames_to_do, stream);
-
-		framesRead += frames_to_do;
-		framesDone += frames_to_do;
-
-		sample *sbuf = (sample *)buf;
-
-		memcpy(sbuf, sample_buffer, frames_to_do * channels * sizeof(sbuf[0]));
-
-		sbuf += frames_to_do * channels;
-
-		buf = (void *)sbuf;
+	if(frames) {
+		render_vgmstream_f32(sampleBuffer, frames, stream);
 
-		frames -= frames_to_do;
+		framesRead += frames;
+		framesDone += frames;
 	}
 
-	[chunk assignSamples:buffer frameCount:framesDone];
+	[chunk assignSamples:sampleBuffer frameCount:framesDone];
 
 	return chunk;
 }
@@ -389,6 +373,8 @@ static NSString *get_description_tag(const char *description, const char *tag, c
 - (void)close {
 	close_vgmstream(stream);
 	stream = NULL;
+	free(sampleBuffer);
+	sampleBuffer = NULL;
 }
 
 - (void)dealloc {